@@ -306,6 +306,14 @@ alsa_backend_open (MateMixerBackend *backend)
 
     alsa = ALSA_BACKEND (backend);
 
+    /* ALSA only provides devices and their streams, when the application
+     * uses neither of them, there is no need to open and monitor the cards */
+    if ((mate_mixer_backend_get_interests (backend) &
+        (MATE_MIXER_INTEREST_DEVICES | MATE_MIXER_INTEREST_STREAMS)) == 0) {
+        _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_READY);
+        return TRUE;
+    }
+
 #ifdef HAVE_UDEV
     if (!udev_monitor_setup (alsa))
 #endif
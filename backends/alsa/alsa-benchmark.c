@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Synthetic-card benchmark of the ALSA stream element storage.
+ *
+ * A device is filled with the given number of playback controls which are
+ * not bound to any ALSA element, so no sound card is needed. For each size
+ * the program measures the time spent adding the controls, dispatching an
+ * element change to each of them by name and removing them again, always
+ * looking up the best control as the backend does after every change.
+ *
+ * With linear load time the cost per element stays the same as the number
+ * of elements grows, the last column shows it relative to the smallest card.
+ *
+ * With --memory the program instead measures the growth of the heap caused by
+ * adding the given number of controls to the synthetic card, which gives the
+ * memory cost of a single ALSA stream control.
+ */
+
+#include <stdlib.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "alsa-device.h"
+#include "alsa-element.h"
+#include "alsa-stream.h"
+#include "alsa-stream-control.h"
+#include "alsa-stream-output-control.h"
+
+#define DEFAULT_SIZES   "100,200,400,800"
+#define DEFAULT_REPEATS 20
+
+static gchar *sizes   = NULL;
+static gint   repeats = DEFAULT_REPEATS;
+static gint   memory  = 0;
+static gint   target  = 0;
+
+static gint64
+heap_size (void)
+{
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 info = mallinfo2 ();
+#else
+    struct mallinfo info = mallinfo ();
+#endif
+    return (gint64) info.uordblks + (gint64) info.hblkhd;
+#else
+    return -1;
+#endif
+}
+
+static gdouble
+run_card (guint n)
+{
+    AlsaDevice *device;
+    AlsaStream *stream;
+    gchar     **names;
+    GRand      *rand;
+    gint64      start;
+    gint64      elapsed;
+    guint       i;
+
+    device = alsa_device_new ("benchmark", "Synthetic card");
+    stream = alsa_device_get_output_stream (device);
+    names  = g_new0 (gchar *, n + 1);
+
+    /* Use the same scores for every run of the same size */
+    rand = g_rand_new_with_seed (n);
+
+    for (i = 0; i < n; i++)
+        names[i] = g_strdup_printf ("Element %u,0", i);
+
+    start = g_get_monotonic_time ();
+
+    for (i = 0; i < n; i++) {
+        AlsaStreamControl *control;
+
+        control = alsa_stream_output_control_new (names[i],
+                                                  names[i],
+                                                  MATE_MIXER_STREAM_CONTROL_ROLE_UNKNOWN,
+                                                  stream);
+
+        alsa_stream_control_set_score (control, g_rand_int_range (rand, -1, 16));
+        alsa_stream_add_control (stream, control);
+        alsa_stream_get_best_control (stream);
+
+        g_object_unref (control);
+    }
+
+    for (i = 0; i < n; i++) {
+        alsa_stream_load_elements (stream, names[i]);
+        alsa_stream_get_best_control (stream);
+    }
+
+    for (i = 0; i < n; i++) {
+        alsa_stream_remove_elements (stream, names[i]);
+        alsa_stream_get_best_control (stream);
+    }
+
+    elapsed = g_get_monotonic_time () - start;
+
+    g_rand_free (rand);
+    g_strfreev (names);
+    g_object_unref (device);
+
+    return (gdouble) elapsed;
+}
+
+static gint64
+measure_card (guint n)
+{
+    AlsaDevice *device;
+    AlsaStream *stream;
+    gint64      before;
+    gint64      size;
+    guint       i;
+
+    device = alsa_device_new ("benchmark", "Synthetic card");
+    stream = alsa_device_get_output_stream (device);
+
+    before = heap_size ();
+
+    for (i = 0; i < n; i++) {
+        AlsaStreamControl *control;
+        gchar             *name;
+
+        name = g_strdup_printf ("Element %u,0", i);
+
+        control = alsa_stream_output_control_new (name,
+                                                  name,
+                                                  MATE_MIXER_STREAM_CONTROL_ROLE_UNKNOWN,
+                                                  stream);
+        alsa_stream_add_control (stream, control);
+
+        g_object_unref (control);
+        g_free (name);
+    }
+
+    /* Include the list of controls as an application would build it */
+    mate_mixer_stream_list_controls (MATE_MIXER_STREAM (stream));
+
+    size = heap_size () - before;
+
+    g_object_unref (device);
+    return size;
+}
+
+static gint
+run_memory (guint n)
+{
+    gint64  size;
+    gdouble per_control;
+
+    if (heap_size () < 0) {
+        g_printerr ("Measuring the heap is not supported on this system\n");
+        return 1;
+    }
+
+    /* Register the types and fill the caches of GLib before measuring */
+    measure_card (n);
+
+    size = measure_card (n);
+    per_control = (gdouble) size / n;
+
+    g_print ("%10s %14s %12s\n",
+             "controls",
+             "heap [bytes]",
+             "per control");
+    g_print ("%10u %14" G_GINT64_FORMAT " %12.1f\n",
+             n,
+             size,
+             per_control);
+
+    if (target > 0 && per_control > target) {
+        g_printerr ("A control takes %.1f bytes, more than the target of %d bytes\n",
+                    per_control,
+                    target);
+        return 1;
+    }
+    return 0;
+}
+
+int main (int argc, char *argv[])
+{
+    GError  *error = NULL;
+    gchar  **items;
+    gdouble  base = 0.0;
+    guint    i;
+
+    GOptionEntry entries[] = {
+        { "sizes",   's', 0, G_OPTION_ARG_STRING, &sizes,   "Comma-separated numbers of elements (default: " DEFAULT_SIZES ")", NULL },
+        { "repeats", 'r', 0, G_OPTION_ARG_INT,    &repeats, "Number of runs of each size", NULL },
+        { "memory",  'm', 0, G_OPTION_ARG_INT,    &memory,  "Measure the heap used by this many controls", NULL },
+        { "target",  't', 0, G_OPTION_ARG_INT,    &target,  "Fail when a control takes more bytes", NULL },
+        { NULL }
+    };
+
+    GOptionContext *ctx = g_option_context_new ("- ALSA element storage benchmark");
+
+    g_option_context_add_main_entries (ctx, entries, NULL);
+
+    if (g_option_context_parse (ctx, &argc, &argv, &error) == FALSE) {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        g_option_context_free (ctx);
+        return 1;
+    }
+    g_option_context_free (ctx);
+
+    if (memory > 0)
+        return run_memory ((guint) memory);
+
+    if (repeats < 1)
+        repeats = 1;
+
+    items = g_strsplit ((sizes != NULL) ? sizes : DEFAULT_SIZES, ",", -1);
+
+    g_print ("%10s %14s %16s %8s\n",
+             "elements",
+             "time [us]",
+             "per element [us]",
+             "ratio");
+
+    for (i = 0; items[i] != NULL; i++) {
+        gdouble total = 0.0;
+        gdouble per_element;
+        guint   n;
+        gint    j;
+
+        n = (guint) strtoul (items[i], NULL, 10);
+        if (n == 0)
+            continue;
+
+        /* Warm up the type system and the allocator */
+        run_card (n);
+
+        for (j = 0; j < repeats; j++)
+            total += run_card (n);
+
+        total /= repeats;
+        per_element = total / n;
+
+        if (base == 0.0)
+            base = per_element;
+
+        g_print ("%10u %14.1f %16.3f %8.2f\n",
+                 n,
+                 total,
+                 per_element,
+                 per_element / base);
+    }
+
+    g_strfreev (items);
+    g_free (sizes);
+    return 0;
+}
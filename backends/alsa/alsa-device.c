@@ -23,6 +23,7 @@
 #include <glib-object.h>
 #include <alsa/asoundlib.h>
 #include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-trace-private.h>
 
 #include "alsa-compat.h"
 #include "alsa-constants.h"
@@ -38,17 +39,8 @@
 
 #define ALSA_DEVICE_ICON "audio-card"
 
-#define ALSA_STREAM_CONTROL_GET_SCORE(c)                        \
-        (GPOINTER_TO_INT (g_object_get_data (G_OBJECT (c),      \
-                                             "__matemixer_alsa_control_score")))
-
-#define ALSA_STREAM_CONTROL_SET_SCORE(c,score)                  \
-        (g_object_set_data (G_OBJECT (c),                       \
-                            "__matemixer_alsa_control_score",   \
-                            GINT_TO_POINTER (score)))
-
 #define ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE(s)                \
-        (ALSA_STREAM_CONTROL_GET_SCORE (alsa_stream_get_default_control (ALSA_STREAM (s))))
+        (alsa_stream_control_get_score (alsa_stream_get_default_control (ALSA_STREAM (s))))
 
 struct _AlsaDevicePrivate
 {
@@ -125,8 +117,6 @@ static int                handle_element_callback   (snd_mixer_elem_t
 
 static void               validate_default_controls (AlsaDevice                 *device);
 
-static AlsaStreamControl *get_best_stream_control   (AlsaStream                 *stream);
-
 static gchar *            get_element_name          (snd_mixer_elem_t           *el);
 
 static void               get_control_info          (snd_mixer_elem_t           *el,
@@ -513,7 +503,7 @@ add_stream_input_control (AlsaDevice *device, snd_mixer_elem_t *el)
     g_free (name);
     g_free (label);
 
-    ALSA_STREAM_CONTROL_SET_SCORE (control, score);
+    alsa_stream_control_set_score (control, score);
 
     alsa_element_set_snd_element (ALSA_ELEMENT (control), el);
 
@@ -541,7 +531,7 @@ add_stream_output_control (AlsaDevice *device, snd_mixer_elem_t *el)
     g_free (name);
     g_free (label);
 
-    ALSA_STREAM_CONTROL_SET_SCORE (control, score);
+    alsa_stream_control_set_score (control, score);
 
     alsa_element_set_snd_element (ALSA_ELEMENT (control), el);
 
@@ -836,7 +826,15 @@ handle_process_events (AlsaDevice *device)
     g_mutex_lock (&device->priv->mutex);
 
     if (device->priv->handle != NULL) {
-        gint ret = snd_mixer_handle_events (device->priv->handle);
+        G_GNUC_UNUSED gint64 start = MATE_MIXER_TRACE_TIMESTAMP ();
+        gint                 ret;
+
+        ret = snd_mixer_handle_events (device->priv->handle);
+
+        MATE_MIXER_TRACE (alsa_process_events,
+                          mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)),
+                          ret,
+                          MATE_MIXER_TRACE_TIMESTAMP () - start);
         if (ret < 0)
             alsa_device_close (device);
     }
@@ -885,6 +883,11 @@ handle_element_callback (snd_mixer_elem_t *el, guint mask)
 
     name = get_element_name (el);
 
+    MATE_MIXER_TRACE (alsa_element_event,
+                      mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)),
+                      name,
+                      mask);
+
     if (mask == SND_CTL_EVENT_MASK_REMOVE) {
         /* Make sure this function is not called again with the element */
         snd_mixer_elem_set_callback_private (el, NULL);
@@ -934,9 +937,9 @@ validate_default_controls (AlsaDevice *device)
      * In other cases just keep the first control as the default.
      */
     if (alsa_stream_has_controls (device->priv->input) == TRUE) {
-        best = get_best_stream_control (device->priv->input);
+        best = alsa_stream_get_best_control (device->priv->input);
 
-        best_score    = ALSA_STREAM_CONTROL_GET_SCORE (best);
+        best_score    = alsa_stream_control_get_score (best);
         current_score = ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE (device->priv->input);
 
         /* See if the best element would make a good default one */
@@ -951,9 +954,9 @@ validate_default_controls (AlsaDevice *device)
     }
 
     if (alsa_stream_has_controls (device->priv->output) == TRUE) {
-        best = get_best_stream_control (device->priv->output);
+        best = alsa_stream_get_best_control (device->priv->output);
 
-        best_score    = ALSA_STREAM_CONTROL_GET_SCORE (best);
+        best_score    = alsa_stream_control_get_score (best);
         current_score = ALSA_STREAM_DEFAULT_CONTROL_GET_SCORE (device->priv->output);
 
         /* See if the best element would make a good default one */
@@ -968,31 +971,6 @@ validate_default_controls (AlsaDevice *device)
     }
 }
 
-static AlsaStreamControl *
-get_best_stream_control (AlsaStream *stream)
-{
-    const GList       *list;
-    AlsaStreamControl *best = NULL;
-    guint              best_score = -1;
-
-    list = mate_mixer_stream_list_controls (MATE_MIXER_STREAM (stream));
-    while (list != NULL) {
-        AlsaStreamControl *current;
-        guint              current_score;
-
-        current = ALSA_STREAM_CONTROL (list->data);
-        current_score = ALSA_STREAM_CONTROL_GET_SCORE (current);
-
-        if (best == NULL || (current_score != -1 &&
-                               (best_score == -1 || current_score < best_score))) {
-            best = current;
-            best_score = current_score;
-        }
-        list = list->next;
-    }
-    return best;
-}
-
 static gchar *
 get_element_name (snd_mixer_elem_t *el)
 {
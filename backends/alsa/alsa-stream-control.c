@@ -29,17 +29,21 @@
 struct _AlsaStreamControlPrivate
 {
     AlsaControlData   data;
+    gint              score;
     guint32           channel_mask;
     snd_mixer_elem_t *element;
 };
 
 static void alsa_element_interface_init    (AlsaElementInterface   *iface);
+static void decibel_scale_interface_init   (MateMixerDecibelScaleInterface *iface);
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (AlsaStreamControl, alsa_stream_control,
                                   MATE_MIXER_TYPE_STREAM_CONTROL,
                                   G_ADD_PRIVATE(AlsaStreamControl)
                                   G_IMPLEMENT_INTERFACE (ALSA_TYPE_ELEMENT,
-                                                         alsa_element_interface_init))
+                                                         alsa_element_interface_init)
+                                  G_IMPLEMENT_INTERFACE (MATE_MIXER_TYPE_DECIBEL_SCALE,
+                                                         decibel_scale_interface_init))
 
 static snd_mixer_elem_t *       alsa_stream_control_get_snd_element      (AlsaElement             *element);
 static void                     alsa_stream_control_set_snd_element      (AlsaElement             *element,
@@ -62,6 +66,13 @@ static gdouble                  alsa_stream_control_get_decibel          (MateMi
 static gboolean                 alsa_stream_control_set_decibel          (MateMixerStreamControl  *mmsc,
                                                                           gdouble                  decibel);
 
+static gboolean                 alsa_stream_control_get_decibel_from_volume (MateMixerDecibelScale *scale,
+                                                                             guint                  volume,
+                                                                             gdouble               *decibel);
+static gboolean                 alsa_stream_control_get_volume_from_decibel (MateMixerDecibelScale *scale,
+                                                                             gdouble                decibel,
+                                                                             guint                 *volume);
+
 static gboolean                 alsa_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
                                                                           MateMixerChannelPosition position);
 static MateMixerChannelPosition alsa_stream_control_get_channel_position (MateMixerStreamControl  *mmsc,
@@ -108,6 +119,13 @@ alsa_element_interface_init (AlsaElementInterface *iface)
     iface->load            = alsa_stream_control_load;
 }
 
+static void
+decibel_scale_interface_init (MateMixerDecibelScaleInterface *iface)
+{
+    iface->get_decibel_from_volume = alsa_stream_control_get_decibel_from_volume;
+    iface->get_volume_from_decibel = alsa_stream_control_get_volume_from_decibel;
+}
+
 static void
 alsa_stream_control_class_init (AlsaStreamControlClass *klass)
 {
@@ -139,6 +157,9 @@ static void
 alsa_stream_control_init (AlsaStreamControl *control)
 {
     control->priv = alsa_stream_control_get_instance_private (control);
+
+    /* Not a known default control candidate */
+    control->priv->score = -1;
 }
 
 AlsaControlData *
@@ -149,6 +170,22 @@ alsa_stream_control_get_data (AlsaStreamControl *control)
     return &control->priv->data;
 }
 
+gint
+alsa_stream_control_get_score (AlsaStreamControl *control)
+{
+    g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (control), -1);
+
+    return control->priv->score;
+}
+
+void
+alsa_stream_control_set_score (AlsaStreamControl *control, gint score)
+{
+    g_return_if_fail (ALSA_IS_STREAM_CONTROL (control));
+
+    control->priv->score = score;
+}
+
 void
 alsa_stream_control_set_data (AlsaStreamControl *control, AlsaControlData *data)
 {
@@ -207,6 +244,8 @@ alsa_stream_control_set_data (AlsaStreamControl *control, AlsaControlData *data)
                 flags |= MATE_MIXER_STREAM_CONTROL_CAN_FADE;
         }
 
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
         g_object_notify (G_OBJECT (control), "volume");
     } else {
         control->priv->channel_mask = 0;
@@ -343,6 +382,8 @@ alsa_stream_control_set_volume (MateMixerStreamControl *mmsc, guint volume)
 
         control->priv->data.volume = volume;
 
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
         g_object_notify (G_OBJECT (control), "volume");
     }
     return TRUE;
@@ -386,6 +427,38 @@ alsa_stream_control_set_decibel (MateMixerStreamControl *mmsc, gdouble decibel)
     return alsa_stream_control_set_volume (mmsc, volume);
 }
 
+static gboolean
+alsa_stream_control_get_decibel_from_volume (MateMixerDecibelScale *scale,
+                                             guint                  volume,
+                                             gdouble               *decibel)
+{
+    AlsaStreamControl *control;
+
+    g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (scale), FALSE);
+
+    control = ALSA_STREAM_CONTROL (scale);
+
+    return ALSA_STREAM_CONTROL_GET_CLASS (control)->get_decibel_from_volume (control,
+                                                                            volume,
+                                                                            decibel);
+}
+
+static gboolean
+alsa_stream_control_get_volume_from_decibel (MateMixerDecibelScale *scale,
+                                             gdouble                decibel,
+                                             guint                 *volume)
+{
+    AlsaStreamControl *control;
+
+    g_return_val_if_fail (ALSA_IS_STREAM_CONTROL (scale), FALSE);
+
+    control = ALSA_STREAM_CONTROL (scale);
+
+    return ALSA_STREAM_CONTROL_GET_CLASS (control)->get_volume_from_decibel (control,
+                                                                            decibel,
+                                                                            volume);
+}
+
 static gboolean
 alsa_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
                                           MateMixerChannelPosition position)
@@ -414,7 +487,7 @@ alsa_stream_control_get_channel_position (MateMixerStreamControl *mmsc, guint ch
     if (channel >= control->priv->data.channels)
         return MATE_MIXER_CHANNEL_UNKNOWN;
 
-    return control->priv->data.c[channel];
+    return (MateMixerChannelPosition) control->priv->data.c[channel];
 }
 
 static guint
@@ -469,6 +542,8 @@ alsa_stream_control_set_channel_volume (MateMixerStreamControl *mmsc, guint chan
         /* The global volume is always set to the highest channel volume */
         control->priv->data.volume = MAX (control->priv->data.volume, volume);
 
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
         g_object_notify (G_OBJECT (control), "volume");
     }
     return TRUE;
@@ -27,11 +27,13 @@
 
 G_BEGIN_DECLS
 
+/* Channel positions and mute values are stored in bytes, each control keeps
+ * a copy of the structure with room for every channel position */
 typedef struct {
     gboolean                 active;
-    MateMixerChannelPosition c[MATE_MIXER_CHANNEL_MAX];
+    guint8                   c[MATE_MIXER_CHANNEL_MAX];
+    guint8                   m[MATE_MIXER_CHANNEL_MAX];
     guint                    v[MATE_MIXER_CHANNEL_MAX];
-    gboolean                 m[MATE_MIXER_CHANNEL_MAX];
     guint                    volume;
     gboolean                 volume_joined;
     gboolean                 switch_usable;
@@ -101,6 +103,10 @@ AlsaControlData *  alsa_stream_control_get_data        (AlsaStreamControl *contr
 void               alsa_stream_control_set_data        (AlsaStreamControl *control,
                                                         AlsaControlData   *data);
 
+gint               alsa_stream_control_get_score       (AlsaStreamControl *control);
+void               alsa_stream_control_set_score       (AlsaStreamControl *control,
+                                                        gint               score);
+
 G_END_DECLS
 
 #endif /* ALSA_STREAM_CONTROL_H */
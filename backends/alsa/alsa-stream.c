@@ -29,21 +29,24 @@
 
 struct _AlsaStreamPrivate
 {
-    GList *switches;
-    GList *controls;
+    GQueue             switches;
+    GQueue             controls;
+    GHashTable        *switches_index;
+    GHashTable        *controls_index;
+    AlsaStreamControl *best;
+    gboolean           best_valid;
 };
 
 static void alsa_stream_dispose    (GObject         *object);
+static void alsa_stream_finalize   (GObject         *object);
 
 G_DEFINE_TYPE_WITH_PRIVATE (AlsaStream, alsa_stream, MATE_MIXER_TYPE_STREAM)
 
 static const GList *alsa_stream_list_controls (MateMixerStream *mms);
 static const GList *alsa_stream_list_switches (MateMixerStream *mms);
 
-static gint         compare_control_name      (gconstpointer    a,
-                                               gconstpointer    b);
-static gint         compare_switch_name       (gconstpointer    a,
-                                               gconstpointer    b);
+static void         update_best_control       (AlsaStream        *stream,
+                                               AlsaStreamControl *control);
 
 static void
 alsa_stream_class_init (AlsaStreamClass *klass)
@@ -52,7 +55,8 @@ alsa_stream_class_init (AlsaStreamClass *klass)
     MateMixerStreamClass *stream_class;
 
     object_class = G_OBJECT_CLASS (klass);
-    object_class->dispose = alsa_stream_dispose;
+    object_class->dispose  = alsa_stream_dispose;
+    object_class->finalize = alsa_stream_finalize;
 
     stream_class = MATE_MIXER_STREAM_CLASS (klass);
     stream_class->list_controls = alsa_stream_list_controls;
@@ -63,6 +67,13 @@ static void
 alsa_stream_init (AlsaStream *stream)
 {
     stream->priv = alsa_stream_get_instance_private (stream);
+
+    /* Index the controls and switches by name, the names are owned by the
+     * elements and the values are links in the queues */
+    stream->priv->controls_index = g_hash_table_new (g_str_hash, g_str_equal);
+    stream->priv->switches_index = g_hash_table_new (g_str_hash, g_str_equal);
+
+    stream->priv->best_valid = TRUE;
 }
 
 static void
@@ -72,18 +83,37 @@ alsa_stream_dispose (GObject *object)
 
     stream = ALSA_STREAM (object);
 
-    if (stream->priv->controls != NULL) {
-        g_list_free_full (stream->priv->controls, g_object_unref);
-        stream->priv->controls = NULL;
+    g_hash_table_remove_all (stream->priv->controls_index);
+    g_hash_table_remove_all (stream->priv->switches_index);
+
+    if (stream->priv->controls.head != NULL) {
+        g_list_free_full (stream->priv->controls.head, g_object_unref);
+        g_queue_init (&stream->priv->controls);
     }
-    if (stream->priv->switches != NULL) {
-        g_list_free_full (stream->priv->switches, g_object_unref);
-        stream->priv->switches = NULL;
+    if (stream->priv->switches.head != NULL) {
+        g_list_free_full (stream->priv->switches.head, g_object_unref);
+        g_queue_init (&stream->priv->switches);
     }
 
+    stream->priv->best       = NULL;
+    stream->priv->best_valid = TRUE;
+
     G_OBJECT_CLASS (alsa_stream_parent_class)->dispose (object);
 }
 
+static void
+alsa_stream_finalize (GObject *object)
+{
+    AlsaStream *stream;
+
+    stream = ALSA_STREAM (object);
+
+    g_hash_table_unref (stream->priv->controls_index);
+    g_hash_table_unref (stream->priv->switches_index);
+
+    G_OBJECT_CLASS (alsa_stream_parent_class)->finalize (object);
+}
+
 AlsaStream *
 alsa_stream_new (const gchar       *name,
                  MateMixerDevice   *device,
@@ -114,8 +144,12 @@ alsa_stream_add_control (AlsaStream *stream, AlsaStreamControl *control)
 
     name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (control));
 
-    stream->priv->controls =
-        g_list_append (stream->priv->controls, g_object_ref (control));
+    g_queue_push_tail (&stream->priv->controls, g_object_ref (control));
+    g_hash_table_insert (stream->priv->controls_index,
+                         (gpointer) name,
+                         g_queue_peek_tail_link (&stream->priv->controls));
+
+    update_best_control (stream, control);
 
     g_signal_emit_by_name (G_OBJECT (stream),
                            "control-added",
@@ -135,8 +169,10 @@ alsa_stream_add_switch (AlsaStream *stream, AlsaSwitch *swtch)
 
     name = mate_mixer_switch_get_name (MATE_MIXER_SWITCH (swtch));
 
-    stream->priv->switches =
-        g_list_append (stream->priv->switches, g_object_ref (swtch));
+    g_queue_push_tail (&stream->priv->switches, g_object_ref (swtch));
+    g_hash_table_insert (stream->priv->switches_index,
+                         (gpointer) name,
+                         g_queue_peek_tail_link (&stream->priv->switches));
 
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
@@ -154,8 +190,10 @@ alsa_stream_add_toggle (AlsaStream *stream, AlsaToggle *toggle)
     name = mate_mixer_switch_get_name (MATE_MIXER_SWITCH (toggle));
 
     /* Toggle is MateMixerSwitch, but not AlsaSwitch */
-    stream->priv->switches =
-        g_list_append (stream->priv->switches, g_object_ref (toggle));
+    g_queue_push_tail (&stream->priv->switches, g_object_ref (toggle));
+    g_hash_table_insert (stream->priv->switches_index,
+                         (gpointer) name,
+                         g_queue_peek_tail_link (&stream->priv->switches));
 
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
@@ -167,7 +205,7 @@ alsa_stream_has_controls (AlsaStream *stream)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (stream), FALSE);
 
-    if (stream->priv->controls != NULL)
+    if (stream->priv->controls.head != NULL)
         return TRUE;
 
     return FALSE;
@@ -178,7 +216,7 @@ alsa_stream_has_switches (AlsaStream *stream)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (stream), FALSE);
 
-    if (stream->priv->switches != NULL)
+    if (stream->priv->switches.head != NULL)
         return TRUE;
 
     return FALSE;
@@ -189,8 +227,8 @@ alsa_stream_has_controls_or_switches (AlsaStream *stream)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (stream), FALSE);
 
-    if (stream->priv->controls != NULL ||
-        stream->priv->switches != NULL)
+    if (stream->priv->controls.head != NULL ||
+        stream->priv->switches.head != NULL)
         return TRUE;
 
     return FALSE;
@@ -221,6 +259,25 @@ alsa_stream_get_default_control (AlsaStream *stream)
     return NULL;
 }
 
+AlsaStreamControl *
+alsa_stream_get_best_control (AlsaStream *stream)
+{
+    GList *list;
+
+    g_return_val_if_fail (ALSA_IS_STREAM (stream), NULL);
+
+    /* The best control is maintained as controls are added and only needs
+     * to be looked up again after it has been removed */
+    if (stream->priv->best_valid == FALSE) {
+        stream->priv->best       = NULL;
+        stream->priv->best_valid = TRUE;
+
+        for (list = stream->priv->controls.head; list != NULL; list = list->next)
+            update_best_control (stream, ALSA_STREAM_CONTROL (list->data));
+    }
+    return stream->priv->best;
+}
+
 void
 alsa_stream_set_default_control (AlsaStream *stream, AlsaStreamControl *control)
 {
@@ -242,11 +299,11 @@ alsa_stream_load_elements (AlsaStream *stream, const gchar *name)
     g_return_if_fail (ALSA_IS_STREAM (stream));
     g_return_if_fail (name != NULL);
 
-    item = g_list_find_custom (stream->priv->controls, name, compare_control_name);
+    item = g_hash_table_lookup (stream->priv->controls_index, name);
     if (item != NULL)
         alsa_element_load (ALSA_ELEMENT (item->data));
 
-    item = g_list_find_custom (stream->priv->switches, name, compare_switch_name);
+    item = g_hash_table_lookup (stream->priv->switches_index, name);
     if (item != NULL)
         alsa_element_load (ALSA_ELEMENT (item->data));
 }
@@ -260,19 +317,26 @@ alsa_stream_remove_elements (AlsaStream *stream, const gchar *name)
     g_return_val_if_fail (ALSA_IS_STREAM (stream), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    item = g_list_find_custom (stream->priv->controls, name, compare_control_name);
+    item = g_hash_table_lookup (stream->priv->controls_index, name);
     if (item != NULL) {
         MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (item->data);
 
         alsa_element_close (ALSA_ELEMENT (control));
-        stream->priv->controls = g_list_delete_link (stream->priv->controls, item);
+
+        g_hash_table_remove (stream->priv->controls_index, name);
+        g_queue_delete_link (&stream->priv->controls, item);
+
+        if (ALSA_STREAM_CONTROL (control) == stream->priv->best) {
+            stream->priv->best       = NULL;
+            stream->priv->best_valid = FALSE;
+        }
 
         /* Change the default control if we have just removed it */
         if (control == mate_mixer_stream_get_default_control (MATE_MIXER_STREAM (stream))) {
             AlsaStreamControl *first = NULL;
 
-            if (stream->priv->controls != NULL)
-                first = ALSA_STREAM_CONTROL (stream->priv->controls->data);
+            if (stream->priv->controls.head != NULL)
+                first = ALSA_STREAM_CONTROL (g_queue_peek_head (&stream->priv->controls));
 
             alsa_stream_set_default_control (stream, first);
         }
@@ -285,13 +349,15 @@ alsa_stream_remove_elements (AlsaStream *stream, const gchar *name)
         removed = TRUE;
     }
 
-    item = g_list_find_custom (stream->priv->switches, name, compare_switch_name);
+    item = g_hash_table_lookup (stream->priv->switches_index, name);
     if (item != NULL) {
         MateMixerSwitch *swtch = MATE_MIXER_SWITCH (item->data);
 
         alsa_element_close (ALSA_ELEMENT (swtch));
 
-        stream->priv->switches = g_list_delete_link (stream->priv->switches, item);
+        g_hash_table_remove (stream->priv->switches_index, name);
+        g_queue_delete_link (&stream->priv->switches, item);
+
         g_signal_emit_by_name (G_OBJECT (stream),
                                "switch-removed",
                                mate_mixer_switch_get_name (swtch));
@@ -306,45 +372,43 @@ alsa_stream_remove_elements (AlsaStream *stream, const gchar *name)
 void
 alsa_stream_remove_all (AlsaStream *stream)
 {
-    GList *list;
-
     g_return_if_fail (ALSA_IS_STREAM (stream));
 
+    g_hash_table_remove_all (stream->priv->controls_index);
+    g_hash_table_remove_all (stream->priv->switches_index);
+
+    stream->priv->best       = NULL;
+    stream->priv->best_valid = TRUE;
+
     /* Remove all stream controls */
-    list = stream->priv->controls;
-    while (list != NULL) {
-        MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (list->data);
-        GList *next = list->next;
+    while (stream->priv->controls.head != NULL) {
+        MateMixerStreamControl *control =
+            MATE_MIXER_STREAM_CONTROL (g_queue_pop_head (&stream->priv->controls));
 
         alsa_element_close (ALSA_ELEMENT (control));
 
-        stream->priv->controls = g_list_delete_link (stream->priv->controls, list);
         g_signal_emit_by_name (G_OBJECT (stream),
                                "control-removed",
                                mate_mixer_stream_control_get_name (control));
 
         g_object_unref (control);
-        list = next;
     }
 
     /* Unset the default stream control */
     alsa_stream_set_default_control (stream, NULL);
 
     /* Remove all stream switches */
-    list = stream->priv->switches;
-    while (list != NULL) {
-        MateMixerSwitch *swtch = MATE_MIXER_SWITCH (list->data);
-        GList *next = list->next;
+    while (stream->priv->switches.head != NULL) {
+        MateMixerSwitch *swtch =
+            MATE_MIXER_SWITCH (g_queue_pop_head (&stream->priv->switches));
 
         alsa_element_close (ALSA_ELEMENT (swtch));
 
-        stream->priv->switches = g_list_delete_link (stream->priv->switches, list);
         g_signal_emit_by_name (G_OBJECT (stream),
                                "switch-removed",
                                mate_mixer_switch_get_name (swtch));
 
         g_object_unref (swtch);
-        list = next;
     }
 }
 
@@ -353,7 +417,7 @@ alsa_stream_list_controls (MateMixerStream *mms)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (mms), NULL);
 
-    return ALSA_STREAM (mms)->priv->controls;
+    return ALSA_STREAM (mms)->priv->controls.head;
 }
 
 static const GList *
@@ -361,23 +425,29 @@ alsa_stream_list_switches (MateMixerStream *mms)
 {
     g_return_val_if_fail (ALSA_IS_STREAM (mms), NULL);
 
-    return ALSA_STREAM (mms)->priv->switches;
+    return ALSA_STREAM (mms)->priv->switches.head;
 }
 
-static gint
-compare_control_name (gconstpointer a, gconstpointer b)
+static void
+update_best_control (AlsaStream *stream, AlsaStreamControl *control)
 {
-    MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (a);
-    const gchar            *name    = (const gchar *) b;
+    gint score;
+    gint best_score;
 
-    return strcmp (mate_mixer_stream_control_get_name (control), name);
-}
+    /* Wait for the next lookup if the best control is not known */
+    if (stream->priv->best_valid == FALSE)
+        return;
 
-static gint
-compare_switch_name (gconstpointer a, gconstpointer b)
-{
-    MateMixerSwitch *swtch = MATE_MIXER_SWITCH (a);
-    const gchar     *name  = (const gchar *) b;
+    if (stream->priv->best == NULL) {
+        stream->priv->best = control;
+        return;
+    }
+
+    /* Smaller score represents a better control, -1 is the worst one and
+     * the earlier control wins among controls with the same score */
+    score      = alsa_stream_control_get_score (control);
+    best_score = alsa_stream_control_get_score (stream->priv->best);
 
-    return strcmp (mate_mixer_switch_get_name (swtch), name);
+    if (score != -1 && (best_score == -1 || score < best_score))
+        stream->priv->best = control;
 }
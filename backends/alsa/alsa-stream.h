@@ -74,6 +74,7 @@ gboolean           alsa_stream_has_controls_or_switches (AlsaStream        *stre
 gboolean           alsa_stream_has_default_control      (AlsaStream        *stream);
 
 AlsaStreamControl *alsa_stream_get_default_control      (AlsaStream        *stream);
+AlsaStreamControl *alsa_stream_get_best_control         (AlsaStream        *stream);
 void               alsa_stream_set_default_control      (AlsaStream        *stream,
                                                          AlsaStreamControl *control);
 
@@ -0,0 +1,1167 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-backend.h"
+#include "broker-control.h"
+#include "broker-device.h"
+#include "broker-device-switch.h"
+#include "broker-helpers.h"
+#include "broker-protocol.h"
+#include "broker-stream.h"
+#include "broker-stream-switch.h"
+
+/* The broker is only used when it is selected explicitly, or when none of
+ * the sound systems can be used directly */
+#define BACKEND_NAME      "Broker"
+#define BACKEND_PRIORITY  5
+#define BACKEND_FLAGS     (MATE_MIXER_BACKEND_HAS_APPLICATION_CONTROLS |        \
+                           MATE_MIXER_BACKEND_HAS_STORED_CONTROLS |             \
+                           MATE_MIXER_BACKEND_CAN_SET_DEFAULT_INPUT_STREAM |    \
+                           MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM)
+
+/* How long to wait for the state of the broker, this includes the time the
+ * broker needs to be activated and to connect to the sound system */
+#define BACKEND_STATE_TIMEOUT 10000
+
+struct _BrokerBackendPrivate
+{
+    GCancellable    *cancellable;
+    GDBusConnection *connection;
+    guint            signal_id;
+    guint            watch_id;
+    gboolean         loaded;
+    gchar           *server_address;
+    GHashTable      *devices;
+    GHashTable      *streams;
+    GHashTable      *stored_controls;
+    GList           *devices_list;
+    GList           *streams_list;
+    GList           *stored_controls_list;
+};
+
+#define BROKER_CHANGE_STATE(b, s)                                       \
+    (_mate_mixer_backend_set_state (MATE_MIXER_BACKEND (b), (s)))
+#define BROKER_STATISTICS(b)                                            \
+    (_mate_mixer_backend_get_statistics (MATE_MIXER_BACKEND (b)))
+
+static void broker_backend_dispose  (GObject *object);
+static void broker_backend_finalize (GObject *object);
+
+G_DEFINE_DYNAMIC_TYPE_EXTENDED (BrokerBackend, broker_backend, MATE_MIXER_TYPE_BACKEND, 0, G_ADD_PRIVATE_DYNAMIC(BrokerBackend))
+
+static gboolean         broker_backend_open                      (MateMixerBackend *backend);
+static void             broker_backend_close                     (MateMixerBackend *backend);
+
+static void             broker_backend_set_server_address        (MateMixerBackend *backend,
+                                                                  const gchar      *address);
+
+static const GList *    broker_backend_list_devices              (MateMixerBackend *backend);
+static const GList *    broker_backend_list_streams              (MateMixerBackend *backend);
+static const GList *    broker_backend_list_stored_controls      (MateMixerBackend *backend);
+
+static gboolean         broker_backend_set_default_input_stream  (MateMixerBackend *backend,
+                                                                  MateMixerStream  *stream);
+
+static gboolean         broker_backend_set_default_output_stream (MateMixerBackend *backend,
+                                                                  MateMixerStream  *stream);
+
+static void             on_bus_get                  (GObject          *object,
+                                                     GAsyncResult     *result,
+                                                     gpointer          user_data);
+static void             on_get_state                (GObject          *object,
+                                                     GAsyncResult     *result,
+                                                     gpointer          user_data);
+
+static void             on_broker_signal            (GDBusConnection  *connection,
+                                                     const gchar      *sender_name,
+                                                     const gchar      *object_path,
+                                                     const gchar      *interface_name,
+                                                     const gchar      *signal_name,
+                                                     GVariant         *parameters,
+                                                     BrokerBackend    *broker);
+
+static void             on_broker_vanished          (GDBusConnection  *connection,
+                                                     const gchar      *name,
+                                                     BrokerBackend    *broker);
+
+static void             load_objects                (BrokerBackend    *broker,
+                                                     GVariant         *state,
+                                                     gsize             index,
+                                                     guchar            kind);
+
+static void             add_object                  (BrokerBackend    *broker,
+                                                     guchar            kind,
+                                                     GVariant         *info);
+static void             remove_object               (BrokerBackend    *broker,
+                                                     guchar            kind,
+                                                     const gchar      *owner,
+                                                     const gchar      *name);
+static void             remove_all_objects          (BrokerBackend    *broker);
+
+static GList *          copy_names                  (GHashTable       *table);
+
+static void             add_device                  (BrokerBackend    *broker,
+                                                     GVariant         *info);
+static void             add_stream                  (BrokerBackend    *broker,
+                                                     GVariant         *info);
+static void             add_control                 (BrokerBackend    *broker,
+                                                     GVariant         *info);
+static void             add_device_switch           (BrokerBackend    *broker,
+                                                     GVariant         *info);
+static void             add_stream_switch           (BrokerBackend    *broker,
+                                                     GVariant         *info);
+
+static void             remove_device               (BrokerBackend    *broker,
+                                                     const gchar      *name);
+static void             remove_stream               (BrokerBackend    *broker,
+                                                     const gchar      *name);
+static void             remove_stored_control       (BrokerBackend    *broker,
+                                                     const gchar      *name);
+
+static MateMixerStreamControl *find_control         (BrokerBackend    *broker,
+                                                     const gchar      *owner,
+                                                     const gchar      *name);
+
+static void             set_default_streams         (BrokerBackend    *broker,
+                                                     const gchar      *input,
+                                                     const gchar      *output);
+
+static void             free_list_devices           (BrokerBackend    *broker);
+static void             free_list_streams           (BrokerBackend    *broker);
+static void             free_list_stored_controls   (BrokerBackend    *broker);
+
+static MateMixerBackendInfo info;
+
+void
+backend_module_init (GTypeModule *module)
+{
+    broker_backend_register_type (module);
+
+    info.name          = BACKEND_NAME;
+    info.priority      = BACKEND_PRIORITY;
+    info.g_type        = BROKER_TYPE_BACKEND;
+    info.backend_flags = BACKEND_FLAGS;
+    info.backend_type  = MATE_MIXER_BACKEND_BROKER;
+}
+
+const MateMixerBackendInfo *backend_module_get_info (void)
+{
+    return &info;
+}
+
+static void
+broker_backend_class_init (BrokerBackendClass *klass)
+{
+    GObjectClass          *object_class;
+    MateMixerBackendClass *backend_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose  = broker_backend_dispose;
+    object_class->finalize = broker_backend_finalize;
+
+    backend_class = MATE_MIXER_BACKEND_CLASS (klass);
+    backend_class->set_server_address        = broker_backend_set_server_address;
+    backend_class->open                      = broker_backend_open;
+    backend_class->close                     = broker_backend_close;
+    backend_class->list_devices              = broker_backend_list_devices;
+    backend_class->list_streams              = broker_backend_list_streams;
+    backend_class->list_stored_controls      = broker_backend_list_stored_controls;
+    backend_class->set_default_input_stream  = broker_backend_set_default_input_stream;
+    backend_class->set_default_output_stream = broker_backend_set_default_output_stream;
+}
+
+/* Called in the code generated by G_DEFINE_DYNAMIC_TYPE() */
+static void
+broker_backend_class_finalize (BrokerBackendClass *klass)
+{
+}
+
+static void
+broker_backend_init (BrokerBackend *broker)
+{
+    broker->priv = broker_backend_get_instance_private (broker);
+
+    /* The objects of the broker are identified by their names */
+    broker->priv->devices =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               g_free,
+                               g_object_unref);
+    broker->priv->streams =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               g_free,
+                               g_object_unref);
+    broker->priv->stored_controls =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               g_free,
+                               g_object_unref);
+}
+
+static void
+broker_backend_dispose (GObject *object)
+{
+    MateMixerBackend *backend;
+    MateMixerState    state;
+
+    backend = MATE_MIXER_BACKEND (object);
+
+    state = mate_mixer_backend_get_state (backend);
+    if (state != MATE_MIXER_STATE_IDLE)
+        broker_backend_close (backend);
+
+    G_OBJECT_CLASS (broker_backend_parent_class)->dispose (object);
+}
+
+static void
+broker_backend_finalize (GObject *object)
+{
+    BrokerBackend *broker;
+
+    broker = BROKER_BACKEND (object);
+
+    g_free (broker->priv->server_address);
+
+    g_hash_table_unref (broker->priv->devices);
+    g_hash_table_unref (broker->priv->streams);
+    g_hash_table_unref (broker->priv->stored_controls);
+
+    G_OBJECT_CLASS (broker_backend_parent_class)->finalize (object);
+}
+
+static gboolean
+broker_backend_open (MateMixerBackend *backend)
+{
+    BrokerBackend *broker;
+
+    g_return_val_if_fail (BROKER_IS_BACKEND (backend), FALSE);
+
+    broker = BROKER_BACKEND (backend);
+
+    if (G_UNLIKELY (broker->priv->cancellable != NULL)) {
+        g_warn_if_reached ();
+        return TRUE;
+    }
+
+    /* The broker only serves the default sound server of the session and it
+     * must not be used by the broker itself */
+    if (broker->priv->server_address != NULL)
+        return FALSE;
+    if (g_getenv (BROKER_DISABLE_VARIABLE) != NULL)
+        return FALSE;
+
+    broker->priv->cancellable = g_cancellable_new ();
+
+    BROKER_CHANGE_STATE (broker, MATE_MIXER_STATE_CONNECTING);
+
+    g_bus_get (G_BUS_TYPE_SESSION,
+               broker->priv->cancellable,
+               on_bus_get,
+               broker);
+    return TRUE;
+}
+
+static void
+broker_backend_close (MateMixerBackend *backend)
+{
+    BrokerBackend *broker;
+
+    g_return_if_fail (BROKER_IS_BACKEND (backend));
+
+    broker = BROKER_BACKEND (backend);
+
+    /* Pending asynchronous calls complete with a cancelled error and do not
+     * touch the backend */
+    if (broker->priv->cancellable != NULL) {
+        g_cancellable_cancel (broker->priv->cancellable);
+        g_clear_object (&broker->priv->cancellable);
+    }
+
+    if (broker->priv->watch_id != 0) {
+        g_bus_unwatch_name (broker->priv->watch_id);
+        broker->priv->watch_id = 0;
+    }
+
+    if (broker->priv->connection != NULL) {
+        if (broker->priv->signal_id != 0) {
+            g_dbus_connection_signal_unsubscribe (broker->priv->connection,
+                                                  broker->priv->signal_id);
+            broker->priv->signal_id = 0;
+        }
+        g_clear_object (&broker->priv->connection);
+    }
+
+    free_list_devices (broker);
+    free_list_streams (broker);
+    free_list_stored_controls (broker);
+
+    g_hash_table_remove_all (broker->priv->devices);
+    g_hash_table_remove_all (broker->priv->streams);
+    g_hash_table_remove_all (broker->priv->stored_controls);
+
+    broker->priv->loaded = FALSE;
+
+    BROKER_CHANGE_STATE (broker, MATE_MIXER_STATE_IDLE);
+}
+
+static void
+broker_backend_set_server_address (MateMixerBackend *backend, const gchar *address)
+{
+    g_return_if_fail (BROKER_IS_BACKEND (backend));
+
+    g_free (BROKER_BACKEND (backend)->priv->server_address);
+
+    BROKER_BACKEND (backend)->priv->server_address = g_strdup (address);
+}
+
+static const GList *
+broker_backend_list_devices (MateMixerBackend *backend)
+{
+    BrokerBackend *broker;
+
+    g_return_val_if_fail (BROKER_IS_BACKEND (backend), NULL);
+
+    broker = BROKER_BACKEND (backend);
+
+    if (broker->priv->devices_list == NULL) {
+        broker->priv->devices_list = g_hash_table_get_values (broker->priv->devices);
+        if (broker->priv->devices_list != NULL)
+            g_list_foreach (broker->priv->devices_list, (GFunc) g_object_ref, NULL);
+    }
+    return broker->priv->devices_list;
+}
+
+static const GList *
+broker_backend_list_streams (MateMixerBackend *backend)
+{
+    BrokerBackend *broker;
+
+    g_return_val_if_fail (BROKER_IS_BACKEND (backend), NULL);
+
+    broker = BROKER_BACKEND (backend);
+
+    if (broker->priv->streams_list == NULL) {
+        broker->priv->streams_list = g_hash_table_get_values (broker->priv->streams);
+        if (broker->priv->streams_list != NULL)
+            g_list_foreach (broker->priv->streams_list, (GFunc) g_object_ref, NULL);
+    }
+    return broker->priv->streams_list;
+}
+
+static const GList *
+broker_backend_list_stored_controls (MateMixerBackend *backend)
+{
+    BrokerBackend *broker;
+
+    g_return_val_if_fail (BROKER_IS_BACKEND (backend), NULL);
+
+    broker = BROKER_BACKEND (backend);
+
+    if (broker->priv->stored_controls_list == NULL) {
+        broker->priv->stored_controls_list = g_hash_table_get_values (broker->priv->stored_controls);
+        if (broker->priv->stored_controls_list != NULL)
+            g_list_foreach (broker->priv->stored_controls_list, (GFunc) g_object_ref, NULL);
+    }
+    return broker->priv->stored_controls_list;
+}
+
+static gboolean
+broker_backend_set_default_input_stream (MateMixerBackend *backend,
+                                         MateMixerStream  *stream)
+{
+    BrokerBackend *broker;
+
+    g_return_val_if_fail (BROKER_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (BROKER_IS_STREAM (stream), FALSE);
+
+    broker = BROKER_BACKEND (backend);
+
+    broker_call_method (broker->priv->connection,
+                        "SetDefaultStream",
+                        g_variant_new ("(us)",
+                                       MATE_MIXER_DIRECTION_INPUT,
+                                       mate_mixer_stream_get_name (stream)));
+    return TRUE;
+}
+
+static gboolean
+broker_backend_set_default_output_stream (MateMixerBackend *backend,
+                                          MateMixerStream  *stream)
+{
+    BrokerBackend *broker;
+
+    g_return_val_if_fail (BROKER_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (BROKER_IS_STREAM (stream), FALSE);
+
+    broker = BROKER_BACKEND (backend);
+
+    broker_call_method (broker->priv->connection,
+                        "SetDefaultStream",
+                        g_variant_new ("(us)",
+                                       MATE_MIXER_DIRECTION_OUTPUT,
+                                       mate_mixer_stream_get_name (stream)));
+    return TRUE;
+}
+
+static void
+on_bus_get (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    BrokerBackend   *broker;
+    GDBusConnection *connection;
+    GError          *error = NULL;
+
+    connection = g_bus_get_finish (result, &error);
+    if (connection == NULL) {
+        /* The backend may not exist anymore when the call has been cancelled */
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED) == FALSE) {
+            g_debug ("Failed to connect to the session bus: %s", error->message);
+
+            BROKER_CHANGE_STATE (user_data, MATE_MIXER_STATE_FAILED);
+        }
+        g_error_free (error);
+        return;
+    }
+
+    broker = BROKER_BACKEND (user_data);
+
+    broker->priv->connection = connection;
+
+    /* Subscribe before asking for the state so no change can be missed, the
+     * signals are ignored until the state is loaded */
+    broker->priv->signal_id =
+        g_dbus_connection_signal_subscribe (connection,
+                                            BROKER_DBUS_NAME,
+                                            BROKER_DBUS_INTERFACE,
+                                            NULL,
+                                            BROKER_DBUS_PATH,
+                                            NULL,
+                                            G_DBUS_SIGNAL_FLAGS_NONE,
+                                            (GDBusSignalCallback) on_broker_signal,
+                                            broker,
+                                            NULL);
+
+    /* This call starts the broker when it is not running yet */
+    g_dbus_connection_call (connection,
+                            BROKER_DBUS_NAME,
+                            BROKER_DBUS_PATH,
+                            BROKER_DBUS_INTERFACE,
+                            "GetState",
+                            NULL,
+                            G_VARIANT_TYPE ("(" BROKER_STATE_TYPE ")"),
+                            G_DBUS_CALL_FLAGS_NONE,
+                            BACKEND_STATE_TIMEOUT,
+                            broker->priv->cancellable,
+                            on_get_state,
+                            broker);
+}
+
+static void
+on_get_state (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    BrokerBackend *broker;
+    GVariant      *reply;
+    GVariant      *state;
+    const gchar   *input;
+    const gchar   *output;
+    guint32        broker_state;
+    GError        *error = NULL;
+
+    reply = g_dbus_connection_call_finish (G_DBUS_CONNECTION (object), result, &error);
+    if (reply == NULL) {
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED) == FALSE) {
+            g_debug ("Failed to read the state of the mixer broker: %s", error->message);
+
+            BROKER_CHANGE_STATE (user_data, MATE_MIXER_STATE_FAILED);
+        }
+        g_error_free (error);
+        return;
+    }
+
+    broker = BROKER_BACKEND (user_data);
+
+    state = g_variant_get_child_value (reply, 0);
+
+    /* Load the objects in the order the owners are created before the
+     * objects they own */
+    load_objects (broker, state, 1, BROKER_KIND_DEVICE);
+    load_objects (broker, state, 2, BROKER_KIND_STREAM);
+    load_objects (broker, state, 3, BROKER_KIND_CONTROL);
+    load_objects (broker, state, 4, BROKER_KIND_DEVICE_SWITCH);
+    load_objects (broker, state, 5, BROKER_KIND_STREAM_SWITCH);
+
+    g_variant_get_child (state, 6, "&s", &input);
+    g_variant_get_child (state, 7, "&s", &output);
+    g_variant_get_child (state, 8, "u", &broker_state);
+
+    set_default_streams (broker, input, output);
+
+    g_variant_unref (state);
+    g_variant_unref (reply);
+
+    broker->priv->watch_id =
+        g_bus_watch_name_on_connection (broker->priv->connection,
+                                        BROKER_DBUS_NAME,
+                                        G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                        NULL,
+                                        (GBusNameVanishedCallback) on_broker_vanished,
+                                        broker,
+                                        NULL);
+
+    broker->priv->loaded = TRUE;
+
+    /* The broker may be reconnecting to the sound system, in which case the
+     * objects arrive later and the StateChanged signal completes the loading */
+    if (broker_state == MATE_MIXER_STATE_READY)
+        BROKER_CHANGE_STATE (broker, MATE_MIXER_STATE_READY);
+}
+
+static void
+on_broker_signal (GDBusConnection *connection,
+                  const gchar     *sender_name,
+                  const gchar     *object_path,
+                  const gchar     *interface_name,
+                  const gchar     *signal_name,
+                  GVariant        *parameters,
+                  BrokerBackend   *broker)
+{
+    const gchar *owner;
+    const gchar *name;
+    guchar       kind;
+
+    /* Changes which happened before the state was read are already included
+     * in the state */
+    if (broker->priv->loaded == FALSE)
+        return;
+
+    /* Each of the signals checks the type of its parameters before reading
+     * them, signals of a broker speaking a different version of the protocol
+     * are ignored */
+    if (g_strcmp0 (signal_name, "ObjectAdded") == 0) {
+        GVariant *info;
+
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(yv)")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(yv)", &kind, &info);
+
+        add_object (broker, kind, info);
+        g_variant_unref (info);
+    }
+    else if (g_strcmp0 (signal_name, "ObjectRemoved") == 0) {
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(yss)")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(y&s&s)", &kind, &owner, &name);
+
+        remove_object (broker, kind, owner, name);
+    }
+    else if (g_strcmp0 (signal_name, "ControlChanged") == 0) {
+        MateMixerStreamControl *control;
+        GVariant               *value;
+
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(ss" BROKER_VALUE_TYPE ")")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(&s&s@" BROKER_VALUE_TYPE ")", &owner, &name, &value);
+
+        control = find_control (broker, owner, name);
+        if (control != NULL) {
+            _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                              (*owner == '\0')
+                                                ? MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL
+                                                : MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+
+            broker_control_update (control, value);
+        }
+        g_variant_unref (value);
+    }
+    else if (g_strcmp0 (signal_name, "SwitchChanged") == 0) {
+        const gchar *option;
+
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(ysss)")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(y&s&s&s)", &kind, &owner, &name, &option);
+
+        if (kind == BROKER_KIND_DEVICE_SWITCH) {
+            MateMixerDevice       *device;
+            MateMixerDeviceSwitch *swtch = NULL;
+
+            device = g_hash_table_lookup (broker->priv->devices, owner);
+            if (device != NULL)
+                swtch = mate_mixer_device_get_switch (device, name);
+            if (swtch != NULL) {
+                _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                                  MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+                broker_device_switch_set_active_option (BROKER_DEVICE_SWITCH (swtch), option);
+            }
+        } else if (kind == BROKER_KIND_STREAM_SWITCH) {
+            MateMixerStream       *stream;
+            MateMixerStreamSwitch *swtch = NULL;
+
+            stream = g_hash_table_lookup (broker->priv->streams, owner);
+            if (stream != NULL)
+                swtch = mate_mixer_stream_get_switch (stream, name);
+            if (swtch != NULL) {
+                _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                                  MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+                broker_stream_switch_set_active_option (BROKER_STREAM_SWITCH (swtch), option);
+            }
+        }
+    }
+    else if (g_strcmp0 (signal_name, "StreamChanged") == 0) {
+        BrokerStream *stream;
+        const gchar  *control;
+
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(ss)")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(&s&s)", &name, &control);
+
+        stream = g_hash_table_lookup (broker->priv->streams, name);
+        if (stream != NULL) {
+            _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                              MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+            broker_stream_set_default_control (stream, control);
+        }
+    }
+    else if (g_strcmp0 (signal_name, "DefaultStreamsChanged") == 0) {
+        const gchar *input;
+        const gchar *output;
+
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(ss)")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(&s&s)", &input, &output);
+
+        _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                          MATE_MIXER_STATISTICS_EVENT_SERVER);
+
+        set_default_streams (broker, input, output);
+    }
+    else if (g_strcmp0 (signal_name, "StateChanged") == 0) {
+        guint32 state;
+
+        if (g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(u)")) == FALSE)
+            return;
+
+        g_variant_get (parameters, "(u)", &state);
+
+        if (state == MATE_MIXER_STATE_CONNECTING) {
+            remove_all_objects (broker);
+
+            /* Keep following the broker, the objects are added again once
+             * it has reconnected */
+            broker->priv->loaded = TRUE;
+
+            BROKER_CHANGE_STATE (broker, MATE_MIXER_STATE_CONNECTING);
+        }
+        else if (state == MATE_MIXER_STATE_READY) {
+            BROKER_CHANGE_STATE (broker, MATE_MIXER_STATE_READY);
+        }
+    }
+}
+
+static void
+on_broker_vanished (GDBusConnection *connection,
+                    const gchar     *name,
+                    BrokerBackend   *broker)
+{
+    g_debug ("The mixer broker has disappeared from the session bus");
+
+    /* Let the context know the objects are gone before failing, the context
+     * falls back to another backend if it did not request this one */
+    remove_all_objects (broker);
+
+    BROKER_CHANGE_STATE (broker, MATE_MIXER_STATE_FAILED);
+}
+
+static void
+load_objects (BrokerBackend *broker,
+              GVariant      *state,
+              gsize          index,
+              guchar         kind)
+{
+    GVariant     *objects;
+    GVariant     *info;
+    GVariantIter  iter;
+
+    objects = g_variant_get_child_value (state, index);
+
+    g_variant_iter_init (&iter, objects);
+    while ((info = g_variant_iter_next_value (&iter)) != NULL) {
+        add_object (broker, kind, info);
+        g_variant_unref (info);
+    }
+    g_variant_unref (objects);
+}
+
+static void
+add_object (BrokerBackend *broker, guchar kind, GVariant *info)
+{
+    switch (kind) {
+    case BROKER_KIND_DEVICE:
+        if (g_variant_is_of_type (info, G_VARIANT_TYPE (BROKER_DEVICE_TYPE)))
+            add_device (broker, info);
+        break;
+    case BROKER_KIND_STREAM:
+        if (g_variant_is_of_type (info, G_VARIANT_TYPE (BROKER_STREAM_TYPE)))
+            add_stream (broker, info);
+        break;
+    case BROKER_KIND_CONTROL:
+        if (g_variant_is_of_type (info, G_VARIANT_TYPE (BROKER_CONTROL_TYPE)))
+            add_control (broker, info);
+        break;
+    case BROKER_KIND_DEVICE_SWITCH:
+        if (g_variant_is_of_type (info, G_VARIANT_TYPE (BROKER_SWITCH_TYPE)))
+            add_device_switch (broker, info);
+        break;
+    case BROKER_KIND_STREAM_SWITCH:
+        if (g_variant_is_of_type (info, G_VARIANT_TYPE (BROKER_SWITCH_TYPE)))
+            add_stream_switch (broker, info);
+        break;
+    default:
+        g_debug ("Ignoring an object of unknown kind %c", kind);
+        break;
+    }
+}
+
+static void
+remove_object (BrokerBackend *broker,
+               guchar         kind,
+               const gchar   *owner,
+               const gchar   *name)
+{
+    BrokerDevice *device;
+    BrokerStream *stream;
+
+    switch (kind) {
+    case BROKER_KIND_DEVICE:
+        remove_device (broker, name);
+        break;
+    case BROKER_KIND_STREAM:
+        remove_stream (broker, name);
+        break;
+    case BROKER_KIND_CONTROL:
+        if (*owner == '\0') {
+            remove_stored_control (broker, name);
+            break;
+        }
+        stream = g_hash_table_lookup (broker->priv->streams, owner);
+        if (stream != NULL) {
+            _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                              MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+
+            broker_stream_remove_control (stream, name);
+        }
+        break;
+    case BROKER_KIND_DEVICE_SWITCH:
+        device = g_hash_table_lookup (broker->priv->devices, owner);
+        if (device != NULL) {
+            _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                              MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+            broker_device_remove_switch (device, name);
+        }
+        break;
+    case BROKER_KIND_STREAM_SWITCH:
+        stream = g_hash_table_lookup (broker->priv->streams, owner);
+        if (stream != NULL) {
+            _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                              MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+            broker_stream_remove_switch (stream, name);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+remove_all_objects (BrokerBackend *broker)
+{
+    GList *names;
+    GList *list;
+
+    broker->priv->loaded = FALSE;
+
+    set_default_streams (broker, "", "");
+
+    names = copy_names (broker->priv->stored_controls);
+    for (list = names; list != NULL; list = list->next)
+        remove_stored_control (broker, list->data);
+    g_list_free_full (names, g_free);
+
+    names = copy_names (broker->priv->streams);
+    for (list = names; list != NULL; list = list->next)
+        remove_stream (broker, list->data);
+    g_list_free_full (names, g_free);
+
+    names = copy_names (broker->priv->devices);
+    for (list = names; list != NULL; list = list->next)
+        remove_device (broker, list->data);
+    g_list_free_full (names, g_free);
+}
+
+static void
+add_device (BrokerBackend *broker, GVariant *info)
+{
+    BrokerDevice *device;
+    const gchar  *name;
+
+    g_variant_get_child (info, 0, "&s", &name);
+
+    if (g_hash_table_contains (broker->priv->devices, name) == TRUE)
+        return;
+
+    device = broker_device_new (info);
+
+    g_hash_table_insert (broker->priv->devices, g_strdup (name), device);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+    free_list_devices (broker);
+    g_signal_emit_by_name (G_OBJECT (broker),
+                           "device-added",
+                           name);
+}
+
+static void
+add_stream (BrokerBackend *broker, GVariant *info)
+{
+    BrokerDevice *device = NULL;
+    BrokerStream *stream;
+    const gchar  *name;
+    const gchar  *device_name;
+
+    g_variant_get_child (info, 0, "&s", &name);
+    g_variant_get_child (info, 2, "&s", &device_name);
+
+    if (g_hash_table_contains (broker->priv->streams, name) == TRUE)
+        return;
+
+    if (*device_name != '\0')
+        device = g_hash_table_lookup (broker->priv->devices, device_name);
+
+    stream = broker_stream_new (info, device);
+
+    g_hash_table_insert (broker->priv->streams, g_strdup (name), stream);
+
+    if (device != NULL)
+        broker_device_add_stream (device, stream);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+    free_list_streams (broker);
+    g_signal_emit_by_name (G_OBJECT (broker),
+                           "stream-added",
+                           name);
+}
+
+static void
+add_control (BrokerBackend *broker, GVariant *info)
+{
+    MateMixerStreamControl *control;
+    BrokerStream           *stream;
+    const gchar            *owner;
+    const gchar            *name;
+
+    g_variant_get_child (info, 0, "&s", &owner);
+    g_variant_get_child (info, 1, "&s", &name);
+
+    /* Stored controls have no owner */
+    if (*owner == '\0') {
+        const gchar *stream_name;
+
+        if (g_hash_table_contains (broker->priv->stored_controls, name) == TRUE)
+            return;
+
+        /* Stored controls may refer to a stream they are applied to */
+        g_variant_get_child (info, 3, "&s", &stream_name);
+
+        stream = g_hash_table_lookup (broker->priv->streams, stream_name);
+        control = broker_control_new (broker->priv->connection,
+                                      info,
+                                      MATE_MIXER_STREAM (stream));
+
+        g_hash_table_insert (broker->priv->stored_controls, g_strdup (name), control);
+
+        _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                          MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL);
+
+        free_list_stored_controls (broker);
+        g_signal_emit_by_name (G_OBJECT (broker),
+                               "stored-control-added",
+                               name);
+        return;
+    }
+
+    stream = g_hash_table_lookup (broker->priv->streams, owner);
+    if (G_UNLIKELY (stream == NULL))
+        return;
+
+    if (mate_mixer_stream_get_control (MATE_MIXER_STREAM (stream), name) != NULL)
+        return;
+
+    control = broker_control_new (broker->priv->connection,
+                                  info,
+                                  MATE_MIXER_STREAM (stream));
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+
+    broker_stream_add_control (stream, control);
+    g_object_unref (control);
+}
+
+static void
+add_device_switch (BrokerBackend *broker, GVariant *info)
+{
+    BrokerDevice       *device;
+    BrokerDeviceSwitch *swtch;
+    const gchar        *owner;
+    const gchar        *name;
+
+    g_variant_get_child (info, 0, "&s", &owner);
+    g_variant_get_child (info, 1, "&s", &name);
+
+    device = g_hash_table_lookup (broker->priv->devices, owner);
+    if (G_UNLIKELY (device == NULL))
+        return;
+
+    if (mate_mixer_device_get_switch (MATE_MIXER_DEVICE (device), name) != NULL)
+        return;
+
+    swtch = broker_device_switch_new (broker->priv->connection, device, info);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+    broker_device_add_switch (device, swtch);
+    g_object_unref (swtch);
+}
+
+static void
+add_stream_switch (BrokerBackend *broker, GVariant *info)
+{
+    BrokerStream       *stream;
+    BrokerStreamSwitch *swtch;
+    const gchar        *owner;
+    const gchar        *name;
+
+    g_variant_get_child (info, 0, "&s", &owner);
+    g_variant_get_child (info, 1, "&s", &name);
+
+    stream = g_hash_table_lookup (broker->priv->streams, owner);
+    if (G_UNLIKELY (stream == NULL))
+        return;
+
+    if (mate_mixer_stream_get_switch (MATE_MIXER_STREAM (stream), name) != NULL)
+        return;
+
+    swtch = broker_stream_switch_new (broker->priv->connection, stream, info);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+    broker_stream_add_switch (stream, swtch);
+    g_object_unref (swtch);
+}
+
+static void
+remove_device (BrokerBackend *broker, const gchar *name)
+{
+    BrokerDevice *device;
+
+    device = g_hash_table_lookup (broker->priv->devices, name);
+    if (G_UNLIKELY (device == NULL))
+        return;
+
+    /* The name may be owned by the hash table */
+    g_object_ref (device);
+    name = mate_mixer_device_get_name (MATE_MIXER_DEVICE (device));
+
+    g_hash_table_remove (broker->priv->devices, name);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+    free_list_devices (broker);
+    g_signal_emit_by_name (G_OBJECT (broker),
+                           "device-removed",
+                           name);
+
+    g_object_unref (device);
+}
+
+static void
+remove_stream (BrokerBackend *broker, const gchar *name)
+{
+    MateMixerBackend *backend;
+    MateMixerStream  *stream;
+    MateMixerDevice  *device;
+
+    stream = g_hash_table_lookup (broker->priv->streams, name);
+    if (G_UNLIKELY (stream == NULL))
+        return;
+
+    backend = MATE_MIXER_BACKEND (broker);
+
+    g_object_ref (stream);
+    name = mate_mixer_stream_get_name (stream);
+
+    g_hash_table_remove (broker->priv->streams, name);
+
+    device = mate_mixer_stream_get_device (stream);
+    if (device != NULL)
+        broker_device_remove_stream (BROKER_DEVICE (device), BROKER_STREAM (stream));
+
+    if (mate_mixer_backend_get_default_input_stream (backend) == stream)
+        _mate_mixer_backend_set_default_input_stream (backend, NULL);
+    if (mate_mixer_backend_get_default_output_stream (backend) == stream)
+        _mate_mixer_backend_set_default_output_stream (backend, NULL);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+    free_list_streams (broker);
+    g_signal_emit_by_name (G_OBJECT (broker),
+                           "stream-removed",
+                           name);
+
+    g_object_unref (stream);
+}
+
+static void
+remove_stored_control (BrokerBackend *broker, const gchar *name)
+{
+    MateMixerStreamControl *control;
+
+    control = g_hash_table_lookup (broker->priv->stored_controls, name);
+    if (G_UNLIKELY (control == NULL))
+        return;
+
+    g_object_ref (control);
+    name = mate_mixer_stream_control_get_name (control);
+
+    g_hash_table_remove (broker->priv->stored_controls, name);
+
+    _mate_mixer_statistics_add_event (BROKER_STATISTICS (broker),
+                                      MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL);
+
+    free_list_stored_controls (broker);
+    g_signal_emit_by_name (G_OBJECT (broker),
+                           "stored-control-removed",
+                           name);
+
+    g_object_unref (control);
+}
+
+static MateMixerStreamControl *
+find_control (BrokerBackend *broker, const gchar *owner, const gchar *name)
+{
+    MateMixerStream *stream;
+
+    if (*owner == '\0')
+        return g_hash_table_lookup (broker->priv->stored_controls, name);
+
+    stream = g_hash_table_lookup (broker->priv->streams, owner);
+    if (stream == NULL)
+        return NULL;
+
+    return mate_mixer_stream_get_control (stream, name);
+}
+
+static void
+set_default_streams (BrokerBackend *broker,
+                     const gchar   *input,
+                     const gchar   *output)
+{
+    MateMixerBackend *backend;
+    MateMixerStream  *stream;
+
+    backend = MATE_MIXER_BACKEND (broker);
+
+    /* An empty name or an unknown stream unsets the default stream */
+    stream = g_hash_table_lookup (broker->priv->streams, input);
+    _mate_mixer_backend_set_default_input_stream (backend, stream);
+
+    stream = g_hash_table_lookup (broker->priv->streams, output);
+    _mate_mixer_backend_set_default_output_stream (backend, stream);
+}
+
+static GList *
+copy_names (GHashTable *table)
+{
+    GList *names;
+    GList *list;
+
+    /* The keys are freed together with the objects, so they cannot be used
+     * while removing the objects one by one */
+    names = g_hash_table_get_keys (table);
+    for (list = names; list != NULL; list = list->next)
+        list->data = g_strdup (list->data);
+
+    return names;
+}
+
+static void
+free_list_devices (BrokerBackend *broker)
+{
+    if (broker->priv->devices_list == NULL)
+        return;
+
+    g_list_free_full (broker->priv->devices_list, g_object_unref);
+
+    broker->priv->devices_list = NULL;
+}
+
+static void
+free_list_streams (BrokerBackend *broker)
+{
+    if (broker->priv->streams_list == NULL)
+        return;
+
+    g_list_free_full (broker->priv->streams_list, g_object_unref);
+
+    broker->priv->streams_list = NULL;
+}
+
+static void
+free_list_stored_controls (BrokerBackend *broker)
+{
+    if (broker->priv->stored_controls_list == NULL)
+        return;
+
+    g_list_free_full (broker->priv->stored_controls_list, g_object_unref);
+
+    broker->priv->stored_controls_list = NULL;
+}
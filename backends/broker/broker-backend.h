@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_BACKEND_H
+#define BROKER_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-types.h"
+
+#define BROKER_TYPE_BACKEND                     \
+        (broker_backend_get_type ())
+#define BROKER_BACKEND(o)                       \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), BROKER_TYPE_BACKEND, BrokerBackend))
+#define BROKER_IS_BACKEND(o)                    \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), BROKER_TYPE_BACKEND))
+#define BROKER_BACKEND_CLASS(k)                 \
+        (G_TYPE_CHECK_CLASS_CAST ((k), BROKER_TYPE_BACKEND, BrokerBackendClass))
+#define BROKER_IS_BACKEND_CLASS(k)              \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), BROKER_TYPE_BACKEND))
+#define BROKER_BACKEND_GET_CLASS(o)             \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), BROKER_TYPE_BACKEND, BrokerBackendClass))
+
+typedef struct _BrokerBackendClass    BrokerBackendClass;
+typedef struct _BrokerBackendPrivate  BrokerBackendPrivate;
+
+struct _BrokerBackend
+{
+    MateMixerBackend parent;
+
+    /*< private >*/
+    BrokerBackendPrivate *priv;
+};
+
+struct _BrokerBackendClass
+{
+    MateMixerBackendClass parent_class;
+};
+
+GType                       broker_backend_get_type (void) G_GNUC_CONST;
+
+/* Support function for dynamic loading of the backend module */
+void                        backend_module_init     (GTypeModule *module);
+const MateMixerBackendInfo *backend_module_get_info (void);
+
+#endif /* BROKER_BACKEND_H */
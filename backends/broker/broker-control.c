@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-control.h"
+#include "broker-helpers.h"
+#include "broker-protocol.h"
+#include "broker-stored-control.h"
+#include "broker-stream-control.h"
+
+/* Features which are not forwarded by the broker */
+#define BROKER_CONTROL_UNSUPPORTED_FLAGS                \
+        (MATE_MIXER_STREAM_CONTROL_MOVABLE |            \
+         MATE_MIXER_STREAM_CONTROL_HAS_DECIBEL |        \
+         MATE_MIXER_STREAM_CONTROL_HAS_MONITOR)
+
+struct _BrokerControl
+{
+    gchar                    *owner;
+    guint                     volume;
+    guint                     min_volume;
+    guint                     max_volume;
+    guint                     normal_volume;
+    guint                     base_volume;
+    guint                     num_channels;
+    guint                    *channel_volume;
+    MateMixerChannelPosition *channel_position;
+    MateMixerAppInfo         *app_info;
+    GDBusConnection          *connection;
+};
+
+#define BROKER_CONTROL_GET(o)                                           \
+        ((BrokerControl *) g_object_get_qdata (G_OBJECT (o), broker_control_quark ()))
+
+static GQuark                   broker_control_quark                (void) G_GNUC_CONST;
+
+static MateMixerAppInfo *       broker_control_get_app_info         (MateMixerStreamControl  *mmsc);
+
+static gboolean                 broker_control_set_mute             (MateMixerStreamControl  *mmsc,
+                                                                     gboolean                 mute);
+
+static guint                    broker_control_get_num_channels     (MateMixerStreamControl  *mmsc);
+
+static guint                    broker_control_get_volume           (MateMixerStreamControl  *mmsc);
+static gboolean                 broker_control_set_volume           (MateMixerStreamControl  *mmsc,
+                                                                     guint                    volume);
+
+static gboolean                 broker_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                                                     MateMixerChannelPosition position);
+static MateMixerChannelPosition broker_control_get_channel_position (MateMixerStreamControl  *mmsc,
+                                                                     guint                    channel);
+
+static guint                    broker_control_get_channel_volume   (MateMixerStreamControl  *mmsc,
+                                                                     guint                    channel);
+static gboolean                 broker_control_set_channel_volume   (MateMixerStreamControl  *mmsc,
+                                                                     guint                    channel,
+                                                                     guint                    volume);
+
+static gboolean                 broker_control_set_balance          (MateMixerStreamControl  *mmsc,
+                                                                     gfloat                   balance);
+
+static gboolean                 broker_control_set_fade             (MateMixerStreamControl  *mmsc,
+                                                                     gfloat                   fade);
+
+static guint                    broker_control_get_min_volume       (MateMixerStreamControl  *mmsc);
+static guint                    broker_control_get_max_volume       (MateMixerStreamControl  *mmsc);
+static guint                    broker_control_get_normal_volume    (MateMixerStreamControl  *mmsc);
+static guint                    broker_control_get_base_volume      (MateMixerStreamControl  *mmsc);
+
+static void                     broker_control_free                 (BrokerControl           *control);
+
+void
+broker_control_init_class (MateMixerStreamControlClass *klass)
+{
+    g_return_if_fail (klass != NULL);
+
+    klass->get_app_info         = broker_control_get_app_info;
+    klass->set_mute             = broker_control_set_mute;
+    klass->get_num_channels     = broker_control_get_num_channels;
+    klass->get_volume           = broker_control_get_volume;
+    klass->set_volume           = broker_control_set_volume;
+    klass->has_channel_position = broker_control_has_channel_position;
+    klass->get_channel_position = broker_control_get_channel_position;
+    klass->get_channel_volume   = broker_control_get_channel_volume;
+    klass->set_channel_volume   = broker_control_set_channel_volume;
+    klass->set_balance          = broker_control_set_balance;
+    klass->set_fade             = broker_control_set_fade;
+    klass->get_min_volume       = broker_control_get_min_volume;
+    klass->get_max_volume       = broker_control_get_max_volume;
+    klass->get_normal_volume    = broker_control_get_normal_volume;
+    klass->get_base_volume      = broker_control_get_base_volume;
+}
+
+MateMixerStreamControl *
+broker_control_new (GDBusConnection *connection,
+                    GVariant        *info,
+                    MateMixerStream *stream)
+{
+    MateMixerStreamControl *mmsc;
+    BrokerControl          *control;
+    GVariantIter           *positions;
+    GVariant               *value;
+    const gchar            *owner;
+    const gchar            *name;
+    const gchar            *label;
+    const gchar            *stream_name;
+    const gchar            *app_name;
+    const gchar            *app_id;
+    const gchar            *app_version;
+    const gchar            *app_icon;
+    guint                   flags;
+    guint                   role;
+    guint                   media_role;
+    guint                   direction;
+    guint                   position;
+    guint                   i = 0;
+
+    g_return_val_if_fail (G_IS_DBUS_CONNECTION (connection), NULL);
+    g_return_val_if_fail (info != NULL, NULL);
+
+    control = g_slice_new0 (BrokerControl);
+
+    g_variant_get (info,
+                   "(&s&s&s&suuuuuuuuau(&s&s&s&s)@" BROKER_VALUE_TYPE ")",
+                   &owner,
+                   &name,
+                   &label,
+                   &stream_name,
+                   &flags,
+                   &role,
+                   &media_role,
+                   &direction,
+                   &control->min_volume,
+                   &control->max_volume,
+                   &control->normal_volume,
+                   &control->base_volume,
+                   &positions,
+                   &app_name,
+                   &app_id,
+                   &app_version,
+                   &app_icon,
+                   &value);
+
+    control->owner      = g_strdup (owner);
+    control->connection = g_object_ref (connection);
+
+    control->num_channels     = g_variant_iter_n_children (positions);
+    control->channel_volume   = g_new0 (guint, control->num_channels);
+    control->channel_position = g_new0 (MateMixerChannelPosition, control->num_channels);
+
+    while (g_variant_iter_next (positions, "u", &position))
+        control->channel_position[i++] = position;
+
+    g_variant_iter_free (positions);
+
+    if (*app_name != '\0' || *app_id != '\0')
+        control->app_info = _mate_mixer_app_info_intern (broker_string_or_null (app_name),
+                                                         broker_string_or_null (app_id),
+                                                         broker_string_or_null (app_version),
+                                                         broker_string_or_null (app_icon));
+
+    flags &= ~BROKER_CONTROL_UNSUPPORTED_FLAGS;
+
+    /* Stored controls do not belong to a stream, the owner is empty */
+    if (*owner == '\0')
+        mmsc = g_object_new (BROKER_TYPE_STORED_CONTROL,
+                             "name", name,
+                             "label", label,
+                             "flags", flags,
+                             "role", role,
+                             "media-role", media_role,
+                             "direction", direction,
+                             "stream", stream,
+                             NULL);
+    else
+        mmsc = g_object_new (BROKER_TYPE_STREAM_CONTROL,
+                             "name", name,
+                             "label", label,
+                             "flags", flags,
+                             "role", role,
+                             "media-role", media_role,
+                             "stream", stream,
+                             NULL);
+
+    g_object_set_qdata_full (G_OBJECT (mmsc),
+                             broker_control_quark (),
+                             control,
+                             (GDestroyNotify) broker_control_free);
+
+    broker_control_update (mmsc, value);
+
+    g_variant_unref (value);
+    return mmsc;
+}
+
+const gchar *
+broker_control_get_owner (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), NULL);
+
+    return BROKER_CONTROL_GET (mmsc)->owner;
+}
+
+void
+broker_control_update (MateMixerStreamControl *mmsc, GVariant *value)
+{
+    BrokerControl *control;
+    GVariantIter  *iter;
+    gboolean       mute;
+    gboolean       changed;
+    guint          volume;
+    guint          i = 0;
+    gdouble        balance;
+    gdouble        fade;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc));
+    g_return_if_fail (value != NULL);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    g_variant_get (value, BROKER_VALUE_TYPE, &mute, &volume, &iter, &balance, &fade);
+
+    changed = control->volume != volume;
+    control->volume = volume;
+
+    while (g_variant_iter_next (iter, "u", &volume)) {
+        if (i >= control->num_channels)
+            break;
+
+        if (control->channel_volume[i] != volume) {
+            control->channel_volume[i] = volume;
+            changed = TRUE;
+        }
+        i++;
+    }
+    g_variant_iter_free (iter);
+
+    g_object_freeze_notify (G_OBJECT (mmsc));
+
+    _mate_mixer_stream_control_set_mute (mmsc, mute);
+
+    if (changed == TRUE) {
+        _mate_mixer_stream_control_publish_state (mmsc);
+
+        g_object_notify (G_OBJECT (mmsc), "volume");
+    }
+
+    _mate_mixer_stream_control_set_balance (mmsc, (gfloat) balance);
+    _mate_mixer_stream_control_set_fade (mmsc, (gfloat) fade);
+
+    g_object_thaw_notify (G_OBJECT (mmsc));
+}
+
+static GQuark
+broker_control_quark (void)
+{
+    static GQuark quark = 0;
+
+    if (G_UNLIKELY (quark == 0))
+        quark = g_quark_from_static_string ("matemixer-broker-control");
+
+    return quark;
+}
+
+static MateMixerAppInfo *
+broker_control_get_app_info (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), NULL);
+
+    return BROKER_CONTROL_GET (mmsc)->app_info;
+}
+
+static gboolean
+broker_control_set_mute (MateMixerStreamControl *mmsc, gboolean mute)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    broker_call_method (control->connection,
+                        "SetMute",
+                        g_variant_new ("(ssb)",
+                                       control->owner,
+                                       mate_mixer_stream_control_get_name (mmsc),
+                                       mute));
+    return TRUE;
+}
+
+static guint
+broker_control_get_num_channels (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    return BROKER_CONTROL_GET (mmsc)->num_channels;
+}
+
+static guint
+broker_control_get_volume (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    return BROKER_CONTROL_GET (mmsc)->volume;
+}
+
+static gboolean
+broker_control_set_volume (MateMixerStreamControl *mmsc, guint volume)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    broker_call_method (control->connection,
+                        "SetVolume",
+                        g_variant_new ("(ssu)",
+                                       control->owner,
+                                       mate_mixer_stream_control_get_name (mmsc),
+                                       volume));
+    return TRUE;
+}
+
+static gboolean
+broker_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                     MateMixerChannelPosition position)
+{
+    BrokerControl *control;
+    guint          i;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    for (i = 0; i < control->num_channels; i++)
+        if (control->channel_position[i] == position)
+            return TRUE;
+
+    return FALSE;
+}
+
+static MateMixerChannelPosition
+broker_control_get_channel_position (MateMixerStreamControl *mmsc, guint channel)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), MATE_MIXER_CHANNEL_UNKNOWN);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    if (channel >= control->num_channels)
+        return MATE_MIXER_CHANNEL_UNKNOWN;
+
+    return control->channel_position[channel];
+}
+
+static guint
+broker_control_get_channel_volume (MateMixerStreamControl *mmsc, guint channel)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    if (channel >= control->num_channels)
+        return 0;
+
+    return control->channel_volume[channel];
+}
+
+static gboolean
+broker_control_set_channel_volume (MateMixerStreamControl *mmsc,
+                                   guint                   channel,
+                                   guint                   volume)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    if (channel >= control->num_channels)
+        return FALSE;
+
+    broker_call_method (control->connection,
+                        "SetChannelVolume",
+                        g_variant_new ("(ssuu)",
+                                       control->owner,
+                                       mate_mixer_stream_control_get_name (mmsc),
+                                       channel,
+                                       volume));
+    return TRUE;
+}
+
+static gboolean
+broker_control_set_balance (MateMixerStreamControl *mmsc, gfloat balance)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    broker_call_method (control->connection,
+                        "SetBalance",
+                        g_variant_new ("(ssd)",
+                                       control->owner,
+                                       mate_mixer_stream_control_get_name (mmsc),
+                                       (gdouble) balance));
+    return TRUE;
+}
+
+static gboolean
+broker_control_set_fade (MateMixerStreamControl *mmsc, gfloat fade)
+{
+    BrokerControl *control;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = BROKER_CONTROL_GET (mmsc);
+
+    broker_call_method (control->connection,
+                        "SetFade",
+                        g_variant_new ("(ssd)",
+                                       control->owner,
+                                       mate_mixer_stream_control_get_name (mmsc),
+                                       (gdouble) fade));
+    return TRUE;
+}
+
+static guint
+broker_control_get_min_volume (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    return BROKER_CONTROL_GET (mmsc)->min_volume;
+}
+
+static guint
+broker_control_get_max_volume (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    return BROKER_CONTROL_GET (mmsc)->max_volume;
+}
+
+static guint
+broker_control_get_normal_volume (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    return BROKER_CONTROL_GET (mmsc)->normal_volume;
+}
+
+static guint
+broker_control_get_base_volume (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (mmsc), 0);
+
+    return BROKER_CONTROL_GET (mmsc)->base_volume;
+}
+
+static void
+broker_control_free (BrokerControl *control)
+{
+    if (control->app_info != NULL)
+        _mate_mixer_app_info_unref (control->app_info);
+
+    g_object_unref (control->connection);
+
+    g_free (control->owner);
+    g_free (control->channel_volume);
+    g_free (control->channel_position);
+
+    g_slice_free (BrokerControl, control);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_CONTROL_H
+#define BROKER_CONTROL_H
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Implementation shared by the stream controls and the stored controls of the
+ * broker, both classes install the same virtual functions and keep the state
+ * of the control in a BrokerControl attached to the instance.
+ */
+void                    broker_control_init_class (MateMixerStreamControlClass *klass);
+
+MateMixerStreamControl *broker_control_new        (GDBusConnection             *connection,
+                                                   GVariant                    *info,
+                                                   MateMixerStream             *stream);
+
+const gchar *           broker_control_get_owner  (MateMixerStreamControl      *control);
+
+void                    broker_control_update     (MateMixerStreamControl      *control,
+                                                   GVariant                    *value);
+
+G_END_DECLS
+
+#endif /* BROKER_CONTROL_H */
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-helpers.h"
+#include "broker-protocol.h"
+#include "broker-device.h"
+#include "broker-device-switch.h"
+
+struct _BrokerDeviceSwitchPrivate
+{
+    GList           *options;
+    GDBusConnection *connection;
+};
+
+static void broker_device_switch_class_init (BrokerDeviceSwitchClass *klass);
+static void broker_device_switch_init       (BrokerDeviceSwitch      *swtch);
+static void broker_device_switch_dispose    (GObject                 *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (BrokerDeviceSwitch, broker_device_switch, MATE_MIXER_TYPE_DEVICE_SWITCH)
+
+static gboolean     broker_device_switch_set_active_option_real (MateMixerSwitch       *mms,
+                                                                 MateMixerSwitchOption *mmso);
+
+static const GList *broker_device_switch_list_options           (MateMixerSwitch       *mms);
+
+static void
+broker_device_switch_class_init (BrokerDeviceSwitchClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerSwitchClass *switch_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = broker_device_switch_dispose;
+
+    switch_class = MATE_MIXER_SWITCH_CLASS (klass);
+    switch_class->set_active_option = broker_device_switch_set_active_option_real;
+    switch_class->list_options      = broker_device_switch_list_options;
+}
+
+static void
+broker_device_switch_init (BrokerDeviceSwitch *swtch)
+{
+    swtch->priv = broker_device_switch_get_instance_private (swtch);
+}
+
+static void
+broker_device_switch_dispose (GObject *object)
+{
+    BrokerDeviceSwitch *swtch;
+
+    swtch = BROKER_DEVICE_SWITCH (object);
+
+    if (swtch->priv->options != NULL) {
+        g_list_free_full (swtch->priv->options, g_object_unref);
+        swtch->priv->options = NULL;
+    }
+
+    g_clear_object (&swtch->priv->connection);
+
+    G_OBJECT_CLASS (broker_device_switch_parent_class)->dispose (object);
+}
+
+BrokerDeviceSwitch *
+broker_device_switch_new (GDBusConnection *connection,
+                          BrokerDevice    *device,
+                          GVariant        *info)
+{
+    BrokerDeviceSwitch *swtch;
+    GVariantIter       *options;
+    const gchar        *owner;
+    const gchar        *name;
+    const gchar        *label;
+    const gchar        *active;
+    guint               role;
+
+    g_return_val_if_fail (G_IS_DBUS_CONNECTION (connection), NULL);
+    g_return_val_if_fail (BROKER_IS_DEVICE (device), NULL);
+    g_return_val_if_fail (info != NULL, NULL);
+
+    g_variant_get (info,
+                   "(&s&s&suua" BROKER_OPTION_TYPE "&s)",
+                   &owner,
+                   &name,
+                   &label,
+                   &role,
+                   NULL,
+                   &options,
+                   &active);
+
+    swtch = g_object_new (BROKER_TYPE_DEVICE_SWITCH,
+                          "name", name,
+                          "label", label,
+                          "role", role,
+                          "device", device,
+                          NULL);
+
+    swtch->priv->options    = broker_create_options (options);
+    swtch->priv->connection = g_object_ref (connection);
+
+    g_variant_iter_free (options);
+
+    broker_device_switch_set_active_option (swtch, active);
+    return swtch;
+}
+
+void
+broker_device_switch_set_active_option (BrokerDeviceSwitch *swtch, const gchar *name)
+{
+    MateMixerSwitchOption *option = NULL;
+
+    g_return_if_fail (BROKER_IS_DEVICE_SWITCH (swtch));
+    g_return_if_fail (name != NULL);
+
+    if (*name != '\0')
+        option = mate_mixer_switch_get_option (MATE_MIXER_SWITCH (swtch), name);
+
+    _mate_mixer_switch_set_active_option (MATE_MIXER_SWITCH (swtch), option);
+}
+
+static gboolean
+broker_device_switch_set_active_option_real (MateMixerSwitch       *mms,
+                                             MateMixerSwitchOption *mmso)
+{
+    MateMixerDevice *device;
+
+    g_return_val_if_fail (BROKER_IS_DEVICE_SWITCH (mms), FALSE);
+
+    device = mate_mixer_device_switch_get_device (MATE_MIXER_DEVICE_SWITCH (mms));
+    if (G_UNLIKELY (device == NULL))
+        return FALSE;
+
+    broker_call_method (BROKER_DEVICE_SWITCH (mms)->priv->connection,
+                        "SetActiveOption",
+                        g_variant_new ("(ysss)",
+                                       BROKER_KIND_DEVICE_SWITCH,
+                                       mate_mixer_device_get_name (device),
+                                       mate_mixer_switch_get_name (mms),
+                                       mate_mixer_switch_option_get_name (mmso)));
+    return TRUE;
+}
+
+static const GList *
+broker_device_switch_list_options (MateMixerSwitch *mms)
+{
+    g_return_val_if_fail (BROKER_IS_DEVICE_SWITCH (mms), NULL);
+
+    return BROKER_DEVICE_SWITCH (mms)->priv->options;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-device.h"
+#include "broker-device-switch.h"
+#include "broker-stream.h"
+
+struct _BrokerDevicePrivate
+{
+    GList *streams;
+    GList *switches;
+};
+
+static void broker_device_class_init (BrokerDeviceClass *klass);
+static void broker_device_init       (BrokerDevice      *device);
+static void broker_device_dispose    (GObject           *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (BrokerDevice, broker_device, MATE_MIXER_TYPE_DEVICE)
+
+static const GList *broker_device_list_streams  (MateMixerDevice *mmd);
+static const GList *broker_device_list_switches (MateMixerDevice *mmd);
+
+static void
+broker_device_class_init (BrokerDeviceClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerDeviceClass *device_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = broker_device_dispose;
+
+    device_class = MATE_MIXER_DEVICE_CLASS (klass);
+    device_class->list_streams  = broker_device_list_streams;
+    device_class->list_switches = broker_device_list_switches;
+}
+
+static void
+broker_device_init (BrokerDevice *device)
+{
+    device->priv = broker_device_get_instance_private (device);
+}
+
+static void
+broker_device_dispose (GObject *object)
+{
+    BrokerDevice *device;
+
+    device = BROKER_DEVICE (object);
+
+    if (device->priv->streams != NULL) {
+        g_list_free_full (device->priv->streams, g_object_unref);
+        device->priv->streams = NULL;
+    }
+    if (device->priv->switches != NULL) {
+        g_list_free_full (device->priv->switches, g_object_unref);
+        device->priv->switches = NULL;
+    }
+
+    G_OBJECT_CLASS (broker_device_parent_class)->dispose (object);
+}
+
+BrokerDevice *
+broker_device_new (GVariant *info)
+{
+    const gchar *name;
+    const gchar *label;
+    const gchar *icon;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    g_variant_get (info, "(&s&s&s)", &name, &label, &icon);
+
+    return g_object_new (BROKER_TYPE_DEVICE,
+                         "name", name,
+                         "label", label,
+                         "icon", (*icon != '\0') ? icon : NULL,
+                         NULL);
+}
+
+void
+broker_device_add_stream (BrokerDevice *device, BrokerStream *stream)
+{
+    g_return_if_fail (BROKER_IS_DEVICE (device));
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+
+    device->priv->streams = g_list_append (device->priv->streams,
+                                           g_object_ref (stream));
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-added",
+                           mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+}
+
+void
+broker_device_remove_stream (BrokerDevice *device, BrokerStream *stream)
+{
+    GList *item;
+
+    g_return_if_fail (BROKER_IS_DEVICE (device));
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+
+    item = g_list_find (device->priv->streams, stream);
+    if (G_UNLIKELY (item == NULL))
+        return;
+
+    device->priv->streams = g_list_delete_link (device->priv->streams, item);
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-removed",
+                           mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+
+    g_object_unref (stream);
+}
+
+void
+broker_device_add_switch (BrokerDevice *device, BrokerDeviceSwitch *swtch)
+{
+    g_return_if_fail (BROKER_IS_DEVICE (device));
+    g_return_if_fail (BROKER_IS_DEVICE_SWITCH (swtch));
+
+    device->priv->switches = g_list_append (device->priv->switches,
+                                            g_object_ref (swtch));
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "switch-added",
+                           mate_mixer_switch_get_name (MATE_MIXER_SWITCH (swtch)));
+}
+
+void
+broker_device_remove_switch (BrokerDevice *device, const gchar *name)
+{
+    MateMixerDeviceSwitch *swtch;
+
+    g_return_if_fail (BROKER_IS_DEVICE (device));
+    g_return_if_fail (name != NULL);
+
+    swtch = mate_mixer_device_get_switch (MATE_MIXER_DEVICE (device), name);
+    if (G_UNLIKELY (swtch == NULL))
+        return;
+
+    device->priv->switches = g_list_remove (device->priv->switches, swtch);
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "switch-removed",
+                           name);
+
+    g_object_unref (swtch);
+}
+
+static const GList *
+broker_device_list_streams (MateMixerDevice *mmd)
+{
+    g_return_val_if_fail (BROKER_IS_DEVICE (mmd), NULL);
+
+    return BROKER_DEVICE (mmd)->priv->streams;
+}
+
+static const GList *
+broker_device_list_switches (MateMixerDevice *mmd)
+{
+    g_return_val_if_fail (BROKER_IS_DEVICE (mmd), NULL);
+
+    return BROKER_DEVICE (mmd)->priv->switches;
+}
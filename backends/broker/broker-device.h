@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_DEVICE_H
+#define BROKER_DEVICE_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-types.h"
+
+G_BEGIN_DECLS
+
+#define BROKER_TYPE_DEVICE                      \
+        (broker_device_get_type ())
+#define BROKER_DEVICE(o)                        \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), BROKER_TYPE_DEVICE, BrokerDevice))
+#define BROKER_IS_DEVICE(o)                     \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), BROKER_TYPE_DEVICE))
+#define BROKER_DEVICE_CLASS(k)                  \
+        (G_TYPE_CHECK_CLASS_CAST ((k), BROKER_TYPE_DEVICE, BrokerDeviceClass))
+#define BROKER_IS_DEVICE_CLASS(k)               \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), BROKER_TYPE_DEVICE))
+#define BROKER_DEVICE_GET_CLASS(o)              \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), BROKER_TYPE_DEVICE, BrokerDeviceClass))
+
+typedef struct _BrokerDeviceClass    BrokerDeviceClass;
+typedef struct _BrokerDevicePrivate  BrokerDevicePrivate;
+
+struct _BrokerDevice
+{
+    MateMixerDevice parent;
+
+    /*< private >*/
+    BrokerDevicePrivate *priv;
+};
+
+struct _BrokerDeviceClass
+{
+    MateMixerDeviceClass parent_class;
+};
+
+GType         broker_device_get_type      (void) G_GNUC_CONST;
+
+BrokerDevice *broker_device_new           (GVariant           *info);
+
+void          broker_device_add_stream    (BrokerDevice       *device,
+                                           BrokerStream       *stream);
+void          broker_device_remove_stream (BrokerDevice       *device,
+                                           BrokerStream       *stream);
+
+void          broker_device_add_switch    (BrokerDevice       *device,
+                                           BrokerDeviceSwitch *swtch);
+void          broker_device_remove_switch (BrokerDevice       *device,
+                                           const gchar        *name);
+
+G_END_DECLS
+
+#endif /* BROKER_DEVICE_H */
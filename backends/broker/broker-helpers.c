@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-helpers.h"
+#include "broker-protocol.h"
+
+static void call_method_cb (GObject      *object,
+                            GAsyncResult *result,
+                            gpointer      user_data);
+
+void
+broker_call_method (GDBusConnection *connection,
+                    const gchar     *method,
+                    GVariant        *parameters)
+{
+    g_return_if_fail (G_IS_DBUS_CONNECTION (connection));
+    g_return_if_fail (method != NULL);
+
+    /* The result of a change is delivered by a signal of the broker, so the
+     * caller does not wait for the reply */
+    g_dbus_connection_call (connection,
+                            BROKER_DBUS_NAME,
+                            BROKER_DBUS_PATH,
+                            BROKER_DBUS_INTERFACE,
+                            method,
+                            parameters,
+                            NULL,
+                            G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                            -1,
+                            NULL,
+                            call_method_cb,
+                            (gpointer) method);
+}
+
+GList *
+broker_create_options (GVariantIter *iter)
+{
+    GList       *options = NULL;
+    const gchar *name;
+    const gchar *label;
+    const gchar *icon;
+
+    g_return_val_if_fail (iter != NULL, NULL);
+
+    while (g_variant_iter_loop (iter, "(&s&s&s)", &name, &label, &icon)) {
+        MateMixerSwitchOption *option;
+
+        option = _mate_mixer_switch_option_new (name,
+                                                label,
+                                                broker_string_or_null (icon));
+
+        options = g_list_prepend (options, option);
+    }
+    return g_list_reverse (options);
+}
+
+const gchar *
+broker_string_or_null (const gchar *string)
+{
+    if (string == NULL || *string == '\0')
+        return NULL;
+
+    return string;
+}
+
+const gchar *
+broker_string_or_empty (const gchar *string)
+{
+    if (string == NULL)
+        return "";
+
+    return string;
+}
+
+static void
+call_method_cb (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    GVariant *ret;
+    GError   *error = NULL;
+
+    ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (object), result, &error);
+    if (ret == NULL) {
+        g_warning ("Broker method %s has failed: %s",
+                   (const gchar *) user_data,
+                   error->message);
+
+        g_error_free (error);
+        return;
+    }
+    g_variant_unref (ret);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_HELPERS_H
+#define BROKER_HELPERS_H
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+
+G_BEGIN_DECLS
+
+void         broker_call_method        (GDBusConnection *connection,
+                                        const gchar     *method,
+                                        GVariant        *parameters);
+
+GList *      broker_create_options     (GVariantIter    *iter);
+
+const gchar *broker_string_or_null     (const gchar     *string);
+const gchar *broker_string_or_empty    (const gchar     *string);
+
+G_END_DECLS
+
+#endif /* BROKER_HELPERS_H */
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_PROTOCOL_H
+#define BROKER_PROTOCOL_H
+
+/*
+ * The mixer broker is a session daemon which keeps a single connection to the
+ * sound system and publishes its object model on the session bus. The Broker
+ * backend module reads the whole model with a single GetState call and then
+ * follows the changes using the signals below.
+ *
+ * Objects are identified by their names. Stream controls and stream switches
+ * are identified by the name of their stream and their own name, device
+ * switches by the name of their device and their own name and stored controls
+ * by their own name with an empty owner.
+ *
+ * Signals are emitted in the order the changes happen, a signal received
+ * before the reply to GetState describes a change already included in the
+ * reply.
+ *
+ * When the broker loses its connection to the sound system, it removes all
+ * its objects and changes its state to MATE_MIXER_STATE_CONNECTING. Once the
+ * connection is restored, the objects are added again and the state changes
+ * back to MATE_MIXER_STATE_READY.
+ */
+#define BROKER_DBUS_NAME            "org.mate.MixerBroker"
+#define BROKER_DBUS_PATH            "/org/mate/MixerBroker"
+#define BROKER_DBUS_INTERFACE       "org.mate.MixerBroker"
+
+/* The broker itself sets this variable to avoid connecting to itself, it may
+ * also be set by the user to bypass the broker */
+#define BROKER_DISABLE_VARIABLE     "LIBMATEMIXER_NO_BROKER"
+
+/* Kind of an object in the ObjectAdded and ObjectRemoved signals */
+#define BROKER_KIND_DEVICE          'd'
+#define BROKER_KIND_STREAM          's'
+#define BROKER_KIND_CONTROL         'c'
+#define BROKER_KIND_DEVICE_SWITCH   'D'
+#define BROKER_KIND_STREAM_SWITCH   'S'
+
+/* (name, label, icon) */
+#define BROKER_DEVICE_TYPE          "(sss)"
+
+/* (name, label, device, direction, default control) */
+#define BROKER_STREAM_TYPE          "(sssus)"
+
+/* (name, label, icon) */
+#define BROKER_OPTION_TYPE          "(sss)"
+
+/* (owner, name, label, role, flags, options, active option) */
+#define BROKER_SWITCH_TYPE          "(sssuua" BROKER_OPTION_TYPE "s)"
+
+/* (mute, volume, channel volumes, balance, fade) */
+#define BROKER_VALUE_TYPE           "(buaudd)"
+
+/* (name, id, version, icon) */
+#define BROKER_APP_TYPE             "(ssss)"
+
+/* (owner, name, label, stream, flags, role, media role, direction,
+ *  min volume, max volume, normal volume, base volume, channel positions,
+ *  application, value) */
+#define BROKER_CONTROL_TYPE         "(ssssuuuuuuuuau" BROKER_APP_TYPE BROKER_VALUE_TYPE ")"
+
+/* (backend name, devices, streams, controls, device switches, stream switches,
+ *  default input stream, default output stream, state) */
+#define BROKER_STATE_TYPE                       \
+        "(s"                                    \
+        "a" BROKER_DEVICE_TYPE                  \
+        "a" BROKER_STREAM_TYPE                  \
+        "a" BROKER_CONTROL_TYPE                 \
+        "a" BROKER_SWITCH_TYPE                  \
+        "a" BROKER_SWITCH_TYPE                  \
+        "ssu)"
+
+#define BROKER_INTROSPECTION_XML                                                \
+    "<node>"                                                                    \
+    "  <interface name='" BROKER_DBUS_INTERFACE "'>"                            \
+    "    <method name='GetState'>"                                              \
+    "      <arg direction='out' type='" BROKER_STATE_TYPE "' name='state'/>"    \
+    "    </method>"                                                             \
+    "    <method name='SetMute'>"                                               \
+    "      <arg direction='in' type='s' name='owner'/>"                         \
+    "      <arg direction='in' type='s' name='name'/>"                          \
+    "      <arg direction='in' type='b' name='mute'/>"                          \
+    "    </method>"                                                             \
+    "    <method name='SetVolume'>"                                             \
+    "      <arg direction='in' type='s' name='owner'/>"                         \
+    "      <arg direction='in' type='s' name='name'/>"                          \
+    "      <arg direction='in' type='u' name='volume'/>"                        \
+    "    </method>"                                                             \
+    "    <method name='SetChannelVolume'>"                                      \
+    "      <arg direction='in' type='s' name='owner'/>"                         \
+    "      <arg direction='in' type='s' name='name'/>"                          \
+    "      <arg direction='in' type='u' name='channel'/>"                       \
+    "      <arg direction='in' type='u' name='volume'/>"                        \
+    "    </method>"                                                             \
+    "    <method name='SetBalance'>"                                            \
+    "      <arg direction='in' type='s' name='owner'/>"                         \
+    "      <arg direction='in' type='s' name='name'/>"                          \
+    "      <arg direction='in' type='d' name='balance'/>"                       \
+    "    </method>"                                                             \
+    "    <method name='SetFade'>"                                               \
+    "      <arg direction='in' type='s' name='owner'/>"                         \
+    "      <arg direction='in' type='s' name='name'/>"                          \
+    "      <arg direction='in' type='d' name='fade'/>"                          \
+    "    </method>"                                                             \
+    "    <method name='SetActiveOption'>"                                       \
+    "      <arg direction='in' type='y' name='kind'/>"                          \
+    "      <arg direction='in' type='s' name='owner'/>"                         \
+    "      <arg direction='in' type='s' name='name'/>"                          \
+    "      <arg direction='in' type='s' name='option'/>"                        \
+    "    </method>"                                                             \
+    "    <method name='SetDefaultStream'>"                                      \
+    "      <arg direction='in' type='u' name='direction'/>"                     \
+    "      <arg direction='in' type='s' name='stream'/>"                        \
+    "    </method>"                                                             \
+    "    <signal name='ObjectAdded'>"                                           \
+    "      <arg type='y' name='kind'/>"                                         \
+    "      <arg type='v' name='object'/>"                                       \
+    "    </signal>"                                                             \
+    "    <signal name='ObjectRemoved'>"                                         \
+    "      <arg type='y' name='kind'/>"                                         \
+    "      <arg type='s' name='owner'/>"                                        \
+    "      <arg type='s' name='name'/>"                                         \
+    "    </signal>"                                                             \
+    "    <signal name='ControlChanged'>"                                        \
+    "      <arg type='s' name='owner'/>"                                        \
+    "      <arg type='s' name='name'/>"                                         \
+    "      <arg type='" BROKER_VALUE_TYPE "' name='value'/>"                    \
+    "    </signal>"                                                             \
+    "    <signal name='SwitchChanged'>"                                         \
+    "      <arg type='y' name='kind'/>"                                         \
+    "      <arg type='s' name='owner'/>"                                        \
+    "      <arg type='s' name='name'/>"                                         \
+    "      <arg type='s' name='option'/>"                                       \
+    "    </signal>"                                                             \
+    "    <signal name='StreamChanged'>"                                         \
+    "      <arg type='s' name='name'/>"                                         \
+    "      <arg type='s' name='default_control'/>"                              \
+    "    </signal>"                                                             \
+    "    <signal name='DefaultStreamsChanged'>"                                 \
+    "      <arg type='s' name='input'/>"                                        \
+    "      <arg type='s' name='output'/>"                                       \
+    "    </signal>"                                                             \
+    "    <signal name='StateChanged'>"                                          \
+    "      <arg type='u' name='state'/>"                                        \
+    "    </signal>"                                                             \
+    "  </interface>"                                                            \
+    "</node>"
+
+#endif /* BROKER_PROTOCOL_H */
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-control.h"
+#include "broker-stream-control.h"
+
+static void broker_stream_control_class_init (BrokerStreamControlClass *klass);
+static void broker_stream_control_init       (BrokerStreamControl      *control);
+
+G_DEFINE_TYPE (BrokerStreamControl, broker_stream_control, MATE_MIXER_TYPE_STREAM_CONTROL)
+
+static void
+broker_stream_control_class_init (BrokerStreamControlClass *klass)
+{
+    broker_control_init_class (MATE_MIXER_STREAM_CONTROL_CLASS (klass));
+}
+
+static void
+broker_stream_control_init (BrokerStreamControl *control)
+{
+}
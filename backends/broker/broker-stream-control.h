@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_STREAM_CONTROL_H
+#define BROKER_STREAM_CONTROL_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-types.h"
+
+G_BEGIN_DECLS
+
+#define BROKER_TYPE_STREAM_CONTROL              \
+        (broker_stream_control_get_type ())
+#define BROKER_STREAM_CONTROL(o)                \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), BROKER_TYPE_STREAM_CONTROL, BrokerStreamControl))
+#define BROKER_IS_STREAM_CONTROL(o)             \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), BROKER_TYPE_STREAM_CONTROL))
+#define BROKER_STREAM_CONTROL_CLASS(k)          \
+        (G_TYPE_CHECK_CLASS_CAST ((k), BROKER_TYPE_STREAM_CONTROL, BrokerStreamControlClass))
+#define BROKER_IS_STREAM_CONTROL_CLASS(k)       \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), BROKER_TYPE_STREAM_CONTROL))
+#define BROKER_STREAM_CONTROL_GET_CLASS(o)      \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), BROKER_TYPE_STREAM_CONTROL, BrokerStreamControlClass))
+
+typedef struct _BrokerStreamControlClass  BrokerStreamControlClass;
+
+struct _BrokerStreamControl
+{
+    MateMixerStreamControl parent;
+};
+
+struct _BrokerStreamControlClass
+{
+    MateMixerStreamControlClass parent_class;
+};
+
+GType broker_stream_control_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* BROKER_STREAM_CONTROL_H */
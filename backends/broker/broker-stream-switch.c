@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-helpers.h"
+#include "broker-protocol.h"
+#include "broker-stream.h"
+#include "broker-stream-switch.h"
+
+struct _BrokerStreamSwitchPrivate
+{
+    GList           *options;
+    GDBusConnection *connection;
+};
+
+static void broker_stream_switch_class_init (BrokerStreamSwitchClass *klass);
+static void broker_stream_switch_init       (BrokerStreamSwitch      *swtch);
+static void broker_stream_switch_dispose    (GObject                 *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (BrokerStreamSwitch, broker_stream_switch, MATE_MIXER_TYPE_STREAM_SWITCH)
+
+static gboolean     broker_stream_switch_set_active_option_real (MateMixerSwitch       *mms,
+                                                                 MateMixerSwitchOption *mmso);
+
+static const GList *broker_stream_switch_list_options           (MateMixerSwitch       *mms);
+
+static void
+broker_stream_switch_class_init (BrokerStreamSwitchClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerSwitchClass *switch_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = broker_stream_switch_dispose;
+
+    switch_class = MATE_MIXER_SWITCH_CLASS (klass);
+    switch_class->set_active_option = broker_stream_switch_set_active_option_real;
+    switch_class->list_options      = broker_stream_switch_list_options;
+}
+
+static void
+broker_stream_switch_init (BrokerStreamSwitch *swtch)
+{
+    swtch->priv = broker_stream_switch_get_instance_private (swtch);
+}
+
+static void
+broker_stream_switch_dispose (GObject *object)
+{
+    BrokerStreamSwitch *swtch;
+
+    swtch = BROKER_STREAM_SWITCH (object);
+
+    if (swtch->priv->options != NULL) {
+        g_list_free_full (swtch->priv->options, g_object_unref);
+        swtch->priv->options = NULL;
+    }
+
+    g_clear_object (&swtch->priv->connection);
+
+    G_OBJECT_CLASS (broker_stream_switch_parent_class)->dispose (object);
+}
+
+BrokerStreamSwitch *
+broker_stream_switch_new (GDBusConnection *connection,
+                          BrokerStream    *stream,
+                          GVariant        *info)
+{
+    BrokerStreamSwitch *swtch;
+    GVariantIter       *options;
+    const gchar        *owner;
+    const gchar        *name;
+    const gchar        *label;
+    const gchar        *active;
+    guint               role;
+    guint               flags;
+
+    g_return_val_if_fail (G_IS_DBUS_CONNECTION (connection), NULL);
+    g_return_val_if_fail (BROKER_IS_STREAM (stream), NULL);
+    g_return_val_if_fail (info != NULL, NULL);
+
+    g_variant_get (info,
+                   "(&s&s&suua" BROKER_OPTION_TYPE "&s)",
+                   &owner,
+                   &name,
+                   &label,
+                   &role,
+                   &flags,
+                   &options,
+                   &active);
+
+    /* Toggles are published as plain switches, the broker does not tell
+     * which of the options is the "on" state */
+    swtch = g_object_new (BROKER_TYPE_STREAM_SWITCH,
+                          "name", name,
+                          "label", label,
+                          "role", role,
+                          "flags", flags & ~MATE_MIXER_STREAM_SWITCH_TOGGLE,
+                          "stream", stream,
+                          NULL);
+
+    swtch->priv->options    = broker_create_options (options);
+    swtch->priv->connection = g_object_ref (connection);
+
+    g_variant_iter_free (options);
+
+    broker_stream_switch_set_active_option (swtch, active);
+    return swtch;
+}
+
+void
+broker_stream_switch_set_active_option (BrokerStreamSwitch *swtch, const gchar *name)
+{
+    MateMixerSwitchOption *option = NULL;
+
+    g_return_if_fail (BROKER_IS_STREAM_SWITCH (swtch));
+    g_return_if_fail (name != NULL);
+
+    if (*name != '\0')
+        option = mate_mixer_switch_get_option (MATE_MIXER_SWITCH (swtch), name);
+
+    _mate_mixer_switch_set_active_option (MATE_MIXER_SWITCH (swtch), option);
+}
+
+static gboolean
+broker_stream_switch_set_active_option_real (MateMixerSwitch       *mms,
+                                             MateMixerSwitchOption *mmso)
+{
+    MateMixerStream *stream;
+
+    g_return_val_if_fail (BROKER_IS_STREAM_SWITCH (mms), FALSE);
+
+    stream = mate_mixer_stream_switch_get_stream (MATE_MIXER_STREAM_SWITCH (mms));
+    if (G_UNLIKELY (stream == NULL))
+        return FALSE;
+
+    broker_call_method (BROKER_STREAM_SWITCH (mms)->priv->connection,
+                        "SetActiveOption",
+                        g_variant_new ("(ysss)",
+                                       BROKER_KIND_STREAM_SWITCH,
+                                       mate_mixer_stream_get_name (stream),
+                                       mate_mixer_switch_get_name (mms),
+                                       mate_mixer_switch_option_get_name (mmso)));
+    return TRUE;
+}
+
+static const GList *
+broker_stream_switch_list_options (MateMixerSwitch *mms)
+{
+    g_return_val_if_fail (BROKER_IS_STREAM_SWITCH (mms), NULL);
+
+    return BROKER_STREAM_SWITCH (mms)->priv->options;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_STREAM_SWITCH_H
+#define BROKER_STREAM_SWITCH_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-types.h"
+
+G_BEGIN_DECLS
+
+#define BROKER_TYPE_STREAM_SWITCH               \
+        (broker_stream_switch_get_type ())
+#define BROKER_STREAM_SWITCH(o)                 \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), BROKER_TYPE_STREAM_SWITCH, BrokerStreamSwitch))
+#define BROKER_IS_STREAM_SWITCH(o)              \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), BROKER_TYPE_STREAM_SWITCH))
+#define BROKER_STREAM_SWITCH_CLASS(k)           \
+        (G_TYPE_CHECK_CLASS_CAST ((k), BROKER_TYPE_STREAM_SWITCH, BrokerStreamSwitchClass))
+#define BROKER_IS_STREAM_SWITCH_CLASS(k)        \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), BROKER_TYPE_STREAM_SWITCH))
+#define BROKER_STREAM_SWITCH_GET_CLASS(o)       \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), BROKER_TYPE_STREAM_SWITCH, BrokerStreamSwitchClass))
+
+typedef struct _BrokerStreamSwitchClass    BrokerStreamSwitchClass;
+typedef struct _BrokerStreamSwitchPrivate  BrokerStreamSwitchPrivate;
+
+struct _BrokerStreamSwitch
+{
+    MateMixerStreamSwitch parent;
+
+    /*< private >*/
+    BrokerStreamSwitchPrivate *priv;
+};
+
+struct _BrokerStreamSwitchClass
+{
+    MateMixerStreamSwitchClass parent_class;
+};
+
+GType               broker_stream_switch_get_type          (void) G_GNUC_CONST;
+
+BrokerStreamSwitch *broker_stream_switch_new               (GDBusConnection    *connection,
+                                                            BrokerStream       *stream,
+                                                            GVariant           *info);
+
+void                broker_stream_switch_set_active_option (BrokerStreamSwitch *swtch,
+                                                            const gchar        *name);
+
+G_END_DECLS
+
+#endif /* BROKER_STREAM_SWITCH_H */
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "broker-device.h"
+#include "broker-stream.h"
+#include "broker-stream-switch.h"
+
+struct _BrokerStreamPrivate
+{
+    gchar *default_control;
+    GList *controls;
+    GList *switches;
+};
+
+static void broker_stream_class_init (BrokerStreamClass *klass);
+static void broker_stream_init       (BrokerStream      *stream);
+static void broker_stream_dispose    (GObject           *object);
+static void broker_stream_finalize   (GObject           *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (BrokerStream, broker_stream, MATE_MIXER_TYPE_STREAM)
+
+static const GList *broker_stream_list_controls (MateMixerStream *mms);
+static const GList *broker_stream_list_switches (MateMixerStream *mms);
+
+static void
+broker_stream_class_init (BrokerStreamClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerStreamClass *stream_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose  = broker_stream_dispose;
+    object_class->finalize = broker_stream_finalize;
+
+    stream_class = MATE_MIXER_STREAM_CLASS (klass);
+    stream_class->list_controls = broker_stream_list_controls;
+    stream_class->list_switches = broker_stream_list_switches;
+}
+
+static void
+broker_stream_init (BrokerStream *stream)
+{
+    stream->priv = broker_stream_get_instance_private (stream);
+}
+
+static void
+broker_stream_dispose (GObject *object)
+{
+    BrokerStream *stream;
+
+    stream = BROKER_STREAM (object);
+
+    if (stream->priv->controls != NULL) {
+        g_list_free_full (stream->priv->controls, g_object_unref);
+        stream->priv->controls = NULL;
+    }
+    if (stream->priv->switches != NULL) {
+        g_list_free_full (stream->priv->switches, g_object_unref);
+        stream->priv->switches = NULL;
+    }
+
+    G_OBJECT_CLASS (broker_stream_parent_class)->dispose (object);
+}
+
+static void
+broker_stream_finalize (GObject *object)
+{
+    BrokerStream *stream;
+
+    stream = BROKER_STREAM (object);
+
+    g_free (stream->priv->default_control);
+
+    G_OBJECT_CLASS (broker_stream_parent_class)->finalize (object);
+}
+
+BrokerStream *
+broker_stream_new (GVariant *info, BrokerDevice *device)
+{
+    BrokerStream *stream;
+    const gchar  *name;
+    const gchar  *label;
+    const gchar  *default_control;
+    guint         direction;
+
+    g_return_val_if_fail (info != NULL, NULL);
+    g_return_val_if_fail (device == NULL || BROKER_IS_DEVICE (device), NULL);
+
+    g_variant_get (info,
+                   "(&s&s&su&s)",
+                   &name,
+                   &label,
+                   NULL,
+                   &direction,
+                   &default_control);
+
+    stream = g_object_new (BROKER_TYPE_STREAM,
+                           "name", name,
+                           "label", label,
+                           "device", device,
+                           "direction", direction,
+                           NULL);
+
+    /* The controls are published after the stream */
+    broker_stream_set_default_control (stream, default_control);
+    return stream;
+}
+
+void
+broker_stream_add_control (BrokerStream *stream, MateMixerStreamControl *control)
+{
+    const gchar *name;
+
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    name = mate_mixer_stream_control_get_name (control);
+
+    stream->priv->controls = g_list_append (stream->priv->controls,
+                                            g_object_ref (control));
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "control-added",
+                           name);
+
+    if (g_strcmp0 (stream->priv->default_control, name) == 0)
+        _mate_mixer_stream_set_default_control (MATE_MIXER_STREAM (stream), control);
+}
+
+void
+broker_stream_remove_control (BrokerStream *stream, const gchar *name)
+{
+    MateMixerStreamControl *control;
+
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+    g_return_if_fail (name != NULL);
+
+    control = mate_mixer_stream_get_control (MATE_MIXER_STREAM (stream), name);
+    if (G_UNLIKELY (control == NULL))
+        return;
+
+    if (mate_mixer_stream_get_default_control (MATE_MIXER_STREAM (stream)) == control)
+        _mate_mixer_stream_set_default_control (MATE_MIXER_STREAM (stream), NULL);
+
+    stream->priv->controls = g_list_remove (stream->priv->controls, control);
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "control-removed",
+                           name);
+
+    g_object_unref (control);
+}
+
+void
+broker_stream_add_switch (BrokerStream *stream, BrokerStreamSwitch *swtch)
+{
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+    g_return_if_fail (BROKER_IS_STREAM_SWITCH (swtch));
+
+    stream->priv->switches = g_list_append (stream->priv->switches,
+                                            g_object_ref (swtch));
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "switch-added",
+                           mate_mixer_switch_get_name (MATE_MIXER_SWITCH (swtch)));
+}
+
+void
+broker_stream_remove_switch (BrokerStream *stream, const gchar *name)
+{
+    MateMixerStreamSwitch *swtch;
+
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+    g_return_if_fail (name != NULL);
+
+    swtch = mate_mixer_stream_get_switch (MATE_MIXER_STREAM (stream), name);
+    if (G_UNLIKELY (swtch == NULL))
+        return;
+
+    stream->priv->switches = g_list_remove (stream->priv->switches, swtch);
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "switch-removed",
+                           name);
+
+    g_object_unref (swtch);
+}
+
+void
+broker_stream_set_default_control (BrokerStream *stream, const gchar *name)
+{
+    MateMixerStreamControl *control = NULL;
+
+    g_return_if_fail (BROKER_IS_STREAM (stream));
+    g_return_if_fail (name != NULL);
+
+    g_free (stream->priv->default_control);
+
+    /* Remember the name in case the control has not been added yet */
+    stream->priv->default_control = g_strdup (name);
+
+    if (*name != '\0')
+        control = mate_mixer_stream_get_control (MATE_MIXER_STREAM (stream), name);
+
+    _mate_mixer_stream_set_default_control (MATE_MIXER_STREAM (stream), control);
+}
+
+static const GList *
+broker_stream_list_controls (MateMixerStream *mms)
+{
+    g_return_val_if_fail (BROKER_IS_STREAM (mms), NULL);
+
+    return BROKER_STREAM (mms)->priv->controls;
+}
+
+static const GList *
+broker_stream_list_switches (MateMixerStream *mms)
+{
+    g_return_val_if_fail (BROKER_IS_STREAM (mms), NULL);
+
+    return BROKER_STREAM (mms)->priv->switches;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_STREAM_H
+#define BROKER_STREAM_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "broker-types.h"
+
+G_BEGIN_DECLS
+
+#define BROKER_TYPE_STREAM                      \
+        (broker_stream_get_type ())
+#define BROKER_STREAM(o)                        \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), BROKER_TYPE_STREAM, BrokerStream))
+#define BROKER_IS_STREAM(o)                     \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), BROKER_TYPE_STREAM))
+#define BROKER_STREAM_CLASS(k)                  \
+        (G_TYPE_CHECK_CLASS_CAST ((k), BROKER_TYPE_STREAM, BrokerStreamClass))
+#define BROKER_IS_STREAM_CLASS(k)               \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), BROKER_TYPE_STREAM))
+#define BROKER_STREAM_GET_CLASS(o)              \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), BROKER_TYPE_STREAM, BrokerStreamClass))
+
+typedef struct _BrokerStreamClass    BrokerStreamClass;
+typedef struct _BrokerStreamPrivate  BrokerStreamPrivate;
+
+struct _BrokerStream
+{
+    MateMixerStream parent;
+
+    /*< private >*/
+    BrokerStreamPrivate *priv;
+};
+
+struct _BrokerStreamClass
+{
+    MateMixerStreamClass parent_class;
+};
+
+GType         broker_stream_get_type            (void) G_GNUC_CONST;
+
+BrokerStream *broker_stream_new                 (GVariant               *info,
+                                                 BrokerDevice           *device);
+
+void          broker_stream_add_control         (BrokerStream           *stream,
+                                                 MateMixerStreamControl *control);
+void          broker_stream_remove_control      (BrokerStream           *stream,
+                                                 const gchar            *name);
+
+void          broker_stream_add_switch          (BrokerStream           *stream,
+                                                 BrokerStreamSwitch     *swtch);
+void          broker_stream_remove_switch       (BrokerStream           *stream,
+                                                 const gchar            *name);
+
+void          broker_stream_set_default_control (BrokerStream           *stream,
+                                                 const gchar            *name);
+
+G_END_DECLS
+
+#endif /* BROKER_STREAM_H */
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROKER_TYPES_H
+#define BROKER_TYPES_H
+
+G_BEGIN_DECLS
+
+typedef struct _BrokerBackend       BrokerBackend;
+typedef struct _BrokerControl       BrokerControl;
+typedef struct _BrokerDevice        BrokerDevice;
+typedef struct _BrokerDeviceSwitch  BrokerDeviceSwitch;
+typedef struct _BrokerStoredControl BrokerStoredControl;
+typedef struct _BrokerStream        BrokerStream;
+typedef struct _BrokerStreamControl BrokerStreamControl;
+typedef struct _BrokerStreamSwitch  BrokerStreamSwitch;
+
+G_END_DECLS
+
+#endif /* BROKER_TYPES_H */
@@ -0,0 +1,1114 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The mixer broker keeps a single connection to the sound system for all the
+ * libmatemixer users of a session and publishes the objects of its context on
+ * the session bus, see broker-protocol.h.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#ifdef G_OS_UNIX
+#include <glib-unix.h>
+#endif
+
+#include <libmatemixer/matemixer.h>
+
+#include "broker-protocol.h"
+
+typedef struct {
+    guchar   kind;
+    gchar   *owner;
+    gchar   *name;
+    GObject *object;
+} BrokerObject;
+
+static MateMixerContext *context;
+static GMainLoop        *mainloop;
+static GDBusConnection  *connection;
+static GDBusNodeInfo    *node_info;
+static GHashTable       *objects;
+static GHashTable       *changed_controls;
+static guint             changed_source;
+static guint             owner_id;
+static guint             registration_id;
+
+static void watch_object   (guchar       kind,
+                            const gchar *owner,
+                            const gchar *name,
+                            gpointer     object);
+static void unwatch_object (guchar       kind,
+                            const gchar *owner,
+                            const gchar *name);
+
+static const gchar *
+string_or_empty (const gchar *string)
+{
+    return (string != NULL) ? string : "";
+}
+
+static gchar *
+object_key (guchar kind, const gchar *owner, const gchar *name)
+{
+    return g_strdup_printf ("%c\n%s\n%s", kind, owner, name);
+}
+
+static void
+emit_signal (const gchar *signal_name, GVariant *parameters)
+{
+    GError *error = NULL;
+
+    /* Nobody can be listening before the name is owned */
+    if (connection == NULL) {
+        g_variant_unref (g_variant_ref_sink (parameters));
+        return;
+    }
+
+    if (g_dbus_connection_emit_signal (connection,
+                                       NULL,
+                                       BROKER_DBUS_PATH,
+                                       BROKER_DBUS_INTERFACE,
+                                       signal_name,
+                                       parameters,
+                                       &error) == FALSE) {
+        g_warning ("Failed to emit %s: %s", signal_name, error->message);
+        g_error_free (error);
+    }
+}
+
+static GVariant *
+device_info (MateMixerDevice *device)
+{
+    return g_variant_new (BROKER_DEVICE_TYPE,
+                          mate_mixer_device_get_name (device),
+                          string_or_empty (mate_mixer_device_get_label (device)),
+                          string_or_empty (mate_mixer_device_get_icon (device)));
+}
+
+static GVariant *
+stream_info (MateMixerStream *stream)
+{
+    MateMixerDevice        *device;
+    MateMixerStreamControl *control;
+
+    device  = mate_mixer_stream_get_device (stream);
+    control = mate_mixer_stream_get_default_control (stream);
+
+    return g_variant_new (BROKER_STREAM_TYPE,
+                          mate_mixer_stream_get_name (stream),
+                          string_or_empty (mate_mixer_stream_get_label (stream)),
+                          (device != NULL) ? mate_mixer_device_get_name (device) : "",
+                          mate_mixer_stream_get_direction (stream),
+                          (control != NULL) ? mate_mixer_stream_control_get_name (control) : "");
+}
+
+static GVariant *
+value_info (MateMixerStreamControl *control)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("au"));
+
+    for (i = 0; i < mate_mixer_stream_control_get_num_channels (control); i++)
+        g_variant_builder_add (&builder,
+                               "u",
+                               mate_mixer_stream_control_get_channel_volume (control, i));
+
+    return g_variant_new (BROKER_VALUE_TYPE,
+                          mate_mixer_stream_control_get_mute (control),
+                          mate_mixer_stream_control_get_volume (control),
+                          &builder,
+                          (gdouble) mate_mixer_stream_control_get_balance (control),
+                          (gdouble) mate_mixer_stream_control_get_fade (control));
+}
+
+static GVariant *
+control_info (const gchar *owner, MateMixerStreamControl *control)
+{
+    MateMixerStream   *stream;
+    MateMixerAppInfo  *app_info;
+    MateMixerDirection direction = MATE_MIXER_DIRECTION_UNKNOWN;
+    GVariantBuilder    builder;
+    guint              i;
+
+    stream   = mate_mixer_stream_control_get_stream (control);
+    app_info = mate_mixer_stream_control_get_app_info (control);
+
+    if (MATE_MIXER_IS_STORED_CONTROL (control))
+        direction = mate_mixer_stored_control_get_direction (MATE_MIXER_STORED_CONTROL (control));
+    else if (stream != NULL)
+        direction = mate_mixer_stream_get_direction (stream);
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("au"));
+
+    for (i = 0; i < mate_mixer_stream_control_get_num_channels (control); i++)
+        g_variant_builder_add (&builder,
+                               "u",
+                               mate_mixer_stream_control_get_channel_position (control, i));
+
+    return g_variant_new ("(ssssuuuuuuuuau" BROKER_APP_TYPE "@" BROKER_VALUE_TYPE ")",
+                          owner,
+                          mate_mixer_stream_control_get_name (control),
+                          string_or_empty (mate_mixer_stream_control_get_label (control)),
+                          (stream != NULL) ? mate_mixer_stream_get_name (stream) : "",
+                          mate_mixer_stream_control_get_flags (control),
+                          mate_mixer_stream_control_get_role (control),
+                          mate_mixer_stream_control_get_media_role (control),
+                          direction,
+                          mate_mixer_stream_control_get_min_volume (control),
+                          mate_mixer_stream_control_get_max_volume (control),
+                          mate_mixer_stream_control_get_normal_volume (control),
+                          mate_mixer_stream_control_get_base_volume (control),
+                          &builder,
+                          (app_info != NULL) ? string_or_empty (mate_mixer_app_info_get_name (app_info)) : "",
+                          (app_info != NULL) ? string_or_empty (mate_mixer_app_info_get_id (app_info)) : "",
+                          (app_info != NULL) ? string_or_empty (mate_mixer_app_info_get_version (app_info)) : "",
+                          (app_info != NULL) ? string_or_empty (mate_mixer_app_info_get_icon (app_info)) : "",
+                          value_info (control));
+}
+
+static GVariant *
+switch_info (const gchar *owner, MateMixerSwitch *swtch)
+{
+    MateMixerSwitchOption *active;
+    GVariantBuilder        builder;
+    const GList           *list;
+    guint                  role  = 0;
+    guint                  flags = 0;
+
+    /* Toggles are published as plain stream switches with two options */
+    if (MATE_MIXER_IS_DEVICE_SWITCH (swtch)) {
+        role = mate_mixer_device_switch_get_role (MATE_MIXER_DEVICE_SWITCH (swtch));
+    } else {
+        role  = mate_mixer_stream_switch_get_role (MATE_MIXER_STREAM_SWITCH (swtch));
+        flags = mate_mixer_stream_switch_get_flags (MATE_MIXER_STREAM_SWITCH (swtch));
+    }
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a" BROKER_OPTION_TYPE));
+
+    list = mate_mixer_switch_list_options (swtch);
+    while (list != NULL) {
+        MateMixerSwitchOption *option = MATE_MIXER_SWITCH_OPTION (list->data);
+
+        g_variant_builder_add (&builder,
+                               BROKER_OPTION_TYPE,
+                               mate_mixer_switch_option_get_name (option),
+                               string_or_empty (mate_mixer_switch_option_get_label (option)),
+                               string_or_empty (mate_mixer_switch_option_get_icon (option)));
+        list = list->next;
+    }
+
+    active = mate_mixer_switch_get_active_option (swtch);
+
+    return g_variant_new (BROKER_SWITCH_TYPE,
+                          owner,
+                          mate_mixer_switch_get_name (swtch),
+                          string_or_empty (mate_mixer_switch_get_label (swtch)),
+                          role,
+                          flags,
+                          &builder,
+                          (active != NULL) ? mate_mixer_switch_option_get_name (active) : "");
+}
+
+static GVariant *
+object_info (BrokerObject *entry)
+{
+    switch (entry->kind) {
+    case BROKER_KIND_DEVICE:
+        return device_info (MATE_MIXER_DEVICE (entry->object));
+    case BROKER_KIND_STREAM:
+        return stream_info (MATE_MIXER_STREAM (entry->object));
+    case BROKER_KIND_CONTROL:
+        return control_info (entry->owner, MATE_MIXER_STREAM_CONTROL (entry->object));
+    default:
+        return switch_info (entry->owner, MATE_MIXER_SWITCH (entry->object));
+    }
+}
+
+/* Returns the reply to GetState */
+static GVariant *
+state_info (void)
+{
+    GVariantBuilder  builders[5];
+    GHashTableIter   iter;
+    BrokerObject    *entry;
+    MateMixerStream *input;
+    MateMixerStream *output;
+    guint            i;
+
+    g_variant_builder_init (&builders[0], G_VARIANT_TYPE ("a" BROKER_DEVICE_TYPE));
+    g_variant_builder_init (&builders[1], G_VARIANT_TYPE ("a" BROKER_STREAM_TYPE));
+    g_variant_builder_init (&builders[2], G_VARIANT_TYPE ("a" BROKER_CONTROL_TYPE));
+    g_variant_builder_init (&builders[3], G_VARIANT_TYPE ("a" BROKER_SWITCH_TYPE));
+    g_variant_builder_init (&builders[4], G_VARIANT_TYPE ("a" BROKER_SWITCH_TYPE));
+
+    g_hash_table_iter_init (&iter, objects);
+
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry) == TRUE) {
+        switch (entry->kind) {
+        case BROKER_KIND_DEVICE:
+            i = 0;
+            break;
+        case BROKER_KIND_STREAM:
+            i = 1;
+            break;
+        case BROKER_KIND_CONTROL:
+            i = 2;
+            break;
+        case BROKER_KIND_DEVICE_SWITCH:
+            i = 3;
+            break;
+        default:
+            i = 4;
+            break;
+        }
+        g_variant_builder_add_value (&builders[i], object_info (entry));
+    }
+
+    input  = mate_mixer_context_get_default_input_stream (context);
+    output = mate_mixer_context_get_default_output_stream (context);
+
+    return g_variant_new ("(" BROKER_STATE_TYPE ")",
+                          mate_mixer_context_get_backend_name (context),
+                          &builders[0],
+                          &builders[1],
+                          &builders[2],
+                          &builders[3],
+                          &builders[4],
+                          (input != NULL) ? mate_mixer_stream_get_name (input) : "",
+                          (output != NULL) ? mate_mixer_stream_get_name (output) : "",
+                          mate_mixer_context_get_state (context));
+}
+
+static gboolean
+flush_changed_controls (gpointer data)
+{
+    GHashTableIter  iter;
+    BrokerObject   *entry;
+
+    /* Changes of a control are often notified property by property, send
+     * a single signal with the whole value instead */
+    g_hash_table_iter_init (&iter, changed_controls);
+
+    while (g_hash_table_iter_next (&iter, (gpointer *) &entry, NULL) == TRUE)
+        emit_signal ("ControlChanged",
+                     g_variant_new ("(ss@" BROKER_VALUE_TYPE ")",
+                                    entry->owner,
+                                    entry->name,
+                                    value_info (MATE_MIXER_STREAM_CONTROL (entry->object))));
+
+    g_hash_table_remove_all (changed_controls);
+
+    changed_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void
+on_control_notify (MateMixerStreamControl *control,
+                   GParamSpec             *pspec,
+                   BrokerObject           *entry)
+{
+    g_hash_table_add (changed_controls, entry);
+
+    if (changed_source == 0)
+        changed_source = g_idle_add (flush_changed_controls, NULL);
+}
+
+static void
+on_switch_notify (MateMixerSwitch *swtch,
+                  GParamSpec      *pspec,
+                  BrokerObject    *entry)
+{
+    MateMixerSwitchOption *active;
+
+    active = mate_mixer_switch_get_active_option (swtch);
+
+    emit_signal ("SwitchChanged",
+                 g_variant_new ("(ysss)",
+                                entry->kind,
+                                entry->owner,
+                                entry->name,
+                                (active != NULL) ? mate_mixer_switch_option_get_name (active) : ""));
+}
+
+static void
+on_stream_default_control_notify (MateMixerStream *stream,
+                                  GParamSpec      *pspec,
+                                  BrokerObject    *entry)
+{
+    MateMixerStreamControl *control;
+
+    control = mate_mixer_stream_get_default_control (stream);
+
+    emit_signal ("StreamChanged",
+                 g_variant_new ("(ss)",
+                                entry->name,
+                                (control != NULL) ? mate_mixer_stream_control_get_name (control) : ""));
+}
+
+static void
+on_stream_control_added (MateMixerStream *stream,
+                         const gchar     *name,
+                         BrokerObject    *entry)
+{
+    MateMixerStreamControl *control;
+
+    control = mate_mixer_stream_get_control (stream, name);
+    if (G_LIKELY (control != NULL))
+        watch_object (BROKER_KIND_CONTROL, entry->name, name, control);
+}
+
+static void
+on_stream_control_removed (MateMixerStream *stream,
+                           const gchar     *name,
+                           BrokerObject    *entry)
+{
+    unwatch_object (BROKER_KIND_CONTROL, entry->name, name);
+}
+
+static void
+on_stream_switch_added (MateMixerStream *stream,
+                        const gchar     *name,
+                        BrokerObject    *entry)
+{
+    MateMixerStreamSwitch *swtch;
+
+    swtch = mate_mixer_stream_get_switch (stream, name);
+    if (G_LIKELY (swtch != NULL))
+        watch_object (BROKER_KIND_STREAM_SWITCH, entry->name, name, swtch);
+}
+
+static void
+on_stream_switch_removed (MateMixerStream *stream,
+                          const gchar     *name,
+                          BrokerObject    *entry)
+{
+    unwatch_object (BROKER_KIND_STREAM_SWITCH, entry->name, name);
+}
+
+static void
+on_device_switch_added (MateMixerDevice *device,
+                        const gchar     *name,
+                        BrokerObject    *entry)
+{
+    MateMixerDeviceSwitch *swtch;
+
+    swtch = mate_mixer_device_get_switch (device, name);
+    if (G_LIKELY (swtch != NULL))
+        watch_object (BROKER_KIND_DEVICE_SWITCH, entry->name, name, swtch);
+}
+
+static void
+on_device_switch_removed (MateMixerDevice *device,
+                          const gchar     *name,
+                          BrokerObject    *entry)
+{
+    unwatch_object (BROKER_KIND_DEVICE_SWITCH, entry->name, name);
+}
+
+static void
+connect_object (BrokerObject *entry)
+{
+    switch (entry->kind) {
+    case BROKER_KIND_DEVICE:
+        g_signal_connect (entry->object,
+                          "switch-added",
+                          G_CALLBACK (on_device_switch_added),
+                          entry);
+        g_signal_connect (entry->object,
+                          "switch-removed",
+                          G_CALLBACK (on_device_switch_removed),
+                          entry);
+        break;
+
+    case BROKER_KIND_STREAM:
+        g_signal_connect (entry->object,
+                          "control-added",
+                          G_CALLBACK (on_stream_control_added),
+                          entry);
+        g_signal_connect (entry->object,
+                          "control-removed",
+                          G_CALLBACK (on_stream_control_removed),
+                          entry);
+        g_signal_connect (entry->object,
+                          "switch-added",
+                          G_CALLBACK (on_stream_switch_added),
+                          entry);
+        g_signal_connect (entry->object,
+                          "switch-removed",
+                          G_CALLBACK (on_stream_switch_removed),
+                          entry);
+        g_signal_connect (entry->object,
+                          "notify::default-control",
+                          G_CALLBACK (on_stream_default_control_notify),
+                          entry);
+        break;
+
+    case BROKER_KIND_CONTROL:
+        g_signal_connect (entry->object,
+                          "notify::mute",
+                          G_CALLBACK (on_control_notify),
+                          entry);
+        g_signal_connect (entry->object,
+                          "notify::volume",
+                          G_CALLBACK (on_control_notify),
+                          entry);
+        g_signal_connect (entry->object,
+                          "notify::balance",
+                          G_CALLBACK (on_control_notify),
+                          entry);
+        g_signal_connect (entry->object,
+                          "notify::fade",
+                          G_CALLBACK (on_control_notify),
+                          entry);
+        break;
+
+    default:
+        g_signal_connect (entry->object,
+                          "notify::active-option",
+                          G_CALLBACK (on_switch_notify),
+                          entry);
+        break;
+    }
+}
+
+static void
+free_object (BrokerObject *entry)
+{
+    g_hash_table_remove (changed_controls, entry);
+
+    g_signal_handlers_disconnect_by_data (entry->object, entry);
+    g_object_unref (entry->object);
+
+    g_free (entry->owner);
+    g_free (entry->name);
+    g_slice_free (BrokerObject, entry);
+}
+
+static void
+watch_object (guchar       kind,
+              const gchar *owner,
+              const gchar *name,
+              gpointer     object)
+{
+    BrokerObject *entry;
+    gchar        *key;
+    const GList  *list;
+
+    key = object_key (kind, owner, name);
+
+    if (g_hash_table_contains (objects, key) == TRUE) {
+        g_free (key);
+        return;
+    }
+
+    entry = g_slice_new (BrokerObject);
+    entry->kind   = kind;
+    entry->owner  = g_strdup (owner);
+    entry->name   = g_strdup (name);
+    entry->object = g_object_ref (object);
+
+    g_hash_table_insert (objects, key, entry);
+
+    connect_object (entry);
+
+    emit_signal ("ObjectAdded",
+                 g_variant_new ("(yv)", kind, object_info (entry)));
+
+    /* The objects owned by the added object are published after it */
+    if (kind == BROKER_KIND_DEVICE) {
+        list = mate_mixer_device_list_switches (MATE_MIXER_DEVICE (object));
+        while (list != NULL) {
+            MateMixerSwitch *swtch = MATE_MIXER_SWITCH (list->data);
+
+            watch_object (BROKER_KIND_DEVICE_SWITCH,
+                          name,
+                          mate_mixer_switch_get_name (swtch),
+                          swtch);
+            list = list->next;
+        }
+    } else if (kind == BROKER_KIND_STREAM) {
+        list = mate_mixer_stream_list_controls (MATE_MIXER_STREAM (object));
+        while (list != NULL) {
+            MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (list->data);
+
+            watch_object (BROKER_KIND_CONTROL,
+                          name,
+                          mate_mixer_stream_control_get_name (control),
+                          control);
+            list = list->next;
+        }
+
+        list = mate_mixer_stream_list_switches (MATE_MIXER_STREAM (object));
+        while (list != NULL) {
+            MateMixerSwitch *swtch = MATE_MIXER_SWITCH (list->data);
+
+            watch_object (BROKER_KIND_STREAM_SWITCH,
+                          name,
+                          mate_mixer_switch_get_name (swtch),
+                          swtch);
+            list = list->next;
+        }
+    }
+}
+
+static gboolean
+is_owned_by (gpointer key, BrokerObject *entry, BrokerObject *owner)
+{
+    if (owner->kind == BROKER_KIND_DEVICE && entry->kind != BROKER_KIND_DEVICE_SWITCH)
+        return FALSE;
+    if (owner->kind == BROKER_KIND_STREAM && entry->kind != BROKER_KIND_CONTROL &&
+                                             entry->kind != BROKER_KIND_STREAM_SWITCH)
+        return FALSE;
+
+    return g_strcmp0 (entry->owner, owner->name) == 0;
+}
+
+static void
+unwatch_object (guchar kind, const gchar *owner, const gchar *name)
+{
+    BrokerObject *entry;
+    gchar        *key;
+
+    key = object_key (kind, owner, name);
+
+    entry = g_hash_table_lookup (objects, key);
+    if (entry == NULL) {
+        g_free (key);
+        return;
+    }
+
+    /* Removing a device or a stream removes the objects it owns in the
+     * clients as well */
+    if (kind == BROKER_KIND_DEVICE || kind == BROKER_KIND_STREAM)
+        g_hash_table_foreach_remove (objects, (GHRFunc) is_owned_by, entry);
+
+    emit_signal ("ObjectRemoved",
+                 g_variant_new ("(yss)", kind, owner, name));
+
+    g_hash_table_remove (objects, key);
+    g_free (key);
+}
+
+static void
+on_context_device_added (MateMixerContext *context, const gchar *name)
+{
+    MateMixerDevice *device;
+
+    device = mate_mixer_context_get_device (context, name);
+    if (G_LIKELY (device != NULL))
+        watch_object (BROKER_KIND_DEVICE, "", name, device);
+}
+
+static void
+on_context_device_removed (MateMixerContext *context, const gchar *name)
+{
+    unwatch_object (BROKER_KIND_DEVICE, "", name);
+}
+
+static void
+on_context_stream_added (MateMixerContext *context, const gchar *name)
+{
+    MateMixerStream *stream;
+
+    stream = mate_mixer_context_get_stream (context, name);
+    if (G_LIKELY (stream != NULL))
+        watch_object (BROKER_KIND_STREAM, "", name, stream);
+}
+
+static void
+on_context_stream_removed (MateMixerContext *context, const gchar *name)
+{
+    unwatch_object (BROKER_KIND_STREAM, "", name);
+}
+
+static void
+on_context_stored_control_added (MateMixerContext *context, const gchar *name)
+{
+    MateMixerStoredControl *control;
+
+    control = mate_mixer_context_get_stored_control (context, name);
+    if (G_LIKELY (control != NULL))
+        watch_object (BROKER_KIND_CONTROL, "", name, control);
+}
+
+static void
+on_context_stored_control_removed (MateMixerContext *context, const gchar *name)
+{
+    unwatch_object (BROKER_KIND_CONTROL, "", name);
+}
+
+static void
+on_context_default_stream_notify (MateMixerContext *context, GParamSpec *pspec)
+{
+    MateMixerStream *input;
+    MateMixerStream *output;
+
+    input  = mate_mixer_context_get_default_input_stream (context);
+    output = mate_mixer_context_get_default_output_stream (context);
+
+    emit_signal ("DefaultStreamsChanged",
+                 g_variant_new ("(ss)",
+                                (input != NULL) ? mate_mixer_stream_get_name (input) : "",
+                                (output != NULL) ? mate_mixer_stream_get_name (output) : ""));
+}
+
+static MateMixerStreamControl *
+find_control (const gchar *owner, const gchar *name)
+{
+    MateMixerStream *stream;
+
+    if (*owner == '\0')
+        return MATE_MIXER_STREAM_CONTROL (mate_mixer_context_get_stored_control (context, name));
+
+    stream = mate_mixer_context_get_stream (context, owner);
+    if (stream == NULL)
+        return NULL;
+
+    return mate_mixer_stream_get_control (stream, name);
+}
+
+static MateMixerSwitch *
+find_switch (guchar kind, const gchar *owner, const gchar *name)
+{
+    if (kind == BROKER_KIND_DEVICE_SWITCH) {
+        MateMixerDevice *device;
+
+        device = mate_mixer_context_get_device (context, owner);
+        if (device != NULL)
+            return MATE_MIXER_SWITCH (mate_mixer_device_get_switch (device, name));
+    } else if (kind == BROKER_KIND_STREAM_SWITCH) {
+        MateMixerStream *stream;
+
+        stream = mate_mixer_context_get_stream (context, owner);
+        if (stream != NULL)
+            return MATE_MIXER_SWITCH (mate_mixer_stream_get_switch (stream, name));
+    }
+    return NULL;
+}
+
+static gboolean
+set_control (const gchar *method, GVariant *parameters, GError **error)
+{
+    MateMixerStreamControl *control;
+    const gchar            *owner;
+    const gchar            *name;
+    gboolean                result;
+
+    g_variant_get_child (parameters, 0, "&s", &owner);
+    g_variant_get_child (parameters, 1, "&s", &name);
+
+    control = find_control (owner, name);
+    if (control == NULL) {
+        g_set_error (error,
+                     G_DBUS_ERROR,
+                     G_DBUS_ERROR_INVALID_ARGS,
+                     "No such control: %s", name);
+        return FALSE;
+    }
+
+    if (g_strcmp0 (method, "SetMute") == 0) {
+        gboolean mute;
+
+        g_variant_get_child (parameters, 2, "b", &mute);
+        result = mate_mixer_stream_control_set_mute (control, mute);
+    }
+    else if (g_strcmp0 (method, "SetVolume") == 0) {
+        guint volume;
+
+        g_variant_get_child (parameters, 2, "u", &volume);
+        result = mate_mixer_stream_control_set_volume (control, volume);
+    }
+    else if (g_strcmp0 (method, "SetChannelVolume") == 0) {
+        guint channel;
+        guint volume;
+
+        g_variant_get_child (parameters, 2, "u", &channel);
+        g_variant_get_child (parameters, 3, "u", &volume);
+        result = mate_mixer_stream_control_set_channel_volume (control, channel, volume);
+    }
+    else if (g_strcmp0 (method, "SetBalance") == 0) {
+        gdouble balance;
+
+        g_variant_get_child (parameters, 2, "d", &balance);
+        result = mate_mixer_stream_control_set_balance (control, (gfloat) balance);
+    }
+    else {
+        gdouble fade;
+
+        g_variant_get_child (parameters, 2, "d", &fade);
+        result = mate_mixer_stream_control_set_fade (control, (gfloat) fade);
+    }
+
+    if (result == FALSE)
+        g_set_error (error,
+                     G_DBUS_ERROR,
+                     G_DBUS_ERROR_FAILED,
+                     "Failed to change control %s", name);
+    return result;
+}
+
+static gboolean
+set_active_option (GVariant *parameters, GError **error)
+{
+    MateMixerSwitch       *swtch;
+    MateMixerSwitchOption *option = NULL;
+    const gchar           *owner;
+    const gchar           *name;
+    const gchar           *option_name;
+    guchar                 kind;
+
+    g_variant_get (parameters, "(y&s&s&s)", &kind, &owner, &name, &option_name);
+
+    swtch = find_switch (kind, owner, name);
+    if (swtch != NULL)
+        option = mate_mixer_switch_get_option (swtch, option_name);
+
+    if (option == NULL) {
+        g_set_error (error,
+                     G_DBUS_ERROR,
+                     G_DBUS_ERROR_INVALID_ARGS,
+                     "No such switch option: %s", option_name);
+        return FALSE;
+    }
+
+    if (mate_mixer_switch_set_active_option (swtch, option) == FALSE) {
+        g_set_error (error,
+                     G_DBUS_ERROR,
+                     G_DBUS_ERROR_FAILED,
+                     "Failed to change switch %s", name);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean
+set_default_stream (GVariant *parameters, GError **error)
+{
+    MateMixerStream *stream;
+    const gchar     *name;
+    guint            direction;
+    gboolean         result;
+
+    g_variant_get (parameters, "(u&s)", &direction, &name);
+
+    stream = mate_mixer_context_get_stream (context, name);
+    if (stream == NULL || mate_mixer_stream_get_direction (stream) != direction) {
+        g_set_error (error,
+                     G_DBUS_ERROR,
+                     G_DBUS_ERROR_INVALID_ARGS,
+                     "No such stream: %s", name);
+        return FALSE;
+    }
+
+    if (direction == MATE_MIXER_DIRECTION_INPUT)
+        result = mate_mixer_context_set_default_input_stream (context, stream);
+    else
+        result = mate_mixer_context_set_default_output_stream (context, stream);
+
+    if (result == FALSE)
+        g_set_error (error,
+                     G_DBUS_ERROR,
+                     G_DBUS_ERROR_FAILED,
+                     "Failed to change the default stream to %s", name);
+    return result;
+}
+
+static void
+handle_method_call (GDBusConnection       *bus,
+                    const gchar           *sender,
+                    const gchar           *object_path,
+                    const gchar           *interface_name,
+                    const gchar           *method_name,
+                    GVariant              *parameters,
+                    GDBusMethodInvocation *invocation,
+                    gpointer               user_data)
+{
+    GError   *error = NULL;
+    gboolean  result;
+
+    if (g_strcmp0 (method_name, "GetState") == 0) {
+        g_dbus_method_invocation_return_value (invocation, state_info ());
+        return;
+    }
+
+    if (g_strcmp0 (method_name, "SetActiveOption") == 0)
+        result = set_active_option (parameters, &error);
+    else if (g_strcmp0 (method_name, "SetDefaultStream") == 0)
+        result = set_default_stream (parameters, &error);
+    else
+        result = set_control (method_name, parameters, &error);
+
+    if (result == TRUE)
+        g_dbus_method_invocation_return_value (invocation, NULL);
+    else
+        g_dbus_method_invocation_take_error (invocation, error);
+}
+
+static const GDBusInterfaceVTable interface_vtable = {
+    handle_method_call,
+    NULL,
+    NULL
+};
+
+static void
+on_bus_acquired (GDBusConnection *bus, const gchar *name, gpointer data)
+{
+    GError *error = NULL;
+
+    registration_id =
+        g_dbus_connection_register_object (bus,
+                                           BROKER_DBUS_PATH,
+                                           node_info->interfaces[0],
+                                           &interface_vtable,
+                                           NULL,
+                                           NULL,
+                                           &error);
+    if (registration_id == 0) {
+        g_warning ("Failed to register the mixer broker: %s", error->message);
+        g_error_free (error);
+
+        g_main_loop_quit (mainloop);
+        return;
+    }
+
+    connection = g_object_ref (bus);
+}
+
+static void
+on_name_lost (GDBusConnection *bus, const gchar *name, gpointer data)
+{
+    /* Either the bus is gone or another broker is already running */
+    g_debug ("Lost the name %s on the session bus", name);
+
+    g_main_loop_quit (mainloop);
+}
+
+static void
+publish (void)
+{
+    const GList *list;
+
+    list = mate_mixer_context_list_devices (context);
+    while (list != NULL) {
+        on_context_device_added (context,
+                                 mate_mixer_device_get_name (MATE_MIXER_DEVICE (list->data)));
+        list = list->next;
+    }
+
+    list = mate_mixer_context_list_streams (context);
+    while (list != NULL) {
+        on_context_stream_added (context,
+                                 mate_mixer_stream_get_name (MATE_MIXER_STREAM (list->data)));
+        list = list->next;
+    }
+
+    list = mate_mixer_context_list_stored_controls (context);
+    while (list != NULL) {
+        MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (list->data);
+
+        on_context_stored_control_added (context,
+                                         mate_mixer_stream_control_get_name (control));
+        list = list->next;
+    }
+
+    if (owner_id != 0)
+        return;
+
+    owner_id = g_bus_own_name (G_BUS_TYPE_SESSION,
+                               BROKER_DBUS_NAME,
+                               G_BUS_NAME_OWNER_FLAGS_NONE,
+                               on_bus_acquired,
+                               NULL,
+                               on_name_lost,
+                               NULL,
+                               NULL);
+}
+
+static void
+unpublish (void)
+{
+    GHashTableIter  iter;
+    BrokerObject   *entry;
+
+    /* The objects owned by devices and streams are removed together with
+     * their owners in the clients */
+    g_hash_table_iter_init (&iter, objects);
+
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry) == TRUE) {
+        if (entry->kind != BROKER_KIND_DEVICE &&
+            entry->kind != BROKER_KIND_STREAM &&
+            (entry->kind != BROKER_KIND_CONTROL || *entry->owner != '\0'))
+            continue;
+
+        emit_signal ("ObjectRemoved",
+                     g_variant_new ("(yss)", entry->kind, entry->owner, entry->name));
+    }
+
+    g_hash_table_remove_all (objects);
+}
+
+static void
+on_context_state_notify (MateMixerContext *context, GParamSpec *pspec)
+{
+    MateMixerState state = mate_mixer_context_get_state (context);
+
+    switch (state) {
+    case MATE_MIXER_STATE_CONNECTING:
+        /* The context is reconnecting to the sound system, the objects it
+         * publishes again once it is ready may not be the same */
+        unpublish ();
+
+        emit_signal ("StateChanged", g_variant_new ("(u)", state));
+        break;
+
+    case MATE_MIXER_STATE_READY:
+        /* Serving a context without a sound system only prevents the clients
+         * from finding a better backend on their own */
+        if (mate_mixer_context_get_backend_type (context) == MATE_MIXER_BACKEND_NULL) {
+            g_debug ("No sound system is available");
+            g_main_loop_quit (mainloop);
+            break;
+        }
+        publish ();
+
+        emit_signal ("StateChanged", g_variant_new ("(u)", state));
+        break;
+
+    case MATE_MIXER_STATE_FAILED:
+        g_main_loop_quit (mainloop);
+        break;
+
+    default:
+        break;
+    }
+}
+
+#ifdef G_OS_UNIX
+static gboolean
+on_signal (gpointer mainloop)
+{
+    g_idle_add ((GSourceFunc) g_main_loop_quit, mainloop);
+
+    return G_SOURCE_REMOVE;
+}
+#endif
+
+int main (int argc, char *argv[])
+{
+    /* Make sure the context does not use the Broker backend */
+    g_setenv (BROKER_DISABLE_VARIABLE, "1", TRUE);
+
+    if (mate_mixer_init () == FALSE)
+        return 1;
+
+    node_info = g_dbus_node_info_new_for_xml (BROKER_INTROSPECTION_XML, NULL);
+
+    objects = g_hash_table_new_full (g_str_hash,
+                                     g_str_equal,
+                                     g_free,
+                                     (GDestroyNotify) free_object);
+
+    changed_controls = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    context = mate_mixer_context_new ();
+
+    mate_mixer_context_set_app_name (context, "MATE Mixer Broker");
+    mate_mixer_context_set_app_id (context, BROKER_DBUS_NAME);
+    mate_mixer_context_set_app_icon (context, "multimedia-volume-control");
+
+    g_signal_connect (G_OBJECT (context),
+                      "notify::state",
+                      G_CALLBACK (on_context_state_notify),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "device-added",
+                      G_CALLBACK (on_context_device_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "device-removed",
+                      G_CALLBACK (on_context_device_removed),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "stream-added",
+                      G_CALLBACK (on_context_stream_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "stream-removed",
+                      G_CALLBACK (on_context_stream_removed),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "stored-control-added",
+                      G_CALLBACK (on_context_stored_control_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "stored-control-removed",
+                      G_CALLBACK (on_context_stored_control_removed),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "notify::default-input-stream",
+                      G_CALLBACK (on_context_default_stream_notify),
+                      NULL);
+    g_signal_connect (G_OBJECT (context),
+                      "notify::default-output-stream",
+                      G_CALLBACK (on_context_default_stream_notify),
+                      NULL);
+
+    mainloop = g_main_loop_new (NULL, FALSE);
+
+    if (mate_mixer_context_open (context) == FALSE) {
+        g_object_unref (context);
+        return 1;
+    }
+
+    /* The state may already be ready when the connection is synchronous */
+    if (mate_mixer_context_get_state (context) == MATE_MIXER_STATE_READY)
+        on_context_state_notify (context, NULL);
+
+#ifdef G_OS_UNIX
+    g_unix_signal_add (SIGTERM, on_signal, mainloop);
+    g_unix_signal_add (SIGINT, on_signal, mainloop);
+#endif
+
+    g_main_loop_run (mainloop);
+
+    if (owner_id != 0)
+        g_bus_unown_name (owner_id);
+
+    if (connection != NULL) {
+        g_dbus_connection_unregister_object (connection, registration_id);
+        g_object_unref (connection);
+    }
+
+    if (changed_source != 0)
+        g_source_remove (changed_source);
+
+    /* Closing the context must not touch the destroyed tables */
+    g_signal_handlers_disconnect_by_data (G_OBJECT (context), NULL);
+
+    g_hash_table_destroy (objects);
+    g_hash_table_destroy (changed_controls);
+
+    g_object_unref (context);
+    g_main_loop_unref (mainloop);
+    g_dbus_node_info_unref (node_info);
+    return 0;
+}
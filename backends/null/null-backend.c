@@ -15,20 +15,80 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 #include <libmatemixer/matemixer.h>
 #include <libmatemixer/matemixer-private.h>
 
 #include "null-backend.h"
+#include "null-device.h"
+#include "null-stream.h"
+#include "null-stream-control.h"
 
 #define BACKEND_NAME      "Null"
 #define BACKEND_PRIORITY  0
 #define BACKEND_FLAGS     MATE_MIXER_BACKEND_NO_FLAGS
 
-G_DEFINE_DYNAMIC_TYPE (NullBackend, null_backend, MATE_MIXER_TYPE_BACKEND)
+/*
+ * When this variable is set, the backend generates a synthetic load instead
+ * of being empty. The value is a comma-separated list of key=value items:
+ *
+ *   devices   number of devices
+ *   streams   number of streams of each device
+ *   controls  number of controls of each stream
+ *   rate      number of events generated per second, 0 disables events
+ *   seed      seed of the random generator, the same seed always produces
+ *             the same objects and sequence of events
+ *
+ * Example: LIBMATEMIXER_NULL_LOAD=devices=8,streams=4,controls=2,rate=500
+ */
+#define BACKEND_LOAD_VARIABLE "LIBMATEMIXER_NULL_LOAD"
+
+typedef struct {
+    guint   devices;
+    guint   streams;
+    guint   controls;
+    guint   rate;
+    guint32 seed;
+} NullLoad;
+
+struct _NullBackendPrivate
+{
+    NullLoad   load;
+    GRand     *rand;
+    GSource   *timeout_source;
+    gint64     start_time;
+    guint64    events;
+    guint      serial;
+    GList     *devices;
+    GPtrArray *streams;
+    GList     *streams_list;
+};
+
+static void null_backend_dispose  (GObject *object);
+static void null_backend_finalize (GObject *object);
+
+G_DEFINE_DYNAMIC_TYPE_EXTENDED (NullBackend, null_backend, MATE_MIXER_TYPE_BACKEND, 0, G_ADD_PRIVATE_DYNAMIC(NullBackend))
 
-static gboolean null_backend_open (MateMixerBackend *backend);
+static gboolean     null_backend_open         (MateMixerBackend *backend);
+static void         null_backend_close        (MateMixerBackend *backend);
+
+static const GList *null_backend_list_devices (MateMixerBackend *backend);
+static const GList *null_backend_list_streams (MateMixerBackend *backend);
+
+static gboolean     parse_load                (const gchar      *value,
+                                               NullLoad         *load);
+
+static gboolean     generate_events           (NullBackend      *null);
+static void         generate_event            (NullBackend      *null);
+
+static void         add_stream                (NullBackend      *null,
+                                               NullDevice       *device);
+static void         remove_stream             (NullBackend      *null,
+                                               guint             index);
+
+static void         free_list_streams         (NullBackend      *null);
 
 static MateMixerBackendInfo info;
 
@@ -52,10 +112,18 @@ const MateMixerBackendInfo *backend_module_get_info (void)
 static void
 null_backend_class_init (NullBackendClass *klass)
 {
+    GObjectClass          *object_class;
     MateMixerBackendClass *backend_class;
 
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose  = null_backend_dispose;
+    object_class->finalize = null_backend_finalize;
+
     backend_class = MATE_MIXER_BACKEND_CLASS (klass);
-    backend_class->open = null_backend_open;
+    backend_class->open         = null_backend_open;
+    backend_class->close        = null_backend_close;
+    backend_class->list_devices = null_backend_list_devices;
+    backend_class->list_streams = null_backend_list_streams;
 }
 
 /* Called in the code generated by G_DEFINE_DYNAMIC_TYPE() */
@@ -67,11 +135,397 @@ null_backend_class_finalize (NullBackendClass *klass)
 static void
 null_backend_init (NullBackend *null)
 {
+    null->priv = null_backend_get_instance_private (null);
+
+    null->priv->streams = g_ptr_array_new_with_free_func (g_object_unref);
+}
+
+static void
+null_backend_dispose (GObject *object)
+{
+    MateMixerBackend *backend;
+    MateMixerState    state;
+
+    backend = MATE_MIXER_BACKEND (object);
+
+    state = mate_mixer_backend_get_state (backend);
+    if (state != MATE_MIXER_STATE_IDLE)
+        null_backend_close (backend);
+
+    G_OBJECT_CLASS (null_backend_parent_class)->dispose (object);
+}
+
+static void
+null_backend_finalize (GObject *object)
+{
+    g_ptr_array_unref (NULL_BACKEND (object)->priv->streams);
+
+    G_OBJECT_CLASS (null_backend_parent_class)->finalize (object);
 }
 
 static gboolean
 null_backend_open (MateMixerBackend *backend)
 {
+    NullBackend *null;
+    const gchar *value;
+    guint        i;
+    guint        j;
+
+    g_return_val_if_fail (NULL_IS_BACKEND (backend), FALSE);
+
+    null = NULL_BACKEND (backend);
+
+    /* Without the variable the backend provides no functionality */
+    value = g_getenv (BACKEND_LOAD_VARIABLE);
+    if (value == NULL || parse_load (value, &null->priv->load) == FALSE) {
+        _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_READY);
+        return TRUE;
+    }
+
+    null->priv->rand = g_rand_new_with_seed (null->priv->load.seed);
+
+    for (i = 0; i < null->priv->load.devices; i++) {
+        NullDevice *device;
+        gchar      *name;
+        gchar      *label;
+
+        name  = g_strdup_printf ("null-device-%u", i);
+        label = g_strdup_printf ("Synthetic Device %u", i);
+
+        device = null_device_new (name, label);
+
+        null->priv->devices = g_list_append (null->priv->devices, device);
+
+        g_signal_emit_by_name (G_OBJECT (null),
+                               "device-added",
+                               name);
+        g_free (name);
+        g_free (label);
+
+        for (j = 0; j < null->priv->load.streams; j++)
+            add_stream (null, device);
+    }
+
+    if (null->priv->load.rate > 0) {
+        /* Tick at most once per millisecond, each tick generates the events
+         * which are due since the start so that the rate is kept exactly */
+        null->priv->start_time = g_get_monotonic_time ();
+        null->priv->events     = 0;
+
+        null->priv->timeout_source =
+            g_timeout_source_new (MAX (1000 / null->priv->load.rate, 1));
+
+        g_source_set_callback (null->priv->timeout_source,
+                               (GSourceFunc) generate_events,
+                               null,
+                               NULL);
+
+        /* Generate the events in the main context of the thread which opened
+         * the backend, the same as the other backends dispatch their events */
+        g_source_attach (null->priv->timeout_source,
+                         g_main_context_get_thread_default ());
+    }
+
     _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_READY);
     return TRUE;
 }
+
+static void
+null_backend_close (MateMixerBackend *backend)
+{
+    NullBackend *null;
+
+    g_return_if_fail (NULL_IS_BACKEND (backend));
+
+    null = NULL_BACKEND (backend);
+
+    if (null->priv->timeout_source != NULL) {
+        g_source_destroy (null->priv->timeout_source);
+        g_clear_pointer (&null->priv->timeout_source, g_source_unref);
+    }
+
+    if (null->priv->rand != NULL) {
+        g_rand_free (null->priv->rand);
+        null->priv->rand = NULL;
+    }
+
+    free_list_streams (null);
+
+    g_ptr_array_set_size (null->priv->streams, 0);
+
+    if (null->priv->devices != NULL) {
+        g_list_free_full (null->priv->devices, g_object_unref);
+        null->priv->devices = NULL;
+    }
+
+    null->priv->serial = 0;
+
+    _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_IDLE);
+}
+
+static const GList *
+null_backend_list_devices (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (NULL_IS_BACKEND (backend), NULL);
+
+    return NULL_BACKEND (backend)->priv->devices;
+}
+
+static const GList *
+null_backend_list_streams (MateMixerBackend *backend)
+{
+    NullBackend *null;
+    guint        i;
+
+    g_return_val_if_fail (NULL_IS_BACKEND (backend), NULL);
+
+    null = NULL_BACKEND (backend);
+
+    if (null->priv->streams_list == NULL) {
+        for (i = null->priv->streams->len; i > 0; i--)
+            null->priv->streams_list =
+                g_list_prepend (null->priv->streams_list,
+                                g_object_ref (g_ptr_array_index (null->priv->streams, i - 1)));
+    }
+    return null->priv->streams_list;
+}
+
+static gboolean
+parse_load (const gchar *value, NullLoad *load)
+{
+    gchar  **items;
+    gboolean result = TRUE;
+    guint    i;
+
+    load->devices  = 1;
+    load->streams  = 2;
+    load->controls = 1;
+    load->rate     = 0;
+    load->seed     = 1;
+
+    items = g_strsplit (value, ",", -1);
+
+    for (i = 0; items[i] != NULL && result == TRUE; i++) {
+        gchar   *key;
+        gchar   *end;
+        guint64  number;
+
+        key = g_strstrip (items[i]);
+        if (*key == '\0')
+            continue;
+
+        end = strchr (key, '=');
+        if (end == NULL) {
+            result = FALSE;
+            break;
+        }
+        *end++ = '\0';
+
+        number = g_ascii_strtoull (end, &end, 10);
+        if (*end != '\0' || number > G_MAXUINT32) {
+            result = FALSE;
+            break;
+        }
+
+        if (strcmp (key, "devices") == 0)
+            load->devices = (guint) number;
+        else if (strcmp (key, "streams") == 0)
+            load->streams = (guint) number;
+        else if (strcmp (key, "controls") == 0)
+            load->controls = (guint) number;
+        else if (strcmp (key, "rate") == 0)
+            load->rate = (guint) number;
+        else if (strcmp (key, "seed") == 0)
+            load->seed = (guint32) number;
+        else
+            result = FALSE;
+    }
+
+    if (result == FALSE)
+        g_warning ("Invalid value of %s: %s", BACKEND_LOAD_VARIABLE, value);
+
+    g_strfreev (items);
+    return result;
+}
+
+static gboolean
+generate_events (NullBackend *null)
+{
+    gint64  elapsed;
+    guint64 due;
+
+    elapsed = g_get_monotonic_time () - null->priv->start_time;
+
+    due = (guint64) elapsed * null->priv->load.rate / G_USEC_PER_SEC;
+
+    while (null->priv->events < due) {
+        generate_event (null);
+        null->priv->events++;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+generate_event (NullBackend *null)
+{
+    MateMixerStatistics *statistics;
+    guint                count;
+    gint32               event;
+
+    statistics = _mate_mixer_backend_get_statistics (MATE_MIXER_BACKEND (null));
+
+    count = null->priv->streams->len;
+    event = g_rand_int_range (null->priv->rand, 0, 100);
+
+    /* Volume changes are the most frequent events, followed by mute changes
+     * and streams appearing and disappearing */
+    if (event < 80 && count > 0) {
+        MateMixerStream        *stream;
+        MateMixerStreamControl *control;
+        const GList            *controls;
+        guint                   length;
+
+        stream = g_ptr_array_index (null->priv->streams,
+                                    g_rand_int_range (null->priv->rand, 0, count));
+
+        controls = mate_mixer_stream_list_controls (stream);
+        length   = g_list_length ((GList *) controls);
+        if (length == 0)
+            return;
+
+        control = g_list_nth_data ((GList *) controls,
+                                   g_rand_int_range (null->priv->rand, 0, length));
+
+        if (event < 60) {
+            guint max = mate_mixer_stream_control_get_max_volume (control);
+
+            null_stream_control_update_volume (NULL_STREAM_CONTROL (control),
+                                               g_rand_int_range (null->priv->rand, 0, max + 1));
+        } else {
+            _mate_mixer_stream_control_set_mute (control,
+                                                 !mate_mixer_stream_control_get_mute (control));
+        }
+
+        _mate_mixer_statistics_add_event (statistics,
+                                          MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+        return;
+    }
+
+    /* Keep the number of streams around the configured number */
+    if (count > 0 && count >= null->priv->load.devices * null->priv->load.streams) {
+        remove_stream (null, g_rand_int_range (null->priv->rand, 0, count));
+    } else if (null->priv->devices != NULL) {
+        NullDevice *device;
+
+        device = g_list_nth_data (null->priv->devices,
+                                  g_rand_int_range (null->priv->rand, 0, null->priv->load.devices));
+        add_stream (null, device);
+    } else
+        return;
+
+    _mate_mixer_statistics_add_event (statistics,
+                                      MATE_MIXER_STATISTICS_EVENT_STREAM);
+}
+
+static void
+add_stream (NullBackend *null, NullDevice *device)
+{
+    MateMixerBackend  *backend;
+    MateMixerDirection direction;
+    NullStream        *stream;
+    gchar             *name;
+    gchar             *label;
+    guint              i;
+
+    backend = MATE_MIXER_BACKEND (null);
+
+    /* Alternate between output and input streams */
+    if (null->priv->serial % 2 == 0)
+        direction = MATE_MIXER_DIRECTION_OUTPUT;
+    else
+        direction = MATE_MIXER_DIRECTION_INPUT;
+
+    name  = g_strdup_printf ("null-stream-%u", null->priv->serial);
+    label = g_strdup_printf ("Synthetic Stream %u", null->priv->serial);
+
+    null->priv->serial++;
+
+    stream = null_stream_new (name, label, device, direction);
+
+    for (i = 0; i < null->priv->load.controls; i++) {
+        NullStreamControl *control;
+        gchar             *control_name;
+        gchar             *control_label;
+
+        control_name  = g_strdup_printf ("control-%u", i);
+        control_label = g_strdup_printf ("Synthetic Control %u", i);
+
+        control = null_stream_control_new (control_name, control_label, stream);
+
+        null_stream_add_control (stream, control);
+        g_object_unref (control);
+
+        g_free (control_name);
+        g_free (control_label);
+    }
+
+    g_ptr_array_add (null->priv->streams, stream);
+
+    null_device_add_stream (device, stream);
+
+    free_list_streams (null);
+    g_signal_emit_by_name (G_OBJECT (null),
+                           "stream-added",
+                           name);
+
+    if (direction == MATE_MIXER_DIRECTION_OUTPUT) {
+        if (mate_mixer_backend_get_default_output_stream (backend) == NULL)
+            _mate_mixer_backend_set_default_output_stream (backend, MATE_MIXER_STREAM (stream));
+    } else {
+        if (mate_mixer_backend_get_default_input_stream (backend) == NULL)
+            _mate_mixer_backend_set_default_input_stream (backend, MATE_MIXER_STREAM (stream));
+    }
+
+    g_free (name);
+    g_free (label);
+}
+
+static void
+remove_stream (NullBackend *null, guint index)
+{
+    MateMixerBackend *backend;
+    MateMixerStream  *stream;
+    MateMixerDevice  *device;
+
+    backend = MATE_MIXER_BACKEND (null);
+
+    stream = g_object_ref (g_ptr_array_index (null->priv->streams, index));
+
+    g_ptr_array_remove_index (null->priv->streams, index);
+
+    device = mate_mixer_stream_get_device (stream);
+    null_device_remove_stream (NULL_DEVICE (device), NULL_STREAM (stream));
+
+    if (mate_mixer_backend_get_default_output_stream (backend) == stream)
+        _mate_mixer_backend_set_default_output_stream (backend, NULL);
+    if (mate_mixer_backend_get_default_input_stream (backend) == stream)
+        _mate_mixer_backend_set_default_input_stream (backend, NULL);
+
+    free_list_streams (null);
+    g_signal_emit_by_name (G_OBJECT (null),
+                           "stream-removed",
+                           mate_mixer_stream_get_name (stream));
+
+    g_object_unref (stream);
+}
+
+static void
+free_list_streams (NullBackend *null)
+{
+    if (null->priv->streams_list == NULL)
+        return;
+
+    g_list_free_full (null->priv->streams_list, g_object_unref);
+
+    null->priv->streams_list = NULL;
+}
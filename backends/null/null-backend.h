@@ -23,6 +23,8 @@
 #include <libmatemixer/matemixer.h>
 #include <libmatemixer/matemixer-private.h>
 
+#include "null-types.h"
+
 #define NULL_TYPE_BACKEND                       \
         (null_backend_get_type ())
 #define NULL_BACKEND(o)                         \
@@ -36,12 +38,15 @@
 #define NULL_BACKEND_GET_CLASS(o)               \
         (G_TYPE_INSTANCE_GET_CLASS ((o), NULL_TYPE_BACKEND, NullBackendClass))
 
-typedef struct _NullBackend       NullBackend;
-typedef struct _NullBackendClass  NullBackendClass;
+typedef struct _NullBackendClass    NullBackendClass;
+typedef struct _NullBackendPrivate  NullBackendPrivate;
 
 struct _NullBackend
 {
     MateMixerBackend parent;
+
+    /*< private >*/
+    NullBackendPrivate *priv;
 };
 
 struct _NullBackendClass
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "null-device.h"
+#include "null-stream.h"
+
+struct _NullDevicePrivate
+{
+    GList *streams;
+};
+
+static void null_device_class_init (NullDeviceClass *klass);
+static void null_device_init       (NullDevice      *device);
+static void null_device_dispose    (GObject         *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (NullDevice, null_device, MATE_MIXER_TYPE_DEVICE)
+
+static const GList *null_device_list_streams (MateMixerDevice *mmd);
+
+static void
+null_device_class_init (NullDeviceClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerDeviceClass *device_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = null_device_dispose;
+
+    device_class = MATE_MIXER_DEVICE_CLASS (klass);
+    device_class->list_streams = null_device_list_streams;
+}
+
+static void
+null_device_init (NullDevice *device)
+{
+    device->priv = null_device_get_instance_private (device);
+}
+
+static void
+null_device_dispose (GObject *object)
+{
+    NullDevice *device;
+
+    device = NULL_DEVICE (object);
+
+    if (device->priv->streams != NULL) {
+        g_list_free_full (device->priv->streams, g_object_unref);
+        device->priv->streams = NULL;
+    }
+
+    G_OBJECT_CLASS (null_device_parent_class)->dispose (object);
+}
+
+NullDevice *
+null_device_new (const gchar *name, const gchar *label)
+{
+    g_return_val_if_fail (name  != NULL, NULL);
+    g_return_val_if_fail (label != NULL, NULL);
+
+    return g_object_new (NULL_TYPE_DEVICE,
+                         "name", name,
+                         "label", label,
+                         "icon", "audio-card",
+                         NULL);
+}
+
+void
+null_device_add_stream (NullDevice *device, NullStream *stream)
+{
+    g_return_if_fail (NULL_IS_DEVICE (device));
+    g_return_if_fail (NULL_IS_STREAM (stream));
+
+    device->priv->streams = g_list_append (device->priv->streams,
+                                           g_object_ref (stream));
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-added",
+                           mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+}
+
+void
+null_device_remove_stream (NullDevice *device, NullStream *stream)
+{
+    GList *item;
+
+    g_return_if_fail (NULL_IS_DEVICE (device));
+    g_return_if_fail (NULL_IS_STREAM (stream));
+
+    item = g_list_find (device->priv->streams, stream);
+    if (G_UNLIKELY (item == NULL))
+        return;
+
+    device->priv->streams = g_list_delete_link (device->priv->streams, item);
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-removed",
+                           mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+
+    g_object_unref (stream);
+}
+
+static const GList *
+null_device_list_streams (MateMixerDevice *mmd)
+{
+    g_return_val_if_fail (NULL_IS_DEVICE (mmd), NULL);
+
+    return NULL_DEVICE (mmd)->priv->streams;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NULL_DEVICE_H
+#define NULL_DEVICE_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "null-types.h"
+
+G_BEGIN_DECLS
+
+#define NULL_TYPE_DEVICE                        \
+        (null_device_get_type ())
+#define NULL_DEVICE(o)                          \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), NULL_TYPE_DEVICE, NullDevice))
+#define NULL_IS_DEVICE(o)                       \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), NULL_TYPE_DEVICE))
+#define NULL_DEVICE_CLASS(k)                    \
+        (G_TYPE_CHECK_CLASS_CAST ((k), NULL_TYPE_DEVICE, NullDeviceClass))
+#define NULL_IS_DEVICE_CLASS(k)                 \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), NULL_TYPE_DEVICE))
+#define NULL_DEVICE_GET_CLASS(o)                \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), NULL_TYPE_DEVICE, NullDeviceClass))
+
+typedef struct _NullDeviceClass    NullDeviceClass;
+typedef struct _NullDevicePrivate  NullDevicePrivate;
+
+struct _NullDevice
+{
+    MateMixerDevice parent;
+
+    /*< private >*/
+    NullDevicePrivate *priv;
+};
+
+struct _NullDeviceClass
+{
+    MateMixerDeviceClass parent_class;
+};
+
+GType       null_device_get_type      (void) G_GNUC_CONST;
+
+NullDevice *null_device_new           (const gchar *name,
+                                       const gchar *label);
+
+void        null_device_add_stream    (NullDevice  *device,
+                                       NullStream  *stream);
+void        null_device_remove_stream (NullDevice  *device,
+                                       NullStream  *stream);
+
+G_END_DECLS
+
+#endif /* NULL_DEVICE_H */
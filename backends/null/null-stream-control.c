@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "null-stream.h"
+#include "null-stream-control.h"
+
+#define NULL_CONTROL_CHANNELS   2
+#define NULL_CONTROL_MAX_VOLUME 65536
+
+#define NULL_CONTROL_FLAGS      (MATE_MIXER_STREAM_CONTROL_MUTE_READABLE |      \
+                                 MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE |      \
+                                 MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |    \
+                                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE)
+
+struct _NullStreamControlPrivate
+{
+    guint volume[NULL_CONTROL_CHANNELS];
+};
+
+static void null_stream_control_class_init (NullStreamControlClass *klass);
+static void null_stream_control_init       (NullStreamControl      *control);
+
+G_DEFINE_TYPE_WITH_PRIVATE (NullStreamControl, null_stream_control, MATE_MIXER_TYPE_STREAM_CONTROL)
+
+static gboolean                 null_stream_control_set_mute             (MateMixerStreamControl  *mmsc,
+                                                                          gboolean                 mute);
+
+static guint                    null_stream_control_get_num_channels     (MateMixerStreamControl  *mmsc);
+
+static guint                    null_stream_control_get_volume           (MateMixerStreamControl  *mmsc);
+static gboolean                 null_stream_control_set_volume           (MateMixerStreamControl  *mmsc,
+                                                                          guint                    volume);
+
+static gboolean                 null_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                                                          MateMixerChannelPosition position);
+static MateMixerChannelPosition null_stream_control_get_channel_position (MateMixerStreamControl  *mmsc,
+                                                                          guint                    channel);
+
+static guint                    null_stream_control_get_channel_volume   (MateMixerStreamControl  *mmsc,
+                                                                          guint                    channel);
+static gboolean                 null_stream_control_set_channel_volume   (MateMixerStreamControl  *mmsc,
+                                                                          guint                    channel,
+                                                                          guint                    volume);
+
+static guint                    null_stream_control_get_min_volume       (MateMixerStreamControl  *mmsc);
+static guint                    null_stream_control_get_max_volume       (MateMixerStreamControl  *mmsc);
+
+static void
+null_stream_control_class_init (NullStreamControlClass *klass)
+{
+    MateMixerStreamControlClass *control_class;
+
+    control_class = MATE_MIXER_STREAM_CONTROL_CLASS (klass);
+    control_class->set_mute             = null_stream_control_set_mute;
+    control_class->get_num_channels     = null_stream_control_get_num_channels;
+    control_class->get_volume           = null_stream_control_get_volume;
+    control_class->set_volume           = null_stream_control_set_volume;
+    control_class->get_channel_volume   = null_stream_control_get_channel_volume;
+    control_class->set_channel_volume   = null_stream_control_set_channel_volume;
+    control_class->has_channel_position = null_stream_control_has_channel_position;
+    control_class->get_channel_position = null_stream_control_get_channel_position;
+    control_class->get_min_volume       = null_stream_control_get_min_volume;
+    control_class->get_max_volume       = null_stream_control_get_max_volume;
+    control_class->get_normal_volume    = null_stream_control_get_max_volume;
+    control_class->get_base_volume      = null_stream_control_get_max_volume;
+}
+
+static void
+null_stream_control_init (NullStreamControl *control)
+{
+    control->priv = null_stream_control_get_instance_private (control);
+}
+
+NullStreamControl *
+null_stream_control_new (const gchar *name,
+                         const gchar *label,
+                         NullStream  *stream)
+{
+    NullStreamControl *control;
+    guint              i;
+
+    g_return_val_if_fail (name  != NULL, NULL);
+    g_return_val_if_fail (label != NULL, NULL);
+    g_return_val_if_fail (NULL_IS_STREAM (stream), NULL);
+
+    control = g_object_new (NULL_TYPE_STREAM_CONTROL,
+                            "name", name,
+                            "label", label,
+                            "flags", NULL_CONTROL_FLAGS,
+                            "role", MATE_MIXER_STREAM_CONTROL_ROLE_MASTER,
+                            "stream", stream,
+                            NULL);
+
+    for (i = 0; i < NULL_CONTROL_CHANNELS; i++)
+        control->priv->volume[i] = NULL_CONTROL_MAX_VOLUME;
+
+    return control;
+}
+
+/* Simulates a change made outside of the application */
+void
+null_stream_control_update_volume (NullStreamControl *control, guint volume)
+{
+    g_return_if_fail (NULL_IS_STREAM_CONTROL (control));
+
+    null_stream_control_set_volume (MATE_MIXER_STREAM_CONTROL (control), volume);
+}
+
+static gboolean
+null_stream_control_set_mute (MateMixerStreamControl *mmsc, gboolean mute)
+{
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    /* The base class stores the new value */
+    return TRUE;
+}
+
+static guint
+null_stream_control_get_num_channels (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), 0);
+
+    return NULL_CONTROL_CHANNELS;
+}
+
+static guint
+null_stream_control_get_volume (MateMixerStreamControl *mmsc)
+{
+    NullStreamControl *control;
+
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), 0);
+
+    control = NULL_STREAM_CONTROL (mmsc);
+
+    return MAX (control->priv->volume[0], control->priv->volume[1]);
+}
+
+static gboolean
+null_stream_control_set_volume (MateMixerStreamControl *mmsc, guint volume)
+{
+    NullStreamControl *control;
+    gboolean           changed = FALSE;
+    guint              i;
+
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = NULL_STREAM_CONTROL (mmsc);
+    volume  = MIN (volume, NULL_CONTROL_MAX_VOLUME);
+
+    for (i = 0; i < NULL_CONTROL_CHANNELS; i++) {
+        if (control->priv->volume[i] != volume) {
+            control->priv->volume[i] = volume;
+            changed = TRUE;
+        }
+    }
+
+    if (changed == TRUE) {
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
+        g_object_notify (G_OBJECT (control), "volume");
+    }
+
+    return TRUE;
+}
+
+static gboolean
+null_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                          MateMixerChannelPosition position)
+{
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    return position == MATE_MIXER_CHANNEL_FRONT_LEFT ||
+           position == MATE_MIXER_CHANNEL_FRONT_RIGHT;
+}
+
+static MateMixerChannelPosition
+null_stream_control_get_channel_position (MateMixerStreamControl *mmsc, guint channel)
+{
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), MATE_MIXER_CHANNEL_UNKNOWN);
+
+    switch (channel) {
+    case 0:
+        return MATE_MIXER_CHANNEL_FRONT_LEFT;
+    case 1:
+        return MATE_MIXER_CHANNEL_FRONT_RIGHT;
+    default:
+        return MATE_MIXER_CHANNEL_UNKNOWN;
+    }
+}
+
+static guint
+null_stream_control_get_channel_volume (MateMixerStreamControl *mmsc, guint channel)
+{
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), 0);
+
+    if (channel >= NULL_CONTROL_CHANNELS)
+        return 0;
+
+    return NULL_STREAM_CONTROL (mmsc)->priv->volume[channel];
+}
+
+static gboolean
+null_stream_control_set_channel_volume (MateMixerStreamControl *mmsc,
+                                        guint                   channel,
+                                        guint                   volume)
+{
+    NullStreamControl *control;
+
+    g_return_val_if_fail (NULL_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    if (channel >= NULL_CONTROL_CHANNELS)
+        return FALSE;
+
+    control = NULL_STREAM_CONTROL (mmsc);
+    volume  = MIN (volume, NULL_CONTROL_MAX_VOLUME);
+
+    if (control->priv->volume[channel] != volume) {
+        control->priv->volume[channel] = volume;
+
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
+        g_object_notify (G_OBJECT (control), "volume");
+    }
+    return TRUE;
+}
+
+static guint
+null_stream_control_get_min_volume (MateMixerStreamControl *mmsc)
+{
+    return 0;
+}
+
+static guint
+null_stream_control_get_max_volume (MateMixerStreamControl *mmsc)
+{
+    return NULL_CONTROL_MAX_VOLUME;
+}
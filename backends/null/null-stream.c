@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "null-device.h"
+#include "null-stream.h"
+#include "null-stream-control.h"
+
+struct _NullStreamPrivate
+{
+    GList *controls;
+};
+
+static void null_stream_class_init (NullStreamClass *klass);
+static void null_stream_init       (NullStream      *stream);
+static void null_stream_dispose    (GObject         *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (NullStream, null_stream, MATE_MIXER_TYPE_STREAM)
+
+static const GList *null_stream_list_controls (MateMixerStream *mms);
+
+static void
+null_stream_class_init (NullStreamClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerStreamClass *stream_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = null_stream_dispose;
+
+    stream_class = MATE_MIXER_STREAM_CLASS (klass);
+    stream_class->list_controls = null_stream_list_controls;
+}
+
+static void
+null_stream_init (NullStream *stream)
+{
+    stream->priv = null_stream_get_instance_private (stream);
+}
+
+static void
+null_stream_dispose (GObject *object)
+{
+    NullStream *stream;
+
+    stream = NULL_STREAM (object);
+
+    if (stream->priv->controls != NULL) {
+        g_list_free_full (stream->priv->controls, g_object_unref);
+        stream->priv->controls = NULL;
+    }
+
+    G_OBJECT_CLASS (null_stream_parent_class)->dispose (object);
+}
+
+NullStream *
+null_stream_new (const gchar        *name,
+                 const gchar        *label,
+                 NullDevice         *device,
+                 MateMixerDirection  direction)
+{
+    g_return_val_if_fail (name  != NULL, NULL);
+    g_return_val_if_fail (label != NULL, NULL);
+    g_return_val_if_fail (NULL_IS_DEVICE (device), NULL);
+
+    return g_object_new (NULL_TYPE_STREAM,
+                         "name", name,
+                         "label", label,
+                         "device", device,
+                         "direction", direction,
+                         NULL);
+}
+
+void
+null_stream_add_control (NullStream *stream, NullStreamControl *control)
+{
+    g_return_if_fail (NULL_IS_STREAM (stream));
+    g_return_if_fail (NULL_IS_STREAM_CONTROL (control));
+
+    stream->priv->controls = g_list_append (stream->priv->controls,
+                                            g_object_ref (control));
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "control-added",
+                           mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (control)));
+
+    /* The first control of the stream is its default control */
+    if (stream->priv->controls->next == NULL)
+        _mate_mixer_stream_set_default_control (MATE_MIXER_STREAM (stream),
+                                                MATE_MIXER_STREAM_CONTROL (control));
+}
+
+static const GList *
+null_stream_list_controls (MateMixerStream *mms)
+{
+    g_return_val_if_fail (NULL_IS_STREAM (mms), NULL);
+
+    return NULL_STREAM (mms)->priv->controls;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NULL_STREAM_H
+#define NULL_STREAM_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "null-types.h"
+
+G_BEGIN_DECLS
+
+#define NULL_TYPE_STREAM                        \
+        (null_stream_get_type ())
+#define NULL_STREAM(o)                          \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), NULL_TYPE_STREAM, NullStream))
+#define NULL_IS_STREAM(o)                       \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), NULL_TYPE_STREAM))
+#define NULL_STREAM_CLASS(k)                    \
+        (G_TYPE_CHECK_CLASS_CAST ((k), NULL_TYPE_STREAM, NullStreamClass))
+#define NULL_IS_STREAM_CLASS(k)                 \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), NULL_TYPE_STREAM))
+#define NULL_STREAM_GET_CLASS(o)                \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), NULL_TYPE_STREAM, NullStreamClass))
+
+typedef struct _NullStreamClass    NullStreamClass;
+typedef struct _NullStreamPrivate  NullStreamPrivate;
+
+struct _NullStream
+{
+    MateMixerStream parent;
+
+    /*< private >*/
+    NullStreamPrivate *priv;
+};
+
+struct _NullStreamClass
+{
+    MateMixerStreamClass parent_class;
+};
+
+GType       null_stream_get_type    (void) G_GNUC_CONST;
+
+NullStream *null_stream_new         (const gchar        *name,
+                                     const gchar        *label,
+                                     NullDevice         *device,
+                                     MateMixerDirection  direction);
+
+void        null_stream_add_control (NullStream         *stream,
+                                     NullStreamControl  *control);
+
+G_END_DECLS
+
+#endif /* NULL_STREAM_H */
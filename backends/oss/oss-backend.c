@@ -197,6 +197,14 @@ oss_backend_open (MateMixerBackend *backend)
 
     oss = OSS_BACKEND (backend);
 
+    /* OSS only provides devices and their streams, when the application
+     * uses neither of them, there is no need to poll the mixer devices */
+    if ((mate_mixer_backend_get_interests (backend) &
+        (MATE_MIXER_INTEREST_DEVICES | MATE_MIXER_INTEREST_STREAMS)) == 0) {
+        _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_READY);
+        return TRUE;
+    }
+
     /* Discover added or removed OSS devices every second */
     oss->priv->timeout_source = g_timeout_source_new_seconds (1);
     g_source_set_callback (oss->priv->timeout_source,
@@ -224,7 +232,11 @@ oss_backend_close (MateMixerBackend *backend)
 
     oss = OSS_BACKEND (backend);
 
-    g_source_destroy (oss->priv->timeout_source);
+    if (oss->priv->timeout_source != NULL) {
+        g_source_destroy (oss->priv->timeout_source);
+        g_source_unref (oss->priv->timeout_source);
+        oss->priv->timeout_source = NULL;
+    }
 
     if (oss->priv->devices != NULL) {
         g_list_free_full (oss->priv->devices, g_object_unref);
@@ -23,6 +23,7 @@
 
 #include <libmatemixer/matemixer.h>
 #include <libmatemixer/matemixer-private.h>
+#include <libmatemixer/matemixer-trace-private.h>
 
 #include "oss-common.h"
 #include "oss-device.h"
@@ -682,12 +683,20 @@ poll_mixer (OssDevice *device)
     }
 #endif
 
+    MATE_MIXER_TRACE (oss_poll_mixer, device->priv->fd, load, device->priv->poll_mode);
+
     if (load == TRUE) {
+        G_GNUC_UNUSED gint64 start = MATE_MIXER_TRACE_TIMESTAMP ();
+
         if (device->priv->input != NULL)
             oss_stream_load (device->priv->input);
         if (device->priv->output != NULL)
             oss_stream_load (device->priv->output);
 
+        MATE_MIXER_TRACE (oss_poll_mixer_loaded,
+                          device->priv->fd,
+                          MATE_MIXER_TRACE_TIMESTAMP () - start);
+
         if (device->priv->poll_use_counter == TRUE &&
             device->priv->poll_mode == OSS_POLL_NORMAL) {
             /* Create a new rapid source */
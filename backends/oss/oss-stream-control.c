@@ -402,6 +402,8 @@ store_volume (OssStreamControl *control, gint volume)
 
         g_object_freeze_notify (G_OBJECT (control));
 
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
         g_object_notify (G_OBJECT (control), "volume");
 
         /* Emits signal if balance has changed */
@@ -415,6 +417,8 @@ store_volume (OssStreamControl *control, gint volume)
 
         control->priv->volume[LEFT_CHANNEL] = volume;
 
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
         g_object_notify (G_OBJECT (control), "volume");
     }
 }
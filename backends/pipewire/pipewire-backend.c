@@ -0,0 +1,1244 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <glib.h>
+#include <glib-unix.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include <pipewire/pipewire.h>
+#include <pipewire/extensions/metadata.h>
+#include <spa/param/param.h>
+
+#include "pipewire-backend.h"
+#include "pipewire-device.h"
+#include "pipewire-helpers.h"
+#include "pipewire-stream.h"
+#include "pipewire-stream-control.h"
+
+#define BACKEND_NAME      "PipeWire"
+#define BACKEND_PRIORITY  150
+#define BACKEND_FLAGS     (MATE_MIXER_BACKEND_HAS_APPLICATION_CONTROLS |        \
+                           MATE_MIXER_BACKEND_CAN_SET_DEFAULT_INPUT_STREAM |    \
+                           MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM)
+
+#define PIPEWIRE_STATISTICS(p)                                          \
+    (_mate_mixer_backend_get_statistics (MATE_MIXER_BACKEND (p)))
+
+/* Keys of the "default" metadata object maintained by the session manager,
+ * the configured keys are written and the effective keys are followed */
+#define DEFAULT_METADATA_NAME       "default"
+#define DEFAULT_SINK_KEY            "default.audio.sink"
+#define DEFAULT_SOURCE_KEY          "default.audio.source"
+#define DEFAULT_CONFIGURED_SINK_KEY "default.configured.audio.sink"
+#define DEFAULT_CONFIGURED_SRC_KEY  "default.configured.audio.source"
+#define TARGET_OBJECT_KEY           "target.object"
+
+typedef struct {
+    PipewireBackend       *pipewire;
+    guint32                id;
+    guint32                device_id;
+    gchar                 *serial;
+    PipewireNodeKind       kind;
+    struct pw_node        *proxy;
+    struct spa_hook        listener;
+    gboolean               ignored;
+    PipewireStream        *stream;
+    PipewireStream        *parent;
+    PipewireStreamControl *control;
+} PipewireNode;
+
+typedef struct {
+    guint32 output_node;
+    guint32 input_node;
+} PipewireLink;
+
+struct _PipewireBackendPrivate
+{
+    gchar              *server_address;
+    MateMixerAppInfo   *app_info;
+    struct pw_loop     *loop;
+    struct pw_context  *context;
+    struct pw_core     *core;
+    struct pw_registry *registry;
+    struct pw_metadata *metadata;
+    guint32             metadata_id;
+    struct spa_hook     core_listener;
+    struct spa_hook     registry_listener;
+    struct spa_hook     metadata_listener;
+    GSource            *source;
+    gint                sync_seq;
+    guint               sync_round;
+    gboolean            failed;
+    GHashTable         *devices;
+    GHashTable         *nodes;
+    GHashTable         *links;
+    GList              *devices_list;
+    GList              *streams_list;
+    gchar              *default_sink;
+    gchar              *default_source;
+};
+
+static void pipewire_backend_dispose  (GObject *object);
+static void pipewire_backend_finalize (GObject *object);
+
+G_DEFINE_DYNAMIC_TYPE_EXTENDED (PipewireBackend, pipewire_backend, MATE_MIXER_TYPE_BACKEND, 0, G_ADD_PRIVATE_DYNAMIC(PipewireBackend))
+
+static gboolean         pipewire_backend_open                      (MateMixerBackend *backend);
+static void             pipewire_backend_close                     (MateMixerBackend *backend);
+
+static void             pipewire_backend_set_app_info              (MateMixerBackend *backend,
+                                                                    MateMixerAppInfo *info);
+
+static void             pipewire_backend_set_server_address        (MateMixerBackend *backend,
+                                                                    const gchar      *address);
+
+static const GList *    pipewire_backend_list_devices              (MateMixerBackend *backend);
+static const GList *    pipewire_backend_list_streams              (MateMixerBackend *backend);
+
+static gboolean         pipewire_backend_set_default_input_stream  (MateMixerBackend *backend,
+                                                                    MateMixerStream  *stream);
+
+static gboolean         pipewire_backend_set_default_output_stream (MateMixerBackend *backend,
+                                                                    MateMixerStream  *stream);
+
+static gboolean         on_loop_ready               (gint                        fd,
+                                                     GIOCondition                condition,
+                                                     PipewireBackend            *pipewire);
+
+static void             on_core_done                (void                       *data,
+                                                     uint32_t                    id,
+                                                     int                         seq);
+static void             on_core_error               (void                       *data,
+                                                     uint32_t                    id,
+                                                     int                         seq,
+                                                     int                         res,
+                                                     const char                 *message);
+
+static void             on_registry_global          (void                       *data,
+                                                     uint32_t                    id,
+                                                     uint32_t                    permissions,
+                                                     const char                 *type,
+                                                     uint32_t                    version,
+                                                     const struct spa_dict      *props);
+static void             on_registry_global_remove   (void                       *data,
+                                                     uint32_t                    id);
+
+static void             on_node_info                (void                       *data,
+                                                     const struct pw_node_info  *info);
+static void             on_node_param               (void                       *data,
+                                                     int                         seq,
+                                                     uint32_t                    id,
+                                                     uint32_t                    index,
+                                                     uint32_t                    next,
+                                                     const struct spa_pod       *param);
+
+static int              on_metadata_property        (void                       *data,
+                                                     uint32_t                    subject,
+                                                     const char                 *key,
+                                                     const char                 *type,
+                                                     const char                 *value);
+
+static void             add_device                  (PipewireBackend            *pipewire,
+                                                     guint32                     id,
+                                                     const struct spa_dict      *props);
+static void             add_node                    (PipewireBackend            *pipewire,
+                                                     guint32                     id,
+                                                     const char                 *type,
+                                                     const struct spa_dict      *props);
+static void             add_link                    (PipewireBackend            *pipewire,
+                                                     guint32                     id,
+                                                     const struct spa_dict      *props);
+static void             add_metadata                (PipewireBackend            *pipewire,
+                                                     guint32                     id,
+                                                     const char                 *type,
+                                                     const struct spa_dict      *props);
+
+static void             remove_device               (PipewireBackend            *pipewire,
+                                                     guint32                     id,
+                                                     PipewireDevice             *device);
+static void             remove_node                 (PipewireBackend            *pipewire,
+                                                     PipewireNode               *node);
+static void             remove_metadata             (PipewireBackend            *pipewire);
+
+static void             create_node_objects         (PipewireBackend            *pipewire,
+                                                     PipewireNode               *node,
+                                                     const struct spa_dict      *props);
+
+static void             apply_link                  (PipewireBackend            *pipewire,
+                                                     PipewireLink               *link);
+static void             apply_node_links            (PipewireBackend            *pipewire,
+                                                     PipewireNode               *node);
+
+static void             attach_control              (PipewireNode               *node,
+                                                     PipewireStream             *stream);
+static void             detach_control              (PipewireNode               *node);
+
+static void             update_default_stream       (PipewireBackend            *pipewire,
+                                                     MateMixerDirection          direction);
+
+static gboolean         write_default_stream        (PipewireBackend            *pipewire,
+                                                     const gchar                *key,
+                                                     MateMixerStream            *stream);
+
+static void             free_node                   (PipewireNode               *node);
+
+static void             free_list_devices           (PipewireBackend            *pipewire);
+static void             free_list_streams           (PipewireBackend            *pipewire);
+
+static const struct pw_core_events core_events = {
+    PW_VERSION_CORE_EVENTS,
+    .done  = on_core_done,
+    .error = on_core_error,
+};
+
+static const struct pw_registry_events registry_events = {
+    PW_VERSION_REGISTRY_EVENTS,
+    .global        = on_registry_global,
+    .global_remove = on_registry_global_remove,
+};
+
+static const struct pw_node_events node_events = {
+    PW_VERSION_NODE_EVENTS,
+    .info  = on_node_info,
+    .param = on_node_param,
+};
+
+static const struct pw_metadata_events metadata_events = {
+    PW_VERSION_METADATA_EVENTS,
+    .property = on_metadata_property,
+};
+
+static MateMixerBackendInfo info;
+
+void
+backend_module_init (GTypeModule *module)
+{
+    pipewire_backend_register_type (module);
+
+    info.name          = BACKEND_NAME;
+    info.priority      = BACKEND_PRIORITY;
+    info.g_type        = PIPEWIRE_TYPE_BACKEND;
+    info.backend_flags = BACKEND_FLAGS;
+    info.backend_type  = MATE_MIXER_BACKEND_PIPEWIRE;
+}
+
+const MateMixerBackendInfo *backend_module_get_info (void)
+{
+    return &info;
+}
+
+static void
+pipewire_backend_class_init (PipewireBackendClass *klass)
+{
+    GObjectClass          *object_class;
+    MateMixerBackendClass *backend_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose  = pipewire_backend_dispose;
+    object_class->finalize = pipewire_backend_finalize;
+
+    backend_class = MATE_MIXER_BACKEND_CLASS (klass);
+    backend_class->set_app_info              = pipewire_backend_set_app_info;
+    backend_class->set_server_address        = pipewire_backend_set_server_address;
+    backend_class->open                      = pipewire_backend_open;
+    backend_class->close                     = pipewire_backend_close;
+    backend_class->list_devices              = pipewire_backend_list_devices;
+    backend_class->list_streams              = pipewire_backend_list_streams;
+    backend_class->set_default_input_stream  = pipewire_backend_set_default_input_stream;
+    backend_class->set_default_output_stream = pipewire_backend_set_default_output_stream;
+}
+
+/* Called in the code generated by G_DEFINE_DYNAMIC_TYPE() */
+static void
+pipewire_backend_class_finalize (PipewireBackendClass *klass)
+{
+}
+
+static void
+pipewire_backend_init (PipewireBackend *pipewire)
+{
+    pipewire->priv = pipewire_backend_get_instance_private (pipewire);
+
+    /* All the tables are indexed by the PipeWire global ids */
+    pipewire->priv->devices =
+        g_hash_table_new_full (g_direct_hash,
+                               g_direct_equal,
+                               NULL,
+                               g_object_unref);
+
+    pipewire->priv->nodes =
+        g_hash_table_new_full (g_direct_hash,
+                               g_direct_equal,
+                               NULL,
+                               (GDestroyNotify) free_node);
+
+    pipewire->priv->links =
+        g_hash_table_new_full (g_direct_hash,
+                               g_direct_equal,
+                               NULL,
+                               g_free);
+
+    pipewire->priv->metadata_id = PW_ID_ANY;
+}
+
+static void
+pipewire_backend_dispose (GObject *object)
+{
+    MateMixerBackend *backend;
+    MateMixerState    state;
+
+    backend = MATE_MIXER_BACKEND (object);
+
+    state = mate_mixer_backend_get_state (backend);
+    if (state != MATE_MIXER_STATE_IDLE)
+        pipewire_backend_close (backend);
+
+    G_OBJECT_CLASS (pipewire_backend_parent_class)->dispose (object);
+}
+
+static void
+pipewire_backend_finalize (GObject *object)
+{
+    PipewireBackend *pipewire;
+
+    pipewire = PIPEWIRE_BACKEND (object);
+
+    if (pipewire->priv->app_info != NULL)
+        _mate_mixer_app_info_unref (pipewire->priv->app_info);
+
+    g_free (pipewire->priv->server_address);
+
+    g_hash_table_unref (pipewire->priv->devices);
+    g_hash_table_unref (pipewire->priv->nodes);
+    g_hash_table_unref (pipewire->priv->links);
+
+    G_OBJECT_CLASS (pipewire_backend_parent_class)->finalize (object);
+}
+
+struct pw_core *
+pipewire_backend_get_core (PipewireBackend *pipewire)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (pipewire), NULL);
+
+    return pipewire->priv->core;
+}
+
+gboolean
+pipewire_backend_move_node (PipewireBackend *pipewire,
+                            guint32          id,
+                            PipewireStream  *stream)
+{
+    PipewireNode *target;
+
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (pipewire), FALSE);
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM (stream), FALSE);
+
+    if (pipewire->priv->metadata == NULL)
+        return FALSE;
+
+    target = g_hash_table_lookup (pipewire->priv->nodes,
+                                  GUINT_TO_POINTER (pipewire_stream_get_id (stream)));
+    if (target == NULL || target->serial == NULL)
+        return FALSE;
+
+    /* The session manager relinks the node and remembers the choice */
+    pw_metadata_set_property (pipewire->priv->metadata,
+                              id,
+                              TARGET_OBJECT_KEY,
+                              "Spa:Id",
+                              target->serial);
+    return TRUE;
+}
+
+#define PIPEWIRE_APP_NAME(p)    (mate_mixer_app_info_get_name (p->priv->app_info))
+#define PIPEWIRE_APP_ID(p)      (mate_mixer_app_info_get_id (p->priv->app_info))
+#define PIPEWIRE_APP_VERSION(p) (mate_mixer_app_info_get_version (p->priv->app_info))
+#define PIPEWIRE_APP_ICON(p)    (mate_mixer_app_info_get_icon (p->priv->app_info))
+
+static gboolean
+pipewire_backend_open (MateMixerBackend *backend)
+{
+    PipewireBackend      *pipewire;
+    struct pw_properties *props;
+
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (backend), FALSE);
+
+    pipewire = PIPEWIRE_BACKEND (backend);
+
+    if (G_UNLIKELY (pipewire->priv->core != NULL)) {
+        g_warn_if_reached ();
+        return TRUE;
+    }
+
+    pw_init (NULL, NULL);
+
+    /* The PipeWire loop is not run by itself, it is dispatched from the GLib
+     * main loop whenever its file descriptor becomes readable */
+    pipewire->priv->loop = pw_loop_new (NULL);
+    if (G_UNLIKELY (pipewire->priv->loop == NULL)) {
+        _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_FAILED);
+        return FALSE;
+    }
+    pw_loop_enter (pipewire->priv->loop);
+
+    pipewire->priv->context = pw_context_new (pipewire->priv->loop, NULL, 0);
+    if (G_UNLIKELY (pipewire->priv->context == NULL)) {
+        pipewire_backend_close (backend);
+        _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_FAILED);
+        return FALSE;
+    }
+
+    props = pw_properties_new (NULL, NULL);
+
+    if (pipewire->priv->app_info != NULL) {
+        pw_properties_set (props, PW_KEY_APP_NAME, PIPEWIRE_APP_NAME (pipewire));
+        pw_properties_set (props, PW_KEY_APP_ID, PIPEWIRE_APP_ID (pipewire));
+        pw_properties_set (props, PW_KEY_APP_VERSION, PIPEWIRE_APP_VERSION (pipewire));
+        pw_properties_set (props, PW_KEY_APP_ICON_NAME, PIPEWIRE_APP_ICON (pipewire));
+    }
+    if (pipewire->priv->server_address != NULL)
+        pw_properties_set (props, PW_KEY_REMOTE_NAME, pipewire->priv->server_address);
+
+    /* Connecting to the local socket either succeeds or fails right away,
+     * a failure lets the context try the next backend */
+    pipewire->priv->core = pw_context_connect (pipewire->priv->context, props, 0);
+    if (pipewire->priv->core == NULL) {
+        g_debug ("Failed to connect to PipeWire: %s", g_strerror (errno));
+
+        pipewire_backend_close (backend);
+        _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_FAILED);
+        return FALSE;
+    }
+
+    pw_core_add_listener (pipewire->priv->core,
+                          &pipewire->priv->core_listener,
+                          &core_events,
+                          pipewire);
+
+    pipewire->priv->registry = pw_core_get_registry (pipewire->priv->core,
+                                                     PW_VERSION_REGISTRY,
+                                                     0);
+    pw_registry_add_listener (pipewire->priv->registry,
+                              &pipewire->priv->registry_listener,
+                              &registry_events,
+                              pipewire);
+
+    pipewire->priv->sync_round = 0;
+    pipewire->priv->sync_seq   = pw_core_sync (pipewire->priv->core, PW_ID_CORE, 0);
+
+    /* Dispatch in the main context of the thread which owns the backend,
+     * which is not necessarily the global default one */
+    pipewire->priv->source = g_unix_fd_source_new (pw_loop_get_fd (pipewire->priv->loop),
+                                                   G_IO_IN);
+    g_source_set_callback (pipewire->priv->source,
+                           (GSourceFunc) on_loop_ready,
+                           pipewire,
+                           NULL);
+    g_source_attach (pipewire->priv->source, g_main_context_get_thread_default ());
+
+    _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_CONNECTING);
+    return TRUE;
+}
+
+static void
+pipewire_backend_close (MateMixerBackend *backend)
+{
+    PipewireBackend *pipewire;
+    GHashTableIter   iter;
+    PipewireNode    *node;
+
+    g_return_if_fail (PIPEWIRE_IS_BACKEND (backend));
+
+    pipewire = PIPEWIRE_BACKEND (backend);
+
+    if (pipewire->priv->source != NULL) {
+        g_source_destroy (pipewire->priv->source);
+        g_clear_pointer (&pipewire->priv->source, g_source_unref);
+    }
+
+    /* Controls may outlive the backend, make sure none of them refers to
+     * the connection after it is closed */
+    g_hash_table_iter_init (&iter, pipewire->priv->nodes);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &node) == TRUE)
+        if (node->control != NULL)
+            pipewire_stream_control_detach (node->control);
+
+    free_list_devices (pipewire);
+    free_list_streams (pipewire);
+
+    g_hash_table_remove_all (pipewire->priv->nodes);
+    g_hash_table_remove_all (pipewire->priv->links);
+    g_hash_table_remove_all (pipewire->priv->devices);
+
+    remove_metadata (pipewire);
+
+    if (pipewire->priv->registry != NULL) {
+        spa_hook_remove (&pipewire->priv->registry_listener);
+
+        pw_proxy_destroy ((struct pw_proxy *) pipewire->priv->registry);
+        pipewire->priv->registry = NULL;
+    }
+    if (pipewire->priv->core != NULL) {
+        spa_hook_remove (&pipewire->priv->core_listener);
+
+        pw_core_disconnect (pipewire->priv->core);
+        pipewire->priv->core = NULL;
+    }
+    if (pipewire->priv->context != NULL) {
+        pw_context_destroy (pipewire->priv->context);
+        pipewire->priv->context = NULL;
+    }
+    if (pipewire->priv->loop != NULL) {
+        pw_loop_leave (pipewire->priv->loop);
+        pw_loop_destroy (pipewire->priv->loop);
+        pipewire->priv->loop = NULL;
+    }
+
+    g_clear_pointer (&pipewire->priv->default_sink, g_free);
+    g_clear_pointer (&pipewire->priv->default_source, g_free);
+
+    pipewire->priv->failed = FALSE;
+
+    _mate_mixer_backend_set_state (backend, MATE_MIXER_STATE_IDLE);
+}
+
+static void
+pipewire_backend_set_app_info (MateMixerBackend *backend, MateMixerAppInfo *info)
+{
+    PipewireBackend *pipewire;
+
+    g_return_if_fail (PIPEWIRE_IS_BACKEND (backend));
+    g_return_if_fail (info != NULL);
+
+    pipewire = PIPEWIRE_BACKEND (backend);
+
+    if (pipewire->priv->app_info != NULL)
+        _mate_mixer_app_info_unref (pipewire->priv->app_info);
+
+    pipewire->priv->app_info = _mate_mixer_app_info_ref (info);
+}
+
+static void
+pipewire_backend_set_server_address (MateMixerBackend *backend, const gchar *address)
+{
+    g_return_if_fail (PIPEWIRE_IS_BACKEND (backend));
+
+    g_free (PIPEWIRE_BACKEND (backend)->priv->server_address);
+
+    PIPEWIRE_BACKEND (backend)->priv->server_address = g_strdup (address);
+}
+
+static const GList *
+pipewire_backend_list_devices (MateMixerBackend *backend)
+{
+    PipewireBackend *pipewire;
+
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (backend), NULL);
+
+    pipewire = PIPEWIRE_BACKEND (backend);
+
+    if (pipewire->priv->devices_list == NULL) {
+        pipewire->priv->devices_list = g_hash_table_get_values (pipewire->priv->devices);
+        if (pipewire->priv->devices_list != NULL)
+            g_list_foreach (pipewire->priv->devices_list, (GFunc) g_object_ref, NULL);
+    }
+    return pipewire->priv->devices_list;
+}
+
+static const GList *
+pipewire_backend_list_streams (MateMixerBackend *backend)
+{
+    PipewireBackend *pipewire;
+
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (backend), NULL);
+
+    pipewire = PIPEWIRE_BACKEND (backend);
+
+    if (pipewire->priv->streams_list == NULL) {
+        GHashTableIter  iter;
+        PipewireNode   *node;
+
+        g_hash_table_iter_init (&iter, pipewire->priv->nodes);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &node) == TRUE)
+            if (node->stream != NULL)
+                pipewire->priv->streams_list =
+                    g_list_prepend (pipewire->priv->streams_list,
+                                    g_object_ref (node->stream));
+    }
+    return pipewire->priv->streams_list;
+}
+
+static gboolean
+pipewire_backend_set_default_input_stream (MateMixerBackend *backend,
+                                           MateMixerStream  *stream)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM (stream), FALSE);
+
+    return write_default_stream (PIPEWIRE_BACKEND (backend),
+                                 DEFAULT_CONFIGURED_SRC_KEY,
+                                 stream);
+}
+
+static gboolean
+pipewire_backend_set_default_output_stream (MateMixerBackend *backend,
+                                            MateMixerStream  *stream)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM (stream), FALSE);
+
+    return write_default_stream (PIPEWIRE_BACKEND (backend),
+                                 DEFAULT_CONFIGURED_SINK_KEY,
+                                 stream);
+}
+
+static gboolean
+on_loop_ready (gint fd, GIOCondition condition, PipewireBackend *pipewire)
+{
+    pw_loop_iterate (pipewire->priv->loop, 0);
+
+    /* Failures are reported from within the loop, but the connection can
+     * only be closed once the loop is not being dispatched */
+    if (pipewire->priv->failed == TRUE) {
+        g_clear_pointer (&pipewire->priv->source, g_source_unref);
+
+        _mate_mixer_backend_set_state (MATE_MIXER_BACKEND (pipewire),
+                                       MATE_MIXER_STATE_FAILED);
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+on_core_done (void *data, uint32_t id, int seq)
+{
+    PipewireBackend *pipewire;
+
+    pipewire = PIPEWIRE_BACKEND (data);
+
+    if (id != PW_ID_CORE || seq != pipewire->priv->sync_seq)
+        return;
+
+    /* The first round lists the globals, the second one makes sure the
+     * information about the bound nodes has been received as well */
+    if (++pipewire->priv->sync_round < 2) {
+        pipewire->priv->sync_seq = pw_core_sync (pipewire->priv->core, PW_ID_CORE, seq);
+        return;
+    }
+
+    _mate_mixer_backend_set_state (MATE_MIXER_BACKEND (pipewire),
+                                   MATE_MIXER_STATE_READY);
+}
+
+static void
+on_core_error (void       *data,
+               uint32_t    id,
+               int         seq,
+               int         res,
+               const char *message)
+{
+    PipewireBackend *pipewire;
+
+    pipewire = PIPEWIRE_BACKEND (data);
+
+    g_debug ("PipeWire error on object %u: %s", id, message);
+
+    /* Only a broken connection to the server is fatal */
+    if (id == PW_ID_CORE && res == -EPIPE)
+        pipewire->priv->failed = TRUE;
+}
+
+static void
+on_registry_global (void                  *data,
+                    uint32_t               id,
+                    uint32_t               permissions,
+                    const char            *type,
+                    uint32_t               version,
+                    const struct spa_dict *props)
+{
+    PipewireBackend *pipewire;
+
+    pipewire = PIPEWIRE_BACKEND (data);
+
+    if (props == NULL)
+        return;
+
+    if (strcmp (type, PW_TYPE_INTERFACE_Node) == 0)
+        add_node (pipewire, id, type, props);
+    else if (strcmp (type, PW_TYPE_INTERFACE_Link) == 0)
+        add_link (pipewire, id, props);
+    else if (strcmp (type, PW_TYPE_INTERFACE_Device) == 0)
+        add_device (pipewire, id, props);
+    else if (strcmp (type, PW_TYPE_INTERFACE_Metadata) == 0)
+        add_metadata (pipewire, id, type, props);
+}
+
+static void
+on_registry_global_remove (void *data, uint32_t id)
+{
+    PipewireBackend *pipewire;
+    PipewireDevice  *device;
+    PipewireNode    *node;
+
+    pipewire = PIPEWIRE_BACKEND (data);
+
+    /* The ids are shared by all the kinds of objects */
+    node = g_hash_table_lookup (pipewire->priv->nodes, GUINT_TO_POINTER (id));
+    if (node != NULL) {
+        remove_node (pipewire, node);
+        return;
+    }
+
+    if (g_hash_table_remove (pipewire->priv->links, GUINT_TO_POINTER (id)) == TRUE)
+        return;
+
+    device = g_hash_table_lookup (pipewire->priv->devices, GUINT_TO_POINTER (id));
+    if (device != NULL) {
+        remove_device (pipewire, id, device);
+        return;
+    }
+
+    if (id == pipewire->priv->metadata_id)
+        remove_metadata (pipewire);
+}
+
+static void
+on_node_info (void *data, const struct pw_node_info *info)
+{
+    PipewireNode *node = data;
+
+    /* The properties of the node are only used to create the objects */
+    if (node->ignored == TRUE || node->control != NULL)
+        return;
+
+    if ((info->change_mask & PW_NODE_CHANGE_MASK_PROPS) == 0 || info->props == NULL)
+        return;
+
+    create_node_objects (node->pipewire, node, info->props);
+}
+
+static void
+on_node_param (void                 *data,
+               int                   seq,
+               uint32_t              id,
+               uint32_t              index,
+               uint32_t              next,
+               const struct spa_pod *param)
+{
+    PipewireNode *node = data;
+
+    if (id != SPA_PARAM_Props || param == NULL || node->control == NULL)
+        return;
+
+    _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (node->pipewire),
+                                      MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+
+    pipewire_stream_control_update_props (node->control, param);
+}
+
+static int
+on_metadata_property (void       *data,
+                      uint32_t    subject,
+                      const char *key,
+                      const char *type,
+                      const char *value)
+{
+    PipewireBackend *pipewire;
+
+    pipewire = PIPEWIRE_BACKEND (data);
+
+    if (subject != PW_ID_CORE)
+        return 0;
+
+    /* A missing key means that all the properties have been removed */
+    if (key == NULL || strcmp (key, DEFAULT_SINK_KEY) == 0) {
+        g_free (pipewire->priv->default_sink);
+
+        pipewire->priv->default_sink = (value != NULL)
+            ? pipewire_parse_metadata_name (value)
+            : NULL;
+
+        update_default_stream (pipewire, MATE_MIXER_DIRECTION_OUTPUT);
+    }
+    if (key == NULL || strcmp (key, DEFAULT_SOURCE_KEY) == 0) {
+        g_free (pipewire->priv->default_source);
+
+        pipewire->priv->default_source = (value != NULL)
+            ? pipewire_parse_metadata_name (value)
+            : NULL;
+
+        update_default_stream (pipewire, MATE_MIXER_DIRECTION_INPUT);
+    }
+    return 0;
+}
+
+static void
+add_device (PipewireBackend *pipewire, guint32 id, const struct spa_dict *props)
+{
+    PipewireDevice *device;
+    const gchar    *prop;
+    const gchar    *name;
+    const gchar    *label;
+
+    prop = spa_dict_lookup (props, PW_KEY_MEDIA_CLASS);
+    if (prop == NULL || strcmp (prop, "Audio/Device") != 0)
+        return;
+
+    name = spa_dict_lookup (props, PW_KEY_DEVICE_NAME);
+    if (name == NULL)
+        return;
+
+    label = spa_dict_lookup (props, PW_KEY_DEVICE_DESCRIPTION);
+    if (label == NULL)
+        label = spa_dict_lookup (props, PW_KEY_DEVICE_NICK);
+    if (label == NULL)
+        label = name;
+
+    device = pipewire_device_new (name,
+                                  label,
+                                  spa_dict_lookup (props, PW_KEY_DEVICE_ICON_NAME));
+
+    g_hash_table_insert (pipewire->priv->devices, GUINT_TO_POINTER (id), device);
+
+    _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (pipewire),
+                                      MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+    free_list_devices (pipewire);
+    g_signal_emit_by_name (G_OBJECT (pipewire),
+                           "device-added",
+                           name);
+}
+
+static void
+add_node (PipewireBackend       *pipewire,
+          guint32                id,
+          const char            *type,
+          const struct spa_dict *props)
+{
+    PipewireNode     *node;
+    PipewireNodeKind  kind;
+    const gchar      *prop;
+    guint32           ids[] = { SPA_PARAM_Props };
+
+    prop = spa_dict_lookup (props, PW_KEY_MEDIA_CLASS);
+    if (prop == NULL)
+        return;
+
+    if (strcmp (prop, "Audio/Sink") == 0)
+        kind = PIPEWIRE_NODE_SINK;
+    else if (strcmp (prop, "Audio/Source") == 0 ||
+             strcmp (prop, "Audio/Source/Virtual") == 0)
+        kind = PIPEWIRE_NODE_SOURCE;
+    else if (strcmp (prop, "Stream/Output/Audio") == 0)
+        kind = PIPEWIRE_NODE_PLAYBACK;
+    else if (strcmp (prop, "Stream/Input/Audio") == 0)
+        kind = PIPEWIRE_NODE_RECORD;
+    else
+        return;
+
+    node = g_new0 (PipewireNode, 1);
+    node->pipewire  = pipewire;
+    node->id        = id;
+    node->kind      = kind;
+    node->device_id = PW_ID_ANY;
+    node->serial    = g_strdup (spa_dict_lookup (props, PW_KEY_OBJECT_SERIAL));
+
+    prop = spa_dict_lookup (props, PW_KEY_DEVICE_ID);
+    if (prop != NULL)
+        node->device_id = (guint32) g_ascii_strtoull (prop, NULL, 10);
+
+    /* The objects are created once the full properties of the node are
+     * known, the global only includes a few of them */
+    node->proxy = pw_registry_bind (pipewire->priv->registry,
+                                    id,
+                                    type,
+                                    PW_VERSION_NODE,
+                                    0);
+    if (G_UNLIKELY (node->proxy == NULL)) {
+        free_node (node);
+        return;
+    }
+
+    pw_node_add_listener (node->proxy, &node->listener, &node_events, node);
+    pw_node_subscribe_params (node->proxy, ids, G_N_ELEMENTS (ids));
+
+    g_hash_table_insert (pipewire->priv->nodes, GUINT_TO_POINTER (id), node);
+}
+
+static void
+add_link (PipewireBackend *pipewire, guint32 id, const struct spa_dict *props)
+{
+    PipewireLink *link;
+    const gchar  *output;
+    const gchar  *input;
+
+    output = spa_dict_lookup (props, PW_KEY_LINK_OUTPUT_NODE);
+    input  = spa_dict_lookup (props, PW_KEY_LINK_INPUT_NODE);
+    if (output == NULL || input == NULL)
+        return;
+
+    link = g_new (PipewireLink, 1);
+    link->output_node = (guint32) g_ascii_strtoull (output, NULL, 10);
+    link->input_node  = (guint32) g_ascii_strtoull (input, NULL, 10);
+
+    g_hash_table_insert (pipewire->priv->links, GUINT_TO_POINTER (id), link);
+
+    apply_link (pipewire, link);
+}
+
+static void
+add_metadata (PipewireBackend       *pipewire,
+              guint32                id,
+              const char            *type,
+              const struct spa_dict *props)
+{
+    const gchar *name;
+
+    name = spa_dict_lookup (props, PW_KEY_METADATA_NAME);
+    if (name == NULL || strcmp (name, DEFAULT_METADATA_NAME) != 0)
+        return;
+
+    if (pipewire->priv->metadata != NULL)
+        return;
+
+    pipewire->priv->metadata = pw_registry_bind (pipewire->priv->registry,
+                                                 id,
+                                                 type,
+                                                 PW_VERSION_METADATA,
+                                                 0);
+    if (G_UNLIKELY (pipewire->priv->metadata == NULL))
+        return;
+
+    pipewire->priv->metadata_id = id;
+
+    pw_metadata_add_listener (pipewire->priv->metadata,
+                              &pipewire->priv->metadata_listener,
+                              &metadata_events,
+                              pipewire);
+}
+
+static void
+remove_device (PipewireBackend *pipewire, guint32 id, PipewireDevice *device)
+{
+    gchar *name;
+
+    name = g_strdup (mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
+
+    g_hash_table_remove (pipewire->priv->devices, GUINT_TO_POINTER (id));
+
+    _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (pipewire),
+                                      MATE_MIXER_STATISTICS_EVENT_DEVICE);
+
+    free_list_devices (pipewire);
+    g_signal_emit_by_name (G_OBJECT (pipewire),
+                           "device-removed",
+                           name);
+    g_free (name);
+}
+
+static void
+remove_node (PipewireBackend *pipewire, PipewireNode *node)
+{
+    if (node->stream != NULL) {
+        MateMixerStream *stream = MATE_MIXER_STREAM (node->stream);
+        MateMixerDevice *device;
+        GHashTableIter   iter;
+        PipewireNode    *other;
+
+        /* Application controls stay in the stream until they are linked
+         * elsewhere, release them together with the stream */
+        g_hash_table_iter_init (&iter, pipewire->priv->nodes);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &other) == TRUE)
+            if (other->parent == node->stream)
+                detach_control (other);
+
+        pipewire_stream_remove_control (node->stream, node->control);
+
+        if (mate_mixer_backend_get_default_output_stream (MATE_MIXER_BACKEND (pipewire)) == stream)
+            _mate_mixer_backend_set_default_output_stream (MATE_MIXER_BACKEND (pipewire), NULL);
+        if (mate_mixer_backend_get_default_input_stream (MATE_MIXER_BACKEND (pipewire)) == stream)
+            _mate_mixer_backend_set_default_input_stream (MATE_MIXER_BACKEND (pipewire), NULL);
+
+        free_list_streams (pipewire);
+
+        device = mate_mixer_stream_get_device (stream);
+        if (device != NULL) {
+            pipewire_device_remove_stream (PIPEWIRE_DEVICE (device), node->stream);
+        } else {
+            g_signal_emit_by_name (G_OBJECT (pipewire),
+                                   "stream-removed",
+                                   mate_mixer_stream_get_name (stream));
+        }
+
+        _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (pipewire),
+                                          MATE_MIXER_STATISTICS_EVENT_STREAM);
+    } else if (node->control != NULL) {
+        detach_control (node);
+
+        _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (pipewire),
+                                          MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+    }
+
+    g_hash_table_remove (pipewire->priv->nodes, GUINT_TO_POINTER (node->id));
+}
+
+static void
+remove_metadata (PipewireBackend *pipewire)
+{
+    if (pipewire->priv->metadata == NULL)
+        return;
+
+    spa_hook_remove (&pipewire->priv->metadata_listener);
+
+    pw_proxy_destroy ((struct pw_proxy *) pipewire->priv->metadata);
+
+    pipewire->priv->metadata    = NULL;
+    pipewire->priv->metadata_id = PW_ID_ANY;
+}
+
+static void
+create_node_objects (PipewireBackend       *pipewire,
+                     PipewireNode          *node,
+                     const struct spa_dict *props)
+{
+    const gchar *prop;
+
+    /* Skip peak detection streams, including the ones made by this backend */
+    prop = spa_dict_lookup (props, PW_KEY_STREAM_MONITOR);
+    if (prop != NULL && spa_atob (prop) == true) {
+        node->ignored = TRUE;
+        return;
+    }
+
+    node->control = pipewire_stream_control_new (pipewire,
+                                                 node->proxy,
+                                                 node->id,
+                                                 node->kind,
+                                                 props);
+    if (G_UNLIKELY (node->control == NULL)) {
+        node->ignored = TRUE;
+        return;
+    }
+
+    if (node->kind == PIPEWIRE_NODE_SINK || node->kind == PIPEWIRE_NODE_SOURCE) {
+        PipewireDevice     *device = NULL;
+        MateMixerDirection  direction;
+        const gchar        *name;
+        const gchar        *label;
+
+        if (node->device_id != PW_ID_ANY)
+            device = g_hash_table_lookup (pipewire->priv->devices,
+                                          GUINT_TO_POINTER (node->device_id));
+
+        if (node->kind == PIPEWIRE_NODE_SINK)
+            direction = MATE_MIXER_DIRECTION_OUTPUT;
+        else
+            direction = MATE_MIXER_DIRECTION_INPUT;
+
+        /* The stream shares the name and label with its own control */
+        name  = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (node->control));
+        label = mate_mixer_stream_control_get_label (MATE_MIXER_STREAM_CONTROL (node->control));
+
+        node->stream = pipewire_stream_new (node->id, name, label, device, direction);
+
+        pipewire_stream_add_control (node->stream, node->control);
+
+        free_list_streams (pipewire);
+
+        if (device != NULL) {
+            pipewire_device_add_stream (device, node->stream);
+        } else {
+            /* Only emit when not a part of the device, otherwise emitted by
+             * the main library */
+            g_signal_emit_by_name (G_OBJECT (pipewire),
+                                   "stream-added",
+                                   name);
+        }
+
+        _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (pipewire),
+                                          MATE_MIXER_STATISTICS_EVENT_STREAM);
+
+        update_default_stream (pipewire, direction);
+    } else {
+        _mate_mixer_statistics_add_event (PIPEWIRE_STATISTICS (pipewire),
+                                          MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL);
+    }
+
+    apply_node_links (pipewire, node);
+}
+
+static void
+apply_link (PipewireBackend *pipewire, PipewireLink *link)
+{
+    PipewireNode *output;
+    PipewireNode *input;
+
+    output = g_hash_table_lookup (pipewire->priv->nodes, GUINT_TO_POINTER (link->output_node));
+    input  = g_hash_table_lookup (pipewire->priv->nodes, GUINT_TO_POINTER (link->input_node));
+    if (output == NULL || input == NULL)
+        return;
+
+    /* Application streams belong to the sink or source they are linked to */
+    if (output->kind == PIPEWIRE_NODE_PLAYBACK && input->stream != NULL)
+        attach_control (output, input->stream);
+    else if (input->kind == PIPEWIRE_NODE_RECORD && output->stream != NULL)
+        attach_control (input, output->stream);
+}
+
+static void
+apply_node_links (PipewireBackend *pipewire, PipewireNode *node)
+{
+    GHashTableIter  iter;
+    PipewireLink   *link;
+
+    g_hash_table_iter_init (&iter, pipewire->priv->links);
+
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &link) == TRUE)
+        if (link->output_node == node->id || link->input_node == node->id)
+            apply_link (pipewire, link);
+}
+
+static void
+attach_control (PipewireNode *node, PipewireStream *stream)
+{
+    if (node->control == NULL || node->parent == stream)
+        return;
+
+    detach_control (node);
+
+    node->parent = g_object_ref (stream);
+
+    pipewire_stream_add_control (stream, node->control);
+}
+
+static void
+detach_control (PipewireNode *node)
+{
+    if (node->parent == NULL)
+        return;
+
+    pipewire_stream_remove_control (node->parent, node->control);
+
+    g_clear_object (&node->parent);
+}
+
+static void
+update_default_stream (PipewireBackend *pipewire, MateMixerDirection direction)
+{
+    MateMixerStream *stream = NULL;
+    const gchar     *name;
+
+    if (direction == MATE_MIXER_DIRECTION_OUTPUT)
+        name = pipewire->priv->default_sink;
+    else
+        name = pipewire->priv->default_source;
+
+    /* The default stream may not be known yet, in which case it is looked
+     * up again when it is added */
+    if (name != NULL) {
+        GHashTableIter  iter;
+        PipewireNode   *node;
+
+        g_hash_table_iter_init (&iter, pipewire->priv->nodes);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &node) == TRUE) {
+            if (node->stream == NULL)
+                continue;
+            if (mate_mixer_stream_get_direction (MATE_MIXER_STREAM (node->stream)) != direction)
+                continue;
+
+            if (strcmp (mate_mixer_stream_get_name (MATE_MIXER_STREAM (node->stream)), name) == 0) {
+                stream = MATE_MIXER_STREAM (node->stream);
+                break;
+            }
+        }
+    }
+
+    if (direction == MATE_MIXER_DIRECTION_OUTPUT)
+        _mate_mixer_backend_set_default_output_stream (MATE_MIXER_BACKEND (pipewire), stream);
+    else
+        _mate_mixer_backend_set_default_input_stream (MATE_MIXER_BACKEND (pipewire), stream);
+}
+
+static gboolean
+write_default_stream (PipewireBackend *pipewire,
+                      const gchar     *key,
+                      MateMixerStream *stream)
+{
+    gchar *value;
+
+    if (pipewire->priv->metadata == NULL)
+        return FALSE;
+
+    value = g_strdup_printf ("{ \"name\": \"%s\" }", mate_mixer_stream_get_name (stream));
+
+    pw_metadata_set_property (pipewire->priv->metadata,
+                              PW_ID_CORE,
+                              key,
+                              "Spa:String:JSON",
+                              value);
+    g_free (value);
+    return TRUE;
+}
+
+static void
+free_node (PipewireNode *node)
+{
+    if (node->control != NULL) {
+        pipewire_stream_control_detach (node->control);
+        g_object_unref (node->control);
+    }
+    if (node->proxy != NULL) {
+        spa_hook_remove (&node->listener);
+
+        pw_proxy_destroy ((struct pw_proxy *) node->proxy);
+    }
+
+    g_clear_object (&node->parent);
+    g_clear_object (&node->stream);
+
+    g_free (node->serial);
+    g_free (node);
+}
+
+static void
+free_list_devices (PipewireBackend *pipewire)
+{
+    if (pipewire->priv->devices_list == NULL)
+        return;
+
+    g_list_free_full (pipewire->priv->devices_list, g_object_unref);
+
+    pipewire->priv->devices_list = NULL;
+}
+
+static void
+free_list_streams (PipewireBackend *pipewire)
+{
+    if (pipewire->priv->streams_list == NULL)
+        return;
+
+    g_list_free_full (pipewire->priv->streams_list, g_object_unref);
+
+    pipewire->priv->streams_list = NULL;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_BACKEND_H
+#define PIPEWIRE_BACKEND_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include <pipewire/pipewire.h>
+
+#include "pipewire-types.h"
+
+#define PIPEWIRE_TYPE_BACKEND                   \
+        (pipewire_backend_get_type ())
+#define PIPEWIRE_BACKEND(o)                     \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), PIPEWIRE_TYPE_BACKEND, PipewireBackend))
+#define PIPEWIRE_IS_BACKEND(o)                  \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), PIPEWIRE_TYPE_BACKEND))
+#define PIPEWIRE_BACKEND_CLASS(k)               \
+        (G_TYPE_CHECK_CLASS_CAST ((k), PIPEWIRE_TYPE_BACKEND, PipewireBackendClass))
+#define PIPEWIRE_IS_BACKEND_CLASS(k)            \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), PIPEWIRE_TYPE_BACKEND))
+#define PIPEWIRE_BACKEND_GET_CLASS(o)           \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), PIPEWIRE_TYPE_BACKEND, PipewireBackendClass))
+
+typedef struct _PipewireBackendClass    PipewireBackendClass;
+typedef struct _PipewireBackendPrivate  PipewireBackendPrivate;
+
+struct _PipewireBackend
+{
+    MateMixerBackend parent;
+
+    /*< private >*/
+    PipewireBackendPrivate *priv;
+};
+
+struct _PipewireBackendClass
+{
+    MateMixerBackendClass parent_class;
+};
+
+GType                       pipewire_backend_get_type  (void) G_GNUC_CONST;
+
+struct pw_core *            pipewire_backend_get_core  (PipewireBackend *pipewire);
+
+gboolean                    pipewire_backend_move_node (PipewireBackend *pipewire,
+                                                        guint32          id,
+                                                        PipewireStream  *stream);
+
+/* Support function for dynamic loading of the backend module */
+void                        backend_module_init        (GTypeModule     *module);
+const MateMixerBackendInfo *backend_module_get_info    (void);
+
+#endif /* PIPEWIRE_BACKEND_H */
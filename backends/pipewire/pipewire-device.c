@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "pipewire-device.h"
+#include "pipewire-stream.h"
+
+struct _PipewireDevicePrivate
+{
+    GList *streams;
+};
+
+static void pipewire_device_class_init (PipewireDeviceClass *klass);
+static void pipewire_device_init       (PipewireDevice      *device);
+static void pipewire_device_dispose    (GObject             *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (PipewireDevice, pipewire_device, MATE_MIXER_TYPE_DEVICE)
+
+static const GList *pipewire_device_list_streams (MateMixerDevice *mmd);
+
+static void
+pipewire_device_class_init (PipewireDeviceClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerDeviceClass *device_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = pipewire_device_dispose;
+
+    device_class = MATE_MIXER_DEVICE_CLASS (klass);
+    device_class->list_streams = pipewire_device_list_streams;
+}
+
+static void
+pipewire_device_init (PipewireDevice *device)
+{
+    device->priv = pipewire_device_get_instance_private (device);
+}
+
+static void
+pipewire_device_dispose (GObject *object)
+{
+    PipewireDevice *device;
+
+    device = PIPEWIRE_DEVICE (object);
+
+    if (device->priv->streams != NULL) {
+        g_list_free_full (device->priv->streams, g_object_unref);
+        device->priv->streams = NULL;
+    }
+
+    G_OBJECT_CLASS (pipewire_device_parent_class)->dispose (object);
+}
+
+PipewireDevice *
+pipewire_device_new (const gchar *name, const gchar *label, const gchar *icon)
+{
+    g_return_val_if_fail (name  != NULL, NULL);
+    g_return_val_if_fail (label != NULL, NULL);
+
+    return g_object_new (PIPEWIRE_TYPE_DEVICE,
+                         "name", name,
+                         "label", label,
+                         "icon", icon,
+                         NULL);
+}
+
+void
+pipewire_device_add_stream (PipewireDevice *device, PipewireStream *stream)
+{
+    g_return_if_fail (PIPEWIRE_IS_DEVICE (device));
+    g_return_if_fail (PIPEWIRE_IS_STREAM (stream));
+
+    device->priv->streams = g_list_append (device->priv->streams,
+                                           g_object_ref (stream));
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-added",
+                           mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+}
+
+void
+pipewire_device_remove_stream (PipewireDevice *device, PipewireStream *stream)
+{
+    GList *item;
+
+    g_return_if_fail (PIPEWIRE_IS_DEVICE (device));
+    g_return_if_fail (PIPEWIRE_IS_STREAM (stream));
+
+    item = g_list_find (device->priv->streams, stream);
+    if (G_UNLIKELY (item == NULL))
+        return;
+
+    device->priv->streams = g_list_delete_link (device->priv->streams, item);
+
+    g_signal_emit_by_name (G_OBJECT (device),
+                           "stream-removed",
+                           mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+
+    g_object_unref (stream);
+}
+
+static const GList *
+pipewire_device_list_streams (MateMixerDevice *mmd)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_DEVICE (mmd), NULL);
+
+    return PIPEWIRE_DEVICE (mmd)->priv->streams;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_DEVICE_H
+#define PIPEWIRE_DEVICE_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "pipewire-types.h"
+
+G_BEGIN_DECLS
+
+#define PIPEWIRE_TYPE_DEVICE                    \
+        (pipewire_device_get_type ())
+#define PIPEWIRE_DEVICE(o)                      \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), PIPEWIRE_TYPE_DEVICE, PipewireDevice))
+#define PIPEWIRE_IS_DEVICE(o)                   \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), PIPEWIRE_TYPE_DEVICE))
+#define PIPEWIRE_DEVICE_CLASS(k)                \
+        (G_TYPE_CHECK_CLASS_CAST ((k), PIPEWIRE_TYPE_DEVICE, PipewireDeviceClass))
+#define PIPEWIRE_IS_DEVICE_CLASS(k)             \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), PIPEWIRE_TYPE_DEVICE))
+#define PIPEWIRE_DEVICE_GET_CLASS(o)            \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), PIPEWIRE_TYPE_DEVICE, PipewireDeviceClass))
+
+typedef struct _PipewireDeviceClass    PipewireDeviceClass;
+typedef struct _PipewireDevicePrivate  PipewireDevicePrivate;
+
+struct _PipewireDevice
+{
+    MateMixerDevice parent;
+
+    /*< private >*/
+    PipewireDevicePrivate *priv;
+};
+
+struct _PipewireDeviceClass
+{
+    MateMixerDeviceClass parent_class;
+};
+
+GType           pipewire_device_get_type      (void) G_GNUC_CONST;
+
+PipewireDevice *pipewire_device_new           (const gchar    *name,
+                                               const gchar    *label,
+                                               const gchar    *icon);
+
+void            pipewire_device_add_stream    (PipewireDevice *device,
+                                               PipewireStream *stream);
+void            pipewire_device_remove_stream (PipewireDevice *device,
+                                               PipewireStream *stream);
+
+G_END_DECLS
+
+#endif /* PIPEWIRE_DEVICE_H */
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <math.h>
+#include <glib.h>
+
+#include <libmatemixer/matemixer-enums.h>
+
+#include <pipewire/pipewire.h>
+#include <spa/param/audio/raw.h>
+#include <spa/utils/json.h>
+
+#include "pipewire-helpers.h"
+
+MateMixerChannelPosition
+pipewire_convert_channel_position (guint32 position)
+{
+    switch (position) {
+    case SPA_AUDIO_CHANNEL_MONO:
+        return MATE_MIXER_CHANNEL_MONO;
+    case SPA_AUDIO_CHANNEL_FL:
+        return MATE_MIXER_CHANNEL_FRONT_LEFT;
+    case SPA_AUDIO_CHANNEL_FR:
+        return MATE_MIXER_CHANNEL_FRONT_RIGHT;
+    case SPA_AUDIO_CHANNEL_FC:
+        return MATE_MIXER_CHANNEL_FRONT_CENTER;
+    case SPA_AUDIO_CHANNEL_LFE:
+        return MATE_MIXER_CHANNEL_LFE;
+    case SPA_AUDIO_CHANNEL_RL:
+        return MATE_MIXER_CHANNEL_BACK_LEFT;
+    case SPA_AUDIO_CHANNEL_RR:
+        return MATE_MIXER_CHANNEL_BACK_RIGHT;
+    case SPA_AUDIO_CHANNEL_RC:
+        return MATE_MIXER_CHANNEL_BACK_CENTER;
+    case SPA_AUDIO_CHANNEL_FLC:
+        return MATE_MIXER_CHANNEL_FRONT_LEFT_CENTER;
+    case SPA_AUDIO_CHANNEL_FRC:
+        return MATE_MIXER_CHANNEL_FRONT_RIGHT_CENTER;
+    case SPA_AUDIO_CHANNEL_SL:
+        return MATE_MIXER_CHANNEL_SIDE_LEFT;
+    case SPA_AUDIO_CHANNEL_SR:
+        return MATE_MIXER_CHANNEL_SIDE_RIGHT;
+    case SPA_AUDIO_CHANNEL_TFL:
+        return MATE_MIXER_CHANNEL_TOP_FRONT_LEFT;
+    case SPA_AUDIO_CHANNEL_TFR:
+        return MATE_MIXER_CHANNEL_TOP_FRONT_RIGHT;
+    case SPA_AUDIO_CHANNEL_TFC:
+        return MATE_MIXER_CHANNEL_TOP_FRONT_CENTER;
+    case SPA_AUDIO_CHANNEL_TC:
+        return MATE_MIXER_CHANNEL_TOP_CENTER;
+    case SPA_AUDIO_CHANNEL_TRL:
+        return MATE_MIXER_CHANNEL_TOP_BACK_LEFT;
+    case SPA_AUDIO_CHANNEL_TRR:
+        return MATE_MIXER_CHANNEL_TOP_BACK_RIGHT;
+    case SPA_AUDIO_CHANNEL_TRC:
+        return MATE_MIXER_CHANNEL_TOP_BACK_CENTER;
+    default:
+        return MATE_MIXER_CHANNEL_UNKNOWN;
+    }
+}
+
+MateMixerStreamControlMediaRole
+pipewire_convert_media_role_name (const gchar *name)
+{
+    g_return_val_if_fail (name != NULL, MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN);
+
+    /* PipeWire uses its own names of the roles, the PulseAudio roles of
+     * applications connected through pipewire-pulse are translated to these */
+    if (!strcmp (name, "Movie")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_VIDEO;
+    }
+    else if (!strcmp (name, "Music")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_MUSIC;
+    }
+    else if (!strcmp (name, "Game")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_GAME;
+    }
+    else if (!strcmp (name, "Notification")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_EVENT;
+    }
+    else if (!strcmp (name, "Communication")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_PHONE;
+    }
+    else if (!strcmp (name, "Production")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_PRODUCTION;
+    }
+    else if (!strcmp (name, "Accessibility")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_A11Y;
+    }
+    else if (!strcmp (name, "Test")) {
+        return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_TEST;
+    }
+
+    return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN;
+}
+
+guint
+pipewire_volume_from_linear (gfloat linear)
+{
+    gdouble volume;
+
+    if (linear <= 0.0f)
+        return 0;
+
+    volume = cbrt (linear) * PIPEWIRE_VOLUME_NORMAL;
+
+    return (guint) CLAMP (lround (volume), 0, G_MAXUINT32);
+}
+
+gfloat
+pipewire_volume_to_linear (guint volume)
+{
+    gdouble cubic;
+
+    cubic = (gdouble) volume / PIPEWIRE_VOLUME_NORMAL;
+
+    return (gfloat) (cubic * cubic * cubic);
+}
+
+gdouble
+pipewire_volume_to_decibel (guint volume)
+{
+    if (volume == 0)
+        return -MATE_MIXER_INFINITY;
+
+    return 60.0 * log10 ((gdouble) volume / PIPEWIRE_VOLUME_NORMAL);
+}
+
+guint
+pipewire_volume_from_decibel (gdouble decibel)
+{
+    if (isinf (decibel) && decibel < 0)
+        return 0;
+
+    return pipewire_volume_from_linear ((gfloat) pow (10.0, decibel / 20.0));
+}
+
+const gchar *
+pipewire_get_node_label (const struct spa_dict *props)
+{
+    const gchar *label;
+
+    g_return_val_if_fail (props != NULL, NULL);
+
+    label = spa_dict_lookup (props, PW_KEY_NODE_DESCRIPTION);
+    if (label == NULL)
+        label = spa_dict_lookup (props, PW_KEY_NODE_NICK);
+    if (label == NULL)
+        label = spa_dict_lookup (props, PW_KEY_NODE_NAME);
+
+    return label;
+}
+
+/* Values of the default nodes in the "default" metadata are JSON objects
+ * in the form of { "name": "node.name" } */
+gchar *
+pipewire_parse_metadata_name (const gchar *value)
+{
+    struct spa_json it[2];
+    gchar           key[64];
+    gchar           name[1024];
+
+    g_return_val_if_fail (value != NULL, NULL);
+
+    spa_json_init (&it[0], value, strlen (value));
+
+    if (spa_json_enter_object (&it[0], &it[1]) <= 0)
+        return NULL;
+
+    while (spa_json_get_string (&it[1], key, sizeof (key)) > 0) {
+        const gchar *v;
+
+        if (strcmp (key, "name") == 0) {
+            if (spa_json_get_string (&it[1], name, sizeof (name)) <= 0)
+                break;
+
+            return g_strdup (name);
+        }
+
+        if (spa_json_next (&it[1], &v) <= 0)
+            break;
+    }
+    return NULL;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_HELPERS_H
+#define PIPEWIRE_HELPERS_H
+
+#include <glib.h>
+#include <libmatemixer/matemixer.h>
+
+#include <pipewire/pipewire.h>
+
+G_BEGIN_DECLS
+
+/* PipeWire stores linear volumes as floats, they are converted to the cubic
+ * scale used by PulseAudio to present the same values to the user */
+#define PIPEWIRE_VOLUME_NORMAL  65536
+#define PIPEWIRE_VOLUME_MAX     (PIPEWIRE_VOLUME_NORMAL * 3 / 2)
+
+MateMixerChannelPosition        pipewire_convert_channel_position (guint32               position);
+MateMixerStreamControlMediaRole pipewire_convert_media_role_name  (const gchar           *name);
+
+guint                           pipewire_volume_from_linear       (gfloat                linear);
+gfloat                          pipewire_volume_to_linear         (guint                 volume);
+
+gdouble                         pipewire_volume_to_decibel        (guint                 volume);
+guint                           pipewire_volume_from_decibel      (gdouble               decibel);
+
+const gchar *                   pipewire_get_node_label           (const struct spa_dict *props);
+
+gchar *                         pipewire_parse_metadata_name      (const gchar           *value);
+
+G_END_DECLS
+
+#endif /* PIPEWIRE_HELPERS_H */
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <glib-object.h>
+
+#include <pipewire/pipewire.h>
+#include <spa/param/audio/format-utils.h>
+
+#include "pipewire-monitor.h"
+
+struct _PipewireMonitorPrivate
+{
+    struct pw_core   *core;
+    struct pw_stream *stream;
+    struct spa_hook   listener;
+    gchar            *target;
+    gboolean          capture_sink;
+    gboolean          enabled;
+};
+
+enum {
+    PROP_0,
+    PROP_ENABLED,
+    N_PROPERTIES
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+enum {
+    VALUE,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS] = { 0, };
+
+static void pipewire_monitor_get_property (GObject           *object,
+                                           guint              param_id,
+                                           GValue            *value,
+                                           GParamSpec        *pspec);
+
+static void pipewire_monitor_finalize     (GObject           *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (PipewireMonitor, pipewire_monitor, G_TYPE_OBJECT);
+
+static gboolean stream_connect    (PipewireMonitor *monitor);
+static void     stream_destroy    (PipewireMonitor *monitor);
+
+static void     stream_process_cb (void            *data);
+
+static const struct pw_stream_events stream_events = {
+    PW_VERSION_STREAM_EVENTS,
+    .process = stream_process_cb,
+};
+
+static void
+pipewire_monitor_class_init (PipewireMonitorClass *klass)
+{
+    GObjectClass *object_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->finalize     = pipewire_monitor_finalize;
+    object_class->get_property = pipewire_monitor_get_property;
+
+    properties[PROP_ENABLED] =
+        g_param_spec_boolean ("enabled",
+                              "Enabled",
+                              "Monitor enabled",
+                              FALSE,
+                              G_PARAM_READABLE |
+                              G_PARAM_STATIC_STRINGS);
+
+    g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+    signals[VALUE] =
+        g_signal_new ("value",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_LAST,
+                      G_STRUCT_OFFSET (PipewireMonitorClass, value),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__DOUBLE,
+                      G_TYPE_NONE,
+                      1,
+                      G_TYPE_DOUBLE);
+}
+
+static void
+pipewire_monitor_get_property (GObject    *object,
+                               guint       param_id,
+                               GValue     *value,
+                               GParamSpec *pspec)
+{
+    PipewireMonitor *monitor;
+
+    monitor = PIPEWIRE_MONITOR (object);
+
+    switch (param_id) {
+    case PROP_ENABLED:
+        g_value_set_boolean (value, monitor->priv->enabled);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, param_id, pspec);
+        break;
+    }
+}
+
+static void
+pipewire_monitor_init (PipewireMonitor *monitor)
+{
+    monitor->priv = pipewire_monitor_get_instance_private (monitor);
+}
+
+static void
+pipewire_monitor_finalize (GObject *object)
+{
+    PipewireMonitor *monitor;
+
+    monitor = PIPEWIRE_MONITOR (object);
+
+    /* The stream may exist if the monitor is running */
+    stream_destroy (monitor);
+
+    g_free (monitor->priv->target);
+
+    G_OBJECT_CLASS (pipewire_monitor_parent_class)->finalize (object);
+}
+
+PipewireMonitor *
+pipewire_monitor_new (struct pw_core *core,
+                      const gchar    *target,
+                      gboolean        capture_sink)
+{
+    PipewireMonitor *monitor;
+
+    g_return_val_if_fail (core   != NULL, NULL);
+    g_return_val_if_fail (target != NULL, NULL);
+
+    monitor = g_object_new (PIPEWIRE_TYPE_MONITOR, NULL);
+
+    monitor->priv->core         = core;
+    monitor->priv->target       = g_strdup (target);
+    monitor->priv->capture_sink = capture_sink;
+
+    return monitor;
+}
+
+gboolean
+pipewire_monitor_get_enabled (PipewireMonitor *monitor)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_MONITOR (monitor), FALSE);
+
+    return monitor->priv->enabled;
+}
+
+gboolean
+pipewire_monitor_set_enabled (PipewireMonitor *monitor, gboolean enabled)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_MONITOR (monitor), FALSE);
+
+    if (enabled == monitor->priv->enabled)
+        return TRUE;
+
+    if (enabled) {
+        if (monitor->priv->core == NULL)
+            return FALSE;
+
+        monitor->priv->enabled = stream_connect (monitor);
+
+        if (monitor->priv->enabled == FALSE)
+            return FALSE;
+    } else {
+        stream_destroy (monitor);
+
+        monitor->priv->enabled = FALSE;
+    }
+    g_object_notify_by_pspec (G_OBJECT (monitor), properties[PROP_ENABLED]);
+
+    return TRUE;
+}
+
+/* Called when the core connection is about to be closed, the monitor keeps
+ * existing as long as its control, but it cannot be enabled anymore */
+void
+pipewire_monitor_disconnect (PipewireMonitor *monitor)
+{
+    g_return_if_fail (PIPEWIRE_IS_MONITOR (monitor));
+
+    pipewire_monitor_set_enabled (monitor, FALSE);
+
+    monitor->priv->core = NULL;
+}
+
+static gboolean
+stream_connect (PipewireMonitor *monitor)
+{
+    struct pw_properties      *props;
+    struct spa_audio_info_raw  info;
+    struct spa_pod_builder     builder;
+    const struct spa_pod      *params[1];
+    guint8                     buffer[1024];
+    int                        ret;
+
+    props = pw_properties_new (PW_KEY_MEDIA_TYPE, "Audio",
+                               PW_KEY_MEDIA_CATEGORY, "Capture",
+                               PW_KEY_MEDIA_ROLE, "DSP",
+                               PW_KEY_STREAM_MONITOR, "true",
+                               PW_KEY_NODE_DONT_RECONNECT, "true",
+                               PW_KEY_TARGET_OBJECT, monitor->priv->target,
+                               NULL);
+
+    /* Sinks are monitored by capturing their output */
+    if (monitor->priv->capture_sink == TRUE)
+        pw_properties_set (props, PW_KEY_STREAM_CAPTURE_SINK, "true");
+
+    monitor->priv->stream = pw_stream_new (monitor->priv->core,
+                                           _("Peak detect"),
+                                           props);
+
+    if (G_UNLIKELY (monitor->priv->stream == NULL)) {
+        g_warning ("Failed to create peak monitor: %s", g_strerror (errno));
+        return FALSE;
+    }
+
+    pw_stream_add_listener (monitor->priv->stream,
+                            &monitor->priv->listener,
+                            &stream_events,
+                            monitor);
+
+    /* Let the server mix all the channels into one, the rate is left for
+     * the server to choose */
+    spa_zero (info);
+    info.format   = SPA_AUDIO_FORMAT_F32;
+    info.channels = 1;
+
+    spa_pod_builder_init (&builder, buffer, sizeof (buffer));
+
+    params[0] = spa_format_audio_raw_build (&builder, SPA_PARAM_EnumFormat, &info);
+
+    ret = pw_stream_connect (monitor->priv->stream,
+                             PW_DIRECTION_INPUT,
+                             PW_ID_ANY,
+                             PW_STREAM_FLAG_AUTOCONNECT |
+                             PW_STREAM_FLAG_MAP_BUFFERS |
+                             PW_STREAM_FLAG_DONT_RECONNECT,
+                             params,
+                             1);
+    if (ret < 0) {
+        g_warning ("Failed to connect peak monitor: %s", spa_strerror (ret));
+
+        stream_destroy (monitor);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void
+stream_destroy (PipewireMonitor *monitor)
+{
+    if (monitor->priv->stream == NULL)
+        return;
+
+    spa_hook_remove (&monitor->priv->listener);
+
+    pw_stream_destroy (monitor->priv->stream);
+    monitor->priv->stream = NULL;
+}
+
+static void
+stream_process_cb (void *data)
+{
+    PipewireMonitor  *monitor;
+    struct pw_buffer *buffer;
+    struct spa_data  *d;
+    gfloat            peak = 0.0f;
+
+    monitor = PIPEWIRE_MONITOR (data);
+
+    buffer = pw_stream_dequeue_buffer (monitor->priv->stream);
+    if (buffer == NULL)
+        return;
+
+    /* Each processing cycle reports the peak of one quantum of samples */
+    d = &buffer->buffer->datas[0];
+
+    if (d->data != NULL && d->chunk != NULL) {
+        const gfloat *samples;
+        guint32       offset;
+        guint32       count;
+        guint32       i;
+
+        offset  = MIN (d->chunk->offset, d->maxsize);
+        count   = MIN (d->chunk->size, d->maxsize - offset) / sizeof (gfloat);
+        samples = SPA_PTROFF (d->data, offset, const gfloat);
+
+        for (i = 0; i < count; i++)
+            peak = MAX (peak, fabsf (samples[i]));
+    }
+
+    pw_stream_queue_buffer (monitor->priv->stream, buffer);
+
+    g_signal_emit (G_OBJECT (monitor),
+                   signals[VALUE],
+                   0,
+                   CLAMP ((gdouble) peak, 0, 1));
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_MONITOR_H
+#define PIPEWIRE_MONITOR_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <pipewire/pipewire.h>
+
+#include "pipewire-types.h"
+
+G_BEGIN_DECLS
+
+#define PIPEWIRE_TYPE_MONITOR                   \
+        (pipewire_monitor_get_type ())
+#define PIPEWIRE_MONITOR(o)                     \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), PIPEWIRE_TYPE_MONITOR, PipewireMonitor))
+#define PIPEWIRE_IS_MONITOR(o)                  \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), PIPEWIRE_TYPE_MONITOR))
+#define PIPEWIRE_MONITOR_CLASS(k)               \
+        (G_TYPE_CHECK_CLASS_CAST ((k), PIPEWIRE_TYPE_MONITOR, PipewireMonitorClass))
+#define PIPEWIRE_IS_MONITOR_CLASS(k)            \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), PIPEWIRE_TYPE_MONITOR))
+#define PIPEWIRE_MONITOR_GET_CLASS(o)           \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), PIPEWIRE_TYPE_MONITOR, PipewireMonitorClass))
+
+typedef struct _PipewireMonitorClass    PipewireMonitorClass;
+typedef struct _PipewireMonitorPrivate  PipewireMonitorPrivate;
+
+struct _PipewireMonitor
+{
+    GObject parent;
+
+    /*< private >*/
+    PipewireMonitorPrivate *priv;
+};
+
+struct _PipewireMonitorClass
+{
+    GObjectClass parent_class;
+
+    /*< private >*/
+    void (*value) (PipewireMonitor *monitor,
+                   gdouble          value);
+};
+
+GType            pipewire_monitor_get_type    (void) G_GNUC_CONST;
+
+PipewireMonitor *pipewire_monitor_new         (struct pw_core  *core,
+                                               const gchar     *target,
+                                               gboolean         capture_sink);
+
+gboolean         pipewire_monitor_get_enabled (PipewireMonitor *monitor);
+gboolean         pipewire_monitor_set_enabled (PipewireMonitor *monitor,
+                                               gboolean         enabled);
+
+void             pipewire_monitor_disconnect  (PipewireMonitor *monitor);
+
+G_END_DECLS
+
+#endif /* PIPEWIRE_MONITOR_H */
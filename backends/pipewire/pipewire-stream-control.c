@@ -0,0 +1,1050 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include <pipewire/pipewire.h>
+#include <spa/param/props.h>
+#include <spa/param/audio/raw.h>
+#include <spa/pod/builder.h>
+#include <spa/pod/iter.h>
+
+#include "pipewire-backend.h"
+#include "pipewire-helpers.h"
+#include "pipewire-monitor.h"
+#include "pipewire-stream.h"
+#include "pipewire-stream-control.h"
+
+#define PIPEWIRE_CONTROL_FLAGS  (MATE_MIXER_STREAM_CONTROL_MUTE_READABLE |      \
+                                 MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE |      \
+                                 MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |    \
+                                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE |    \
+                                 MATE_MIXER_STREAM_CONTROL_HAS_DECIBEL)
+
+struct _PipewireStreamControlPrivate
+{
+    guint32           id;
+    PipewireNodeKind  kind;
+    gchar            *target;
+    guint8            channels;
+    guint            *volume;
+    guint8           *positions;
+    guint32           channel_mask;
+    MateMixerAppInfo *app_info;
+    PipewireMonitor  *monitor;
+    PipewireBackend  *backend;
+    struct pw_node   *node;
+};
+
+static void pipewire_stream_control_class_init (PipewireStreamControlClass *klass);
+static void pipewire_stream_control_init       (PipewireStreamControl      *control);
+static void pipewire_stream_control_dispose    (GObject                    *object);
+static void pipewire_stream_control_finalize   (GObject                    *object);
+
+static void decibel_scale_interface_init       (MateMixerDecibelScaleInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (PipewireStreamControl, pipewire_stream_control,
+                         MATE_MIXER_TYPE_STREAM_CONTROL,
+                         G_ADD_PRIVATE (PipewireStreamControl)
+                         G_IMPLEMENT_INTERFACE (MATE_MIXER_TYPE_DECIBEL_SCALE,
+                                                decibel_scale_interface_init))
+
+static MateMixerAppInfo *       pipewire_stream_control_get_app_info         (MateMixerStreamControl  *mmsc);
+
+static gboolean                 pipewire_stream_control_set_stream           (MateMixerStreamControl  *mmsc,
+                                                                              MateMixerStream         *mms);
+
+static gboolean                 pipewire_stream_control_set_mute             (MateMixerStreamControl  *mmsc,
+                                                                              gboolean                 mute);
+
+static guint                    pipewire_stream_control_get_num_channels     (MateMixerStreamControl  *mmsc);
+
+static guint                    pipewire_stream_control_get_volume           (MateMixerStreamControl  *mmsc);
+static gboolean                 pipewire_stream_control_set_volume           (MateMixerStreamControl  *mmsc,
+                                                                              guint                    volume);
+
+static gdouble                  pipewire_stream_control_get_decibel          (MateMixerStreamControl  *mmsc);
+static gboolean                 pipewire_stream_control_set_decibel          (MateMixerStreamControl  *mmsc,
+                                                                              gdouble                  decibel);
+
+static gboolean                 pipewire_stream_control_get_decibel_from_volume (MateMixerDecibelScale *scale,
+                                                                                 guint                  volume,
+                                                                                 gdouble               *decibel);
+static gboolean                 pipewire_stream_control_get_volume_from_decibel (MateMixerDecibelScale *scale,
+                                                                                 gdouble                decibel,
+                                                                                 guint                 *volume);
+
+static gboolean                 pipewire_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                                                              MateMixerChannelPosition position);
+static MateMixerChannelPosition pipewire_stream_control_get_channel_position (MateMixerStreamControl  *mmsc,
+                                                                              guint                    channel);
+
+static guint                    pipewire_stream_control_get_channel_volume   (MateMixerStreamControl  *mmsc,
+                                                                              guint                    channel);
+static gboolean                 pipewire_stream_control_set_channel_volume   (MateMixerStreamControl  *mmsc,
+                                                                              guint                    channel,
+                                                                              guint                    volume);
+
+static gdouble                  pipewire_stream_control_get_channel_decibel  (MateMixerStreamControl  *mmsc,
+                                                                              guint                    channel);
+static gboolean                 pipewire_stream_control_set_channel_decibel  (MateMixerStreamControl  *mmsc,
+                                                                              guint                    channel,
+                                                                              gdouble                  decibel);
+
+static gboolean                 pipewire_stream_control_set_balance          (MateMixerStreamControl  *mmsc,
+                                                                              gfloat                   balance);
+
+static gboolean                 pipewire_stream_control_set_fade             (MateMixerStreamControl  *mmsc,
+                                                                              gfloat                   fade);
+
+static gboolean                 pipewire_stream_control_get_monitor_enabled  (MateMixerStreamControl  *mmsc);
+static gboolean                 pipewire_stream_control_set_monitor_enabled  (MateMixerStreamControl  *mmsc,
+                                                                              gboolean                 enabled);
+
+static guint                    pipewire_stream_control_get_min_volume       (MateMixerStreamControl  *mmsc);
+static guint                    pipewire_stream_control_get_max_volume       (MateMixerStreamControl  *mmsc);
+static guint                    pipewire_stream_control_get_normal_volume    (MateMixerStreamControl  *mmsc);
+
+static gboolean                 write_props                                  (PipewireStreamControl   *control,
+                                                                              const gboolean          *mute,
+                                                                              const guint             *volume);
+static gboolean                 write_volume                                 (PipewireStreamControl   *control,
+                                                                              const guint             *volume);
+
+static gboolean                 store_channels                               (PipewireStreamControl   *control,
+                                                                              guint                    channels);
+static gboolean                 store_volume                                 (PipewireStreamControl   *control,
+                                                                              const guint             *volume);
+static void                     store_positions                              (PipewireStreamControl   *control,
+                                                                              const guint32           *positions);
+
+static void                     update_balance_fade                          (PipewireStreamControl   *control);
+
+static void                     get_average_left_right                       (PipewireStreamControl   *control,
+                                                                              guint                   *left,
+                                                                              guint                   *right);
+static void                     get_average_front_back                       (PipewireStreamControl   *control,
+                                                                              guint                   *front,
+                                                                              guint                   *back);
+
+static void                     on_monitor_value                             (PipewireMonitor         *monitor,
+                                                                              gdouble                  value,
+                                                                              PipewireStreamControl   *control);
+
+static void
+decibel_scale_interface_init (MateMixerDecibelScaleInterface *iface)
+{
+    iface->get_decibel_from_volume = pipewire_stream_control_get_decibel_from_volume;
+    iface->get_volume_from_decibel = pipewire_stream_control_get_volume_from_decibel;
+}
+
+static void
+pipewire_stream_control_class_init (PipewireStreamControlClass *klass)
+{
+    GObjectClass                *object_class;
+    MateMixerStreamControlClass *control_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose  = pipewire_stream_control_dispose;
+    object_class->finalize = pipewire_stream_control_finalize;
+
+    control_class = MATE_MIXER_STREAM_CONTROL_CLASS (klass);
+    control_class->get_app_info         = pipewire_stream_control_get_app_info;
+    control_class->set_stream           = pipewire_stream_control_set_stream;
+    control_class->set_mute             = pipewire_stream_control_set_mute;
+    control_class->get_num_channels     = pipewire_stream_control_get_num_channels;
+    control_class->get_volume           = pipewire_stream_control_get_volume;
+    control_class->set_volume           = pipewire_stream_control_set_volume;
+    control_class->get_decibel          = pipewire_stream_control_get_decibel;
+    control_class->set_decibel          = pipewire_stream_control_set_decibel;
+    control_class->has_channel_position = pipewire_stream_control_has_channel_position;
+    control_class->get_channel_position = pipewire_stream_control_get_channel_position;
+    control_class->get_channel_volume   = pipewire_stream_control_get_channel_volume;
+    control_class->set_channel_volume   = pipewire_stream_control_set_channel_volume;
+    control_class->get_channel_decibel  = pipewire_stream_control_get_channel_decibel;
+    control_class->set_channel_decibel  = pipewire_stream_control_set_channel_decibel;
+    control_class->set_balance          = pipewire_stream_control_set_balance;
+    control_class->set_fade             = pipewire_stream_control_set_fade;
+    control_class->get_monitor_enabled  = pipewire_stream_control_get_monitor_enabled;
+    control_class->set_monitor_enabled  = pipewire_stream_control_set_monitor_enabled;
+    control_class->get_min_volume       = pipewire_stream_control_get_min_volume;
+    control_class->get_max_volume       = pipewire_stream_control_get_max_volume;
+    control_class->get_normal_volume    = pipewire_stream_control_get_normal_volume;
+    control_class->get_base_volume      = pipewire_stream_control_get_normal_volume;
+}
+
+static void
+pipewire_stream_control_init (PipewireStreamControl *control)
+{
+    control->priv = pipewire_stream_control_get_instance_private (control);
+}
+
+static void
+pipewire_stream_control_dispose (GObject *object)
+{
+    PipewireStreamControl *control;
+
+    control = PIPEWIRE_STREAM_CONTROL (object);
+
+    pipewire_stream_control_detach (control);
+
+    g_clear_object (&control->priv->monitor);
+
+    G_OBJECT_CLASS (pipewire_stream_control_parent_class)->dispose (object);
+}
+
+static void
+pipewire_stream_control_finalize (GObject *object)
+{
+    PipewireStreamControl *control;
+
+    control = PIPEWIRE_STREAM_CONTROL (object);
+
+    if (control->priv->app_info != NULL)
+        _mate_mixer_app_info_unref (control->priv->app_info);
+
+    g_free (control->priv->target);
+    g_free (control->priv->volume);
+    g_free (control->priv->positions);
+
+    G_OBJECT_CLASS (pipewire_stream_control_parent_class)->finalize (object);
+}
+
+PipewireStreamControl *
+pipewire_stream_control_new (PipewireBackend       *backend,
+                             struct pw_node        *node,
+                             guint32                id,
+                             PipewireNodeKind       kind,
+                             const struct spa_dict *props)
+{
+    PipewireStreamControl *control;
+    const gchar           *prop;
+    const gchar           *label = NULL;
+    gchar                 *name;
+    MateMixerAppInfo      *app_info = NULL;
+
+    MateMixerStreamControlFlags flags = PIPEWIRE_CONTROL_FLAGS;
+    MateMixerStreamControlRole  role  = MATE_MIXER_STREAM_CONTROL_ROLE_UNKNOWN;
+
+    MateMixerStreamControlMediaRole media_role = MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN;
+
+    g_return_val_if_fail (PIPEWIRE_IS_BACKEND (backend), NULL);
+    g_return_val_if_fail (node  != NULL, NULL);
+    g_return_val_if_fail (props != NULL, NULL);
+
+    switch (kind) {
+    case PIPEWIRE_NODE_SINK:
+    case PIPEWIRE_NODE_SOURCE:
+        /* Sinks and sources have a single control named after the node */
+        prop = spa_dict_lookup (props, PW_KEY_NODE_NAME);
+        if (prop != NULL)
+            name = g_strdup (prop);
+        else
+            name = g_strdup_printf ("pipewire-node-%u", id);
+
+        label = pipewire_get_node_label (props);
+        role  = MATE_MIXER_STREAM_CONTROL_ROLE_MASTER;
+        flags |= MATE_MIXER_STREAM_CONTROL_HAS_MONITOR;
+        break;
+
+    case PIPEWIRE_NODE_PLAYBACK:
+    case PIPEWIRE_NODE_RECORD:
+        /* Include the PipeWire id to make the name unique, the same as the
+         * PulseAudio backend does with its indices */
+        if (kind == PIPEWIRE_NODE_PLAYBACK) {
+            name = g_strdup_printf ("pipewire-playback-%u", id);
+
+            /* Recording streams do not have any output to monitor */
+            flags |= MATE_MIXER_STREAM_CONTROL_HAS_MONITOR;
+        } else
+            name = g_strdup_printf ("pipewire-record-%u", id);
+
+        flags |= MATE_MIXER_STREAM_CONTROL_MOVABLE;
+
+        prop = spa_dict_lookup (props, PW_KEY_APP_NAME);
+        if (prop != NULL) {
+            role = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
+
+            /* All the streams of the same application share a single structure */
+            app_info = _mate_mixer_app_info_intern (prop,
+                                                    spa_dict_lookup (props, PW_KEY_APP_ID),
+                                                    spa_dict_lookup (props, PW_KEY_APP_VERSION),
+                                                    spa_dict_lookup (props, PW_KEY_APP_ICON_NAME));
+        }
+
+        prop = spa_dict_lookup (props, PW_KEY_MEDIA_ROLE);
+        if (prop != NULL) {
+            media_role = pipewire_convert_media_role_name (prop);
+
+            if (media_role == MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_EVENT)
+                label = spa_dict_lookup (props, "event.description");
+        }
+
+        if (label == NULL)
+            label = spa_dict_lookup (props, PW_KEY_MEDIA_NAME);
+        if (label == NULL)
+            label = pipewire_get_node_label (props);
+        break;
+
+    default:
+        g_return_val_if_reached (NULL);
+    }
+
+    control = g_object_new (PIPEWIRE_TYPE_STREAM_CONTROL,
+                            "name", name,
+                            "label", (label != NULL) ? label : name,
+                            "flags", flags,
+                            "role", role,
+                            "media-role", media_role,
+                            NULL);
+    g_free (name);
+
+    control->priv->id       = id;
+    control->priv->kind     = kind;
+    control->priv->app_info = app_info;
+    control->priv->backend  = backend;
+    control->priv->node     = node;
+
+    /* The monitor links to the node by its serial number, which unlike the
+     * id is never reused */
+    prop = spa_dict_lookup (props, PW_KEY_OBJECT_SERIAL);
+    if (prop != NULL)
+        control->priv->target = g_strdup (prop);
+    else
+        control->priv->target = g_strdup_printf ("%u", id);
+
+    return control;
+}
+
+guint32
+pipewire_stream_control_get_id (PipewireStreamControl *control)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (control), PW_ID_ANY);
+
+    return control->priv->id;
+}
+
+PipewireNodeKind
+pipewire_stream_control_get_kind (PipewireStreamControl *control)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (control), PIPEWIRE_NODE_SINK);
+
+    return control->priv->kind;
+}
+
+void
+pipewire_stream_control_update_props (PipewireStreamControl *control,
+                                      const struct spa_pod  *param)
+{
+    MateMixerStreamControlFlags  flags;
+    const struct spa_pod_object *object;
+    const struct spa_pod_prop   *prop;
+    gfloat                       values[SPA_AUDIO_MAX_CHANNELS];
+    guint32                      positions[SPA_AUDIO_MAX_CHANNELS];
+    guint                        volume[SPA_AUDIO_MAX_CHANNELS];
+    guint                        n_values = 0;
+    guint                        n_positions = 0;
+    guint                        i;
+    bool                         mute;
+    gboolean                     has_mute = FALSE;
+    gboolean                     changed = FALSE;
+
+    g_return_if_fail (PIPEWIRE_IS_STREAM_CONTROL (control));
+    g_return_if_fail (param != NULL);
+
+    if (spa_pod_is_object_type (param, SPA_TYPE_OBJECT_Props) == FALSE)
+        return;
+
+    object = (const struct spa_pod_object *) param;
+
+    SPA_POD_OBJECT_FOREACH (object, prop) {
+        switch (prop->key) {
+        case SPA_PROP_mute:
+            if (spa_pod_get_bool (&prop->value, &mute) == 0)
+                has_mute = TRUE;
+            break;
+        case SPA_PROP_channelVolumes:
+            n_values = spa_pod_copy_array (&prop->value,
+                                           SPA_TYPE_Float,
+                                           values,
+                                           SPA_AUDIO_MAX_CHANNELS);
+            break;
+        case SPA_PROP_channelMap:
+            n_positions = spa_pod_copy_array (&prop->value,
+                                              SPA_TYPE_Id,
+                                              positions,
+                                              SPA_AUDIO_MAX_CHANNELS);
+            break;
+        default:
+            break;
+        }
+    }
+
+    g_object_freeze_notify (G_OBJECT (control));
+
+    if (has_mute == TRUE)
+        _mate_mixer_stream_control_set_mute (MATE_MIXER_STREAM_CONTROL (control),
+                                             mute ? TRUE : FALSE);
+
+    if (n_values > 0)
+        changed = store_channels (control, n_values);
+
+    if (n_positions > 0 && n_positions == control->priv->channels)
+        store_positions (control, positions);
+
+    if (n_values > 0) {
+        for (i = 0; i < n_values; i++)
+            volume[i] = pipewire_volume_from_linear (values[i]);
+
+        if (store_volume (control, volume) == TRUE)
+            changed = TRUE;
+    }
+
+    if (changed == TRUE) {
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
+        g_object_notify (G_OBJECT (control), "volume");
+    }
+
+    flags = mate_mixer_stream_control_get_flags (MATE_MIXER_STREAM_CONTROL (control));
+    flags &= ~(MATE_MIXER_STREAM_CONTROL_CAN_BALANCE |
+               MATE_MIXER_STREAM_CONTROL_CAN_FADE);
+
+    if (MATE_MIXER_CHANNEL_MASK_HAS_LEFT (control->priv->channel_mask) &&
+        MATE_MIXER_CHANNEL_MASK_HAS_RIGHT (control->priv->channel_mask))
+        flags |= MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
+
+    if (MATE_MIXER_CHANNEL_MASK_HAS_FRONT (control->priv->channel_mask) &&
+        MATE_MIXER_CHANNEL_MASK_HAS_BACK (control->priv->channel_mask))
+        flags |= MATE_MIXER_STREAM_CONTROL_CAN_FADE;
+
+    _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (control), flags);
+
+    update_balance_fade (control);
+
+    g_object_thaw_notify (G_OBJECT (control));
+}
+
+/* Called when the node is removed or the connection is closed, the object
+ * may outlive both of them */
+void
+pipewire_stream_control_detach (PipewireStreamControl *control)
+{
+    g_return_if_fail (PIPEWIRE_IS_STREAM_CONTROL (control));
+
+    if (control->priv->monitor != NULL)
+        pipewire_monitor_disconnect (control->priv->monitor);
+
+    control->priv->backend = NULL;
+    control->priv->node    = NULL;
+}
+
+static MateMixerAppInfo *
+pipewire_stream_control_get_app_info (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), NULL);
+
+    return PIPEWIRE_STREAM_CONTROL (mmsc)->priv->app_info;
+}
+
+static gboolean
+pipewire_stream_control_set_stream (MateMixerStreamControl *mmsc, MateMixerStream *mms)
+{
+    PipewireStreamControl *control;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM (mms), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+
+    if (control->priv->backend == NULL)
+        return FALSE;
+
+    return pipewire_backend_move_node (control->priv->backend,
+                                       control->priv->id,
+                                       PIPEWIRE_STREAM (mms));
+}
+
+static gboolean
+pipewire_stream_control_set_mute (MateMixerStreamControl *mmsc, gboolean mute)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    /* The base class stores the new value */
+    return write_props (PIPEWIRE_STREAM_CONTROL (mmsc), &mute, NULL);
+}
+
+static guint
+pipewire_stream_control_get_num_channels (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), 0);
+
+    return PIPEWIRE_STREAM_CONTROL (mmsc)->priv->channels;
+}
+
+static guint
+pipewire_stream_control_get_volume (MateMixerStreamControl *mmsc)
+{
+    PipewireStreamControl *control;
+    guint                  volume = 0;
+    guint                  i;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), 0);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+
+    for (i = 0; i < control->priv->channels; i++)
+        volume = MAX (volume, control->priv->volume[i]);
+
+    return volume;
+}
+
+static gboolean
+pipewire_stream_control_set_volume (MateMixerStreamControl *mmsc, guint volume)
+{
+    PipewireStreamControl *control;
+    guint                  current;
+    guint                  values[SPA_AUDIO_MAX_CHANNELS];
+    guint                  i;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+    if (control->priv->channels == 0)
+        return FALSE;
+
+    volume  = MIN (volume, PIPEWIRE_VOLUME_MAX);
+    current = pipewire_stream_control_get_volume (mmsc);
+
+    /* Scale the channels to keep their relative levels */
+    for (i = 0; i < control->priv->channels; i++) {
+        if (current == 0)
+            values[i] = volume;
+        else
+            values[i] = ((guint64) control->priv->volume[i] * volume) / current;
+    }
+    return write_volume (control, values);
+}
+
+static gdouble
+pipewire_stream_control_get_decibel (MateMixerStreamControl *mmsc)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), -MATE_MIXER_INFINITY);
+
+    return pipewire_volume_to_decibel (pipewire_stream_control_get_volume (mmsc));
+}
+
+static gboolean
+pipewire_stream_control_set_decibel (MateMixerStreamControl *mmsc, gdouble decibel)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    return pipewire_stream_control_set_volume (mmsc, pipewire_volume_from_decibel (decibel));
+}
+
+static gboolean
+pipewire_stream_control_get_decibel_from_volume (MateMixerDecibelScale *scale,
+                                                 guint                  volume,
+                                                 gdouble               *decibel)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (scale), FALSE);
+
+    *decibel = pipewire_volume_to_decibel (volume);
+    return TRUE;
+}
+
+static gboolean
+pipewire_stream_control_get_volume_from_decibel (MateMixerDecibelScale *scale,
+                                                 gdouble                decibel,
+                                                 guint                 *volume)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (scale), FALSE);
+
+    *volume = pipewire_volume_from_decibel (decibel);
+    return TRUE;
+}
+
+static gboolean
+pipewire_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                              MateMixerChannelPosition position)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    return MATE_MIXER_CHANNEL_MASK_HAS_CHANNEL (PIPEWIRE_STREAM_CONTROL (mmsc)->priv->channel_mask,
+                                                position) ? TRUE : FALSE;
+}
+
+static MateMixerChannelPosition
+pipewire_stream_control_get_channel_position (MateMixerStreamControl *mmsc, guint channel)
+{
+    PipewireStreamControl *control;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), MATE_MIXER_CHANNEL_UNKNOWN);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+    if (channel >= control->priv->channels)
+        return MATE_MIXER_CHANNEL_UNKNOWN;
+
+    return (MateMixerChannelPosition) control->priv->positions[channel];
+}
+
+static guint
+pipewire_stream_control_get_channel_volume (MateMixerStreamControl *mmsc, guint channel)
+{
+    PipewireStreamControl *control;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), 0);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+    if (channel >= control->priv->channels)
+        return 0;
+
+    return control->priv->volume[channel];
+}
+
+static gboolean
+pipewire_stream_control_set_channel_volume (MateMixerStreamControl *mmsc,
+                                            guint                   channel,
+                                            guint                   volume)
+{
+    PipewireStreamControl *control;
+    guint                  values[SPA_AUDIO_MAX_CHANNELS];
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+    if (channel >= control->priv->channels)
+        return FALSE;
+
+    memcpy (values, control->priv->volume, control->priv->channels * sizeof (guint));
+
+    values[channel] = MIN (volume, PIPEWIRE_VOLUME_MAX);
+
+    return write_volume (control, values);
+}
+
+static gdouble
+pipewire_stream_control_get_channel_decibel (MateMixerStreamControl *mmsc, guint channel)
+{
+    PipewireStreamControl *control;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), -MATE_MIXER_INFINITY);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+    if (channel >= control->priv->channels)
+        return -MATE_MIXER_INFINITY;
+
+    return pipewire_volume_to_decibel (control->priv->volume[channel]);
+}
+
+static gboolean
+pipewire_stream_control_set_channel_decibel (MateMixerStreamControl *mmsc,
+                                             guint                   channel,
+                                             gdouble                 decibel)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    return pipewire_stream_control_set_channel_volume (mmsc,
+                                                       channel,
+                                                       pipewire_volume_from_decibel (decibel));
+}
+
+static gboolean
+pipewire_stream_control_set_balance (MateMixerStreamControl *mmsc, gfloat balance)
+{
+    PipewireStreamControl *control;
+    guint                  values[SPA_AUDIO_MAX_CHANNELS];
+    guint                  left,
+                           right;
+    guint                  nleft,
+                           nright;
+    guint                  max;
+    guint                  channel;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+
+    get_average_left_right (control, &left, &right);
+
+    max = MAX (left, right);
+    if (balance <= 0) {
+        nright = (balance + 1.0f) * max;
+        nleft  = max;
+    } else {
+        nleft  = (1.0f - balance) * max;
+        nright = max;
+    }
+
+    for (channel = 0; channel < control->priv->channels; channel++) {
+        guint volume = control->priv->volume[channel];
+
+        if (MATE_MIXER_IS_LEFT_CHANNEL (control->priv->positions[channel])) {
+            if (left == 0)
+                volume = nleft;
+            else
+                volume = ((guint64) volume * nleft) / left;
+        } else if (MATE_MIXER_IS_RIGHT_CHANNEL (control->priv->positions[channel])) {
+            if (right == 0)
+                volume = nright;
+            else
+                volume = ((guint64) volume * nright) / right;
+        }
+        values[channel] = MIN (volume, PIPEWIRE_VOLUME_MAX);
+    }
+    return write_volume (control, values);
+}
+
+static gboolean
+pipewire_stream_control_set_fade (MateMixerStreamControl *mmsc, gfloat fade)
+{
+    PipewireStreamControl *control;
+    guint                  values[SPA_AUDIO_MAX_CHANNELS];
+    guint                  front,
+                           back;
+    guint                  nfront,
+                           nback;
+    guint                  max;
+    guint                  channel;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+
+    get_average_front_back (control, &front, &back);
+
+    max = MAX (front, back);
+    if (fade <= 0) {
+        nback  = (fade + 1.0f) * max;
+        nfront = max;
+    } else {
+        nfront = (1.0f - fade) * max;
+        nback  = max;
+    }
+
+    for (channel = 0; channel < control->priv->channels; channel++) {
+        guint volume = control->priv->volume[channel];
+
+        if (MATE_MIXER_IS_FRONT_CHANNEL (control->priv->positions[channel])) {
+            if (front == 0)
+                volume = nfront;
+            else
+                volume = ((guint64) volume * nfront) / front;
+        } else if (MATE_MIXER_IS_BACK_CHANNEL (control->priv->positions[channel])) {
+            if (back == 0)
+                volume = nback;
+            else
+                volume = ((guint64) volume * nback) / back;
+        }
+        values[channel] = MIN (volume, PIPEWIRE_VOLUME_MAX);
+    }
+    return write_volume (control, values);
+}
+
+static gboolean
+pipewire_stream_control_get_monitor_enabled (MateMixerStreamControl *mmsc)
+{
+    PipewireStreamControl *control;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+
+    if (control->priv->monitor != NULL)
+        return pipewire_monitor_get_enabled (control->priv->monitor);
+
+    return FALSE;
+}
+
+static gboolean
+pipewire_stream_control_set_monitor_enabled (MateMixerStreamControl *mmsc, gboolean enabled)
+{
+    PipewireStreamControl *control;
+
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PIPEWIRE_STREAM_CONTROL (mmsc);
+
+    if (enabled == TRUE) {
+        if (control->priv->monitor == NULL) {
+            if (control->priv->backend == NULL)
+                return FALSE;
+
+            control->priv->monitor =
+                pipewire_monitor_new (pipewire_backend_get_core (control->priv->backend),
+                                      control->priv->target,
+                                      control->priv->kind == PIPEWIRE_NODE_SINK);
+
+            if (G_UNLIKELY (control->priv->monitor == NULL))
+                return FALSE;
+
+            g_signal_connect (G_OBJECT (control->priv->monitor),
+                              "value",
+                              G_CALLBACK (on_monitor_value),
+                              control);
+        }
+    } else {
+        if (control->priv->monitor == NULL)
+            return TRUE;
+    }
+    return pipewire_monitor_set_enabled (control->priv->monitor, enabled);
+}
+
+static guint
+pipewire_stream_control_get_min_volume (MateMixerStreamControl *mmsc)
+{
+    return 0;
+}
+
+static guint
+pipewire_stream_control_get_max_volume (MateMixerStreamControl *mmsc)
+{
+    return PIPEWIRE_VOLUME_MAX;
+}
+
+static guint
+pipewire_stream_control_get_normal_volume (MateMixerStreamControl *mmsc)
+{
+    return PIPEWIRE_VOLUME_NORMAL;
+}
+
+static gboolean
+write_props (PipewireStreamControl *control,
+             const gboolean        *mute,
+             const guint           *volume)
+{
+    struct spa_pod_builder builder;
+    struct spa_pod_frame   frame;
+    struct spa_pod        *param;
+    guint8                 buffer[1024];
+    int                    ret;
+
+    if (control->priv->node == NULL)
+        return FALSE;
+
+    spa_pod_builder_init (&builder, buffer, sizeof (buffer));
+    spa_pod_builder_push_object (&builder, &frame, SPA_TYPE_OBJECT_Props, SPA_PARAM_Props);
+
+    if (mute != NULL) {
+        spa_pod_builder_prop (&builder, SPA_PROP_mute, 0);
+        spa_pod_builder_bool (&builder, *mute ? true : false);
+    }
+
+    if (volume != NULL) {
+        gfloat values[SPA_AUDIO_MAX_CHANNELS];
+        guint  i;
+
+        for (i = 0; i < control->priv->channels; i++)
+            values[i] = pipewire_volume_to_linear (volume[i]);
+
+        spa_pod_builder_prop (&builder, SPA_PROP_channelVolumes, 0);
+        spa_pod_builder_array (&builder,
+                               sizeof (gfloat),
+                               SPA_TYPE_Float,
+                               control->priv->channels,
+                               values);
+    }
+
+    param = spa_pod_builder_pop (&builder, &frame);
+
+    ret = pw_node_set_param (control->priv->node, SPA_PARAM_Props, 0, param);
+    if (ret < 0) {
+        g_warning ("Failed to set properties of node %u: %s",
+                   control->priv->id,
+                   spa_strerror (ret));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* The new volume is stored right away, the node reports the same value back
+ * once the change is applied */
+static gboolean
+write_volume (PipewireStreamControl *control, const guint *volume)
+{
+    if (write_props (control, NULL, volume) == FALSE)
+        return FALSE;
+
+    if (store_volume (control, volume) == TRUE) {
+        g_object_freeze_notify (G_OBJECT (control));
+
+        update_balance_fade (control);
+
+        _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
+        g_object_notify (G_OBJECT (control), "volume");
+        g_object_thaw_notify (G_OBJECT (control));
+    }
+    return TRUE;
+}
+
+static gboolean
+store_channels (PipewireStreamControl *control, guint channels)
+{
+    if (channels == control->priv->channels)
+        return FALSE;
+
+    control->priv->volume    = g_renew (guint, control->priv->volume, channels);
+    control->priv->positions = g_renew (guint8, control->priv->positions, channels);
+    control->priv->channels  = channels;
+
+    memset (control->priv->volume, 0, channels * sizeof (guint));
+
+    /* The channel map may not be included in the properties, use the common
+     * layout for the number of channels until it is known */
+    store_positions (control, NULL);
+    return TRUE;
+}
+
+static gboolean
+store_volume (PipewireStreamControl *control, const guint *volume)
+{
+    if (memcmp (control->priv->volume, volume, control->priv->channels * sizeof (guint)) == 0)
+        return FALSE;
+
+    memcpy (control->priv->volume, volume, control->priv->channels * sizeof (guint));
+    return TRUE;
+}
+
+static void
+store_positions (PipewireStreamControl *control, const guint32 *positions)
+{
+    MateMixerChannelPosition map[SPA_AUDIO_MAX_CHANNELS];
+    guint                    channels;
+    guint                    i;
+
+    channels = control->priv->channels;
+
+    for (i = 0; i < channels; i++) {
+        if (positions != NULL)
+            map[i] = pipewire_convert_channel_position (positions[i]);
+        else if (channels == 1)
+            map[i] = MATE_MIXER_CHANNEL_MONO;
+        else if (channels == 2)
+            map[i] = (i == 0) ? MATE_MIXER_CHANNEL_FRONT_LEFT : MATE_MIXER_CHANNEL_FRONT_RIGHT;
+        else
+            map[i] = MATE_MIXER_CHANNEL_UNKNOWN;
+    }
+
+    for (i = 0; i < channels; i++)
+        control->priv->positions[i] = (guint8) map[i];
+
+    control->priv->channel_mask = _mate_mixer_create_channel_mask (map, channels);
+}
+
+static void
+update_balance_fade (PipewireStreamControl *control)
+{
+    MateMixerStreamControlFlags flags;
+    guint                       a;
+    guint                       b;
+
+    flags = mate_mixer_stream_control_get_flags (MATE_MIXER_STREAM_CONTROL (control));
+
+    if (flags & MATE_MIXER_STREAM_CONTROL_CAN_BALANCE) {
+        get_average_left_right (control, &a, &b);
+
+        if (a == b)
+            _mate_mixer_stream_control_set_balance (MATE_MIXER_STREAM_CONTROL (control), 0.0f);
+        else if (a > b)
+            _mate_mixer_stream_control_set_balance (MATE_MIXER_STREAM_CONTROL (control),
+                                                    -1.0f + ((gfloat) b / (gfloat) a));
+        else
+            _mate_mixer_stream_control_set_balance (MATE_MIXER_STREAM_CONTROL (control),
+                                                    +1.0f - ((gfloat) a / (gfloat) b));
+    }
+
+    if (flags & MATE_MIXER_STREAM_CONTROL_CAN_FADE) {
+        get_average_front_back (control, &a, &b);
+
+        if (a == b)
+            _mate_mixer_stream_control_set_fade (MATE_MIXER_STREAM_CONTROL (control), 0.0f);
+        else if (a > b)
+            _mate_mixer_stream_control_set_fade (MATE_MIXER_STREAM_CONTROL (control),
+                                                 -1.0f + ((gfloat) b / (gfloat) a));
+        else
+            _mate_mixer_stream_control_set_fade (MATE_MIXER_STREAM_CONTROL (control),
+                                                 +1.0f - ((gfloat) a / (gfloat) b));
+    }
+}
+
+static void
+get_average_left_right (PipewireStreamControl *control, guint *left, guint *right)
+{
+    guint64 l = 0,
+            r = 0;
+    guint   nl = 0,
+            nr = 0;
+    guint   channel;
+
+    for (channel = 0; channel < control->priv->channels; channel++)
+        if (MATE_MIXER_IS_LEFT_CHANNEL (control->priv->positions[channel])) {
+            l += control->priv->volume[channel];
+            nl++;
+        }
+        else if (MATE_MIXER_IS_RIGHT_CHANNEL (control->priv->positions[channel])) {
+            r += control->priv->volume[channel];
+            nr++;
+        }
+
+    *left  = (nl > 0) ? l / nl : PIPEWIRE_VOLUME_NORMAL;
+    *right = (nr > 0) ? r / nr : PIPEWIRE_VOLUME_NORMAL;
+}
+
+static void
+get_average_front_back (PipewireStreamControl *control, guint *front, guint *back)
+{
+    guint64 f = 0,
+            b = 0;
+    guint   nf = 0,
+            nb = 0;
+    guint   channel;
+
+    for (channel = 0; channel < control->priv->channels; channel++)
+        if (MATE_MIXER_IS_FRONT_CHANNEL (control->priv->positions[channel])) {
+            f += control->priv->volume[channel];
+            nf++;
+        }
+        else if (MATE_MIXER_IS_BACK_CHANNEL (control->priv->positions[channel])) {
+            b += control->priv->volume[channel];
+            nb++;
+        }
+
+    *front = (nf > 0) ? f / nf : PIPEWIRE_VOLUME_NORMAL;
+    *back  = (nb > 0) ? b / nb : PIPEWIRE_VOLUME_NORMAL;
+}
+
+static void
+on_monitor_value (PipewireMonitor       *monitor,
+                  gdouble                value,
+                  PipewireStreamControl *control)
+{
+    if (control->priv->backend != NULL) {
+        MateMixerStatistics *statistics;
+
+        statistics = _mate_mixer_backend_get_statistics (MATE_MIXER_BACKEND (control->priv->backend));
+        if (statistics != NULL)
+            _mate_mixer_statistics_add_monitor_value (statistics);
+    }
+
+    _mate_mixer_stream_control_push_monitor_value (MATE_MIXER_STREAM_CONTROL (control),
+                                                   value);
+}
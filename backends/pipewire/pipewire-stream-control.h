@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_STREAM_CONTROL_H
+#define PIPEWIRE_STREAM_CONTROL_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include <pipewire/pipewire.h>
+
+#include "pipewire-types.h"
+
+G_BEGIN_DECLS
+
+#define PIPEWIRE_TYPE_STREAM_CONTROL            \
+        (pipewire_stream_control_get_type ())
+#define PIPEWIRE_STREAM_CONTROL(o)              \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), PIPEWIRE_TYPE_STREAM_CONTROL, PipewireStreamControl))
+#define PIPEWIRE_IS_STREAM_CONTROL(o)           \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), PIPEWIRE_TYPE_STREAM_CONTROL))
+#define PIPEWIRE_STREAM_CONTROL_CLASS(k)        \
+        (G_TYPE_CHECK_CLASS_CAST ((k), PIPEWIRE_TYPE_STREAM_CONTROL, PipewireStreamControlClass))
+#define PIPEWIRE_IS_STREAM_CONTROL_CLASS(k)     \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), PIPEWIRE_TYPE_STREAM_CONTROL))
+#define PIPEWIRE_STREAM_CONTROL_GET_CLASS(o)    \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), PIPEWIRE_TYPE_STREAM_CONTROL, PipewireStreamControlClass))
+
+typedef struct _PipewireStreamControlClass    PipewireStreamControlClass;
+typedef struct _PipewireStreamControlPrivate  PipewireStreamControlPrivate;
+
+/* Kinds of audio nodes which are represented by a stream control */
+typedef enum {
+    PIPEWIRE_NODE_SINK,
+    PIPEWIRE_NODE_SOURCE,
+    PIPEWIRE_NODE_PLAYBACK,
+    PIPEWIRE_NODE_RECORD
+} PipewireNodeKind;
+
+struct _PipewireStreamControl
+{
+    MateMixerStreamControl parent;
+
+    /*< private >*/
+    PipewireStreamControlPrivate *priv;
+};
+
+struct _PipewireStreamControlClass
+{
+    MateMixerStreamControlClass parent_class;
+};
+
+GType                  pipewire_stream_control_get_type     (void) G_GNUC_CONST;
+
+PipewireStreamControl *pipewire_stream_control_new          (PipewireBackend        *backend,
+                                                             struct pw_node         *node,
+                                                             guint32                 id,
+                                                             PipewireNodeKind        kind,
+                                                             const struct spa_dict  *props);
+
+guint32                pipewire_stream_control_get_id       (PipewireStreamControl  *control);
+PipewireNodeKind       pipewire_stream_control_get_kind     (PipewireStreamControl  *control);
+
+void                   pipewire_stream_control_update_props (PipewireStreamControl  *control,
+                                                             const struct spa_pod   *param);
+
+void                   pipewire_stream_control_detach       (PipewireStreamControl  *control);
+
+G_END_DECLS
+
+#endif /* PIPEWIRE_STREAM_CONTROL_H */
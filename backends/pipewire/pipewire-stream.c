@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include "pipewire-device.h"
+#include "pipewire-stream.h"
+#include "pipewire-stream-control.h"
+
+struct _PipewireStreamPrivate
+{
+    guint32  id;
+    GList   *controls;
+};
+
+static void pipewire_stream_class_init (PipewireStreamClass *klass);
+static void pipewire_stream_init       (PipewireStream      *stream);
+static void pipewire_stream_dispose    (GObject             *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (PipewireStream, pipewire_stream, MATE_MIXER_TYPE_STREAM)
+
+static const GList *pipewire_stream_list_controls (MateMixerStream *mms);
+
+static void
+pipewire_stream_class_init (PipewireStreamClass *klass)
+{
+    GObjectClass         *object_class;
+    MateMixerStreamClass *stream_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose = pipewire_stream_dispose;
+
+    stream_class = MATE_MIXER_STREAM_CLASS (klass);
+    stream_class->list_controls = pipewire_stream_list_controls;
+}
+
+static void
+pipewire_stream_init (PipewireStream *stream)
+{
+    stream->priv = pipewire_stream_get_instance_private (stream);
+}
+
+static void
+pipewire_stream_dispose (GObject *object)
+{
+    PipewireStream *stream;
+
+    stream = PIPEWIRE_STREAM (object);
+
+    if (stream->priv->controls != NULL) {
+        g_list_free_full (stream->priv->controls, g_object_unref);
+        stream->priv->controls = NULL;
+    }
+
+    G_OBJECT_CLASS (pipewire_stream_parent_class)->dispose (object);
+}
+
+PipewireStream *
+pipewire_stream_new (guint32             id,
+                     const gchar        *name,
+                     const gchar        *label,
+                     PipewireDevice     *device,
+                     MateMixerDirection  direction)
+{
+    PipewireStream *stream;
+
+    g_return_val_if_fail (name  != NULL, NULL);
+    g_return_val_if_fail (label != NULL, NULL);
+    g_return_val_if_fail (device == NULL || PIPEWIRE_IS_DEVICE (device), NULL);
+
+    stream = g_object_new (PIPEWIRE_TYPE_STREAM,
+                           "name", name,
+                           "label", label,
+                           "device", device,
+                           "direction", direction,
+                           NULL);
+
+    stream->priv->id = id;
+    return stream;
+}
+
+guint32
+pipewire_stream_get_id (PipewireStream *stream)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM (stream), 0);
+
+    return stream->priv->id;
+}
+
+void
+pipewire_stream_add_control (PipewireStream *stream, PipewireStreamControl *control)
+{
+    g_return_if_fail (PIPEWIRE_IS_STREAM (stream));
+    g_return_if_fail (PIPEWIRE_IS_STREAM_CONTROL (control));
+
+    if (g_list_find (stream->priv->controls, control) != NULL)
+        return;
+
+    stream->priv->controls = g_list_append (stream->priv->controls,
+                                            g_object_ref (control));
+
+    _mate_mixer_stream_control_set_stream (MATE_MIXER_STREAM_CONTROL (control),
+                                           MATE_MIXER_STREAM (stream));
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "control-added",
+                           mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (control)));
+
+    /* The first control of a sink or source is its own volume control */
+    if (mate_mixer_stream_get_default_control (MATE_MIXER_STREAM (stream)) == NULL &&
+        mate_mixer_stream_control_get_role (MATE_MIXER_STREAM_CONTROL (control)) ==
+        MATE_MIXER_STREAM_CONTROL_ROLE_MASTER)
+        _mate_mixer_stream_set_default_control (MATE_MIXER_STREAM (stream),
+                                                MATE_MIXER_STREAM_CONTROL (control));
+}
+
+void
+pipewire_stream_remove_control (PipewireStream *stream, PipewireStreamControl *control)
+{
+    GList *item;
+
+    g_return_if_fail (PIPEWIRE_IS_STREAM (stream));
+    g_return_if_fail (PIPEWIRE_IS_STREAM_CONTROL (control));
+
+    item = g_list_find (stream->priv->controls, control);
+    if (item == NULL)
+        return;
+
+    if (mate_mixer_stream_get_default_control (MATE_MIXER_STREAM (stream)) ==
+        MATE_MIXER_STREAM_CONTROL (control))
+        _mate_mixer_stream_set_default_control (MATE_MIXER_STREAM (stream), NULL);
+
+    stream->priv->controls = g_list_delete_link (stream->priv->controls, item);
+
+    g_signal_emit_by_name (G_OBJECT (stream),
+                           "control-removed",
+                           mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (control)));
+
+    g_object_unref (control);
+}
+
+static const GList *
+pipewire_stream_list_controls (MateMixerStream *mms)
+{
+    g_return_val_if_fail (PIPEWIRE_IS_STREAM (mms), NULL);
+
+    return PIPEWIRE_STREAM (mms)->priv->controls;
+}
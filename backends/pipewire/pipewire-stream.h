@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_STREAM_H
+#define PIPEWIRE_STREAM_H
+
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+
+#include "pipewire-types.h"
+
+G_BEGIN_DECLS
+
+#define PIPEWIRE_TYPE_STREAM                    \
+        (pipewire_stream_get_type ())
+#define PIPEWIRE_STREAM(o)                      \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), PIPEWIRE_TYPE_STREAM, PipewireStream))
+#define PIPEWIRE_IS_STREAM(o)                   \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), PIPEWIRE_TYPE_STREAM))
+#define PIPEWIRE_STREAM_CLASS(k)                \
+        (G_TYPE_CHECK_CLASS_CAST ((k), PIPEWIRE_TYPE_STREAM, PipewireStreamClass))
+#define PIPEWIRE_IS_STREAM_CLASS(k)             \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), PIPEWIRE_TYPE_STREAM))
+#define PIPEWIRE_STREAM_GET_CLASS(o)            \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), PIPEWIRE_TYPE_STREAM, PipewireStreamClass))
+
+typedef struct _PipewireStreamClass    PipewireStreamClass;
+typedef struct _PipewireStreamPrivate  PipewireStreamPrivate;
+
+struct _PipewireStream
+{
+    MateMixerStream parent;
+
+    /*< private >*/
+    PipewireStreamPrivate *priv;
+};
+
+struct _PipewireStreamClass
+{
+    MateMixerStreamClass parent_class;
+};
+
+GType           pipewire_stream_get_type       (void) G_GNUC_CONST;
+
+PipewireStream *pipewire_stream_new            (guint32                id,
+                                                const gchar           *name,
+                                                const gchar           *label,
+                                                PipewireDevice        *device,
+                                                MateMixerDirection     direction);
+
+guint32         pipewire_stream_get_id         (PipewireStream        *stream);
+
+void            pipewire_stream_add_control    (PipewireStream        *stream,
+                                                PipewireStreamControl *control);
+void            pipewire_stream_remove_control (PipewireStream        *stream,
+                                                PipewireStreamControl *control);
+
+G_END_DECLS
+
+#endif /* PIPEWIRE_STREAM_H */
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPEWIRE_TYPES_H
+#define PIPEWIRE_TYPES_H
+
+G_BEGIN_DECLS
+
+typedef struct _PipewireBackend       PipewireBackend;
+typedef struct _PipewireDevice        PipewireDevice;
+typedef struct _PipewireMonitor       PipewireMonitor;
+typedef struct _PipewireStream        PipewireStream;
+typedef struct _PipewireStreamControl PipewireStreamControl;
+
+G_END_DECLS
+
+#endif /* PIPEWIRE_TYPES_H */
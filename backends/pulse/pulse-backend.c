@@ -31,10 +31,12 @@
 #include "pulse-enums.h"
 #include "pulse-ext-stream.h"
 #include "pulse-stream.h"
+#include "pulse-stream-control.h"
 #include "pulse-sink.h"
 #include "pulse-sink-input.h"
 #include "pulse-source.h"
 #include "pulse-source-output.h"
+#include "pulse-socket-watch.h"
 
 #define BACKEND_NAME      "PulseAudio"
 #define BACKEND_PRIORITY  100
@@ -43,16 +45,32 @@
                            MATE_MIXER_BACKEND_CAN_SET_DEFAULT_INPUT_STREAM |    \
                            MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM)
 
+/* How long to keep removed streams of a card in case they are created again */
+#define BACKEND_PARKED_TIMEOUT 2000
+
+/* Bounds of the delay between attempts to reconnect, the delay doubles after
+ * each failed attempt and a random jitter of up to a quarter is added to it */
+#define BACKEND_RECONNECT_DELAY_MIN   250
+#define BACKEND_RECONNECT_DELAY_MAX 30000
+
 struct _PulseBackendPrivate
 {
-    guint             connect_tag;
+    GSource          *connect_source;
+    guint             connect_delay;
+    gint64            connect_mark;
     gboolean          connected_once;
+    PulseSocketWatch *socket_watch;
     GHashTable       *devices;
     GHashTable       *sinks;
     GHashTable       *sources;
+    GHashTable       *sink_names;
+    GHashTable       *source_names;
+    GHashTable       *parked;
+    GSource          *parked_source;
     GHashTable       *sink_input_map;
     GHashTable       *source_output_map;
     GHashTable       *ext_streams;
+    guint             ext_streams_generation;
     GList            *devices_list;
     GList            *streams_list;
     GList            *ext_streams_list;
@@ -61,6 +79,12 @@ struct _PulseBackendPrivate
     PulseConnection  *connection;
 };
 
+typedef struct {
+    PulseBackend         *pulse;
+    MateMixerTransaction *transaction;
+    gboolean              success;
+} PulseTransaction;
+
 #define PULSE_CHANGE_STATE(p, s)        \
     (_mate_mixer_backend_set_state (MATE_MIXER_BACKEND (p), (s)))
 #define PULSE_GET_DEFAULT_SINK(p)       \
@@ -138,53 +162,64 @@ static gboolean         pulse_backend_set_default_input_stream  (MateMixerBacken
 static gboolean         pulse_backend_set_default_output_stream (MateMixerBackend *backend,
                                                                  MateMixerStream  *stream);
 
+static gboolean         pulse_backend_commit_transaction        (MateMixerBackend     *backend,
+                                                                 MateMixerTransaction *transaction);
+
+static void             on_connection_sync                  (PulseConnection                  *connection,
+                                                             gboolean                          success,
+                                                             gpointer                          user_data);
+
 static void             on_connection_state_notify          (PulseConnection                  *connection,
                                                              GParamSpec                       *pspec,
                                                              PulseBackend                     *pulse);
 
 static void             on_connection_server_info           (PulseConnection                  *connection,
-                                                             const pa_server_info             *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 
 static void             on_connection_card_info             (PulseConnection                  *connection,
-                                                             const pa_card_info               *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 static void             on_connection_card_removed          (PulseConnection                  *connection,
-                                                             guint                             index,
-                                                             PulseBackend                     *pulse);
+                                                             guint32                           index,
+                                                             gpointer                          user_data);
 static void             on_connection_sink_info             (PulseConnection                  *connection,
-                                                             const pa_sink_info               *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 static void             on_connection_sink_removed          (PulseConnection                  *connection,
-                                                             guint                             index,
-                                                             PulseBackend                     *pulse);
+                                                             guint32                           index,
+                                                             gpointer                          user_data);
 static void             on_connection_sink_input_info       (PulseConnection                  *connection,
-                                                             const pa_sink_input_info         *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 static void             on_connection_sink_input_removed    (PulseConnection                  *connection,
-                                                             guint                             index,
-                                                             PulseBackend                     *pulse);
+                                                             guint32                           index,
+                                                             gpointer                          user_data);
 static void             on_connection_source_info           (PulseConnection                  *connection,
-                                                             const pa_source_info             *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 static void             on_connection_source_removed        (PulseConnection                  *connection,
-                                                             guint                             index,
-                                                             PulseBackend                     *pulse);
+                                                             guint32                           index,
+                                                             gpointer                          user_data);
 static void             on_connection_source_output_info    (PulseConnection                  *connection,
-                                                             const pa_source_output_info      *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 static void             on_connection_source_output_removed (PulseConnection                  *connection,
-                                                             guint                             index,
-                                                             PulseBackend                     *pulse);
+                                                             guint32                           index,
+                                                             gpointer                          user_data);
 static void             on_connection_ext_stream_loading    (PulseConnection                  *connection,
-                                                             PulseBackend                     *pulse);
+                                                             gpointer                          user_data);
 static void             on_connection_ext_stream_loaded     (PulseConnection                  *connection,
-                                                             PulseBackend                     *pulse);
+                                                             gpointer                          user_data);
 static void             on_connection_ext_stream_info       (PulseConnection                  *connection,
-                                                             const pa_ext_stream_restore_info *info,
-                                                             PulseBackend                     *pulse);
+                                                             gconstpointer                     data,
+                                                             gpointer                          user_data);
 
+static gboolean         try_reconnect                       (PulseBackend                     *pulse);
+static void             schedule_reconnect                  (PulseBackend                     *pulse);
+static void             stop_reconnect                      (PulseBackend                     *pulse);
 static gboolean         source_try_connect                  (PulseBackend                     *pulse);
+static void             on_socket_created                   (PulseBackend                     *pulse);
 
 static void             check_pending_sink                  (PulseBackend                     *pulse,
                                                              PulseStream                      *stream);
@@ -198,13 +233,45 @@ static void             remove_source_output                (PulseBackend
                                                              PulseSource                      *source,
                                                              guint                             index);
 
+static void             remove_sink                         (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+static void             remove_source                       (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+
+static gboolean         is_changing_profile                 (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+static void             park_stream                         (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+static gboolean         unpark_stream                       (PulseBackend                     *pulse,
+                                                             GHashTable                       *table,
+                                                             PulseStream                      *stream,
+                                                             guint32                           index,
+                                                             guint32                           monitor);
+static void             flush_parked_streams                (PulseBackend                     *pulse,
+                                                             PulseDevice                      *device);
+static void             stop_parked_timeout                 (PulseBackend                     *pulse);
+static gboolean         source_flush_parked_streams         (PulseBackend                     *pulse);
+
 static void             free_list_devices                   (PulseBackend                     *pulse);
 static void             free_list_streams                   (PulseBackend                     *pulse);
 static void             free_list_ext_streams               (PulseBackend                     *pulse);
 
-static gboolean         compare_stream_names                (gpointer                          key,
-                                                             gpointer                          value,
-                                                             gpointer                          user_data);
+static const PulseConnectionListener connection_listener = {
+    .server_info           = on_connection_server_info,
+    .card_info             = on_connection_card_info,
+    .card_removed          = on_connection_card_removed,
+    .sink_info             = on_connection_sink_info,
+    .sink_removed          = on_connection_sink_removed,
+    .sink_input_info       = on_connection_sink_input_info,
+    .sink_input_removed    = on_connection_sink_input_removed,
+    .source_info           = on_connection_source_info,
+    .source_removed        = on_connection_source_removed,
+    .source_output_info    = on_connection_source_output_info,
+    .source_output_removed = on_connection_source_output_removed,
+    .ext_stream_loading    = on_connection_ext_stream_loading,
+    .ext_stream_loaded     = on_connection_ext_stream_loaded,
+    .ext_stream_info       = on_connection_ext_stream_info
+};
 
 static MateMixerBackendInfo info;
 
@@ -245,6 +312,7 @@ pulse_backend_class_init (PulseBackendClass *klass)
     backend_class->list_stored_controls      = pulse_backend_list_stored_controls;
     backend_class->set_default_input_stream  = pulse_backend_set_default_input_stream;
     backend_class->set_default_output_stream = pulse_backend_set_default_output_stream;
+    backend_class->commit_transaction        = pulse_backend_commit_transaction;
 }
 
 /* Called in the code generated by G_DEFINE_DYNAMIC_TYPE() */
@@ -275,6 +343,17 @@ pulse_backend_init (PulseBackend *pulse)
                                NULL,
                                g_object_unref);
 
+    /* Name indexes of the sink and source tables, the keys and values are
+     * owned by the streams */
+    pulse->priv->sink_names =
+        g_hash_table_new (g_str_hash, g_str_equal);
+    pulse->priv->source_names =
+        g_hash_table_new (g_str_hash, g_str_equal);
+
+    /* Removed streams waiting to be created again, see park_stream() */
+    pulse->priv->parked =
+        g_hash_table_new (g_direct_hash, g_direct_equal);
+
     pulse->priv->ext_streams =
         g_hash_table_new_full (g_str_hash,
                                g_str_equal,
@@ -316,11 +395,14 @@ pulse_backend_finalize (GObject *object)
     pulse = PULSE_BACKEND (object);
 
     if (pulse->priv->app_info != NULL)
-        _mate_mixer_app_info_free (pulse->priv->app_info);
+        _mate_mixer_app_info_unref (pulse->priv->app_info);
 
     g_hash_table_unref (pulse->priv->devices);
     g_hash_table_unref (pulse->priv->sinks);
     g_hash_table_unref (pulse->priv->sources);
+    g_hash_table_unref (pulse->priv->sink_names);
+    g_hash_table_unref (pulse->priv->source_names);
+    g_hash_table_unref (pulse->priv->parked);
     g_hash_table_unref (pulse->priv->ext_streams);
     g_hash_table_unref (pulse->priv->sink_input_map);
     g_hash_table_unref (pulse->priv->source_output_map);
@@ -362,66 +444,19 @@ pulse_backend_open (MateMixerBackend *backend)
         return FALSE;
     }
 
+    pulse_connection_set_statistics (connection,
+                                     _mate_mixer_backend_get_statistics (backend));
+    pulse_connection_set_interests (connection,
+                                    mate_mixer_backend_get_interests (backend));
+
     g_signal_connect (G_OBJECT (connection),
                       "notify::state",
                       G_CALLBACK (on_connection_state_notify),
                       pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "server-info",
-                      G_CALLBACK (on_connection_server_info),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "card-info",
-                      G_CALLBACK (on_connection_card_info),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "card-removed",
-                      G_CALLBACK (on_connection_card_removed),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "sink-info",
-                      G_CALLBACK (on_connection_sink_info),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "sink-removed",
-                      G_CALLBACK (on_connection_sink_removed),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "sink-input-info",
-                      G_CALLBACK (on_connection_sink_input_info),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "sink-input-removed",
-                      G_CALLBACK (on_connection_sink_input_removed),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "source-info",
-                      G_CALLBACK (on_connection_source_info),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "source-removed",
-                      G_CALLBACK (on_connection_source_removed),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "source-output-info",
-                      G_CALLBACK (on_connection_source_output_info),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "source-output-removed",
-                      G_CALLBACK (on_connection_source_output_removed),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "ext-stream-loading",
-                      G_CALLBACK (on_connection_ext_stream_loading),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "ext-stream-loaded",
-                      G_CALLBACK (on_connection_ext_stream_loaded),
-                      pulse);
-    g_signal_connect (G_OBJECT (connection),
-                      "ext-stream-info",
-                      G_CALLBACK (on_connection_ext_stream_info),
-                      pulse);
+
+    /* The introspection results are delivered directly to the listener
+     * rather than through the signals of the connection */
+    pulse_connection_set_listener (connection, &connection_listener, pulse);
 
     PULSE_CHANGE_STATE (backend, MATE_MIXER_STATE_CONNECTING);
 
@@ -446,22 +481,28 @@ pulse_backend_close (MateMixerBackend *backend)
 
     pulse = PULSE_BACKEND (backend);
 
-    if (pulse->priv->connect_tag != 0) {
-        g_source_remove (pulse->priv->connect_tag);
-        pulse->priv->connect_tag = 0;
-    }
+    stop_reconnect (pulse);
 
     if (pulse->priv->connection != NULL) {
         g_signal_handlers_disconnect_by_data (G_OBJECT (pulse->priv->connection),
                                               pulse);
+        pulse_connection_set_listener (pulse->priv->connection, NULL, NULL);
+
+        /* The connection might be kept alive by the controls */
+        pulse_connection_set_statistics (pulse->priv->connection, NULL);
 
         g_clear_object (&pulse->priv->connection);
     }
 
+    stop_parked_timeout (pulse);
+    g_hash_table_remove_all (pulse->priv->parked);
+
     free_list_devices (pulse);
     free_list_streams (pulse);
     free_list_ext_streams (pulse);
 
+    g_hash_table_remove_all (pulse->priv->sink_names);
+    g_hash_table_remove_all (pulse->priv->source_names);
     g_hash_table_remove_all (pulse->priv->devices);
     g_hash_table_remove_all (pulse->priv->sinks);
     g_hash_table_remove_all (pulse->priv->sources);
@@ -485,7 +526,7 @@ pulse_backend_set_app_info (MateMixerBackend *backend, MateMixerAppInfo *info)
     pulse = PULSE_BACKEND (backend);
 
     if (pulse->priv->app_info != NULL)
-        _mate_mixer_app_info_free (pulse->priv->app_info);
+        _mate_mixer_app_info_unref (pulse->priv->app_info);
 
     pulse->priv->app_info = _mate_mixer_app_info_copy (info);
 }
@@ -606,6 +647,60 @@ pulse_backend_set_default_output_stream (MateMixerBackend *backend,
     return TRUE;
 }
 
+static gboolean
+pulse_backend_commit_transaction (MateMixerBackend     *backend,
+                                  MateMixerTransaction *transaction)
+{
+    PulseBackend     *pulse;
+    PulseTransaction *data;
+
+    g_return_val_if_fail (PULSE_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (transaction != NULL, FALSE);
+
+    pulse = PULSE_BACKEND (backend);
+
+    if (pulse->priv->connection == NULL)
+        return FALSE;
+
+    data = g_slice_new (PulseTransaction);
+    data->pulse       = g_object_ref (pulse);
+    data->transaction = mate_mixer_transaction_ref (transaction);
+
+    /* All the operations are sent to the server without waiting for each
+     * other, the transaction is completed when the server has replied to
+     * a sync request sent after the last one, the change notifications
+     * of the controls are held until then */
+    _mate_mixer_transaction_freeze_notify (transaction);
+
+    data->success = _mate_mixer_transaction_apply (transaction, backend);
+
+    if (pulse_connection_sync (pulse->priv->connection,
+                               on_connection_sync,
+                               data) == FALSE)
+        on_connection_sync (pulse->priv->connection, FALSE, data);
+
+    return TRUE;
+}
+
+static void
+on_connection_sync (PulseConnection *connection,
+                    gboolean         success,
+                    gpointer         user_data)
+{
+    PulseTransaction *data = user_data;
+
+    _mate_mixer_transaction_thaw_notify (data->transaction);
+
+    _mate_mixer_backend_complete_transaction (MATE_MIXER_BACKEND (data->pulse),
+                                              data->transaction,
+                                              data->success && success);
+
+    mate_mixer_transaction_unref (data->transaction);
+    g_object_unref (data->pulse);
+
+    g_slice_free (PulseTransaction, data);
+}
+
 static void
 on_connection_state_notify (PulseConnection *connection,
                             GParamSpec      *pspec,
@@ -615,9 +710,15 @@ on_connection_state_notify (PulseConnection *connection,
 
     switch (state) {
     case PULSE_CONNECTION_DISCONNECTED:
+        /* The parked streams will not come back on this connection */
+        flush_parked_streams (pulse, NULL);
+
         if (pulse->priv->connected_once == TRUE) {
             /* We managed to connect once before, try to reconnect and if it
-             * fails immediately, use a timeout source.
+             * fails, keep trying with an increasing delay, or as soon as the
+             * server socket appears.
+             * This state is also reached when an attempt to reconnect fails
+             * after the connection has been initiated.
              * All current devices and streams are marked as hanging as it is
              * unknown whether they are still available.
              * Stream callbacks will unmark available streams and remaining
@@ -625,22 +726,18 @@ on_connection_state_notify (PulseConnection *connection,
              * is reached. */
             PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_CONNECTING);
 
-            if (G_UNLIKELY (pulse->priv->connect_tag != 0))
+            if (G_UNLIKELY (pulse->priv->connect_source != NULL))
                 break;
 
-            if (pulse_connection_connect (connection, TRUE) == FALSE) {
-                GSource *source;
+            if (pulse->priv->connect_mark == 0) {
+                pulse->priv->connect_mark = g_get_monotonic_time ();
 
-                source = g_timeout_source_new (200);
-                g_source_set_callback (source,
-                                       (GSourceFunc) source_try_connect,
-                                       pulse,
-                                       NULL);
-                pulse->priv->connect_tag =
-                    g_source_attach (source, g_main_context_get_thread_default ());
+                if (try_reconnect (pulse) == TRUE)
+                    break;
+            } else
+                pulse->priv->connect_mark = g_get_monotonic_time ();
 
-                g_source_unref (source);
-            }
+            schedule_reconnect (pulse);
             break;
         }
 
@@ -655,6 +752,15 @@ on_connection_state_notify (PulseConnection *connection,
         break;
 
     case PULSE_CONNECTION_CONNECTED:
+        if (pulse->priv->connect_mark != 0) {
+            MateMixerStatistics *statistics;
+
+            statistics = _mate_mixer_backend_get_statistics (MATE_MIXER_BACKEND (pulse));
+
+            _mate_mixer_statistics_add_reconnect (statistics,
+                                                  g_get_monotonic_time () - pulse->priv->connect_mark);
+            stop_reconnect (pulse);
+        }
         pulse->priv->connected_once = TRUE;
 
         PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_READY);
@@ -663,13 +769,15 @@ on_connection_state_notify (PulseConnection *connection,
 }
 
 static void
-on_connection_server_info (PulseConnection      *connection,
-                           const pa_server_info *info,
-                           PulseBackend         *pulse)
+on_connection_server_info (PulseConnection *connection,
+                           gconstpointer    data,
+                           gpointer         user_data)
 {
-    MateMixerStream *stream;
-    const gchar     *name_source = NULL;
-    const gchar     *name_sink = NULL;
+    const pa_server_info *info = data;
+    PulseBackend         *pulse = user_data;
+    MateMixerStream      *stream;
+    const gchar          *name_source = NULL;
+    const gchar          *name_sink = NULL;
 
     stream = PULSE_GET_DEFAULT_SOURCE (pulse);
     if (stream != NULL)
@@ -677,9 +785,8 @@ on_connection_server_info (PulseConnection      *connection,
 
     if (g_strcmp0 (name_source, info->default_source_name) != 0) {
         if (info->default_source_name != NULL) {
-            MateMixerStream *stream = g_hash_table_find (pulse->priv->sources,
-                                                         compare_stream_names,
-                                                         (gpointer) info->default_source_name);
+            MateMixerStream *stream = g_hash_table_lookup (pulse->priv->source_names,
+                                                           info->default_source_name);
 
             /*
              * It is possible that we are unaware of the default stream as
@@ -713,9 +820,8 @@ on_connection_server_info (PulseConnection      *connection,
 
     if (g_strcmp0 (name_sink, info->default_sink_name) != 0) {
         if (info->default_sink_name != NULL) {
-            MateMixerStream *stream = g_hash_table_find (pulse->priv->sinks,
-                                                         compare_stream_names,
-                                                         (gpointer) info->default_sink_name);
+            MateMixerStream *stream = g_hash_table_lookup (pulse->priv->sink_names,
+                                                           info->default_sink_name);
 
             /*
              * It is possible that we are unaware of the default stream as
@@ -751,11 +857,13 @@ on_connection_server_info (PulseConnection      *connection,
 }
 
 static void
-on_connection_card_info (PulseConnection    *connection,
-                         const pa_card_info *info,
-                         PulseBackend       *pulse)
+on_connection_card_info (PulseConnection *connection,
+                         gconstpointer    data,
+                         gpointer         user_data)
 {
-    PulseDevice *device;
+    const pa_card_info *info = data;
+    PulseBackend       *pulse = user_data;
+    PulseDevice        *device;
 
     device = g_hash_table_lookup (pulse->priv->devices, GUINT_TO_POINTER (info->index));
     if (device == NULL) {
@@ -775,16 +883,21 @@ on_connection_card_info (PulseConnection    *connection,
 
 static void
 on_connection_card_removed (PulseConnection *connection,
-                            guint            index,
-                            PulseBackend    *pulse)
+                            guint32          index,
+                            gpointer         user_data)
 {
-    PulseDevice *device;
-    gchar       *name;
+    PulseBackend *pulse = user_data;
+    PulseDevice  *device;
+    gchar        *name;
 
     device = g_hash_table_lookup (pulse->priv->devices, GUINT_TO_POINTER (index));
     if (G_UNLIKELY (device == NULL))
         return;
 
+    /* The streams of the card are removed before the card itself, make sure
+     * the parked ones are removed before the device */
+    flush_parked_streams (pulse, device);
+
     name = g_strdup (mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
 
     g_hash_table_remove (pulse->priv->devices, GUINT_TO_POINTER (index));
@@ -797,12 +910,14 @@ on_connection_card_removed (PulseConnection *connection,
 }
 
 static void
-on_connection_sink_info (PulseConnection    *connection,
-                         const pa_sink_info *info,
-                         PulseBackend       *pulse)
+on_connection_sink_info (PulseConnection *connection,
+                         gconstpointer    data,
+                         gpointer         user_data)
 {
-    PulseDevice *device = NULL;
-    PulseStream *stream;
+    const pa_sink_info *info = data;
+    PulseBackend       *pulse = user_data;
+    PulseDevice        *device = NULL;
+    PulseStream        *stream;
 
     if (info->card != PA_INVALID_INDEX)
         device = g_hash_table_lookup (pulse->priv->devices,
@@ -810,11 +925,24 @@ on_connection_sink_info (PulseConnection    *connection,
 
     stream = g_hash_table_lookup (pulse->priv->sinks, GUINT_TO_POINTER (info->index));
     if (stream == NULL) {
+        /* The stream might be coming back after a change of the card profile */
+        stream = g_hash_table_lookup (pulse->priv->sink_names, info->name);
+        if (stream != NULL &&
+            unpark_stream (pulse, pulse->priv->sinks, stream, info->index, info->monitor_source) == TRUE) {
+            pulse_sink_update (PULSE_SINK (stream), info);
+
+            check_pending_sink (pulse, stream);
+            return;
+        }
+
         stream = PULSE_STREAM (pulse_sink_new (connection, info, device));
 
         g_hash_table_insert (pulse->priv->sinks,
                              GUINT_TO_POINTER (info->index),
                              stream);
+        g_hash_table_insert (pulse->priv->sink_names,
+                             (gpointer) mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)),
+                             stream);
 
         free_list_streams (pulse);
 
@@ -838,51 +966,34 @@ on_connection_sink_info (PulseConnection    *connection,
 
 static void
 on_connection_sink_removed (PulseConnection *connection,
-                            guint            idx,
-                            PulseBackend    *pulse)
+                            guint32          idx,
+                            gpointer         user_data)
 {
-    PulseStream *stream;
-    PulseDevice *device;
+    PulseBackend *pulse = user_data;
+    PulseStream  *stream;
 
     stream = g_hash_table_lookup (pulse->priv->sinks, GUINT_TO_POINTER (idx));
     if (G_UNLIKELY (stream == NULL))
         return;
 
-    g_object_ref (stream);
-
-    g_hash_table_remove (pulse->priv->sinks, GUINT_TO_POINTER (idx));
-    free_list_streams (pulse);
-
-    device = pulse_stream_get_device (stream);
-    if (device != NULL) {
-        pulse_device_remove_stream (device, stream);
-    } else {
-        g_signal_emit_by_name (G_OBJECT (pulse),
-                               "stream-removed",
-                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
-    }
-
-    /* The removed stream might be one of the default streams, this happens
-     * especially when switching profiles, after which PulseAudio removes the
-     * old streams and creates new ones with different names */
-    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SINK (pulse)) {
-        PULSE_SET_DEFAULT_SINK (pulse, NULL);
-
-        /* PulseAudio usually sends a server info update by itself when default
-         * stream changes, but there is at least one case when it does not - setting
-         * a card profile to off, so to be sure request an update explicitely */
-        pulse_connection_load_server_info (pulse->priv->connection);
-    }
-    g_object_unref (stream);
+    /* PulseAudio removes all the streams of a card and creates them again
+     * when the card profile changes, keep the streams for a while to see
+     * whether they come back if we have changed the profile of the card */
+    if (is_changing_profile (pulse, stream) == TRUE)
+        park_stream (pulse, stream);
+    else
+        remove_sink (pulse, stream);
 }
 
 static void
-on_connection_sink_input_info (PulseConnection          *connection,
-                               const pa_sink_input_info *info,
-                               PulseBackend             *pulse)
+on_connection_sink_input_info (PulseConnection *connection,
+                               gconstpointer    data,
+                               gpointer         user_data)
 {
-    PulseSink *sink = NULL;
-    PulseSink *prev;
+    const pa_sink_input_info *info = data;
+    PulseBackend             *pulse = user_data;
+    PulseSink                *sink = NULL;
+    PulseSink                *prev;
 
     if (G_LIKELY (info->sink != PA_INVALID_INDEX))
         sink = g_hash_table_lookup (pulse->priv->sinks, GUINT_TO_POINTER (info->sink));
@@ -921,10 +1032,11 @@ on_connection_sink_input_info (PulseConnection          *connection,
 
 static void
 on_connection_sink_input_removed (PulseConnection *connection,
-                                  guint            idx,
-                                  PulseBackend    *pulse)
+                                  guint32          idx,
+                                  gpointer         user_data)
 {
-    PulseSink *sink;
+    PulseBackend *pulse = user_data;
+    PulseSink    *sink;
 
     sink = g_hash_table_lookup (pulse->priv->sink_input_map, GUINT_TO_POINTER (idx));
     if (G_UNLIKELY (sink == NULL))
@@ -934,12 +1046,14 @@ on_connection_sink_input_removed (PulseConnection *connection,
 }
 
 static void
-on_connection_source_info (PulseConnection      *connection,
-                           const pa_source_info *info,
-                           PulseBackend         *pulse)
+on_connection_source_info (PulseConnection *connection,
+                           gconstpointer    data,
+                           gpointer         user_data)
 {
-    PulseDevice *device = NULL;
-    PulseStream *stream;
+    const pa_source_info *info = data;
+    PulseBackend         *pulse = user_data;
+    PulseDevice          *device = NULL;
+    PulseStream          *stream;
 
     if (info->card != PA_INVALID_INDEX)
         device = g_hash_table_lookup (pulse->priv->devices,
@@ -947,11 +1061,24 @@ on_connection_source_info (PulseConnection      *connection,
 
     stream = g_hash_table_lookup (pulse->priv->sources, GUINT_TO_POINTER (info->index));
     if (stream == NULL) {
+        /* The stream might be coming back after a change of the card profile */
+        stream = g_hash_table_lookup (pulse->priv->source_names, info->name);
+        if (stream != NULL &&
+            unpark_stream (pulse, pulse->priv->sources, stream, info->index, PA_INVALID_INDEX) == TRUE) {
+            pulse_source_update (PULSE_SOURCE (stream), info);
+
+            check_pending_source (pulse, stream);
+            return;
+        }
+
         stream = PULSE_STREAM (pulse_source_new (connection, info, device));
 
         g_hash_table_insert (pulse->priv->sources,
                              GUINT_TO_POINTER (info->index),
                              stream);
+        g_hash_table_insert (pulse->priv->source_names,
+                             (gpointer) mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)),
+                             stream);
 
         free_list_streams (pulse);
 
@@ -975,51 +1102,34 @@ on_connection_source_info (PulseConnection      *connection,
 
 static void
 on_connection_source_removed (PulseConnection *connection,
-                              guint            idx,
-                              PulseBackend    *pulse)
+                              guint32          idx,
+                              gpointer         user_data)
 {
-    PulseDevice *device;
-    PulseStream *stream;
+    PulseBackend *pulse = user_data;
+    PulseStream  *stream;
 
     stream = g_hash_table_lookup (pulse->priv->sources, GUINT_TO_POINTER (idx));
     if (G_UNLIKELY (stream == NULL))
         return;
 
-    g_object_ref (stream);
-
-    g_hash_table_remove (pulse->priv->sources, GUINT_TO_POINTER (idx));
-    free_list_streams (pulse);
-
-    device = pulse_stream_get_device (stream);
-    if (device != NULL) {
-        pulse_device_remove_stream (device, stream);
-    } else {
-        g_signal_emit_by_name (G_OBJECT (pulse),
-                               "stream-removed",
-                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
-    }
-
-    /* The removed stream might be one of the default streams, this happens
-     * especially when switching profiles, after which PulseAudio removes the
-     * old streams and creates new ones with different names */
-    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SOURCE (pulse)) {
-        PULSE_SET_DEFAULT_SOURCE (pulse, NULL);
-
-        /* PulseAudio usually sends a server info update by itself when default
-         * stream changes, but there is at least one case when it does not - setting
-         * a card profile to off, so to be sure request an update explicitely */
-        pulse_connection_load_server_info (pulse->priv->connection);
-    }
-    g_object_unref (stream);
+    /* PulseAudio removes all the streams of a card and creates them again
+     * when the card profile changes, keep the streams for a while to see
+     * whether they come back if we have changed the profile of the card */
+    if (is_changing_profile (pulse, stream) == TRUE)
+        park_stream (pulse, stream);
+    else
+        remove_source (pulse, stream);
 }
 
 static void
-on_connection_source_output_info (PulseConnection             *connection,
-                                  const pa_source_output_info *info,
-                                  PulseBackend                *pulse)
+on_connection_source_output_info (PulseConnection *connection,
+                                  gconstpointer    data,
+                                  gpointer         user_data)
 {
-    PulseSource *source = NULL;
-    PulseSource *prev;
+    const pa_source_output_info *info = data;
+    PulseBackend                *pulse = user_data;
+    PulseSource                 *source = NULL;
+    PulseSource                 *prev;
 
     if (G_LIKELY (info->source != PA_INVALID_INDEX))
         source = g_hash_table_lookup (pulse->priv->sources, GUINT_TO_POINTER (info->source));
@@ -1058,10 +1168,11 @@ on_connection_source_output_info (PulseConnection             *connection,
 
 static void
 on_connection_source_output_removed (PulseConnection *connection,
-                                     guint            idx,
-                                     PulseBackend    *pulse)
+                                     guint32          idx,
+                                     gpointer         user_data)
 {
-    PulseSource *source;
+    PulseBackend *pulse = user_data;
+    PulseSource  *source;
 
     source = g_hash_table_lookup (pulse->priv->source_output_map, GUINT_TO_POINTER (idx));
     if (G_UNLIKELY (source == NULL))
@@ -1071,20 +1182,20 @@ on_connection_source_output_removed (PulseConnection *connection,
 }
 
 static void
-on_connection_ext_stream_info (PulseConnection                  *connection,
-                               const pa_ext_stream_restore_info *info,
-                               PulseBackend                     *pulse)
+on_connection_ext_stream_info (PulseConnection *connection,
+                               gconstpointer    data,
+                               gpointer         user_data)
 {
-    PulseExtStream *ext;
-    PulseStream    *parent = NULL;
+    const pa_ext_stream_restore_info *info = data;
+    PulseBackend                     *pulse = user_data;
+    PulseExtStream                   *ext;
+    PulseStream                      *parent = NULL;
 
     if (info->device != NULL) {
-        parent = g_hash_table_find (pulse->priv->sinks, compare_stream_names,
-                                    (gpointer) info->device);
+        parent = g_hash_table_lookup (pulse->priv->sink_names, info->device);
 
         if (parent == NULL)
-            parent = g_hash_table_find (pulse->priv->sources, compare_stream_names,
-                                        (gpointer) info->device);
+            parent = g_hash_table_lookup (pulse->priv->source_names, info->device);
     }
 
     ext = g_hash_table_lookup (pulse->priv->ext_streams, info->name);
@@ -1095,43 +1206,48 @@ on_connection_ext_stream_info (PulseConnection                  *connection,
                              g_strdup (info->name),
                              ext);
 
+        pulse_ext_stream_set_generation (ext, pulse->priv->ext_streams_generation);
+
         free_list_ext_streams (pulse);
 
         g_signal_emit_by_name (G_OBJECT (pulse),
                                "stored-control-added",
                                mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (ext)));
     } else {
+        /* Unchanged entries are skipped by the ext-stream itself */
         pulse_ext_stream_update (ext, info, parent);
 
-        /* The object might be hanging if ext-streams are being loaded, remove
-         * the hanging flag to prevent it from being removed */
-        PULSE_UNSET_HANGING (ext);
+        /* Mark the entry as seen in the current read of the database to
+         * prevent it from being removed */
+        pulse_ext_stream_set_generation (ext, pulse->priv->ext_streams_generation);
     }
 }
 
 static void
-on_connection_ext_stream_loading (PulseConnection *connection, PulseBackend *pulse)
+on_connection_ext_stream_loading (PulseConnection *connection,
+                                  gpointer         user_data)
 {
-    GHashTableIter iter;
-    gpointer       ext;
-
-    g_hash_table_iter_init (&iter, pulse->priv->ext_streams);
+    PulseBackend *pulse = user_data;
 
-    while (g_hash_table_iter_next (&iter, NULL, &ext) == TRUE)
-        PULSE_SET_HANGING (ext);
+    /* Each read of the database starts a new generation, entries which are
+     * not included in the read keep the previous one and are removed when
+     * the read finishes */
+    pulse->priv->ext_streams_generation++;
 }
 
 static void
-on_connection_ext_stream_loaded (PulseConnection *connection, PulseBackend *pulse)
+on_connection_ext_stream_loaded (PulseConnection *connection,
+                                 gpointer         user_data)
 {
-    GHashTableIter iter;
-    gpointer       name;
-    gpointer       ext;
+    PulseBackend   *pulse = user_data;
+    GHashTableIter  iter;
+    gpointer        name;
+    gpointer        ext;
 
     g_hash_table_iter_init (&iter, pulse->priv->ext_streams);
 
     while (g_hash_table_iter_next (&iter, &name, &ext) == TRUE) {
-        if (PULSE_GET_HANGING (ext) == FALSE)
+        if (pulse_ext_stream_get_generation (ext) == pulse->priv->ext_streams_generation)
             continue;
 
         g_hash_table_iter_remove (&iter);
@@ -1144,16 +1260,110 @@ on_connection_ext_stream_loaded (PulseConnection *connection, PulseBackend *puls
 }
 
 static gboolean
-source_try_connect (PulseBackend *pulse)
+try_reconnect (PulseBackend *pulse)
 {
-    /* When the connect call succeeds, return FALSE to remove the source
-     * and wait for the connection state notifications, otherwise this function
-     * will be called again */
-    if (pulse_connection_connect (pulse->priv->connection, TRUE) == TRUE) {
-        pulse->priv->connect_tag = 0;
-        return G_SOURCE_REMOVE;
+    _mate_mixer_statistics_add_reconnect_attempt (_mate_mixer_backend_get_statistics (MATE_MIXER_BACKEND (pulse)));
+
+    if (pulse_connection_connect (pulse->priv->connection, TRUE) == TRUE)
+        return TRUE;
+
+    /* The latency is counted from the last failed attempt */
+    pulse->priv->connect_mark = g_get_monotonic_time ();
+    return FALSE;
+}
+
+static void
+schedule_reconnect (PulseBackend *pulse)
+{
+    GSource *source;
+    guint    delay;
+
+    /* Watch for the server socket to reconnect as soon as the server is back,
+     * the timer then only covers servers which cannot be watched */
+    if (pulse->priv->socket_watch == NULL) {
+        gchar *path;
+
+        path = pulse_socket_watch_get_path (pulse->priv->server_address);
+        if (path != NULL) {
+            pulse->priv->socket_watch =
+                pulse_socket_watch_new (path, (PulseSocketWatchFunc) on_socket_created, pulse);
+            g_free (path);
+        }
     }
-    return G_SOURCE_CONTINUE;
+
+    if (pulse->priv->connect_delay == 0)
+        pulse->priv->connect_delay = BACKEND_RECONNECT_DELAY_MIN;
+    else
+        pulse->priv->connect_delay = MIN (pulse->priv->connect_delay * 2,
+                                          BACKEND_RECONNECT_DELAY_MAX);
+
+    /* The jitter keeps the clients of a restarted server from reconnecting
+     * all at the same time */
+    delay = pulse->priv->connect_delay;
+    delay = delay - delay / 4 + g_random_int_range (0, delay / 2 + 1);
+
+    g_debug ("Reconnecting to PulseAudio in %u ms", delay);
+
+    /* The source is kept to be able to remove it from the main context it
+     * is attached to, g_source_remove() only looks in the global one */
+    source = g_timeout_source_new (delay);
+    g_source_set_callback (source,
+                           (GSourceFunc) source_try_connect,
+                           pulse,
+                           NULL);
+    g_source_attach (source, g_main_context_get_thread_default ());
+
+    pulse->priv->connect_source = source;
+}
+
+static void
+stop_reconnect (PulseBackend *pulse)
+{
+    if (pulse->priv->connect_source != NULL) {
+        g_source_destroy (pulse->priv->connect_source);
+        g_clear_pointer (&pulse->priv->connect_source, g_source_unref);
+    }
+
+    if (pulse->priv->socket_watch != NULL) {
+        pulse_socket_watch_free (pulse->priv->socket_watch);
+        pulse->priv->socket_watch = NULL;
+    }
+
+    pulse->priv->connect_delay = 0;
+    pulse->priv->connect_mark  = 0;
+}
+
+static gboolean
+source_try_connect (PulseBackend *pulse)
+{
+    g_clear_pointer (&pulse->priv->connect_source, g_source_unref);
+
+    /* When the connect call succeeds, wait for the connection state
+     * notifications, otherwise try again later */
+    if (try_reconnect (pulse) == FALSE)
+        schedule_reconnect (pulse);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+on_socket_created (PulseBackend *pulse)
+{
+    /* Only interesting while waiting for the next attempt */
+    if (pulse->priv->connect_source == NULL)
+        return;
+
+    g_debug ("PulseAudio socket created, reconnecting");
+
+    g_source_destroy (pulse->priv->connect_source);
+    g_clear_pointer (&pulse->priv->connect_source, g_source_unref);
+
+    /* The server is known to be back, start over with the shortest delay */
+    pulse->priv->connect_delay = 0;
+    pulse->priv->connect_mark  = g_get_monotonic_time ();
+
+    if (try_reconnect (pulse) == FALSE)
+        schedule_reconnect (pulse);
 }
 
 static void
@@ -1200,6 +1410,202 @@ check_pending_source (PulseBackend *pulse, PulseStream *stream)
     PULSE_SET_DEFAULT_SOURCE (pulse, stream);
 }
 
+static void
+remove_sink (PulseBackend *pulse, PulseStream *stream)
+{
+    PulseDevice *device;
+
+    g_object_ref (stream);
+
+    g_hash_table_remove (pulse->priv->parked, stream);
+    g_hash_table_remove (pulse->priv->sink_names,
+                         mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+    g_hash_table_remove (pulse->priv->sinks,
+                         GUINT_TO_POINTER (pulse_stream_get_index (stream)));
+    free_list_streams (pulse);
+
+    device = pulse_stream_get_device (stream);
+    if (device != NULL) {
+        pulse_device_remove_stream (device, stream);
+    } else {
+        g_signal_emit_by_name (G_OBJECT (pulse),
+                               "stream-removed",
+                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+    }
+
+    /* The removed stream might be one of the default streams, this happens
+     * especially when switching profiles, after which PulseAudio removes the
+     * old streams and creates new ones with different names */
+    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SINK (pulse)) {
+        PULSE_SET_DEFAULT_SINK (pulse, NULL);
+
+        /* PulseAudio usually sends a server info update by itself when default
+         * stream changes, but there is at least one case when it does not - setting
+         * a card profile to off, so to be sure request an update explicitely */
+        pulse_connection_load_server_info (pulse->priv->connection);
+    }
+    g_object_unref (stream);
+}
+
+static void
+remove_source (PulseBackend *pulse, PulseStream *stream)
+{
+    PulseDevice *device;
+
+    g_object_ref (stream);
+
+    g_hash_table_remove (pulse->priv->parked, stream);
+    g_hash_table_remove (pulse->priv->source_names,
+                         mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+    g_hash_table_remove (pulse->priv->sources,
+                         GUINT_TO_POINTER (pulse_stream_get_index (stream)));
+    free_list_streams (pulse);
+
+    device = pulse_stream_get_device (stream);
+    if (device != NULL) {
+        pulse_device_remove_stream (device, stream);
+    } else {
+        g_signal_emit_by_name (G_OBJECT (pulse),
+                               "stream-removed",
+                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+    }
+
+    /* The removed stream might be one of the default streams, this happens
+     * especially when switching profiles, after which PulseAudio removes the
+     * old streams and creates new ones with different names */
+    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SOURCE (pulse)) {
+        PULSE_SET_DEFAULT_SOURCE (pulse, NULL);
+
+        /* PulseAudio usually sends a server info update by itself when default
+         * stream changes, but there is at least one case when it does not - setting
+         * a card profile to off, so to be sure request an update explicitely */
+        pulse_connection_load_server_info (pulse->priv->connection);
+    }
+    g_object_unref (stream);
+}
+
+static gboolean
+is_changing_profile (PulseBackend *pulse, PulseStream *stream)
+{
+    PulseDevice *device;
+
+    device = pulse_stream_get_device (stream);
+    if (device == NULL)
+        return FALSE;
+
+    return pulse_connection_is_changing_profile (pulse->priv->connection,
+                                                 mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
+}
+
+static void
+park_stream (PulseBackend *pulse, PulseStream *stream)
+{
+    g_debug ("Keeping removed stream %s for a while",
+             mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+
+    /* The stream stays in the tables under its old index, so it is still
+     * listed and no signals are emitted until it either comes back or the
+     * timeout expires */
+    g_hash_table_add (pulse->priv->parked, stream);
+
+    if (pulse->priv->parked_source == NULL) {
+        GSource *source;
+
+        source = g_timeout_source_new (BACKEND_PARKED_TIMEOUT);
+        g_source_set_callback (source,
+                               (GSourceFunc) source_flush_parked_streams,
+                               pulse,
+                               NULL);
+        g_source_attach (source, g_main_context_get_thread_default ());
+
+        pulse->priv->parked_source = source;
+    }
+}
+
+static gboolean
+unpark_stream (PulseBackend *pulse,
+               GHashTable   *table,
+               PulseStream  *stream,
+               guint32       index,
+               guint32       monitor)
+{
+    MateMixerStreamControl *control;
+
+    if (g_hash_table_remove (pulse->priv->parked, stream) == FALSE)
+        return FALSE;
+
+    g_debug ("Reusing stream %s with new index %u",
+             mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)),
+             index);
+
+    /* Move the stream to the new index, the table keeps its reference */
+    g_hash_table_steal (table, GUINT_TO_POINTER (pulse_stream_get_index (stream)));
+    g_hash_table_insert (table, GUINT_TO_POINTER (index), stream);
+
+    pulse_stream_set_index (stream, index);
+
+    if (PULSE_IS_SINK (stream))
+        pulse_sink_set_index_monitor (PULSE_SINK (stream), monitor);
+
+    /* The monitor of the stream still reads from the old indices */
+    control = mate_mixer_stream_get_default_control (MATE_MIXER_STREAM (stream));
+    if (control != NULL)
+        pulse_stream_control_reset_monitor (PULSE_STREAM_CONTROL (control));
+
+    if (g_hash_table_size (pulse->priv->parked) == 0)
+        stop_parked_timeout (pulse);
+    return TRUE;
+}
+
+static void
+flush_parked_streams (PulseBackend *pulse, PulseDevice *device)
+{
+    GHashTableIter  iter;
+    PulseStream    *stream;
+    GList          *streams = NULL;
+    GList          *list;
+
+    g_hash_table_iter_init (&iter, pulse->priv->parked);
+
+    while (g_hash_table_iter_next (&iter, (gpointer *) &stream, NULL) == TRUE) {
+        if (device == NULL || pulse_stream_get_device (stream) == device)
+            streams = g_list_prepend (streams, stream);
+    }
+
+    for (list = streams; list != NULL; list = list->next) {
+        stream = PULSE_STREAM (list->data);
+
+        if (PULSE_IS_SINK (stream))
+            remove_sink (pulse, stream);
+        else
+            remove_source (pulse, stream);
+    }
+    g_list_free (streams);
+
+    if (g_hash_table_size (pulse->priv->parked) == 0)
+        stop_parked_timeout (pulse);
+}
+
+static void
+stop_parked_timeout (PulseBackend *pulse)
+{
+    /* The source is attached to the thread-default main context, which
+     * g_source_remove() does not search */
+    if (pulse->priv->parked_source != NULL) {
+        g_source_destroy (pulse->priv->parked_source);
+        g_clear_pointer (&pulse->priv->parked_source, g_source_unref);
+    }
+}
+
+static gboolean
+source_flush_parked_streams (PulseBackend *pulse)
+{
+    g_clear_pointer (&pulse->priv->parked_source, g_source_unref);
+
+    flush_parked_streams (pulse, NULL);
+    return G_SOURCE_REMOVE;
+}
+
 static void
 remove_sink_input (PulseBackend *pulse, PulseSink *sink, guint index)
 {
@@ -1248,11 +1654,3 @@ free_list_ext_streams (PulseBackend *pulse)
 
     pulse->priv->ext_streams_list = NULL;
 }
-
-static gboolean
-compare_stream_names (gpointer key, gpointer value, gpointer user_data)
-{
-    MateMixerStream *stream = MATE_MIXER_STREAM (value);
-
-    return strcmp (mate_mixer_stream_get_name (stream), (const gchar *) user_data) == 0;
-}
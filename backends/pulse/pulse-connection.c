@@ -24,23 +24,53 @@
 #include <pulse/glib-mainloop.h>
 #include <pulse/ext-stream-restore.h>
 
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+#include <libmatemixer/matemixer-trace-private.h>
+
 #include "pulse-connection.h"
 #include "pulse-enums.h"
 #include "pulse-enum-types.h"
+#include "pulse-helpers.h"
 #include "pulse-monitor.h"
+#include "pulse-record.h"
 
 struct _PulseConnectionPrivate
 {
-    gchar               *server;
-    guint                outstanding;
-    pa_context          *context;
-    pa_proplist         *proplist;
-    pa_glib_mainloop    *mainloop;
-    gboolean             ext_streams_loading;
-    gboolean             ext_streams_dirty;
-    PulseConnectionState state;
+    gchar                         *server;
+    guint                          outstanding;
+    pa_context                    *context;
+    pa_proplist                   *proplist;
+    pa_glib_mainloop              *mainloop;
+    gboolean                       ext_streams_loading;
+    gboolean                       ext_streams_dirty;
+    GHashTable                    *ext_streams_writes;
+    GSource                       *ext_streams_writes_source;
+    guint                          queries;
+    MateMixerStatistics           *statistics;
+    PulseRecorder                 *recorder;
+    PulseReplay                   *replay;
+    PulseConnectionState           state;
+    MateMixerInterestFlags         interests;
+    GSList                        *syncs;
+    const PulseConnectionListener *listener;
+    gpointer                       listener_data;
+    GHashTable                    *profile_changes;
 };
 
+typedef struct {
+    PulseConnection        *connection;
+    PulseConnectionSyncFunc func;
+    gpointer                user_data;
+} PulseConnectionSync;
+
+/* Time in milliseconds for which a card is considered to be changing its
+ * profile after the change has been requested */
+#define CARD_PROFILE_CHANGE_TIMEOUT 2000
+
+#define PULSE_CONNECTION_WANTS(c,i) \
+    (((c)->priv->interests & MATE_MIXER_INTEREST_##i) != 0)
+
 enum {
     PROP_0,
     PROP_SERVER,
@@ -85,6 +115,8 @@ G_DEFINE_TYPE_WITH_PRIVATE (PulseConnection, pulse_connection, G_TYPE_OBJECT);
 
 static gchar    *create_app_name             (void);
 
+static pa_subscription_mask_t get_subscription_mask (PulseConnection         *connection);
+
 static gboolean  load_lists                  (PulseConnection                  *connection);
 static gboolean  load_list_finished          (PulseConnection                  *connection);
 
@@ -97,6 +129,9 @@ static void      pulse_subscribe_cb          (pa_context                       *
 
 static void      pulse_restore_subscribe_cb  (pa_context                       *c,
                                               void                             *userdata);
+static void      pulse_restore_write_cb      (pa_context                       *c,
+                                              int                               success,
+                                              void                             *userdata);
 static void      pulse_server_info_cb        (pa_context                       *c,
                                               const pa_server_info             *info,
                                               void                             *userdata);
@@ -124,12 +159,53 @@ static void      pulse_ext_stream_restore_cb (pa_context                       *
                                               const pa_ext_stream_restore_info *info,
                                               int                               eol,
                                               void                             *userdata);
+static void      pulse_sync_cb               (pa_context                       *c,
+                                              const pa_stat_info               *info,
+                                              void                             *userdata);
 
 static void      change_state                (PulseConnection                  *connection,
                                               PulseConnectionState              state);
 
 static gboolean  process_pulse_operation     (PulseConnection                  *connection,
                                               pa_operation                     *op);
+static gboolean  process_pulse_query         (PulseConnection                  *connection,
+                                              pa_operation                     *op);
+static void      finish_pulse_query          (PulseConnection                  *connection);
+
+static void      emit_signal                 (PulseConnection                  *connection,
+                                              PulseRecordType                   type);
+static void      emit_index_signal           (PulseConnection                  *connection,
+                                              PulseRecordType                   type,
+                                              guint32                           index);
+static void      emit_info_signal            (PulseConnection                  *connection,
+                                              PulseRecordType                   type,
+                                              gconstpointer                     info);
+
+static guint     get_record_signal           (PulseRecordType                   type);
+static guint32   get_record_index            (PulseRecordType                   type,
+                                              gconstpointer                     info) G_GNUC_UNUSED;
+
+static PulseConnectionFunc      get_listener_func       (const PulseConnectionListener *listener,
+                                                         PulseRecordType                type);
+static PulseConnectionIndexFunc get_listener_index_func (const PulseConnectionListener *listener,
+                                                         PulseRecordType                type);
+static PulseConnectionInfoFunc  get_listener_info_func  (const PulseConnectionListener *listener,
+                                                         PulseRecordType                type);
+
+static gboolean  source_flush_ext_streams    (PulseConnection                  *connection);
+
+static gboolean  write_ext_streams           (PulseConnection                  *connection);
+static void      clear_ext_stream_writes     (PulseConnection                  *connection);
+
+static void      fail_syncs                  (PulseConnection                  *connection);
+
+static pa_ext_stream_restore_info *ext_stream_info_copy (const pa_ext_stream_restore_info *info);
+static void                        ext_stream_info_free (pa_ext_stream_restore_info       *info);
+
+static void      replay_record               (PulseRecordType                   type,
+                                              gconstpointer                     info,
+                                              guint32                           index,
+                                              gpointer                          user_data);
 
 static void
 pulse_connection_class_init (PulseConnectionClass *klass)
@@ -378,6 +454,22 @@ static void
 pulse_connection_init (PulseConnection *connection)
 {
     connection->priv = pulse_connection_get_instance_private (connection);
+
+    /* Stream-restore entries waiting to be written, keyed by the entry name */
+    connection->priv->ext_streams_writes =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               NULL,
+                               (GDestroyNotify) ext_stream_info_free);
+
+    /* Deadlines of requested card profile changes, keyed by the card name */
+    connection->priv->profile_changes =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               g_free,
+                               g_free);
+
+    connection->priv->interests = MATE_MIXER_INTEREST_ALL;
 }
 
 static void
@@ -389,9 +481,20 @@ pulse_connection_finalize (GObject *object)
 
     g_free (connection->priv->server);
 
+    clear_ext_stream_writes (connection);
+    g_hash_table_unref (connection->priv->ext_streams_writes);
+    g_hash_table_unref (connection->priv->profile_changes);
+
+    fail_syncs (connection);
+
     if (connection->priv->context != NULL)
         pa_context_unref (connection->priv->context);
 
+    if (connection->priv->replay != NULL)
+        pulse_replay_free (connection->priv->replay);
+    if (connection->priv->recorder != NULL)
+        pulse_recorder_free (connection->priv->recorder);
+
     pa_proplist_free (connection->priv->proplist);
     pa_glib_mainloop_free (connection->priv->mainloop);
 
@@ -408,6 +511,7 @@ pulse_connection_new (const gchar *app_name,
     pa_glib_mainloop *mainloop;
     pa_proplist      *proplist;
     PulseConnection  *connection;
+    const gchar      *path;
 
     mainloop = pa_glib_mainloop_new (g_main_context_get_thread_default ());
     if (G_UNLIKELY (mainloop == NULL)) {
@@ -442,6 +546,12 @@ pulse_connection_new (const gchar *app_name,
     connection->priv->mainloop = mainloop;
     connection->priv->proplist = proplist;
 
+    /* Optionally record the events delivered by the connection, the file
+     * can later be replayed instead of connecting to a server */
+    path = g_getenv ("LIBMATEMIXER_PULSE_RECORD");
+    if (path != NULL && *path != '\0')
+        connection->priv->recorder = pulse_recorder_new (path);
+
     return connection;
 }
 
@@ -451,12 +561,34 @@ pulse_connection_connect (PulseConnection *connection, gboolean wait_for_daemon)
     pa_context         *context;
     pa_context_flags_t  flags = PA_CONTEXT_NOFLAGS;
     pa_mainloop_api    *mainloop;
+    const gchar        *path;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
     if (connection->priv->state != PULSE_CONNECTION_DISCONNECTED)
         return TRUE;
 
+    path = g_getenv ("LIBMATEMIXER_PULSE_REPLAY");
+    if (path != NULL && *path != '\0') {
+        const gchar *speed;
+
+        speed = g_getenv ("LIBMATEMIXER_PULSE_REPLAY_SPEED");
+
+        /* Replay a recording instead of connecting to the server, the
+         * replay uses the original timing unless a speed factor is given,
+         * zero speed replays the events as fast as possible */
+        connection->priv->replay =
+            pulse_replay_new (path, (speed != NULL) ? g_ascii_strtod (speed, NULL) : 1.0);
+
+        if (connection->priv->replay == NULL)
+            return FALSE;
+
+        change_state (connection, PULSE_CONNECTION_CONNECTING);
+
+        pulse_replay_start (connection->priv->replay, replay_record, connection);
+        return TRUE;
+    }
+
     mainloop = pa_glib_mainloop_get_api (connection->priv->mainloop);
     context  = pa_context_new_with_proplist (mainloop,
                                              NULL,
@@ -500,9 +632,27 @@ pulse_connection_disconnect (PulseConnection *connection)
 
     connection->priv->context = NULL;
     connection->priv->outstanding = 0;
+
+    if (connection->priv->replay != NULL) {
+        pulse_replay_free (connection->priv->replay);
+        connection->priv->replay = NULL;
+    }
+
+    /* The queries in flight will never be finished */
+    while (connection->priv->queries > 0)
+        finish_pulse_query (connection);
+
     connection->priv->ext_streams_loading = FALSE;
     connection->priv->ext_streams_dirty = FALSE;
 
+    /* The pending writes are lost together with the connection */
+    clear_ext_stream_writes (connection);
+
+    g_hash_table_remove_all (connection->priv->profile_changes);
+
+    /* The callbacks of the waiting syncs will never be called */
+    fail_syncs (connection);
+
     change_state (connection, PULSE_CONNECTION_DISCONNECTED);
 }
 
@@ -514,6 +664,42 @@ pulse_connection_get_state (PulseConnection *connection)
     return connection->priv->state;
 }
 
+MateMixerStatistics *
+pulse_connection_get_statistics (PulseConnection *connection)
+{
+    g_return_val_if_fail (PULSE_IS_CONNECTION (connection), NULL);
+
+    return connection->priv->statistics;
+}
+
+void
+pulse_connection_set_statistics (PulseConnection *connection, MateMixerStatistics *statistics)
+{
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    connection->priv->statistics = statistics;
+}
+
+void
+pulse_connection_set_listener (PulseConnection               *connection,
+                               const PulseConnectionListener *listener,
+                               gpointer                       user_data)
+{
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    /* The listener is not copied and must stay valid until it is unset */
+    connection->priv->listener      = listener;
+    connection->priv->listener_data = user_data;
+}
+
+void
+pulse_connection_set_interests (PulseConnection *connection, MateMixerInterestFlags interests)
+{
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    connection->priv->interests = interests;
+}
+
 gboolean
 pulse_connection_load_server_info (PulseConnection *connection)
 {
@@ -521,15 +707,16 @@ pulse_connection_load_server_info (PulseConnection *connection)
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_get_server_info (connection->priv->context,
                                      pulse_server_info_cb,
                                      connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -539,8 +726,9 @@ pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     if (index == PA_INVALID_INDEX)
@@ -553,7 +741,7 @@ pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
                                             pulse_card_info_cb,
                                             connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -564,8 +752,9 @@ pulse_connection_load_card_info_name (PulseConnection *connection, const gchar *
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_get_card_info_by_name (connection->priv->context,
@@ -573,7 +762,7 @@ pulse_connection_load_card_info_name (PulseConnection *connection, const gchar *
                                            pulse_card_info_cb,
                                            connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -583,8 +772,9 @@ pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     if (index == PA_INVALID_INDEX)
@@ -597,7 +787,7 @@ pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
                                             pulse_sink_info_cb,
                                             connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -608,8 +798,9 @@ pulse_connection_load_sink_info_name (PulseConnection *connection, const gchar *
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_get_sink_info_by_name (connection->priv->context,
@@ -617,7 +808,7 @@ pulse_connection_load_sink_info_name (PulseConnection *connection, const gchar *
                                            pulse_sink_info_cb,
                                            connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -627,8 +818,9 @@ pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 inde
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     if (index == PA_INVALID_INDEX)
@@ -641,7 +833,7 @@ pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 inde
                                                   pulse_sink_input_info_cb,
                                                   connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -651,8 +843,9 @@ pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     if (index == PA_INVALID_INDEX)
@@ -665,7 +858,7 @@ pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
                                               pulse_source_info_cb,
                                               connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -676,8 +869,9 @@ pulse_connection_load_source_info_name (PulseConnection *connection, const gchar
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_get_source_info_by_name (connection->priv->context,
@@ -685,7 +879,7 @@ pulse_connection_load_source_info_name (PulseConnection *connection, const gchar
                                              pulse_source_info_cb,
                                              connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -695,8 +889,9 @@ pulse_connection_load_source_output_info (PulseConnection *connection, guint32 i
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     if (index == PA_INVALID_INDEX)
@@ -709,7 +904,7 @@ pulse_connection_load_source_output_info (PulseConnection *connection, guint32 i
                                                      pulse_source_output_info_cb,
                                                      connection);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_query (connection, op);
 }
 
 gboolean
@@ -719,8 +914,9 @@ pulse_connection_load_ext_stream_info (PulseConnection *connection)
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_LOADING &&
-        connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if ((connection->priv->state != PULSE_CONNECTION_LOADING &&
+         connection->priv->state != PULSE_CONNECTION_CONNECTED) ||
+        connection->priv->context == NULL)
         return FALSE;
 
     /* When we receive a request to load the list of ext-streams, see if
@@ -737,20 +933,16 @@ pulse_connection_load_ext_stream_info (PulseConnection *connection)
 
     connection->priv->ext_streams_dirty = FALSE;
     connection->priv->ext_streams_loading = TRUE;
-    g_signal_emit (G_OBJECT (connection),
-                   signals[EXT_STREAM_LOADING],
-                   0);
+    emit_signal (connection, PULSE_RECORD_EXT_STREAM_LOADING);
 
     op = pa_ext_stream_restore_read (connection->priv->context,
                                      pulse_ext_stream_restore_cb,
                                      connection);
 
-    if (process_pulse_operation (connection, op) == FALSE) {
+    if (process_pulse_query (connection, op) == FALSE) {
         connection->priv->ext_streams_loading = FALSE;
 
-        g_signal_emit (G_OBJECT (connection),
-                       signals[EXT_STREAM_LOADED],
-                       0);
+        emit_signal (connection, PULSE_RECORD_EXT_STREAM_LOADED);
         return FALSE;
     }
     return TRUE;
@@ -763,7 +955,8 @@ pulse_connection_create_monitor (PulseConnection *connection,
 {
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), NULL);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return NULL;
 
     return pulse_monitor_new (connection->priv->context,
@@ -781,7 +974,8 @@ pulse_connection_set_default_sink (PulseConnection *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_default_sink (connection->priv->context,
@@ -800,7 +994,8 @@ pulse_connection_set_default_source (PulseConnection *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_default_source (connection->priv->context,
@@ -816,12 +1011,14 @@ pulse_connection_set_card_profile (PulseConnection *connection,
                                    const gchar     *profile)
 {
     pa_operation *op;
+    gint64       *deadline;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (card != NULL, FALSE);
     g_return_val_if_fail (profile != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_card_profile_by_name (connection->priv->context,
@@ -829,7 +1026,38 @@ pulse_connection_set_card_profile (PulseConnection *connection,
                                               profile,
                                               NULL, NULL);
 
-    return process_pulse_operation (connection, op);
+    if (process_pulse_operation (connection, op) == FALSE)
+        return FALSE;
+
+    /* The streams of the card are going to be removed and created again,
+     * remember the change for a while so the backend can recognize it */
+    deadline  = g_new (gint64, 1);
+    *deadline = g_get_monotonic_time () + CARD_PROFILE_CHANGE_TIMEOUT * 1000;
+
+    g_hash_table_insert (connection->priv->profile_changes,
+                         g_strdup (card),
+                         deadline);
+    return TRUE;
+}
+
+gboolean
+pulse_connection_is_changing_profile (PulseConnection *connection,
+                                      const gchar     *card)
+{
+    gint64 *deadline;
+
+    g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
+    g_return_val_if_fail (card != NULL, FALSE);
+
+    deadline = g_hash_table_lookup (connection->priv->profile_changes, card);
+    if (deadline == NULL)
+        return FALSE;
+
+    if (g_get_monotonic_time () < *deadline)
+        return TRUE;
+
+    g_hash_table_remove (connection->priv->profile_changes, card);
+    return FALSE;
 }
 
 gboolean
@@ -841,7 +1069,8 @@ pulse_connection_set_sink_mute (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_sink_mute_by_index (connection->priv->context,
@@ -862,7 +1091,8 @@ pulse_connection_set_sink_volume (PulseConnection  *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_sink_volume_by_index (connection->priv->context,
@@ -883,7 +1113,8 @@ pulse_connection_set_sink_port (PulseConnection *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (port != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_sink_port_by_index (connection->priv->context,
@@ -903,7 +1134,8 @@ pulse_connection_set_sink_input_mute (PulseConnection  *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_sink_input_mute (connection->priv->context,
@@ -924,7 +1156,8 @@ pulse_connection_set_sink_input_volume (PulseConnection  *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_sink_input_volume (connection->priv->context,
@@ -944,7 +1177,8 @@ pulse_connection_set_source_mute (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_source_mute_by_index (connection->priv->context,
@@ -965,7 +1199,8 @@ pulse_connection_set_source_volume (PulseConnection  *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_source_volume_by_index (connection->priv->context,
@@ -986,7 +1221,8 @@ pulse_connection_set_source_port (PulseConnection *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (port != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_source_port_by_index (connection->priv->context,
@@ -1006,7 +1242,8 @@ pulse_connection_set_source_output_mute (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_source_output_mute (connection->priv->context,
@@ -1027,7 +1264,8 @@ pulse_connection_set_source_output_volume (PulseConnection  *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (volume != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_set_source_output_volume (connection->priv->context,
@@ -1047,7 +1285,8 @@ pulse_connection_suspend_sink (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_suspend_sink_by_index (connection->priv->context,
@@ -1067,7 +1306,8 @@ pulse_connection_suspend_source (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_suspend_source_by_index (connection->priv->context,
@@ -1087,7 +1327,8 @@ pulse_connection_move_sink_input (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_move_sink_input_by_index (connection->priv->context,
@@ -1107,7 +1348,8 @@ pulse_connection_move_source_output (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_move_source_output_by_index (connection->priv->context,
@@ -1126,7 +1368,8 @@ pulse_connection_kill_sink_input (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_kill_sink_input (connection->priv->context,
@@ -1144,7 +1387,8 @@ pulse_connection_kill_source_output (PulseConnection *connection,
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     op = pa_context_kill_source_output (connection->priv->context,
@@ -1158,21 +1402,61 @@ gboolean
 pulse_connection_write_ext_stream (PulseConnection                  *connection,
                                    const pa_ext_stream_restore_info *info)
 {
-    pa_operation *op;
+    pa_ext_stream_restore_info *copy;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (info != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
-    op = pa_ext_stream_restore_write (connection->priv->context,
-                                      PA_UPDATE_REPLACE,
-                                      info, 1,
-                                      TRUE,
-                                      NULL, NULL);
+    /* Changes are collected and written all at once when the main loop
+     * becomes idle, a later change of the same entry replaces the earlier
+     * one */
+    copy = ext_stream_info_copy (info);
+
+    g_hash_table_replace (connection->priv->ext_streams_writes,
+                          (gpointer) copy->name,
+                          copy);
+
+    if (connection->priv->ext_streams_writes_source == NULL) {
+        /* Flush in the main context of the thread which owns the connection,
+         * the PulseAudio main loop is attached to the same one */
+        connection->priv->ext_streams_writes_source = g_idle_source_new ();
+        g_source_set_callback (connection->priv->ext_streams_writes_source,
+                               (GSourceFunc) source_flush_ext_streams,
+                               connection,
+                               NULL);
+        g_source_attach (connection->priv->ext_streams_writes_source,
+                         g_main_context_get_thread_default ());
+    }
 
-    return process_pulse_operation (connection, op);
+    return TRUE;
+}
+
+const pa_ext_stream_restore_info *
+pulse_connection_get_ext_stream_write (PulseConnection *connection,
+                                       const gchar     *name)
+{
+    g_return_val_if_fail (PULSE_IS_CONNECTION (connection), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    return g_hash_table_lookup (connection->priv->ext_streams_writes, name);
+}
+
+gboolean
+pulse_connection_flush_ext_streams (PulseConnection *connection)
+{
+    g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
+
+    if (connection->priv->ext_streams_writes_source == NULL)
+        return TRUE;
+
+    g_source_destroy (connection->priv->ext_streams_writes_source);
+    g_clear_pointer (&connection->priv->ext_streams_writes_source, g_source_unref);
+
+    return write_ext_streams (connection);
 }
 
 gboolean
@@ -1185,7 +1469,8 @@ pulse_connection_delete_ext_stream (PulseConnection *connection,
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
     g_return_val_if_fail (name != NULL, FALSE);
 
-    if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
         return FALSE;
 
     names    = g_new (gchar *, 2);
@@ -1201,6 +1486,45 @@ pulse_connection_delete_ext_stream (PulseConnection *connection,
     return process_pulse_operation (connection, op);
 }
 
+gboolean
+pulse_connection_sync (PulseConnection        *connection,
+                       PulseConnectionSyncFunc func,
+                       gpointer                user_data)
+{
+    PulseConnectionSync *sync;
+    pa_operation        *op;
+
+    g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
+    g_return_val_if_fail (func != NULL, FALSE);
+
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL)
+        return FALSE;
+
+    /* Make sure the deferred stream-restore writes are sent before the sync */
+    pulse_connection_flush_ext_streams (connection);
+
+    sync = g_slice_new (PulseConnectionSync);
+    sync->connection = connection;
+    sync->func       = func;
+    sync->user_data  = user_data;
+
+    /* PulseAudio replies to the requests in the order they were sent, so the
+     * reply to this request arrives after the replies to all the operations
+     * issued before */
+    op = pa_context_stat (connection->priv->context,
+                          pulse_sync_cb,
+                          sync);
+
+    if (process_pulse_operation (connection, op) == FALSE) {
+        g_slice_free (PulseConnectionSync, sync);
+        return FALSE;
+    }
+
+    connection->priv->syncs = g_slist_prepend (connection->priv->syncs, sync);
+    return TRUE;
+}
+
 static gchar *
 create_app_name (void)
 {
@@ -1218,71 +1542,110 @@ create_app_name (void)
     return g_strdup_printf ("libmatemixer-%lu", (gulong) getpid ());
 }
 
+static pa_subscription_mask_t
+get_subscription_mask (PulseConnection *connection)
+{
+    pa_subscription_mask_t mask = PA_SUBSCRIPTION_MASK_SERVER;
+
+    if (PULSE_CONNECTION_WANTS (connection, DEVICES))
+        mask |= PA_SUBSCRIPTION_MASK_CARD;
+
+    if (PULSE_CONNECTION_WANTS (connection, STREAMS) ||
+        PULSE_CONNECTION_WANTS (connection, APPLICATION_CONTROLS))
+        mask |= PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE;
+
+    if (PULSE_CONNECTION_WANTS (connection, APPLICATION_CONTROLS))
+        mask |= PA_SUBSCRIPTION_MASK_SINK_INPUT | PA_SUBSCRIPTION_MASK_SOURCE_OUTPUT;
+
+    return mask;
+}
+
 static gboolean
 load_lists (PulseConnection *connection)
 {
     GSList       *ops = NULL;
     pa_operation *op;
+    guint         outstanding = 0;
 
     if (G_UNLIKELY (connection->priv->outstanding > 0)) {
         g_warn_if_reached ();
         return FALSE;
     }
 
-    op = pa_context_get_card_info_list (connection->priv->context,
-                                        pulse_card_info_cb,
-                                        connection);
-    if (G_UNLIKELY (op == NULL))
-        goto error;
+    /* Only download the lists of objects the application is interested in,
+     * sinks and sources are also needed by the application controls */
+    if (PULSE_CONNECTION_WANTS (connection, DEVICES)) {
+        op = pa_context_get_card_info_list (connection->priv->context,
+                                            pulse_card_info_cb,
+                                            connection);
+        if (G_UNLIKELY (op == NULL))
+            goto error;
 
-    ops = g_slist_prepend (ops, op);
+        ops = g_slist_prepend (ops, op);
+        outstanding++;
+    }
 
-    op = pa_context_get_sink_info_list (connection->priv->context,
-                                        pulse_sink_info_cb,
-                                        connection);
-    if (G_UNLIKELY (op == NULL))
-        goto error;
+    if (PULSE_CONNECTION_WANTS (connection, STREAMS) ||
+        PULSE_CONNECTION_WANTS (connection, APPLICATION_CONTROLS)) {
+        op = pa_context_get_sink_info_list (connection->priv->context,
+                                            pulse_sink_info_cb,
+                                            connection);
+        if (G_UNLIKELY (op == NULL))
+            goto error;
 
-    ops = g_slist_prepend (ops, op);
+        ops = g_slist_prepend (ops, op);
 
-    op = pa_context_get_sink_input_info_list (connection->priv->context,
-                                              pulse_sink_input_info_cb,
+        op = pa_context_get_source_info_list (connection->priv->context,
+                                              pulse_source_info_cb,
                                               connection);
-    if (G_UNLIKELY (op == NULL))
-        goto error;
-
-    ops = g_slist_prepend (ops, op);
-
-    op = pa_context_get_source_info_list (connection->priv->context,
-                                          pulse_source_info_cb,
-                                          connection);
-    if (G_UNLIKELY (op == NULL))
-        goto error;
+        if (G_UNLIKELY (op == NULL))
+            goto error;
 
-    ops = g_slist_prepend (ops, op);
+        ops = g_slist_prepend (ops, op);
+        outstanding += 2;
+    }
 
-    op = pa_context_get_source_output_info_list (connection->priv->context,
-                                                 pulse_source_output_info_cb,
-                                                 connection);
-    if (G_UNLIKELY (op == NULL))
-        goto error;
+    if (PULSE_CONNECTION_WANTS (connection, APPLICATION_CONTROLS)) {
+        op = pa_context_get_sink_input_info_list (connection->priv->context,
+                                                  pulse_sink_input_info_cb,
+                                                  connection);
+        if (G_UNLIKELY (op == NULL))
+            goto error;
 
-    ops = g_slist_prepend (ops, op);
+        ops = g_slist_prepend (ops, op);
 
-    connection->priv->outstanding = 5;
+        op = pa_context_get_source_output_info_list (connection->priv->context,
+                                                     pulse_source_output_info_cb,
+                                                     connection);
+        if (G_UNLIKELY (op == NULL))
+            goto error;
 
-    /* This might not always be supported */
-    op = pa_ext_stream_restore_read (connection->priv->context,
-                                     pulse_ext_stream_restore_cb,
-                                     connection);
-    if (op != NULL) {
         ops = g_slist_prepend (ops, op);
-        connection->priv->outstanding++;
+        outstanding += 2;
     }
 
-    g_slist_foreach (ops, (GFunc) pa_operation_unref, NULL);
-    g_slist_free (ops);
+    if (PULSE_CONNECTION_WANTS (connection, STORED_CONTROLS)) {
+        /* This might not always be supported */
+        op = pa_ext_stream_restore_read (connection->priv->context,
+                                         pulse_ext_stream_restore_cb,
+                                         connection);
+        if (op != NULL) {
+            ops = g_slist_prepend (ops, op);
+            outstanding++;
+        }
+    }
+
+    /* Nothing to wait for, continue with the server information */
+    if (outstanding == 0)
+        return pulse_connection_load_server_info (connection);
 
+    connection->priv->outstanding = outstanding;
+
+    /* Each of the lists is finished by its own callback */
+    while (ops != NULL) {
+        process_pulse_query (connection, ops->data);
+        ops = g_slist_delete_link (ops, ops);
+    }
     return TRUE;
 
 error:
@@ -1341,24 +1704,22 @@ pulse_state_cb (pa_context *c, void *userdata)
         pa_context_set_subscribe_callback (connection->priv->context,
                                            pulse_subscribe_cb,
                                            connection);
-        pa_ext_stream_restore_set_subscribe_cb (connection->priv->context,
-                                                pulse_restore_subscribe_cb,
-                                                connection);
 
-        op = pa_ext_stream_restore_subscribe (connection->priv->context,
-                                              TRUE,
-                                              NULL, NULL);
+        if (PULSE_CONNECTION_WANTS (connection, STORED_CONTROLS)) {
+            pa_ext_stream_restore_set_subscribe_cb (connection->priv->context,
+                                                    pulse_restore_subscribe_cb,
+                                                    connection);
+
+            op = pa_ext_stream_restore_subscribe (connection->priv->context,
+                                                  TRUE,
+                                                  NULL, NULL);
 
-        /* Keep going if this operation fails */
-        process_pulse_operation (connection, op);
+            /* Keep going if this operation fails */
+            process_pulse_operation (connection, op);
+        }
 
         op = pa_context_subscribe (connection->priv->context,
-                                   PA_SUBSCRIPTION_MASK_SERVER |
-                                   PA_SUBSCRIPTION_MASK_CARD |
-                                   PA_SUBSCRIPTION_MASK_SINK |
-                                   PA_SUBSCRIPTION_MASK_SOURCE |
-                                   PA_SUBSCRIPTION_MASK_SINK_INPUT |
-                                   PA_SUBSCRIPTION_MASK_SOURCE_OUTPUT,
+                                   get_subscription_mask (connection),
                                    NULL, NULL);
 
         if (process_pulse_operation (connection, op) == TRUE) {
@@ -1393,6 +1754,21 @@ pulse_subscribe_cb (pa_context                   *c,
 
     connection = PULSE_CONNECTION (userdata);
 
+    MATE_MIXER_TRACE (pulse_subscribe,
+                      t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK,
+                      t & PA_SUBSCRIPTION_EVENT_TYPE_MASK,
+                      idx);
+
+    if (connection->priv->statistics != NULL)
+        _mate_mixer_statistics_add_event (connection->priv->statistics,
+                                          pulse_convert_facility (t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK));
+
+    if (connection->priv->recorder != NULL)
+        pulse_recorder_write (connection->priv->recorder,
+                              PULSE_RECORD_SUBSCRIBE,
+                              GUINT_TO_POINTER (t),
+                              idx);
+
     switch (t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) {
     case PA_SUBSCRIPTION_EVENT_SERVER:
         pulse_connection_load_server_info (connection);
@@ -1400,50 +1776,35 @@ pulse_subscribe_cb (pa_context                   *c,
 
     case PA_SUBSCRIPTION_EVENT_CARD:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
-            g_signal_emit (G_OBJECT (connection),
-                           signals[CARD_REMOVED],
-                           0,
-                           idx);
+            emit_index_signal (connection, PULSE_RECORD_CARD_REMOVED, idx);
         else
             pulse_connection_load_card_info (connection, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SINK:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
-            g_signal_emit (G_OBJECT (connection),
-                           signals[SINK_REMOVED],
-                           0,
-                           idx);
+            emit_index_signal (connection, PULSE_RECORD_SINK_REMOVED, idx);
         else
             pulse_connection_load_sink_info (connection, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
-            g_signal_emit (G_OBJECT (connection),
-                           signals[SINK_INPUT_REMOVED],
-                           0,
-                           idx);
+            emit_index_signal (connection, PULSE_RECORD_SINK_INPUT_REMOVED, idx);
         else
             pulse_connection_load_sink_input_info (connection, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SOURCE:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
-            g_signal_emit (G_OBJECT (connection),
-                           signals[SOURCE_REMOVED],
-                           0,
-                           idx);
+            emit_index_signal (connection, PULSE_RECORD_SOURCE_REMOVED, idx);
         else
             pulse_connection_load_source_info (connection, idx);
         break;
 
     case PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE)
-            g_signal_emit (G_OBJECT (connection),
-                           signals[SOURCE_OUTPUT_REMOVED],
-                           0,
-                           idx);
+            emit_index_signal (connection, PULSE_RECORD_SOURCE_OUTPUT_REMOVED, idx);
         else
             pulse_connection_load_source_output_info (connection, idx);
         break;
@@ -1457,6 +1818,33 @@ pulse_restore_subscribe_cb (pa_context *c, void *userdata)
 
     connection = PULSE_CONNECTION (userdata);
 
+    if (connection->priv->statistics != NULL)
+        _mate_mixer_statistics_add_event (connection->priv->statistics,
+                                          MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL);
+
+    /* The notification carries no content and cannot be told apart from a
+     * change made by another client, so the database is read again even after
+     * our own writes. Reads requested while one is running are merged, and
+     * the entries which match the written ones are skipped by the
+     * ext-streams without emitting any signals */
+    pulse_connection_load_ext_stream_info (connection);
+}
+
+static void
+pulse_restore_write_cb (pa_context *c, int success, void *userdata)
+{
+    PulseConnection *connection;
+
+    connection = PULSE_CONNECTION (userdata);
+
+    if (success)
+        return;
+
+    g_warning ("Failed to write PulseAudio stream-restore entries: %s",
+               pa_strerror (pa_context_errno (c)));
+
+    /* There is no notification for a failed write, make sure to read the
+     * database to revert the entries we have announced as written */
     pulse_connection_load_ext_stream_info (connection);
 }
 
@@ -1467,17 +1855,18 @@ pulse_server_info_cb (pa_context           *c,
 {
     PulseConnection *connection;
 
+    connection = PULSE_CONNECTION (userdata);
+
+    finish_pulse_query (connection);
+
     if (! info) {
         g_warning ("Failed to get PulseAudio server information: %s", pa_strerror (pa_context_errno (c)));
         return;
     }
 
-    connection = PULSE_CONNECTION (userdata);
+    MATE_MIXER_TRACE (pulse_server_info, info->default_sink_name, info->default_source_name);
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[SERVER_INFO],
-                   0,
-                   info);
+    emit_info_signal (connection, PULSE_RECORD_SERVER_INFO, info);
 
     /* This notification may arrive at any time, but it also finalizes the
      * connection process */
@@ -1496,15 +1885,16 @@ pulse_card_info_cb (pa_context         *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
+        finish_pulse_query (connection);
+
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
         return;
     }
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[CARD_INFO],
-                   0,
-                   info);
+    MATE_MIXER_TRACE (pulse_card_info, info->index);
+
+    emit_info_signal (connection, PULSE_RECORD_CARD_INFO, info);
 }
 
 static void
@@ -1518,15 +1908,16 @@ pulse_sink_info_cb (pa_context         *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
+        finish_pulse_query (connection);
+
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
         return;
     }
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[SINK_INFO],
-                   0,
-                   info);
+    MATE_MIXER_TRACE (pulse_sink_info, info->index);
+
+    emit_info_signal (connection, PULSE_RECORD_SINK_INFO, info);
 }
 
 static void
@@ -1540,15 +1931,16 @@ pulse_sink_input_info_cb (pa_context               *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
+        finish_pulse_query (connection);
+
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
         return;
     }
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[SINK_INPUT_INFO],
-                   0,
-                   info);
+    MATE_MIXER_TRACE (pulse_sink_input_info, info->index);
+
+    emit_info_signal (connection, PULSE_RECORD_SINK_INPUT_INFO, info);
 }
 
 static void
@@ -1562,15 +1954,16 @@ pulse_source_info_cb (pa_context           *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
+        finish_pulse_query (connection);
+
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
         return;
     }
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[SOURCE_INFO],
-                   0,
-                   info);
+    MATE_MIXER_TRACE (pulse_source_info, info->index);
+
+    emit_info_signal (connection, PULSE_RECORD_SOURCE_INFO, info);
 }
 
 static void
@@ -1584,15 +1977,16 @@ pulse_source_output_info_cb (pa_context                  *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
+        finish_pulse_query (connection);
+
         if (connection->priv->state == PULSE_CONNECTION_LOADING)
             load_list_finished (connection);
         return;
     }
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[SOURCE_OUTPUT_INFO],
-                   0,
-                   info);
+    MATE_MIXER_TRACE (pulse_source_output_info, info->index);
+
+    emit_info_signal (connection, PULSE_RECORD_SOURCE_OUTPUT_INFO, info);
 }
 
 static void
@@ -1606,10 +2000,10 @@ pulse_ext_stream_restore_cb (pa_context                       *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
+        finish_pulse_query (connection);
+
         connection->priv->ext_streams_loading = FALSE;
-        g_signal_emit (G_OBJECT (connection),
-                       signals[EXT_STREAM_LOADED],
-                       0);
+        emit_signal (connection, PULSE_RECORD_EXT_STREAM_LOADED);
 
         if (connection->priv->state == PULSE_CONNECTION_LOADING) {
             if (load_list_finished (connection) == FALSE)
@@ -1622,10 +2016,25 @@ pulse_ext_stream_restore_cb (pa_context                       *c,
         return;
     }
 
-    g_signal_emit (G_OBJECT (connection),
-                   signals[EXT_STREAM_INFO],
-                   0,
-                   info);
+    MATE_MIXER_TRACE (pulse_ext_stream_info, info->name);
+
+    emit_info_signal (connection, PULSE_RECORD_EXT_STREAM_INFO, info);
+}
+
+static void
+pulse_sync_cb (pa_context *c, const pa_stat_info *info, void *userdata)
+{
+    PulseConnectionSync *sync;
+    PulseConnection     *connection;
+
+    sync       = userdata;
+    connection = sync->connection;
+
+    connection->priv->syncs = g_slist_remove (connection->priv->syncs, sync);
+
+    sync->func (connection, info != NULL, sync->user_data);
+
+    g_slice_free (PulseConnectionSync, sync);
 }
 
 static void
@@ -1636,12 +2045,20 @@ change_state (PulseConnection *connection, PulseConnectionState state)
 
     connection->priv->state = state;
 
+    if (connection->priv->recorder != NULL)
+        pulse_recorder_write (connection->priv->recorder,
+                              PULSE_RECORD_STATE,
+                              NULL,
+                              state);
+
     g_object_notify_by_pspec (G_OBJECT (connection), properties[PROP_STATE]);
 }
 
 static gboolean
 process_pulse_operation (PulseConnection *connection, pa_operation *op)
 {
+    MATE_MIXER_TRACE (pulse_operation, op != NULL, connection->priv->queries);
+
     if (G_UNLIKELY (op == NULL)) {
         g_warning ("PulseAudio operation failed: %s",
                    pa_strerror (pa_context_errno (connection->priv->context)));
@@ -1651,3 +2068,389 @@ process_pulse_operation (PulseConnection *connection, pa_operation *op)
     pa_operation_unref (op);
     return TRUE;
 }
+
+static gboolean
+process_pulse_query (PulseConnection *connection, pa_operation *op)
+{
+    if (process_pulse_operation (connection, op) == FALSE)
+        return FALSE;
+
+    /* The query is finished when its callback receives the last item */
+    connection->priv->queries++;
+
+    if (connection->priv->statistics != NULL) {
+        _mate_mixer_statistics_add_query (connection->priv->statistics);
+        _mate_mixer_statistics_begin_operation (connection->priv->statistics);
+    }
+    return TRUE;
+}
+
+static void
+finish_pulse_query (PulseConnection *connection)
+{
+    if (G_UNLIKELY (connection->priv->queries == 0))
+        return;
+
+    connection->priv->queries--;
+
+    if (connection->priv->statistics != NULL)
+        _mate_mixer_statistics_end_operation (connection->priv->statistics);
+}
+
+static void
+emit_signal (PulseConnection *connection, PulseRecordType type)
+{
+    if (connection->priv->recorder != NULL)
+        pulse_recorder_write (connection->priv->recorder, type, NULL, PA_INVALID_INDEX);
+
+    if (connection->priv->listener != NULL) {
+        PulseConnectionFunc func;
+
+        func = get_listener_func (connection->priv->listener, type);
+        if (func != NULL)
+            func (connection, connection->priv->listener_data);
+    }
+
+    g_signal_emit (G_OBJECT (connection), get_record_signal (type), 0);
+}
+
+static void
+emit_index_signal (PulseConnection *connection, PulseRecordType type, guint32 index)
+{
+    if (connection->priv->recorder != NULL)
+        pulse_recorder_write (connection->priv->recorder, type, NULL, index);
+
+    if (connection->priv->listener != NULL) {
+        PulseConnectionIndexFunc func;
+
+        func = get_listener_index_func (connection->priv->listener, type);
+        if (func != NULL)
+            func (connection, index, connection->priv->listener_data);
+    }
+
+    g_signal_emit (G_OBJECT (connection), get_record_signal (type), 0, index);
+}
+
+static void
+emit_info_signal (PulseConnection *connection, PulseRecordType type, gconstpointer info)
+{
+    gboolean timed;
+    gint64   start = 0;
+    gint64   usec;
+
+    if (connection->priv->recorder != NULL)
+        pulse_recorder_write (connection->priv->recorder, type, info, PA_INVALID_INDEX);
+
+    /* Only read the clock when somebody uses the handler time */
+    timed = (connection->priv->statistics != NULL || MATE_MIXER_TRACE_ENABLED);
+    if (timed == TRUE)
+        start = g_get_monotonic_time ();
+
+    /* The listener is called directly, the signal emission is cheap when
+     * there are no other handlers */
+    if (connection->priv->listener != NULL) {
+        PulseConnectionInfoFunc func;
+
+        func = get_listener_info_func (connection->priv->listener, type);
+        if (func != NULL)
+            func (connection, info, connection->priv->listener_data);
+    }
+
+    g_signal_emit (G_OBJECT (connection), get_record_signal (type), 0, info);
+
+    if (timed == FALSE)
+        return;
+
+    usec = g_get_monotonic_time () - start;
+
+    MATE_MIXER_TRACE (pulse_info_handled, type, get_record_index (type, info), usec);
+
+    /* The statistics might have been removed by the signal handler */
+    if (connection->priv->statistics != NULL)
+        _mate_mixer_statistics_add_handler_time (connection->priv->statistics, usec);
+}
+
+static guint32
+get_record_index (PulseRecordType type, gconstpointer info)
+{
+    switch (type) {
+    case PULSE_RECORD_CARD_INFO:
+        return ((const pa_card_info *) info)->index;
+    case PULSE_RECORD_SINK_INFO:
+        return ((const pa_sink_info *) info)->index;
+    case PULSE_RECORD_SINK_INPUT_INFO:
+        return ((const pa_sink_input_info *) info)->index;
+    case PULSE_RECORD_SOURCE_INFO:
+        return ((const pa_source_info *) info)->index;
+    case PULSE_RECORD_SOURCE_OUTPUT_INFO:
+        return ((const pa_source_output_info *) info)->index;
+    default:
+        return PA_INVALID_INDEX;
+    }
+}
+
+static guint
+get_record_signal (PulseRecordType type)
+{
+    switch (type) {
+    case PULSE_RECORD_SERVER_INFO:
+        return signals[SERVER_INFO];
+    case PULSE_RECORD_CARD_INFO:
+        return signals[CARD_INFO];
+    case PULSE_RECORD_CARD_REMOVED:
+        return signals[CARD_REMOVED];
+    case PULSE_RECORD_SINK_INFO:
+        return signals[SINK_INFO];
+    case PULSE_RECORD_SINK_REMOVED:
+        return signals[SINK_REMOVED];
+    case PULSE_RECORD_SINK_INPUT_INFO:
+        return signals[SINK_INPUT_INFO];
+    case PULSE_RECORD_SINK_INPUT_REMOVED:
+        return signals[SINK_INPUT_REMOVED];
+    case PULSE_RECORD_SOURCE_INFO:
+        return signals[SOURCE_INFO];
+    case PULSE_RECORD_SOURCE_REMOVED:
+        return signals[SOURCE_REMOVED];
+    case PULSE_RECORD_SOURCE_OUTPUT_INFO:
+        return signals[SOURCE_OUTPUT_INFO];
+    case PULSE_RECORD_SOURCE_OUTPUT_REMOVED:
+        return signals[SOURCE_OUTPUT_REMOVED];
+    case PULSE_RECORD_EXT_STREAM_LOADING:
+        return signals[EXT_STREAM_LOADING];
+    case PULSE_RECORD_EXT_STREAM_LOADED:
+        return signals[EXT_STREAM_LOADED];
+    case PULSE_RECORD_EXT_STREAM_INFO:
+        return signals[EXT_STREAM_INFO];
+    default:
+        g_assert_not_reached ();
+    }
+    return 0;
+}
+
+static PulseConnectionFunc
+get_listener_func (const PulseConnectionListener *listener, PulseRecordType type)
+{
+    switch (type) {
+    case PULSE_RECORD_EXT_STREAM_LOADING:
+        return listener->ext_stream_loading;
+    case PULSE_RECORD_EXT_STREAM_LOADED:
+        return listener->ext_stream_loaded;
+    default:
+        break;
+    }
+    return NULL;
+}
+
+static PulseConnectionIndexFunc
+get_listener_index_func (const PulseConnectionListener *listener, PulseRecordType type)
+{
+    switch (type) {
+    case PULSE_RECORD_CARD_REMOVED:
+        return listener->card_removed;
+    case PULSE_RECORD_SINK_REMOVED:
+        return listener->sink_removed;
+    case PULSE_RECORD_SINK_INPUT_REMOVED:
+        return listener->sink_input_removed;
+    case PULSE_RECORD_SOURCE_REMOVED:
+        return listener->source_removed;
+    case PULSE_RECORD_SOURCE_OUTPUT_REMOVED:
+        return listener->source_output_removed;
+    default:
+        break;
+    }
+    return NULL;
+}
+
+static PulseConnectionInfoFunc
+get_listener_info_func (const PulseConnectionListener *listener, PulseRecordType type)
+{
+    switch (type) {
+    case PULSE_RECORD_SERVER_INFO:
+        return listener->server_info;
+    case PULSE_RECORD_CARD_INFO:
+        return listener->card_info;
+    case PULSE_RECORD_SINK_INFO:
+        return listener->sink_info;
+    case PULSE_RECORD_SINK_INPUT_INFO:
+        return listener->sink_input_info;
+    case PULSE_RECORD_SOURCE_INFO:
+        return listener->source_info;
+    case PULSE_RECORD_SOURCE_OUTPUT_INFO:
+        return listener->source_output_info;
+    case PULSE_RECORD_EXT_STREAM_INFO:
+        return listener->ext_stream_info;
+    default:
+        break;
+    }
+    return NULL;
+}
+
+static void
+replay_record (PulseRecordType type,
+               gconstpointer   info,
+               guint32         index,
+               gpointer        user_data)
+{
+    PulseConnection *connection;
+
+    connection = PULSE_CONNECTION (user_data);
+
+    switch (type) {
+    case PULSE_RECORD_STATE:
+        /* The replayed connection stays open after the recording ends,
+         * it is only closed by the backend */
+        if (index != PULSE_CONNECTION_DISCONNECTED)
+            change_state (connection, (PulseConnectionState) index);
+        break;
+
+    case PULSE_RECORD_SUBSCRIBE:
+        /* The subscription event is followed by the recorded result */
+        if (connection->priv->statistics != NULL)
+            _mate_mixer_statistics_add_event (connection->priv->statistics,
+                                              pulse_convert_facility (GPOINTER_TO_UINT (info) &
+                                                                      PA_SUBSCRIPTION_EVENT_FACILITY_MASK));
+        break;
+
+    case PULSE_RECORD_EXT_STREAM_LOADING:
+        connection->priv->ext_streams_loading = TRUE;
+        emit_signal (connection, type);
+        break;
+
+    case PULSE_RECORD_EXT_STREAM_LOADED:
+        connection->priv->ext_streams_loading = FALSE;
+        emit_signal (connection, type);
+        break;
+
+    case PULSE_RECORD_CARD_REMOVED:
+    case PULSE_RECORD_SINK_REMOVED:
+    case PULSE_RECORD_SINK_INPUT_REMOVED:
+    case PULSE_RECORD_SOURCE_REMOVED:
+    case PULSE_RECORD_SOURCE_OUTPUT_REMOVED:
+        emit_index_signal (connection, type, index);
+        break;
+
+    default:
+        emit_info_signal (connection, type, info);
+        break;
+    }
+}
+
+static gboolean
+source_flush_ext_streams (PulseConnection *connection)
+{
+    g_clear_pointer (&connection->priv->ext_streams_writes_source, g_source_unref);
+
+    write_ext_streams (connection);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+write_ext_streams (PulseConnection *connection)
+{
+    GHashTable                 *writes;
+    GHashTableIter              iter;
+    GArray                     *array;
+    pa_operation               *op;
+    pa_ext_stream_restore_info *info;
+
+    if (g_hash_table_size (connection->priv->ext_streams_writes) == 0)
+        return TRUE;
+
+    /* Take the pending entries as the signal handlers may queue new ones */
+    writes = connection->priv->ext_streams_writes;
+
+    connection->priv->ext_streams_writes =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               NULL,
+                               (GDestroyNotify) ext_stream_info_free);
+
+    if (connection->priv->state != PULSE_CONNECTION_CONNECTED ||
+        connection->priv->context == NULL) {
+        g_hash_table_unref (writes);
+        return FALSE;
+    }
+
+    array = g_array_sized_new (FALSE, FALSE,
+                               sizeof (pa_ext_stream_restore_info),
+                               g_hash_table_size (writes));
+
+    g_hash_table_iter_init (&iter, writes);
+
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &info) == TRUE)
+        g_array_append_vals (array, info, 1);
+
+    op = pa_ext_stream_restore_write (connection->priv->context,
+                                      PA_UPDATE_REPLACE,
+                                      (const pa_ext_stream_restore_info *) array->data,
+                                      array->len,
+                                      TRUE,
+                                      pulse_restore_write_cb,
+                                      connection);
+
+    g_array_free (array, TRUE);
+
+    if (process_pulse_operation (connection, op) == FALSE) {
+        g_hash_table_unref (writes);
+        return FALSE;
+    }
+
+    /* Announce the written entries right away instead of reading the whole
+     * database when the notification about the write arrives */
+    g_hash_table_iter_init (&iter, writes);
+
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &info) == TRUE)
+        emit_info_signal (connection, PULSE_RECORD_EXT_STREAM_INFO, info);
+
+    g_hash_table_unref (writes);
+    return TRUE;
+}
+
+static void
+clear_ext_stream_writes (PulseConnection *connection)
+{
+    if (connection->priv->ext_streams_writes_source != NULL) {
+        g_source_destroy (connection->priv->ext_streams_writes_source);
+        g_clear_pointer (&connection->priv->ext_streams_writes_source, g_source_unref);
+    }
+
+    g_hash_table_remove_all (connection->priv->ext_streams_writes);
+}
+
+static pa_ext_stream_restore_info *
+ext_stream_info_copy (const pa_ext_stream_restore_info *info)
+{
+    pa_ext_stream_restore_info *copy;
+
+    copy = g_slice_dup (pa_ext_stream_restore_info, info);
+
+    copy->name   = g_strdup (info->name);
+    copy->device = g_strdup (info->device);
+
+    return copy;
+}
+
+static void
+fail_syncs (PulseConnection *connection)
+{
+    while (connection->priv->syncs != NULL) {
+        PulseConnectionSync *sync = connection->priv->syncs->data;
+
+        connection->priv->syncs = g_slist_delete_link (connection->priv->syncs,
+                                                       connection->priv->syncs);
+
+        sync->func (connection, FALSE, sync->user_data);
+
+        g_slice_free (PulseConnectionSync, sync);
+    }
+}
+
+static void
+ext_stream_info_free (pa_ext_stream_restore_info *info)
+{
+    g_free ((gchar *) info->name);
+    g_free ((gchar *) info->device);
+
+    g_slice_free (pa_ext_stream_restore_info, info);
+}
@@ -24,6 +24,8 @@
 #include <pulse/pulseaudio.h>
 #include <pulse/ext-stream-restore.h>
 
+#include <libmatemixer/matemixer.h>
+
 #include "pulse-enums.h"
 #include "pulse-types.h"
 
@@ -45,6 +47,46 @@ G_BEGIN_DECLS
 typedef struct _PulseConnectionClass    PulseConnectionClass;
 typedef struct _PulseConnectionPrivate  PulseConnectionPrivate;
 
+typedef void (*PulseConnectionSyncFunc) (PulseConnection *connection,
+                                         gboolean         success,
+                                         gpointer         user_data);
+
+typedef void (*PulseConnectionFunc)      (PulseConnection *connection,
+                                          gpointer         user_data);
+typedef void (*PulseConnectionIndexFunc) (PulseConnection *connection,
+                                          guint32          index,
+                                          gpointer         user_data);
+typedef void (*PulseConnectionInfoFunc)  (PulseConnection *connection,
+                                          gconstpointer    info,
+                                          gpointer         user_data);
+
+/*
+ * The listener receives the same notifications as the signals of the
+ * connection, but it is called directly without the overhead of a signal
+ * emission. It is meant for the backend, which handles every introspection
+ * result, the signals remain available for other users.
+ *
+ * The info passed to the info functions is the PulseAudio info structure
+ * of the given type, any of the functions may be NULL.
+ */
+typedef struct
+{
+    PulseConnectionInfoFunc  server_info;
+    PulseConnectionInfoFunc  card_info;
+    PulseConnectionIndexFunc card_removed;
+    PulseConnectionInfoFunc  sink_info;
+    PulseConnectionIndexFunc sink_removed;
+    PulseConnectionInfoFunc  sink_input_info;
+    PulseConnectionIndexFunc sink_input_removed;
+    PulseConnectionInfoFunc  source_info;
+    PulseConnectionIndexFunc source_removed;
+    PulseConnectionInfoFunc  source_output_info;
+    PulseConnectionIndexFunc source_output_removed;
+    PulseConnectionFunc      ext_stream_loading;
+    PulseConnectionFunc      ext_stream_loaded;
+    PulseConnectionInfoFunc  ext_stream_info;
+} PulseConnectionListener;
+
 struct _PulseConnection
 {
     GObject parent;
@@ -106,6 +148,15 @@ void                 pulse_connection_disconnect               (PulseConnection
 
 PulseConnectionState pulse_connection_get_state                (PulseConnection                  *connection);
 
+MateMixerStatistics *pulse_connection_get_statistics           (PulseConnection                  *connection);
+void                 pulse_connection_set_statistics           (PulseConnection                  *connection,
+                                                                MateMixerStatistics              *statistics);
+void                 pulse_connection_set_listener             (PulseConnection                  *connection,
+                                                                const PulseConnectionListener    *listener,
+                                                                gpointer                          user_data);
+void                 pulse_connection_set_interests            (PulseConnection                  *connection,
+                                                                MateMixerInterestFlags            interests);
+
 gboolean             pulse_connection_load_server_info         (PulseConnection                  *connection);
 
 gboolean             pulse_connection_load_card_info           (PulseConnection                  *connection,
@@ -143,6 +194,8 @@ gboolean             pulse_connection_set_default_source       (PulseConnection
 gboolean             pulse_connection_set_card_profile         (PulseConnection                  *connection,
                                                                 const gchar                      *device,
                                                                 const gchar                      *profile);
+gboolean             pulse_connection_is_changing_profile      (PulseConnection                  *connection,
+                                                                const gchar                      *device);
 
 gboolean             pulse_connection_set_sink_mute            (PulseConnection                  *connection,
                                                                 guint32                           index,
@@ -199,9 +252,17 @@ gboolean             pulse_connection_kill_source_output       (PulseConnection
 
 gboolean             pulse_connection_write_ext_stream         (PulseConnection                  *connection,
                                                                 const pa_ext_stream_restore_info *info);
+const pa_ext_stream_restore_info *
+                     pulse_connection_get_ext_stream_write     (PulseConnection                  *connection,
+                                                                const gchar                      *name);
+gboolean             pulse_connection_flush_ext_streams        (PulseConnection                  *connection);
 gboolean             pulse_connection_delete_ext_stream        (PulseConnection                  *connection,
                                                                 const gchar                      *name);
 
+gboolean             pulse_connection_sync                     (PulseConnection                  *connection,
+                                                                PulseConnectionSyncFunc           func,
+                                                                gpointer                          user_data);
+
 G_END_DECLS
 
 #endif /* PULSE_CONNECTION_H */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include <pulse/pulseaudio.h>
+
+#include "pulse-control-record.h"
+#include "pulse-stream-control.h"
+
+/* Sink input and source output information structures share the names of
+ * the fields used here */
+#define RECORD_UPDATE(r,i)                                              \
+    G_STMT_START {                                                      \
+        (r)->mute            = (i)->mute ? TRUE : FALSE;                \
+        (r)->has_volume      = (i)->has_volume ? TRUE : FALSE;          \
+        (r)->volume_writable = (i)->volume_writable ? TRUE : FALSE;     \
+        (r)->channel_map     = (i)->channel_map;                        \
+        (r)->volume          = (i)->volume;                             \
+    } G_STMT_END
+
+#define RECORD_NEW(r,i)                                                 \
+    G_STMT_START {                                                      \
+        (r) = g_slice_new0 (PulseControlRecord);                        \
+        (r)->index    = (i)->index;                                     \
+        (r)->client   = (i)->client;                                    \
+        (r)->name     = g_strdup ((i)->name);                           \
+        (r)->proplist = pa_proplist_copy ((i)->proplist);               \
+        RECORD_UPDATE (r, i);                                           \
+    } G_STMT_END
+
+#define RECORD_FILL(r,i)                                                \
+    G_STMT_START {                                                      \
+        memset ((i), 0, sizeof (*(i)));                                 \
+        (i)->index           = (r)->index;                              \
+        (i)->client          = (r)->client;                             \
+        (i)->name            = (r)->name;                               \
+        (i)->proplist        = (r)->proplist;                           \
+        (i)->mute            = (r)->mute;                               \
+        (i)->has_volume      = (r)->has_volume;                         \
+        (i)->volume_writable = (r)->volume_writable;                    \
+        (i)->channel_map     = (r)->channel_map;                        \
+        (i)->volume          = (r)->volume;                             \
+    } G_STMT_END
+
+PulseControlRecord *
+pulse_control_record_new_sink_input (const pa_sink_input_info *info)
+{
+    PulseControlRecord *record;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    RECORD_NEW (record, info);
+    return record;
+}
+
+PulseControlRecord *
+pulse_control_record_new_source_output (const pa_source_output_info *info)
+{
+    PulseControlRecord *record;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    RECORD_NEW (record, info);
+    return record;
+}
+
+void
+pulse_control_record_free (PulseControlRecord *record)
+{
+    if (record == NULL)
+        return;
+
+    if (record->control != NULL)
+        g_object_unref (record->control);
+
+    if (record->proplist != NULL)
+        pa_proplist_free (record->proplist);
+
+    g_free (record->name);
+    g_slice_free (PulseControlRecord, record);
+}
+
+void
+pulse_control_record_update_sink_input (PulseControlRecord       *record,
+                                        const pa_sink_input_info *info)
+{
+    g_return_if_fail (record != NULL);
+    g_return_if_fail (info != NULL);
+
+    RECORD_UPDATE (record, info);
+}
+
+void
+pulse_control_record_update_source_output (PulseControlRecord          *record,
+                                           const pa_source_output_info *info)
+{
+    g_return_if_fail (record != NULL);
+    g_return_if_fail (info != NULL);
+
+    RECORD_UPDATE (record, info);
+}
+
+void
+pulse_control_record_fill_sink_input_info (const PulseControlRecord *record,
+                                           pa_sink_input_info       *info)
+{
+    g_return_if_fail (record != NULL);
+    g_return_if_fail (info != NULL);
+
+    RECORD_FILL (record, info);
+}
+
+void
+pulse_control_record_fill_source_output_info (const PulseControlRecord *record,
+                                              pa_source_output_info    *info)
+{
+    g_return_if_fail (record != NULL);
+    g_return_if_fail (info != NULL);
+
+    RECORD_FILL (record, info);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PULSE_CONTROL_RECORD_H
+#define PULSE_CONTROL_RECORD_H
+
+#include <glib.h>
+
+#include <pulse/pulseaudio.h>
+
+#include "pulse-types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Compact description of a sink input or a source output.
+ *
+ * Streams keep a record for each of their application controls and only
+ * create the control object when the application asks for it, until then
+ * an update of the control only refreshes the record.
+ */
+struct _PulseControlRecord
+{
+    guint32             index;
+    guint32             client;
+    gchar              *name;
+    pa_proplist        *proplist;
+    pa_channel_map      channel_map;
+    pa_cvolume          volume;
+    gboolean            mute;
+    gboolean            has_volume;
+    gboolean            volume_writable;
+    PulseStreamControl *control;
+};
+
+PulseControlRecord *pulse_control_record_new_sink_input          (const pa_sink_input_info    *info);
+PulseControlRecord *pulse_control_record_new_source_output       (const pa_source_output_info *info);
+
+void                pulse_control_record_free                    (PulseControlRecord          *record);
+
+void                pulse_control_record_update_sink_input       (PulseControlRecord          *record,
+                                                                  const pa_sink_input_info    *info);
+void                pulse_control_record_update_source_output    (PulseControlRecord          *record,
+                                                                  const pa_source_output_info *info);
+
+void                pulse_control_record_fill_sink_input_info    (const PulseControlRecord    *record,
+                                                                  pa_sink_input_info          *info);
+void                pulse_control_record_fill_source_output_info (const PulseControlRecord    *record,
+                                                                  pa_source_output_info       *info);
+
+G_END_DECLS
+
+#endif /* PULSE_CONTROL_RECORD_H */
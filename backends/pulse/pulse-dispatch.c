@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of the delivery of PulseAudio connection results.
+ *
+ * A recording made with LIBMATEMIXER_PULSE_RECORD=<file> is replayed by a
+ * connection as fast as possible, once with the results delivered through
+ * the listener, which is what the backend uses, and once through the signals
+ * of the connection. The handlers only count the calls, so the difference
+ * is the cost of the delivery itself.
+ */
+
+#include <stdlib.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
+#include <pulse/pulseaudio.h>
+#include <pulse/ext-stream-restore.h>
+
+#include "pulse-connection.h"
+
+typedef struct {
+    gint64  wall_time;
+    guint64 calls;
+} Result;
+
+static const gchar *connection_signals[] = {
+    "server-info",
+    "card-info",
+    "card-removed",
+    "sink-info",
+    "sink-removed",
+    "sink-input-info",
+    "sink-input-removed",
+    "source-info",
+    "source-removed",
+    "source-output-info",
+    "source-output-removed",
+    "ext-stream-loading",
+    "ext-stream-loaded",
+    "ext-stream-info"
+};
+
+static GMainLoop *mainloop;
+
+static void
+on_result (PulseConnection *connection, gpointer user_data)
+{
+    ((Result *) user_data)->calls++;
+}
+
+static void
+on_index_result (PulseConnection *connection, guint32 index, gpointer user_data)
+{
+    ((Result *) user_data)->calls++;
+}
+
+static void
+on_info_result (PulseConnection *connection, gconstpointer info, gpointer user_data)
+{
+    ((Result *) user_data)->calls++;
+}
+
+static const PulseConnectionListener listener = {
+    .server_info           = on_info_result,
+    .card_info             = on_info_result,
+    .card_removed          = on_index_result,
+    .sink_info             = on_info_result,
+    .sink_removed          = on_index_result,
+    .sink_input_info       = on_info_result,
+    .sink_input_removed    = on_index_result,
+    .source_info           = on_info_result,
+    .source_removed        = on_index_result,
+    .source_output_info    = on_info_result,
+    .source_output_removed = on_index_result,
+    .ext_stream_loading    = on_result,
+    .ext_stream_loaded     = on_result,
+    .ext_stream_info       = on_info_result
+};
+
+static gboolean
+on_replay_idle (gpointer data)
+{
+    /* The replay dispatches its records from idle sources of the default
+     * idle priority, this low priority source only runs once it has
+     * finished */
+    g_main_loop_quit (mainloop);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+run_replay (gboolean use_signals, Result *result)
+{
+    PulseConnection *connection;
+    gint64           start;
+    guint            i;
+
+    connection = pulse_connection_new ("Dispatch benchmark", NULL, NULL, NULL, NULL);
+    if (connection == NULL)
+        return FALSE;
+
+    result->calls = 0;
+
+    if (use_signals == TRUE) {
+        /* Each signal is connected to the handler with the matching
+         * arguments, the removed signals pass an index and the loading
+         * signals pass nothing */
+        for (i = 0; i < G_N_ELEMENTS (connection_signals); i++) {
+            GCallback callback;
+
+            if (g_str_has_suffix (connection_signals[i], "-removed"))
+                callback = G_CALLBACK (on_index_result);
+            else if (g_str_has_suffix (connection_signals[i], "-info"))
+                callback = G_CALLBACK (on_info_result);
+            else
+                callback = G_CALLBACK (on_result);
+
+            g_signal_connect (G_OBJECT (connection),
+                              connection_signals[i],
+                              callback,
+                              result);
+        }
+    } else
+        pulse_connection_set_listener (connection, &listener, result);
+
+    start = g_get_monotonic_time ();
+
+    if (pulse_connection_connect (connection, FALSE) == FALSE) {
+        g_object_unref (connection);
+        return FALSE;
+    }
+
+    g_idle_add_full (G_PRIORITY_LOW, on_replay_idle, NULL, NULL);
+    g_main_loop_run (mainloop);
+
+    result->wall_time = g_get_monotonic_time () - start;
+
+    pulse_connection_set_listener (connection, NULL, NULL);
+    pulse_connection_disconnect (connection);
+
+    g_object_unref (connection);
+    return TRUE;
+}
+
+static void
+print_result (const gchar *name, const Result *result, gint iterations)
+{
+    gdouble calls = (gdouble) result->calls / iterations;
+    gdouble usec  = (gdouble) result->wall_time / iterations;
+
+    g_print ("%-10s %12.1f %14.0f %14.3f\n",
+             name,
+             usec / 1000.0,
+             calls,
+             (calls > 0) ? usec / calls : 0.0);
+}
+
+int main (int argc, char *argv[])
+{
+    GOptionContext *ctx;
+    GError         *error      = NULL;
+    gint            iterations = 10;
+    gint            i;
+    Result          listener_total = { 0, 0 };
+    Result          signals_total  = { 0, 0 };
+    GOptionEntry    entries[] = {
+        { "iterations", 'n', 0, G_OPTION_ARG_INT, &iterations, "Number of replays of each kind", NULL },
+        { NULL }
+    };
+
+    ctx = g_option_context_new ("RECORDING - PulseAudio dispatch benchmark");
+
+    g_option_context_add_main_entries (ctx, entries, NULL);
+
+    if (g_option_context_parse (ctx, &argc, &argv, &error) == FALSE) {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        g_option_context_free (ctx);
+        return 1;
+    }
+
+    g_option_context_free (ctx);
+
+    if (argc != 2) {
+        g_printerr ("Usage: %s [-n ITERATIONS] RECORDING\n"
+                    "Create a recording by running any program with "
+                    "LIBMATEMIXER_PULSE_RECORD=RECORDING.\n",
+                    argv[0]);
+        return 1;
+    }
+
+    if (iterations < 1)
+        iterations = 1;
+
+    g_setenv ("LIBMATEMIXER_PULSE_REPLAY", argv[1], TRUE);
+    g_setenv ("LIBMATEMIXER_PULSE_REPLAY_SPEED", "0", TRUE);
+
+    mainloop = g_main_loop_new (NULL, FALSE);
+
+    /* Alternate the two kinds so that both are equally affected by caches
+     * and by the rest of the system */
+    for (i = 0; i < iterations; i++) {
+        Result result;
+
+        if (run_replay (FALSE, &result) == FALSE)
+            goto failed;
+
+        listener_total.wall_time += result.wall_time;
+        listener_total.calls     += result.calls;
+
+        if (run_replay (TRUE, &result) == FALSE)
+            goto failed;
+
+        signals_total.wall_time += result.wall_time;
+        signals_total.calls     += result.calls;
+    }
+
+    g_print ("%-10s %12s %14s %14s\n",
+             "dispatch",
+             "replay [ms]",
+             "handler calls",
+             "per call [us]");
+
+    print_result ("listener", &listener_total, iterations);
+    print_result ("signals",  &signals_total,  iterations);
+
+    g_main_loop_unref (mainloop);
+    return 0;
+
+failed:
+    g_printerr ("Failed to replay %s\n", argv[1]);
+
+    g_main_loop_unref (mainloop);
+    return 1;
+}
@@ -26,4 +26,23 @@ typedef enum {
     PULSE_CONNECTION_CONNECTED
 } PulseConnectionState;
 
+typedef enum {
+    PULSE_RECORD_STATE = 0,
+    PULSE_RECORD_SUBSCRIBE,
+    PULSE_RECORD_SERVER_INFO,
+    PULSE_RECORD_CARD_INFO,
+    PULSE_RECORD_CARD_REMOVED,
+    PULSE_RECORD_SINK_INFO,
+    PULSE_RECORD_SINK_REMOVED,
+    PULSE_RECORD_SINK_INPUT_INFO,
+    PULSE_RECORD_SINK_INPUT_REMOVED,
+    PULSE_RECORD_SOURCE_INFO,
+    PULSE_RECORD_SOURCE_REMOVED,
+    PULSE_RECORD_SOURCE_OUTPUT_INFO,
+    PULSE_RECORD_SOURCE_OUTPUT_REMOVED,
+    PULSE_RECORD_EXT_STREAM_LOADING,
+    PULSE_RECORD_EXT_STREAM_LOADED,
+    PULSE_RECORD_EXT_STREAM_INFO
+} PulseRecordType;
+
 #endif /* PULSE_ENUMS_H */
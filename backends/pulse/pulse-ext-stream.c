@@ -34,6 +34,7 @@
 struct _PulseExtStreamPrivate
 {
     guint             volume;
+    guint             generation;
     pa_cvolume        cvolume;
     pa_channel_map    channel_map;
     MateMixerAppInfo *app_info;
@@ -99,6 +100,13 @@ static guint                    pulse_ext_stream_get_max_volume       (MateMixer
 static guint                    pulse_ext_stream_get_normal_volume    (MateMixerStreamControl  *mmsc);
 static guint                    pulse_ext_stream_get_base_volume      (MateMixerStreamControl  *mmsc);
 
+static void                     update_info                           (PulseExtStream                   *ext,
+                                                                       const pa_ext_stream_restore_info *info,
+                                                                       PulseStream                      *parent);
+
+static gboolean                 info_matches                          (PulseExtStream                   *ext,
+                                                                       const pa_ext_stream_restore_info *info);
+
 static void                     fill_ext_stream_restore_info          (PulseExtStream             *ext,
                                                                        pa_ext_stream_restore_info *info);
 
@@ -232,7 +240,7 @@ pulse_ext_stream_finalize (GObject *object)
     ext = PULSE_EXT_STREAM (object);
 
     if (ext->priv->app_info != NULL)
-        _mate_mixer_app_info_free (ext->priv->app_info);
+        _mate_mixer_app_info_unref (ext->priv->app_info);
 
     G_OBJECT_CLASS (pulse_ext_stream_parent_class)->finalize (object);
 }
@@ -288,11 +296,7 @@ pulse_ext_stream_new (PulseConnection                  *connection,
         /* Make sure an application ext-stream always has a MateMixerAppInfo
          * structure available, even in the case no application info is
          * available */
-        if (app_info == NULL)
-            app_info = _mate_mixer_app_info_new ();
-
-        if (G_LIKELY (suffix != NULL))
-            _mate_mixer_app_info_set_name (app_info, suffix);
+        app_info = _mate_mixer_app_info_intern (suffix, NULL, NULL, NULL);
     }
     else if (strstr (info->name, "-by-application-id:")) {
         role = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
@@ -300,11 +304,7 @@ pulse_ext_stream_new (PulseConnection                  *connection,
         /* Make sure an application ext-stream always has a MateMixerAppInfo
          * structure available, even in the case no application info is
          * available */
-        if (app_info == NULL)
-            app_info = _mate_mixer_app_info_new ();
-
-        if (G_LIKELY (suffix != NULL))
-            _mate_mixer_app_info_set_id (app_info, suffix);
+        app_info = _mate_mixer_app_info_intern (NULL, suffix, NULL, NULL);
     }
 
     ext = g_object_new (PULSE_TYPE_EXT_STREAM,
@@ -319,10 +319,10 @@ pulse_ext_stream_new (PulseConnection                  *connection,
                         NULL);
 
     if (app_info != NULL)
-        _mate_mixer_app_info_free (app_info);
+        _mate_mixer_app_info_unref (app_info);
 
     /* Store values which are expected to be changed */
-    pulse_ext_stream_update (ext, info, parent);
+    update_info (ext, info, parent);
 
     return ext;
 }
@@ -332,68 +332,36 @@ pulse_ext_stream_update (PulseExtStream                   *ext,
                          const pa_ext_stream_restore_info *info,
                          PulseStream                      *parent)
 {
-    MateMixerStreamControlFlags flags;
-    gboolean                    volume_changed = FALSE;
+    MateMixerStream *stream;
 
     g_return_if_fail (PULSE_IS_EXT_STREAM (ext));
     g_return_if_fail (info != NULL);
 
-    /* Let all the information update before emitting notify signals */
-    g_object_freeze_notify (G_OBJECT (ext));
-
-    _mate_mixer_stream_control_set_mute (MATE_MIXER_STREAM_CONTROL (ext),
-                                         info->mute ? TRUE : FALSE);
-
-    flags = mate_mixer_stream_control_get_flags (MATE_MIXER_STREAM_CONTROL (ext));
-
-    if (pa_channel_map_valid (&info->channel_map) != 0) {
-        if (pa_channel_map_can_balance (&info->channel_map) != 0)
-            flags |= MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
-        else
-            flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
-
-        if (pa_channel_map_can_fade (&info->channel_map) != 0)
-            flags |= MATE_MIXER_STREAM_CONTROL_CAN_FADE;
-        else
-            flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_FADE;
-
-        ext->priv->channel_map = info->channel_map;
-    } else {
-        flags &= ~(MATE_MIXER_STREAM_CONTROL_CAN_BALANCE | MATE_MIXER_STREAM_CONTROL_CAN_FADE);
-
-        /* If the channel map is not valid, create an empty channel map, which
-         * also won't validate, but at least we know what it is */
-        pa_channel_map_init (&ext->priv->channel_map);
-    }
-
-    if (pa_cvolume_valid (&info->volume) != 0) {
-        flags |= MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
-                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE;
+    /* The whole stream-restore database is read each time any of the entries
+     * changes, skip the entries which are identical to the previous read */
+    stream = mate_mixer_stream_control_get_stream (MATE_MIXER_STREAM_CONTROL (ext));
 
-        if (pa_cvolume_equal (&ext->priv->cvolume, &info->volume) == 0)
-            volume_changed = TRUE;
-    } else {
-        flags &= ~(MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
-                   MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE);
+    if (stream == MATE_MIXER_STREAM (parent) &&
+        info_matches (ext, info) == TRUE)
+        return;
 
-        if (ext->priv->volume != (guint) PA_VOLUME_MUTED)
-            volume_changed = TRUE;
-    }
+    update_info (ext, info, parent);
+}
 
-    if (volume_changed == TRUE)
-        store_cvolume (ext, &info->volume);
+guint
+pulse_ext_stream_get_generation (PulseExtStream *ext)
+{
+    g_return_val_if_fail (PULSE_IS_EXT_STREAM (ext), 0);
 
-    _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (ext), flags);
+    return ext->priv->generation;
+}
 
-    /* Also set initially, but may change at any time */
-    if (parent != NULL)
-        _mate_mixer_stream_control_set_stream (MATE_MIXER_STREAM_CONTROL (ext),
-                                               MATE_MIXER_STREAM (parent));
-    else
-        _mate_mixer_stream_control_set_stream (MATE_MIXER_STREAM_CONTROL (ext),
-                                               NULL);
+void
+pulse_ext_stream_set_generation (PulseExtStream *ext, guint generation)
+{
+    g_return_if_fail (PULSE_IS_EXT_STREAM (ext));
 
-    g_object_thaw_notify (G_OBJECT (ext));
+    ext->priv->generation = generation;
 }
 
 static MateMixerAppInfo *
@@ -616,15 +584,117 @@ pulse_ext_stream_get_base_volume (MateMixerStreamControl *mmsc)
     return (guint) PA_VOLUME_NORM;
 }
 
+static void
+update_info (PulseExtStream                   *ext,
+             const pa_ext_stream_restore_info *info,
+             PulseStream                      *parent)
+{
+    MateMixerStreamControlFlags flags;
+    gboolean                    volume_changed = FALSE;
+
+    /* Let all the information update before emitting notify signals */
+    g_object_freeze_notify (G_OBJECT (ext));
+
+    _mate_mixer_stream_control_set_mute (MATE_MIXER_STREAM_CONTROL (ext),
+                                         info->mute ? TRUE : FALSE);
+
+    flags = mate_mixer_stream_control_get_flags (MATE_MIXER_STREAM_CONTROL (ext));
+
+    if (pa_channel_map_valid (&info->channel_map) != 0) {
+        if (pa_channel_map_can_balance (&info->channel_map) != 0)
+            flags |= MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
+        else
+            flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
+
+        if (pa_channel_map_can_fade (&info->channel_map) != 0)
+            flags |= MATE_MIXER_STREAM_CONTROL_CAN_FADE;
+        else
+            flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_FADE;
+
+        ext->priv->channel_map = info->channel_map;
+    } else {
+        flags &= ~(MATE_MIXER_STREAM_CONTROL_CAN_BALANCE | MATE_MIXER_STREAM_CONTROL_CAN_FADE);
+
+        /* If the channel map is not valid, create an empty channel map, which
+         * also won't validate, but at least we know what it is */
+        pa_channel_map_init (&ext->priv->channel_map);
+    }
+
+    if (pa_cvolume_valid (&info->volume) != 0) {
+        flags |= MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
+                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE;
+
+        if (pa_cvolume_equal (&ext->priv->cvolume, &info->volume) == 0)
+            volume_changed = TRUE;
+    } else {
+        flags &= ~(MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
+                   MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE);
+
+        if (ext->priv->volume != (guint) PA_VOLUME_MUTED)
+            volume_changed = TRUE;
+    }
+
+    if (volume_changed == TRUE)
+        store_cvolume (ext, &info->volume);
+
+    _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (ext), flags);
+
+    /* Also set initially, but may change at any time */
+    if (parent != NULL)
+        _mate_mixer_stream_control_set_stream (MATE_MIXER_STREAM_CONTROL (ext),
+                                               MATE_MIXER_STREAM (parent));
+    else
+        _mate_mixer_stream_control_set_stream (MATE_MIXER_STREAM_CONTROL (ext),
+                                               NULL);
+
+    g_object_thaw_notify (G_OBJECT (ext));
+}
+
+static gboolean
+info_matches (PulseExtStream *ext, const pa_ext_stream_restore_info *info)
+{
+    MateMixerStreamControl *mmsc;
+
+    mmsc = MATE_MIXER_STREAM_CONTROL (ext);
+
+    /* The device is not compared, it only selects the parent stream which
+     * is compared by the caller */
+    if (mate_mixer_stream_control_get_mute (mmsc) != (info->mute ? TRUE : FALSE))
+        return FALSE;
+
+    if (pa_cvolume_valid (&info->volume) != 0) {
+        if (pa_cvolume_equal (&ext->priv->cvolume, &info->volume) == 0)
+            return FALSE;
+    } else {
+        if (mate_mixer_stream_control_get_flags (mmsc) & MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE)
+            return FALSE;
+    }
+
+    if (pa_channel_map_valid (&info->channel_map) != 0)
+        return pa_channel_map_equal (&ext->priv->channel_map, &info->channel_map) != 0;
+
+    return ext->priv->channel_map.channels == 0;
+}
+
 static void
 fill_ext_stream_restore_info (PulseExtStream             *ext,
                               pa_ext_stream_restore_info *info)
 {
-    MateMixerStream        *mms;
-    MateMixerStreamControl *mmsc;
+    MateMixerStream                  *mms;
+    MateMixerStreamControl           *mmsc;
+    const pa_ext_stream_restore_info *pending;
 
     mmsc = MATE_MIXER_STREAM_CONTROL (ext);
 
+    /* Writes are delayed until the main loop is idle, start from the pending
+     * entry to make sure several changes made in a row are all kept */
+    pending = pulse_connection_get_ext_stream_write (ext->priv->connection,
+                                                     mate_mixer_stream_control_get_name (mmsc));
+    if (pending != NULL) {
+        *info = *pending;
+        return;
+    }
+
     info->name = mate_mixer_stream_control_get_name (mmsc);
     info->mute = mate_mixer_stream_control_get_mute (mmsc);
     info->volume      = ext->priv->cvolume;
@@ -668,6 +738,8 @@ store_cvolume (PulseExtStream *ext, const pa_cvolume *cvolume)
     ext->priv->cvolume = *cvolume;
     ext->priv->volume  = (guint) pa_cvolume_max (cvolume);
 
+    _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (ext));
+
     g_object_notify (G_OBJECT (ext), "volume");
 
     /* PulseAudio returns the default 0.0f value on error, so skip checking validity
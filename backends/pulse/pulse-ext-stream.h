@@ -68,6 +68,10 @@ void            pulse_ext_stream_update   (PulseExtStream                   *ext
                                            const pa_ext_stream_restore_info *info,
                                            PulseStream                      *parent);
 
+guint           pulse_ext_stream_get_generation (PulseExtStream             *ext);
+void            pulse_ext_stream_set_generation (PulseExtStream             *ext,
+                                                 guint                       generation);
+
 G_END_DECLS
 
 #endif /* PULSE_EXT_STREAM_H */
@@ -111,3 +111,22 @@ pulse_convert_media_role_name (const gchar *name)
 
     return MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN;
 }
+
+MateMixerStatisticsEvent
+pulse_convert_facility (pa_subscription_event_type_t facility)
+{
+    switch (facility) {
+    case PA_SUBSCRIPTION_EVENT_SERVER:
+        return MATE_MIXER_STATISTICS_EVENT_SERVER;
+    case PA_SUBSCRIPTION_EVENT_CARD:
+        return MATE_MIXER_STATISTICS_EVENT_DEVICE;
+    case PA_SUBSCRIPTION_EVENT_SINK:
+    case PA_SUBSCRIPTION_EVENT_SOURCE:
+        return MATE_MIXER_STATISTICS_EVENT_STREAM;
+    case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
+    case PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT:
+        return MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL;
+    default:
+        return MATE_MIXER_STATISTICS_EVENT_OTHER;
+    }
+}
@@ -28,7 +28,8 @@ G_BEGIN_DECLS
 extern const MateMixerChannelPosition   pulse_channel_map_from[PA_CHANNEL_POSITION_MAX];
 extern const pa_channel_position_t      pulse_channel_map_to[MATE_MIXER_CHANNEL_MAX];
 
-MateMixerStreamControlMediaRole pulse_convert_media_role_name (const gchar *name);
+MateMixerStreamControlMediaRole pulse_convert_media_role_name (const gchar                   *name);
+MateMixerStatisticsEvent        pulse_convert_facility        (pa_subscription_event_type_t   facility);
 
 G_END_DECLS
 
@@ -21,6 +21,8 @@
 
 #include <pulse/pulseaudio.h>
 
+#include <libmatemixer/matemixer-trace-private.h>
+
 #include "pulse-monitor.h"
 
 struct _PulseMonitorPrivate
@@ -329,6 +331,8 @@ stream_read_cb (pa_stream *stream, size_t length, void *userdata)
     if (pa_stream_peek (stream, &data, &length) < 0)
         return;
 
+    MATE_MIXER_TRACE (pulse_monitor_read, pa_stream_get_index (stream), length);
+
     if (data != NULL) {
         gdouble v = ((const gfloat *) data)[length / sizeof (gfloat) - 1];
 
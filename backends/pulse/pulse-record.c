@@ -0,0 +1,1037 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include <pulse/pulseaudio.h>
+#include <pulse/ext-stream-restore.h>
+
+#include "pulse-enums.h"
+#include "pulse-record.h"
+
+/*
+ * The file starts with the magic string followed by a sequence of records.
+ * Each record is a 32-bit little endian size followed by a serialized
+ * little endian GVariant of type (xyuv), which contains the time in
+ * microseconds since the start of the recording, the record type, an index
+ * and the record payload.
+ */
+#define PULSE_RECORD_MAGIC          "LMMREC01"
+#define PULSE_RECORD_MAGIC_LENGTH   8
+
+#define PULSE_RECORD_VARIANT_TYPE   ((const GVariantType *) "(xyuv)")
+
+/* Maximum number of records dispatched in a single main loop iteration */
+#define PULSE_REPLAY_BATCH          100
+
+struct _PulseRecorder
+{
+    FILE   *file;
+    gint64  start_time;
+};
+
+struct _PulseReplay
+{
+    GPtrArray      *records;
+    guint           position;
+    gdouble         speed;
+    gint64          start_time;
+    GSource        *source;
+    PulseReplayFunc func;
+    gpointer        user_data;
+};
+
+static GVariant *encode_proplist      (pa_proplist                      *proplist);
+static GVariant *encode_cvolume       (const pa_cvolume                 *cvolume);
+static GVariant *encode_channel_map   (const pa_channel_map             *map);
+
+static GVariant *encode_server_info   (const pa_server_info             *info);
+static GVariant *encode_card_info     (const pa_card_info               *info);
+static GVariant *encode_sink_info     (const pa_sink_info               *info);
+static GVariant *encode_source_info   (const pa_source_info             *info);
+static GVariant *encode_sink_input    (const pa_sink_input_info         *info);
+static GVariant *encode_source_output (const pa_source_output_info      *info);
+static GVariant *encode_ext_stream    (const pa_ext_stream_restore_info *info);
+
+static void      decode_cvolume       (GVariant                         *value,
+                                       pa_cvolume                       *cvolume);
+static void      decode_channel_map   (GVariant                         *value,
+                                       pa_channel_map                   *map);
+
+static void      replay_server_info   (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+static void      replay_card_info     (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+static void      replay_sink_info     (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+static void      replay_source_info   (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+static void      replay_sink_input    (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+static void      replay_source_output (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+static void      replay_ext_stream    (PulseReplay                      *replay,
+                                       GVariant                         *payload);
+
+static void      replay_record        (PulseReplay                      *replay,
+                                       GVariant                         *record);
+static gboolean  replay_next          (PulseReplay                      *replay);
+static void      replay_schedule      (PulseReplay                      *replay);
+
+PulseRecorder *
+pulse_recorder_new (const gchar *path)
+{
+    PulseRecorder *recorder;
+    FILE          *file;
+
+    g_return_val_if_fail (path != NULL, NULL);
+
+    file = fopen (path, "wb");
+    if (G_UNLIKELY (file == NULL)) {
+        g_warning ("Failed to open %s for recording: %s", path, g_strerror (errno));
+        return NULL;
+    }
+
+    if (fwrite (PULSE_RECORD_MAGIC, PULSE_RECORD_MAGIC_LENGTH, 1, file) != 1) {
+        g_warning ("Failed to write to %s", path);
+        fclose (file);
+        return NULL;
+    }
+
+    recorder = g_slice_new (PulseRecorder);
+    recorder->file       = file;
+    recorder->start_time = g_get_monotonic_time ();
+
+    g_debug ("Recording PulseAudio events to %s", path);
+    return recorder;
+}
+
+void
+pulse_recorder_free (PulseRecorder *recorder)
+{
+    g_return_if_fail (recorder != NULL);
+
+    fclose (recorder->file);
+
+    g_slice_free (PulseRecorder, recorder);
+}
+
+void
+pulse_recorder_write (PulseRecorder   *recorder,
+                      PulseRecordType  type,
+                      gconstpointer    info,
+                      guint32          index)
+{
+    GVariant *payload;
+    GVariant *record;
+    guint32   size;
+
+    g_return_if_fail (recorder != NULL);
+
+    switch (type) {
+    case PULSE_RECORD_SUBSCRIBE:
+        payload = g_variant_new_uint32 (GPOINTER_TO_UINT (info));
+        break;
+    case PULSE_RECORD_SERVER_INFO:
+        payload = encode_server_info (info);
+        break;
+    case PULSE_RECORD_CARD_INFO:
+        payload = encode_card_info (info);
+        break;
+    case PULSE_RECORD_SINK_INFO:
+        payload = encode_sink_info (info);
+        break;
+    case PULSE_RECORD_SOURCE_INFO:
+        payload = encode_source_info (info);
+        break;
+    case PULSE_RECORD_SINK_INPUT_INFO:
+        payload = encode_sink_input (info);
+        break;
+    case PULSE_RECORD_SOURCE_OUTPUT_INFO:
+        payload = encode_source_output (info);
+        break;
+    case PULSE_RECORD_EXT_STREAM_INFO:
+        payload = encode_ext_stream (info);
+        break;
+    default:
+        payload = g_variant_new_tuple (NULL, 0);
+        break;
+    }
+
+    record = g_variant_new ("(xyuv)",
+                            g_get_monotonic_time () - recorder->start_time,
+                            (guchar) type,
+                            index,
+                            payload);
+
+    g_variant_ref_sink (record);
+
+    if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+        GVariant *swapped = g_variant_byteswap (record);
+
+        g_variant_unref (record);
+        record = swapped;
+    }
+
+    size = GUINT32_TO_LE ((guint32) g_variant_get_size (record));
+
+    if (fwrite (&size, sizeof (size), 1, recorder->file) != 1 ||
+        fwrite (g_variant_get_data (record), g_variant_get_size (record), 1, recorder->file) != 1)
+        g_warning ("Failed to write PulseAudio event record");
+
+    /* Keep the file usable even if the process does not exit cleanly */
+    fflush (recorder->file);
+
+    g_variant_unref (record);
+}
+
+PulseReplay *
+pulse_replay_new (const gchar *path, gdouble speed)
+{
+    PulseReplay *replay;
+    GPtrArray   *records;
+    gchar       *contents;
+    gsize        length;
+    gsize        offset;
+    GError      *error = NULL;
+
+    g_return_val_if_fail (path != NULL, NULL);
+
+    if (g_file_get_contents (path, &contents, &length, &error) == FALSE) {
+        g_warning ("Failed to read PulseAudio event recording: %s", error->message);
+        g_error_free (error);
+        return NULL;
+    }
+
+    if (length < PULSE_RECORD_MAGIC_LENGTH ||
+        memcmp (contents, PULSE_RECORD_MAGIC, PULSE_RECORD_MAGIC_LENGTH) != 0) {
+        g_warning ("File %s is not a PulseAudio event recording", path);
+        g_free (contents);
+        return NULL;
+    }
+
+    records = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_unref);
+    offset  = PULSE_RECORD_MAGIC_LENGTH;
+
+    while (offset + sizeof (guint32) <= length) {
+        GVariant *record;
+        GBytes   *bytes;
+        guint32   size;
+
+        memcpy (&size, contents + offset, sizeof (size));
+
+        size = GUINT32_FROM_LE (size);
+        offset += sizeof (guint32);
+
+        if (size > length - offset) {
+            g_warning ("PulseAudio event recording %s is truncated", path);
+            break;
+        }
+
+        /* Copy the record to make sure it is correctly aligned */
+        bytes  = g_bytes_new (contents + offset, size);
+        record = g_variant_new_from_bytes (PULSE_RECORD_VARIANT_TYPE, bytes, FALSE);
+
+        g_bytes_unref (bytes);
+
+        if (G_BYTE_ORDER == G_BIG_ENDIAN) {
+            GVariant *swapped = g_variant_byteswap (record);
+
+            g_variant_unref (record);
+            record = swapped;
+        }
+
+        g_ptr_array_add (records, g_variant_ref_sink (record));
+        offset += size;
+    }
+
+    g_free (contents);
+
+    replay = g_slice_new0 (PulseReplay);
+    replay->records = records;
+    replay->speed   = speed;
+
+    g_debug ("Loaded %u PulseAudio event records from %s", records->len, path);
+    return replay;
+}
+
+void
+pulse_replay_free (PulseReplay *replay)
+{
+    g_return_if_fail (replay != NULL);
+
+    if (replay->source != NULL) {
+        g_source_destroy (replay->source);
+        g_source_unref (replay->source);
+    }
+
+    g_ptr_array_unref (replay->records);
+
+    g_slice_free (PulseReplay, replay);
+}
+
+void
+pulse_replay_start (PulseReplay     *replay,
+                    PulseReplayFunc  func,
+                    gpointer         user_data)
+{
+    g_return_if_fail (replay != NULL);
+    g_return_if_fail (func != NULL);
+
+    replay->func       = func;
+    replay->user_data  = user_data;
+    replay->position   = 0;
+    replay->start_time = g_get_monotonic_time ();
+
+    replay_schedule (replay);
+}
+
+static GVariant *
+encode_proplist (pa_proplist *proplist)
+{
+    GVariant *value;
+    gchar    *str;
+
+    if (proplist == NULL)
+        return g_variant_new_string ("");
+
+    str   = pa_proplist_to_string (proplist);
+    value = g_variant_new_string (str);
+
+    pa_xfree (str);
+    return value;
+}
+
+static GVariant *
+encode_cvolume (const pa_cvolume *cvolume)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("au"));
+
+    for (i = 0; i < cvolume->channels && i < PA_CHANNELS_MAX; i++)
+        g_variant_builder_add (&builder, "u", cvolume->values[i]);
+
+    return g_variant_builder_end (&builder);
+}
+
+static GVariant *
+encode_channel_map (const pa_channel_map *map)
+{
+    GVariantBuilder builder;
+    guint           i;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("ay"));
+
+    /* PA_CHANNEL_POSITION_INVALID is stored as 255 */
+    for (i = 0; i < map->channels && i < PA_CHANNELS_MAX; i++)
+        g_variant_builder_add (&builder, "y", (guchar) map->map[i]);
+
+    return g_variant_builder_end (&builder);
+}
+
+static GVariant *
+encode_server_info (const pa_server_info *info)
+{
+    return g_variant_new ("(msmsmsmsms)",
+                          info->host_name,
+                          info->server_version,
+                          info->server_name,
+                          info->default_sink_name,
+                          info->default_source_name);
+}
+
+static GVariant *
+encode_card_info (const pa_card_info *info)
+{
+    GVariantBuilder ports;
+    GVariantBuilder profiles;
+    guint32         i;
+
+    g_variant_builder_init (&ports, G_VARIANT_TYPE ("a(ssuis)"));
+
+    for (i = 0; i < info->n_ports; i++)
+        g_variant_builder_add (&ports, "(ssui@s)",
+                               info->ports[i]->name,
+                               info->ports[i]->description,
+                               info->ports[i]->priority,
+                               info->ports[i]->available,
+                               encode_proplist (info->ports[i]->proplist));
+
+    g_variant_builder_init (&profiles, G_VARIANT_TYPE ("a(ssuuui)"));
+
+    for (i = 0; i < info->n_profiles; i++)
+        g_variant_builder_add (&profiles, "(ssuuui)",
+                               info->profiles2[i]->name,
+                               info->profiles2[i]->description,
+                               info->profiles2[i]->n_sinks,
+                               info->profiles2[i]->n_sources,
+                               info->profiles2[i]->priority,
+                               info->profiles2[i]->available);
+
+    return g_variant_new ("(us@sa(ssuis)a(ssuuui)ms)",
+                          info->index,
+                          info->name,
+                          encode_proplist (info->proplist),
+                          &ports,
+                          &profiles,
+                          (info->active_profile2 != NULL) ? info->active_profile2->name : NULL);
+}
+
+static GVariant *
+encode_sink_info (const pa_sink_info *info)
+{
+    GVariantBuilder ports;
+    guint32         i;
+
+    g_variant_builder_init (&ports, G_VARIANT_TYPE ("a(ssui)"));
+
+    for (i = 0; i < info->n_ports; i++)
+        g_variant_builder_add (&ports, "(ssui)",
+                               info->ports[i]->name,
+                               info->ports[i]->description,
+                               info->ports[i]->priority,
+                               info->ports[i]->available);
+
+    return g_variant_new ("(uss@suub@au@ayua(ssui)msu)",
+                          info->index,
+                          info->name,
+                          info->description,
+                          encode_proplist (info->proplist),
+                          info->card,
+                          (guint32) info->flags,
+                          info->mute ? TRUE : FALSE,
+                          encode_cvolume (&info->volume),
+                          encode_channel_map (&info->channel_map),
+                          info->base_volume,
+                          &ports,
+                          (info->active_port != NULL) ? info->active_port->name : NULL,
+                          info->monitor_source);
+}
+
+static GVariant *
+encode_source_info (const pa_source_info *info)
+{
+    GVariantBuilder ports;
+    guint32         i;
+
+    g_variant_builder_init (&ports, G_VARIANT_TYPE ("a(ssui)"));
+
+    for (i = 0; i < info->n_ports; i++)
+        g_variant_builder_add (&ports, "(ssui)",
+                               info->ports[i]->name,
+                               info->ports[i]->description,
+                               info->ports[i]->priority,
+                               info->ports[i]->available);
+
+    return g_variant_new ("(uss@suub@au@ayua(ssui)msu)",
+                          info->index,
+                          info->name,
+                          info->description,
+                          encode_proplist (info->proplist),
+                          info->card,
+                          (guint32) info->flags,
+                          info->mute ? TRUE : FALSE,
+                          encode_cvolume (&info->volume),
+                          encode_channel_map (&info->channel_map),
+                          info->base_volume,
+                          &ports,
+                          (info->active_port != NULL) ? info->active_port->name : NULL,
+                          info->monitor_of_sink);
+}
+
+static GVariant *
+encode_sink_input (const pa_sink_input_info *info)
+{
+    return g_variant_new ("(umsuu@sbbb@au@ay)",
+                          info->index,
+                          info->name,
+                          info->client,
+                          info->sink,
+                          encode_proplist (info->proplist),
+                          info->has_volume ? TRUE : FALSE,
+                          info->volume_writable ? TRUE : FALSE,
+                          info->mute ? TRUE : FALSE,
+                          encode_cvolume (&info->volume),
+                          encode_channel_map (&info->channel_map));
+}
+
+static GVariant *
+encode_source_output (const pa_source_output_info *info)
+{
+    return g_variant_new ("(umsuu@sbbb@au@ay)",
+                          info->index,
+                          info->name,
+                          info->client,
+                          info->source,
+                          encode_proplist (info->proplist),
+                          info->has_volume ? TRUE : FALSE,
+                          info->volume_writable ? TRUE : FALSE,
+                          info->mute ? TRUE : FALSE,
+                          encode_cvolume (&info->volume),
+                          encode_channel_map (&info->channel_map));
+}
+
+static GVariant *
+encode_ext_stream (const pa_ext_stream_restore_info *info)
+{
+    return g_variant_new ("(s@ay@aumsb)",
+                          info->name,
+                          encode_channel_map (&info->channel_map),
+                          encode_cvolume (&info->volume),
+                          info->device,
+                          info->mute ? TRUE : FALSE);
+}
+
+static void
+decode_cvolume (GVariant *value, pa_cvolume *cvolume)
+{
+    gsize i;
+
+    pa_cvolume_init (cvolume);
+
+    for (i = 0; i < g_variant_n_children (value) && i < PA_CHANNELS_MAX; i++)
+        g_variant_get_child (value, i, "u", &cvolume->values[i]);
+
+    cvolume->channels = i;
+}
+
+static void
+decode_channel_map (GVariant *value, pa_channel_map *map)
+{
+    gsize i;
+
+    pa_channel_map_init (map);
+
+    for (i = 0; i < g_variant_n_children (value) && i < PA_CHANNELS_MAX; i++) {
+        guchar position;
+
+        g_variant_get_child (value, i, "y", &position);
+
+        if (position == 255)
+            map->map[i] = PA_CHANNEL_POSITION_INVALID;
+        else
+            map->map[i] = (pa_channel_position_t) position;
+    }
+    map->channels = i;
+}
+
+static pa_proplist *
+decode_proplist (const gchar *str)
+{
+    pa_proplist *proplist;
+
+    proplist = pa_proplist_from_string (str);
+    if (G_UNLIKELY (proplist == NULL))
+        proplist = pa_proplist_new ();
+
+    return proplist;
+}
+
+static void
+replay_server_info (PulseReplay *replay, GVariant *payload)
+{
+    pa_server_info info;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(m&sm&sm&sm&sm&s)",
+                   &info.host_name,
+                   &info.server_version,
+                   &info.server_name,
+                   &info.default_sink_name,
+                   &info.default_source_name);
+
+    replay->func (PULSE_RECORD_SERVER_INFO, &info, PA_INVALID_INDEX, replay->user_data);
+}
+
+static void
+replay_card_info (PulseReplay *replay, GVariant *payload)
+{
+    pa_card_info           info;
+    pa_card_port_info     *ports;
+    pa_card_port_info    **ports_list;
+    pa_card_profile_info  *profiles;
+    pa_card_profile_info2 *profiles2;
+    pa_card_profile_info2 **profiles2_list;
+    GVariant              *ports_value;
+    GVariant              *profiles_value;
+    const gchar           *proplist;
+    const gchar           *active_profile;
+    guint32                i;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(u&s&s@a(ssuis)@a(ssuuui)m&s)",
+                   &info.index,
+                   &info.name,
+                   &proplist,
+                   &ports_value,
+                   &profiles_value,
+                   &active_profile);
+
+    info.proplist   = decode_proplist (proplist);
+    info.n_ports    = g_variant_n_children (ports_value);
+    info.n_profiles = g_variant_n_children (profiles_value);
+
+    ports      = g_new0 (pa_card_port_info, info.n_ports);
+    ports_list = g_new0 (pa_card_port_info *, info.n_ports + 1);
+
+    for (i = 0; i < info.n_ports; i++) {
+        g_variant_get_child (ports_value, i, "(&s&sui&s)",
+                             &ports[i].name,
+                             &ports[i].description,
+                             &ports[i].priority,
+                             &ports[i].available,
+                             &proplist);
+
+        ports[i].proplist = decode_proplist (proplist);
+        ports_list[i] = &ports[i];
+    }
+
+    profiles       = g_new0 (pa_card_profile_info, info.n_profiles);
+    profiles2      = g_new0 (pa_card_profile_info2, info.n_profiles);
+    profiles2_list = g_new0 (pa_card_profile_info2 *, info.n_profiles + 1);
+
+    for (i = 0; i < info.n_profiles; i++) {
+        g_variant_get_child (profiles_value, i, "(&s&suuui)",
+                             &profiles2[i].name,
+                             &profiles2[i].description,
+                             &profiles2[i].n_sinks,
+                             &profiles2[i].n_sources,
+                             &profiles2[i].priority,
+                             &profiles2[i].available);
+
+        profiles[i].name        = profiles2[i].name;
+        profiles[i].description = profiles2[i].description;
+        profiles[i].n_sinks     = profiles2[i].n_sinks;
+        profiles[i].n_sources   = profiles2[i].n_sources;
+        profiles[i].priority    = profiles2[i].priority;
+
+        profiles2_list[i] = &profiles2[i];
+
+        if (active_profile != NULL && strcmp (active_profile, profiles2[i].name) == 0) {
+            info.active_profile  = &profiles[i];
+            info.active_profile2 = &profiles2[i];
+        }
+    }
+
+    info.ports     = ports_list;
+    info.profiles  = profiles;
+    info.profiles2 = profiles2_list;
+
+    replay->func (PULSE_RECORD_CARD_INFO, &info, info.index, replay->user_data);
+
+    for (i = 0; i < info.n_ports; i++)
+        pa_proplist_free (ports[i].proplist);
+
+    pa_proplist_free (info.proplist);
+
+    g_free (ports);
+    g_free (ports_list);
+    g_free (profiles);
+    g_free (profiles2);
+    g_free (profiles2_list);
+
+    g_variant_unref (ports_value);
+    g_variant_unref (profiles_value);
+}
+
+static void
+replay_sink_info (PulseReplay *replay, GVariant *payload)
+{
+    pa_sink_info        info;
+    pa_sink_port_info  *ports;
+    pa_sink_port_info **ports_list;
+    GVariant           *ports_value;
+    GVariant           *volume;
+    GVariant           *map;
+    const gchar        *proplist;
+    const gchar        *active_port;
+    guint32             flags;
+    gboolean            mute;
+    guint32             i;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(u&s&s&suub@au@ayu@a(ssui)m&su)",
+                   &info.index,
+                   &info.name,
+                   &info.description,
+                   &proplist,
+                   &info.card,
+                   &flags,
+                   &mute,
+                   &volume,
+                   &map,
+                   &info.base_volume,
+                   &ports_value,
+                   &active_port,
+                   &info.monitor_source);
+
+    info.proplist = decode_proplist (proplist);
+    info.flags    = (pa_sink_flags_t) flags;
+    info.mute     = mute;
+    info.n_ports  = g_variant_n_children (ports_value);
+
+    decode_cvolume (volume, &info.volume);
+    decode_channel_map (map, &info.channel_map);
+
+    ports      = g_new0 (pa_sink_port_info, info.n_ports);
+    ports_list = g_new0 (pa_sink_port_info *, info.n_ports + 1);
+
+    for (i = 0; i < info.n_ports; i++) {
+        g_variant_get_child (ports_value, i, "(&s&sui)",
+                             &ports[i].name,
+                             &ports[i].description,
+                             &ports[i].priority,
+                             &ports[i].available);
+
+        ports_list[i] = &ports[i];
+
+        if (active_port != NULL && strcmp (active_port, ports[i].name) == 0)
+            info.active_port = &ports[i];
+    }
+    info.ports = ports_list;
+
+    replay->func (PULSE_RECORD_SINK_INFO, &info, info.index, replay->user_data);
+
+    pa_proplist_free (info.proplist);
+
+    g_free (ports);
+    g_free (ports_list);
+
+    g_variant_unref (ports_value);
+    g_variant_unref (volume);
+    g_variant_unref (map);
+}
+
+static void
+replay_source_info (PulseReplay *replay, GVariant *payload)
+{
+    pa_source_info        info;
+    pa_source_port_info  *ports;
+    pa_source_port_info **ports_list;
+    GVariant             *ports_value;
+    GVariant             *volume;
+    GVariant             *map;
+    const gchar          *proplist;
+    const gchar          *active_port;
+    guint32               flags;
+    gboolean              mute;
+    guint32               i;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(u&s&s&suub@au@ayu@a(ssui)m&su)",
+                   &info.index,
+                   &info.name,
+                   &info.description,
+                   &proplist,
+                   &info.card,
+                   &flags,
+                   &mute,
+                   &volume,
+                   &map,
+                   &info.base_volume,
+                   &ports_value,
+                   &active_port,
+                   &info.monitor_of_sink);
+
+    info.proplist = decode_proplist (proplist);
+    info.flags    = (pa_source_flags_t) flags;
+    info.mute     = mute;
+    info.n_ports  = g_variant_n_children (ports_value);
+
+    decode_cvolume (volume, &info.volume);
+    decode_channel_map (map, &info.channel_map);
+
+    ports      = g_new0 (pa_source_port_info, info.n_ports);
+    ports_list = g_new0 (pa_source_port_info *, info.n_ports + 1);
+
+    for (i = 0; i < info.n_ports; i++) {
+        g_variant_get_child (ports_value, i, "(&s&sui)",
+                             &ports[i].name,
+                             &ports[i].description,
+                             &ports[i].priority,
+                             &ports[i].available);
+
+        ports_list[i] = &ports[i];
+
+        if (active_port != NULL && strcmp (active_port, ports[i].name) == 0)
+            info.active_port = &ports[i];
+    }
+    info.ports = ports_list;
+
+    replay->func (PULSE_RECORD_SOURCE_INFO, &info, info.index, replay->user_data);
+
+    pa_proplist_free (info.proplist);
+
+    g_free (ports);
+    g_free (ports_list);
+
+    g_variant_unref (ports_value);
+    g_variant_unref (volume);
+    g_variant_unref (map);
+}
+
+static void
+replay_sink_input (PulseReplay *replay, GVariant *payload)
+{
+    pa_sink_input_info info;
+    GVariant          *volume;
+    GVariant          *map;
+    const gchar       *proplist;
+    gboolean           has_volume;
+    gboolean           volume_writable;
+    gboolean           mute;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(um&suu&sbbb@au@ay)",
+                   &info.index,
+                   &info.name,
+                   &info.client,
+                   &info.sink,
+                   &proplist,
+                   &has_volume,
+                   &volume_writable,
+                   &mute,
+                   &volume,
+                   &map);
+
+    info.proplist        = decode_proplist (proplist);
+    info.has_volume      = has_volume;
+    info.volume_writable = volume_writable;
+    info.mute            = mute;
+
+    decode_cvolume (volume, &info.volume);
+    decode_channel_map (map, &info.channel_map);
+
+    replay->func (PULSE_RECORD_SINK_INPUT_INFO, &info, info.index, replay->user_data);
+
+    pa_proplist_free (info.proplist);
+
+    g_variant_unref (volume);
+    g_variant_unref (map);
+}
+
+static void
+replay_source_output (PulseReplay *replay, GVariant *payload)
+{
+    pa_source_output_info info;
+    GVariant             *volume;
+    GVariant             *map;
+    const gchar          *proplist;
+    gboolean              has_volume;
+    gboolean              volume_writable;
+    gboolean              mute;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(um&suu&sbbb@au@ay)",
+                   &info.index,
+                   &info.name,
+                   &info.client,
+                   &info.source,
+                   &proplist,
+                   &has_volume,
+                   &volume_writable,
+                   &mute,
+                   &volume,
+                   &map);
+
+    info.proplist        = decode_proplist (proplist);
+    info.has_volume      = has_volume;
+    info.volume_writable = volume_writable;
+    info.mute            = mute;
+
+    decode_cvolume (volume, &info.volume);
+    decode_channel_map (map, &info.channel_map);
+
+    replay->func (PULSE_RECORD_SOURCE_OUTPUT_INFO, &info, info.index, replay->user_data);
+
+    pa_proplist_free (info.proplist);
+
+    g_variant_unref (volume);
+    g_variant_unref (map);
+}
+
+static void
+replay_ext_stream (PulseReplay *replay, GVariant *payload)
+{
+    pa_ext_stream_restore_info info;
+    GVariant                  *volume;
+    GVariant                  *map;
+    gboolean                   mute;
+
+    memset (&info, 0, sizeof (info));
+
+    g_variant_get (payload, "(&s@ay@aum&sb)",
+                   &info.name,
+                   &map,
+                   &volume,
+                   &info.device,
+                   &mute);
+
+    info.mute = mute;
+
+    decode_cvolume (volume, &info.volume);
+    decode_channel_map (map, &info.channel_map);
+
+    replay->func (PULSE_RECORD_EXT_STREAM_INFO, &info, PA_INVALID_INDEX, replay->user_data);
+
+    g_variant_unref (volume);
+    g_variant_unref (map);
+}
+
+static void
+replay_record (PulseReplay *replay, GVariant *record)
+{
+    GVariant *payload;
+    gint64    timestamp;
+    guchar    type;
+    guint32   index;
+
+    g_variant_get (record, "(xyuv)", &timestamp, &type, &index, &payload);
+
+    switch (type) {
+    case PULSE_RECORD_SUBSCRIBE:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE_UINT32))
+            replay->func (type,
+                          GUINT_TO_POINTER (g_variant_get_uint32 (payload)),
+                          index,
+                          replay->user_data);
+        break;
+    case PULSE_RECORD_SERVER_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(msmsmsmsms)")))
+            replay_server_info (replay, payload);
+        break;
+    case PULSE_RECORD_CARD_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(ussa(ssuis)a(ssuuui)ms)")))
+            replay_card_info (replay, payload);
+        break;
+    case PULSE_RECORD_SINK_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(usssuubauayua(ssui)msu)")))
+            replay_sink_info (replay, payload);
+        break;
+    case PULSE_RECORD_SOURCE_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(usssuubauayua(ssui)msu)")))
+            replay_source_info (replay, payload);
+        break;
+    case PULSE_RECORD_SINK_INPUT_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(umsuusbbbauay)")))
+            replay_sink_input (replay, payload);
+        break;
+    case PULSE_RECORD_SOURCE_OUTPUT_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(umsuusbbbauay)")))
+            replay_source_output (replay, payload);
+        break;
+    case PULSE_RECORD_EXT_STREAM_INFO:
+        if (g_variant_is_of_type (payload, G_VARIANT_TYPE ("(sayaumsb)")))
+            replay_ext_stream (replay, payload);
+        break;
+    case PULSE_RECORD_STATE:
+    case PULSE_RECORD_CARD_REMOVED:
+    case PULSE_RECORD_SINK_REMOVED:
+    case PULSE_RECORD_SINK_INPUT_REMOVED:
+    case PULSE_RECORD_SOURCE_REMOVED:
+    case PULSE_RECORD_SOURCE_OUTPUT_REMOVED:
+    case PULSE_RECORD_EXT_STREAM_LOADING:
+    case PULSE_RECORD_EXT_STREAM_LOADED:
+        replay->func (type, NULL, index, replay->user_data);
+        break;
+    default:
+        g_debug ("Skipping unknown PulseAudio event record type %u", type);
+        break;
+    }
+
+    g_variant_unref (payload);
+}
+
+static gboolean
+replay_next (PulseReplay *replay)
+{
+    guint count = 0;
+
+    g_clear_pointer (&replay->source, g_source_unref);
+
+    while (replay->position < replay->records->len) {
+        GVariant *record;
+        gint64    timestamp;
+
+        record = g_ptr_array_index (replay->records, replay->position);
+
+        g_variant_get_child (record, 0, "x", &timestamp);
+
+        /* Stop when the next record is not due yet or when too many records
+         * have been dispatched without returning to the main loop */
+        if (replay->speed > 0 &&
+            replay->start_time + timestamp / replay->speed > g_get_monotonic_time ())
+            break;
+        if (count++ == PULSE_REPLAY_BATCH)
+            break;
+
+        replay->position++;
+
+        replay_record (replay, record);
+    }
+
+    if (replay->position < replay->records->len)
+        replay_schedule (replay);
+    else
+        g_debug ("PulseAudio event replay has finished");
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+replay_schedule (PulseReplay *replay)
+{
+    GVariant *record;
+    gint64    timestamp;
+    gint64    delay;
+
+    if (replay->position >= replay->records->len)
+        return;
+
+    record = g_ptr_array_index (replay->records, replay->position);
+
+    g_variant_get_child (record, 0, "x", &timestamp);
+
+    if (replay->speed > 0)
+        delay = replay->start_time + timestamp / replay->speed - g_get_monotonic_time ();
+    else
+        delay = 0;
+
+    /* Replay in the main context of the thread which owns the connection,
+     * the same one which would receive the live events */
+    if (delay > 0)
+        replay->source = g_timeout_source_new (delay / 1000);
+    else
+        replay->source = g_idle_source_new ();
+
+    g_source_set_callback (replay->source,
+                           (GSourceFunc) replay_next,
+                           replay,
+                           NULL);
+    g_source_attach (replay->source, g_main_context_get_thread_default ());
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PULSE_RECORD_H
+#define PULSE_RECORD_H
+
+#include <glib.h>
+
+#include "pulse-enums.h"
+#include "pulse-types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * The recorder serializes the events delivered by a PulseConnection into a
+ * file and the replay feeds them back with the original timing.
+ *
+ * The data passed to the functions depends on the record type:
+ *  - PULSE_RECORD_STATE: the new PulseConnectionState in index
+ *  - PULSE_RECORD_SUBSCRIBE: the pa_subscription_event_type_t packed using
+ *    GUINT_TO_POINTER() in info and the object index in index
+ *  - PULSE_RECORD_*_INFO: a pointer to the PulseAudio info structure in info
+ *  - PULSE_RECORD_*_REMOVED: the object index in index
+ *  - PULSE_RECORD_EXT_STREAM_LOADING and PULSE_RECORD_EXT_STREAM_LOADED
+ *    have no data
+ */
+typedef void (*PulseReplayFunc) (PulseRecordType type,
+                                 gconstpointer   info,
+                                 guint32         index,
+                                 gpointer        user_data);
+
+PulseRecorder *pulse_recorder_new   (const gchar     *path);
+void           pulse_recorder_free  (PulseRecorder   *recorder);
+
+void           pulse_recorder_write (PulseRecorder   *recorder,
+                                     PulseRecordType  type,
+                                     gconstpointer    info,
+                                     guint32          index);
+
+PulseReplay *  pulse_replay_new     (const gchar     *path,
+                                     gdouble          speed);
+void           pulse_replay_free    (PulseReplay     *replay);
+
+void           pulse_replay_start   (PulseReplay     *replay,
+                                     PulseReplayFunc  func,
+                                     gpointer         user_data);
+
+G_END_DECLS
+
+#endif /* PULSE_RECORD_H */
@@ -86,7 +86,7 @@ pulse_sink_input_new (PulseConnection          *connection,
      * name here, but we use the name only as an identifier, so let's avoid
      * this unnecessary overhead and use a custom name.
      * Also make sure to make the name unique by including the PulseAudio index. */
-    name = g_strdup_printf ("pulse-output-control-%lu", (gulong) info->index);
+    name = g_strdup_printf (PULSE_SINK_INPUT_NAME_PREFIX "%lu", (gulong) info->index);
 
     if (info->has_volume) {
         flags |=
@@ -98,25 +98,14 @@ pulse_sink_input_new (PulseConnection          *connection,
     }
 
     if (info->client != PA_INVALID_INDEX) {
-        app_info = _mate_mixer_app_info_new ();
-
         role = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
 
-        prop = pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_NAME);
-        if (prop != NULL)
-            _mate_mixer_app_info_set_name (app_info, prop);
-
-        prop = pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_ID);
-        if (prop != NULL)
-            _mate_mixer_app_info_set_id (app_info, prop);
-
-        prop = pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_VERSION);
-        if (prop != NULL)
-            _mate_mixer_app_info_set_version (app_info, prop);
-
-        prop = pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_ICON_NAME);
-        if (prop != NULL)
-            _mate_mixer_app_info_set_icon (app_info, prop);
+        /* All the streams of the same application share a single structure */
+        app_info = _mate_mixer_app_info_intern (
+                pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_NAME),
+                pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_ID),
+                pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_VERSION),
+                pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_ICON_NAME));
     }
 
     prop = pa_proplist_gets (info->proplist, PA_PROP_MEDIA_ROLE);
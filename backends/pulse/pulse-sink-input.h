@@ -28,6 +28,9 @@
 
 G_BEGIN_DECLS
 
+/* Control names include the PulseAudio index of the sink input */
+#define PULSE_SINK_INPUT_NAME_PREFIX "pulse-output-control-"
+
 #define PULSE_TYPE_SINK_INPUT                   \
         (pulse_sink_input_get_type ())
 #define PULSE_SINK_INPUT(o)                     \
@@ -15,6 +15,7 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include <glib/gi18n.h>
 #include <glib-object.h>
@@ -24,6 +25,7 @@
 #include <pulse/pulseaudio.h>
 
 #include "pulse-connection.h"
+#include "pulse-control-record.h"
 #include "pulse-device.h"
 #include "pulse-monitor.h"
 #include "pulse-port.h"
@@ -49,10 +51,16 @@ static void pulse_sink_finalize   (GObject        *object);
 
 G_DEFINE_TYPE_WITH_PRIVATE (PulseSink, pulse_sink, PULSE_TYPE_STREAM);
 
-static const GList *pulse_sink_list_controls (MateMixerStream *mms);
-static const GList *pulse_sink_list_switches (MateMixerStream *mms);
+static MateMixerStreamControl *pulse_sink_get_control   (MateMixerStream    *mms,
+                                                         const gchar        *name);
 
-static void         free_list_controls       (PulseSink       *sink);
+static const GList            *pulse_sink_list_controls (MateMixerStream    *mms);
+static const GList            *pulse_sink_list_switches (MateMixerStream    *mms);
+
+static PulseSinkInput         *materialize_input        (PulseSink          *sink,
+                                                         PulseControlRecord *record);
+
+static void                    free_list_controls       (PulseSink          *sink);
 
 static void
 pulse_sink_class_init (PulseSinkClass *klass)
@@ -65,6 +73,7 @@ pulse_sink_class_init (PulseSinkClass *klass)
     object_class->finalize = pulse_sink_finalize;
 
     stream_class = MATE_MIXER_STREAM_CLASS (klass);
+    stream_class->get_control   = pulse_sink_get_control;
     stream_class->list_controls = pulse_sink_list_controls;
     stream_class->list_switches = pulse_sink_list_switches;
 }
@@ -77,7 +86,7 @@ pulse_sink_init (PulseSink *sink)
     sink->priv->inputs = g_hash_table_new_full (g_direct_hash,
                                                 g_direct_equal,
                                                 NULL,
-                                                g_object_unref);
+                                                (GDestroyNotify) pulse_control_record_free);
 
     sink->priv->monitor = PA_INVALID_INDEX;
 }
@@ -182,60 +191,61 @@ pulse_sink_new (PulseConnection    *connection,
 gboolean
 pulse_sink_add_input (PulseSink *sink, const pa_sink_input_info *info)
 {
-    PulseSinkInput *input;
+    PulseControlRecord *record;
 
     g_return_val_if_fail (PULSE_IS_SINK (sink), FALSE);
     g_return_val_if_fail (info != NULL, FALSE);
 
-    /* This function is used for both creating and refreshing sink inputs */
-    input = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (info->index));
-    if (input == NULL) {
-        const gchar *name;
-        PulseConnection *connection;
+    /* This function is used for both creating and refreshing sink inputs,
+     * the control object is only created when the application asks for it */
+    record = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (info->index));
+    if (record == NULL) {
+        gchar name[64];
 
-        connection = pulse_stream_get_connection (PULSE_STREAM (sink));
-        input = pulse_sink_input_new (connection,
-                                      info,
-                                      sink);
+        record = pulse_control_record_new_sink_input (info);
 
         g_hash_table_insert (sink->priv->inputs,
                              GUINT_TO_POINTER (info->index),
-                             input);
+                             record);
 
         free_list_controls (sink);
 
-        name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (input));
+        g_snprintf (name, sizeof (name),
+                    PULSE_SINK_INPUT_NAME_PREFIX "%lu",
+                    (gulong) info->index);
+
         g_signal_emit_by_name (G_OBJECT (sink),
                                "control-added",
                                name);
         return TRUE;
     }
 
-    pulse_sink_input_update (input, info);
+    pulse_control_record_update_sink_input (record, info);
+
+    if (record->control != NULL)
+        pulse_sink_input_update (PULSE_SINK_INPUT (record->control), info);
+
     return FALSE;
 }
 
 void
 pulse_sink_remove_input (PulseSink *sink, guint32 index)
 {
-    PulseSinkInput *input;
-    gchar          *name;
+    gchar name[64];
 
     g_return_if_fail (PULSE_IS_SINK (sink));
 
-    input = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER (index));
-    if (G_UNLIKELY (input == NULL))
+    if (g_hash_table_remove (sink->priv->inputs, GUINT_TO_POINTER (index)) == FALSE)
         return;
 
-    name = g_strdup (mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (input)));
-
-    g_hash_table_remove (sink->priv->inputs, GUINT_TO_POINTER (index));
+    g_snprintf (name, sizeof (name),
+                PULSE_SINK_INPUT_NAME_PREFIX "%lu",
+                (gulong) index);
 
     free_list_controls (sink);
     g_signal_emit_by_name (G_OBJECT (sink),
                            "control-removed",
                            name);
-    g_free (name);
 }
 
 void
@@ -263,6 +273,50 @@ pulse_sink_get_index_monitor (PulseSink *sink)
     return sink->priv->monitor;
 }
 
+void
+pulse_sink_set_index_monitor (PulseSink *sink, guint32 index)
+{
+    g_return_if_fail (PULSE_IS_SINK (sink));
+
+    sink->priv->monitor = index;
+}
+
+static MateMixerStreamControl *
+pulse_sink_get_control (MateMixerStream *mms, const gchar *name)
+{
+    PulseSink              *sink;
+    PulseControlRecord     *record;
+    MateMixerStreamControl *control;
+    const gchar            *str;
+    gchar                  *end;
+    guint64                 index;
+
+    g_return_val_if_fail (PULSE_IS_SINK (mms), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    sink = PULSE_SINK (mms);
+
+    control = MATE_MIXER_STREAM_CONTROL (sink->priv->control);
+    if (strcmp (name, mate_mixer_stream_control_get_name (control)) == 0)
+        return control;
+
+    /* Find the sink input by the index included in the name instead of
+     * creating all the controls to compare their names */
+    if (g_str_has_prefix (name, PULSE_SINK_INPUT_NAME_PREFIX) == FALSE)
+        return NULL;
+
+    str   = name + strlen (PULSE_SINK_INPUT_NAME_PREFIX);
+    index = g_ascii_strtoull (str, &end, 10);
+    if (end == str || *end != '\0' || index > G_MAXUINT32)
+        return NULL;
+
+    record = g_hash_table_lookup (sink->priv->inputs, GUINT_TO_POINTER ((guint32) index));
+    if (record == NULL)
+        return NULL;
+
+    return MATE_MIXER_STREAM_CONTROL (materialize_input (sink, record));
+}
+
 static const GList *
 pulse_sink_list_controls (MateMixerStream *mms)
 {
@@ -273,9 +327,17 @@ pulse_sink_list_controls (MateMixerStream *mms)
     sink = PULSE_SINK (mms);
 
     if (sink->priv->inputs_list == NULL) {
-        sink->priv->inputs_list = g_hash_table_get_values (sink->priv->inputs);
-        if (sink->priv->inputs_list != NULL)
-            g_list_foreach (sink->priv->inputs_list, (GFunc) g_object_ref, NULL);
+        GHashTableIter      iter;
+        PulseControlRecord *record;
+
+        g_hash_table_iter_init (&iter, sink->priv->inputs);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &record) == TRUE) {
+            PulseSinkInput *input = materialize_input (sink, record);
+
+            sink->priv->inputs_list = g_list_prepend (sink->priv->inputs_list,
+                                                      g_object_ref (input));
+        }
 
         sink->priv->inputs_list = g_list_prepend (sink->priv->inputs_list,
                                                   g_object_ref (sink->priv->control));
@@ -301,3 +363,19 @@ free_list_controls (PulseSink *sink)
 
     sink->priv->inputs_list = NULL;
 }
+
+static PulseSinkInput *
+materialize_input (PulseSink *sink, PulseControlRecord *record)
+{
+    if (record->control == NULL) {
+        pa_sink_input_info info;
+
+        pulse_control_record_fill_sink_input_info (record, &info);
+
+        record->control =
+            PULSE_STREAM_CONTROL (pulse_sink_input_new (pulse_stream_get_connection (PULSE_STREAM (sink)),
+                                                        &info,
+                                                        sink));
+    }
+    return PULSE_SINK_INPUT (record->control);
+}
@@ -73,6 +73,8 @@ void       pulse_sink_update            (PulseSink                *sink,
                                          const pa_sink_info       *info);
 
 guint32    pulse_sink_get_index_monitor (PulseSink                *sink);
+void       pulse_sink_set_index_monitor (PulseSink                *sink,
+                                         guint32                   index);
 
 G_END_DECLS
 
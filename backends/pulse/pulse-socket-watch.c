@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <glib.h>
+
+#ifdef HAVE_SYS_INOTIFY_H
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#  include <glib-unix.h>
+#endif
+
+#include "pulse-socket-watch.h"
+
+struct _PulseSocketWatch
+{
+    gint                  fd;
+    GSource              *source;
+    gchar                *name;
+    PulseSocketWatchFunc  func;
+    gpointer              user_data;
+};
+
+#ifdef HAVE_SYS_INOTIFY_H
+static gboolean watch_cb (gint              fd,
+                          GIOCondition      condition,
+                          PulseSocketWatch *watch);
+#endif
+
+gchar *
+pulse_socket_watch_get_path (const gchar *server)
+{
+    const gchar *path;
+
+    if (server == NULL)
+        server = g_getenv ("PULSE_SERVER");
+
+    /* Only a single local server can be watched, not a list of servers or
+     * a remote server */
+    if (server != NULL && *server != '\0') {
+        if (strchr (server, ' ') != NULL)
+            return NULL;
+
+        if (g_str_has_prefix (server, "unix:") == TRUE)
+            server += strlen ("unix:");
+
+        if (*server == '/')
+            return g_strdup (server);
+
+        return NULL;
+    }
+
+    path = g_getenv ("PULSE_RUNTIME_PATH");
+    if (path != NULL && *path != '\0')
+        return g_build_filename (path, "native", NULL);
+
+    return g_build_filename (g_get_user_runtime_dir (), "pulse", "native", NULL);
+}
+
+PulseSocketWatch *
+pulse_socket_watch_new (const gchar          *path,
+                        PulseSocketWatchFunc  func,
+                        gpointer              user_data)
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    PulseSocketWatch *watch;
+    gchar            *dir;
+    gint              fd;
+
+    g_return_val_if_fail (path != NULL, NULL);
+    g_return_val_if_fail (func != NULL, NULL);
+
+    fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+
+    /* The socket does not exist while the server is not running, watch
+     * the directory for the socket to be created */
+    dir = g_path_get_dirname (path);
+
+    if (inotify_add_watch (fd, dir, IN_CREATE | IN_MOVED_TO) < 0) {
+        g_debug ("Failed to watch directory %s for the PulseAudio socket", dir);
+        g_free (dir);
+        close (fd);
+        return NULL;
+    }
+    g_free (dir);
+
+    watch = g_slice_new (PulseSocketWatch);
+    watch->fd        = fd;
+    watch->name      = g_path_get_basename (path);
+    watch->func      = func;
+    watch->user_data = user_data;
+
+    /* Dispatch in the main context of the thread which owns the backend,
+     * which is not necessarily the global default one */
+    watch->source = g_unix_fd_source_new (fd, G_IO_IN);
+    g_source_set_callback (watch->source,
+                           (GSourceFunc) watch_cb,
+                           watch,
+                           NULL);
+    g_source_attach (watch->source, g_main_context_get_thread_default ());
+    return watch;
+#else
+    return NULL;
+#endif
+}
+
+void
+pulse_socket_watch_free (PulseSocketWatch *watch)
+{
+    g_return_if_fail (watch != NULL);
+
+    if (watch->source != NULL) {
+        g_source_destroy (watch->source);
+        g_source_unref (watch->source);
+    }
+
+#ifdef HAVE_SYS_INOTIFY_H
+    close (watch->fd);
+#endif
+
+    g_free (watch->name);
+    g_slice_free (PulseSocketWatch, watch);
+}
+
+#ifdef HAVE_SYS_INOTIFY_H
+static gboolean
+watch_cb (gint fd, GIOCondition condition, PulseSocketWatch *watch)
+{
+    union {
+        struct inotify_event event;
+        gchar                buffer[4096];
+    } data;
+    gboolean created = FALSE;
+    gssize   length;
+
+    while ((length = read (fd, &data, sizeof (data))) > 0) {
+        gchar *ptr = data.buffer;
+
+        while (ptr < data.buffer + length) {
+            const struct inotify_event *event = (const struct inotify_event *) ptr;
+
+            if (event->len > 0 && strcmp (event->name, watch->name) == 0)
+                created = TRUE;
+
+            ptr += sizeof (struct inotify_event) + event->len;
+        }
+    }
+
+    /* The function may free the watch, do not touch it afterwards */
+    if (created == TRUE)
+        watch->func (watch->user_data);
+
+    return G_SOURCE_CONTINUE;
+}
+#endif
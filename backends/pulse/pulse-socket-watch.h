@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PULSE_SOCKET_WATCH_H
+#define PULSE_SOCKET_WATCH_H
+
+#include <glib.h>
+
+#include "pulse-types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * The socket watch calls the given function when the PulseAudio server
+ * creates its socket, which allows reconnecting as soon as the server is
+ * running again.
+ *
+ * The watch is only supported on systems with inotify, elsewhere
+ * pulse_socket_watch_new() returns NULL.
+ */
+typedef void (*PulseSocketWatchFunc) (gpointer user_data);
+
+gchar *           pulse_socket_watch_get_path (const gchar          *server);
+
+PulseSocketWatch *pulse_socket_watch_new      (const gchar          *path,
+                                               PulseSocketWatchFunc  func,
+                                               gpointer              user_data);
+void              pulse_socket_watch_free     (PulseSocketWatch     *watch);
+
+G_END_DECLS
+
+#endif /* PULSE_SOCKET_WATCH_H */
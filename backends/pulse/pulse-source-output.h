@@ -28,6 +28,9 @@
 
 G_BEGIN_DECLS
 
+/* Control names include the PulseAudio index of the source output */
+#define PULSE_SOURCE_OUTPUT_NAME_PREFIX "pulse-input-control-"
+
 #define PULSE_TYPE_SOURCE_OUTPUT                   \
         (pulse_source_output_get_type ())
 #define PULSE_SOURCE_OUTPUT(o)                     \
@@ -15,6 +15,7 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include <glib/gi18n.h>
 #include <glib-object.h>
@@ -24,6 +25,7 @@
 #include <pulse/pulseaudio.h>
 
 #include "pulse-connection.h"
+#include "pulse-control-record.h"
 #include "pulse-device.h"
 #include "pulse-monitor.h"
 #include "pulse-port.h"
@@ -48,10 +50,16 @@ static void pulse_source_finalize   (GObject          *object);
 
 G_DEFINE_TYPE_WITH_PRIVATE (PulseSource, pulse_source, PULSE_TYPE_STREAM);
 
-static const GList *pulse_source_list_controls (MateMixerStream *mms);
-static const GList *pulse_source_list_switches (MateMixerStream *mms);
+static MateMixerStreamControl *pulse_source_get_control   (MateMixerStream    *mms,
+                                                           const gchar        *name);
 
-static void         free_list_controls         (PulseSource     *source);
+static const GList            *pulse_source_list_controls (MateMixerStream    *mms);
+static const GList            *pulse_source_list_switches (MateMixerStream    *mms);
+
+static PulseSourceOutput      *materialize_output         (PulseSource        *source,
+                                                           PulseControlRecord *record);
+
+static void                    free_list_controls         (PulseSource        *source);
 
 static void
 pulse_source_class_init (PulseSourceClass *klass)
@@ -64,6 +72,7 @@ pulse_source_class_init (PulseSourceClass *klass)
     object_class->finalize = pulse_source_finalize;
 
     stream_class = MATE_MIXER_STREAM_CLASS (klass);
+    stream_class->get_control   = pulse_source_get_control;
     stream_class->list_controls = pulse_source_list_controls;
     stream_class->list_switches = pulse_source_list_switches;
 }
@@ -76,7 +85,7 @@ pulse_source_init (PulseSource *source)
     source->priv->outputs = g_hash_table_new_full (g_direct_hash,
                                                    g_direct_equal,
                                                    NULL,
-                                                   g_object_unref);
+                                                   (GDestroyNotify) pulse_control_record_free);
 }
 
 static void
@@ -179,59 +188,61 @@ pulse_source_new (PulseConnection      *connection,
 gboolean
 pulse_source_add_output (PulseSource *source, const pa_source_output_info *info)
 {
-    PulseSourceOutput *output;
+    PulseControlRecord *record;
 
     g_return_val_if_fail (PULSE_IS_SOURCE (source), FALSE);
     g_return_val_if_fail (info != NULL, FALSE);
 
-    /* This function is used for both creating and refreshing source outputs */
-    output = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (info->index));
-    if (output == NULL) {
-        const gchar *name;
-        PulseConnection *connection;
+    /* This function is used for both creating and refreshing source outputs,
+     * the control object is only created when the application asks for it */
+    record = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (info->index));
+    if (record == NULL) {
+        gchar name[64];
+
+        record = pulse_control_record_new_source_output (info);
 
-        connection = pulse_stream_get_connection (PULSE_STREAM (source));
-        output = pulse_source_output_new (connection,
-                                          info,
-                                          source);
         g_hash_table_insert (source->priv->outputs,
                              GUINT_TO_POINTER (info->index),
-                             output);
+                             record);
 
         free_list_controls (source);
 
-        name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (output));
+        g_snprintf (name, sizeof (name),
+                    PULSE_SOURCE_OUTPUT_NAME_PREFIX "%lu",
+                    (gulong) info->index);
+
         g_signal_emit_by_name (G_OBJECT (source),
                                "control-added",
                                name);
         return TRUE;
     }
 
-    pulse_source_output_update (output, info);
+    pulse_control_record_update_source_output (record, info);
+
+    if (record->control != NULL)
+        pulse_source_output_update (PULSE_SOURCE_OUTPUT (record->control), info);
+
     return FALSE;
 }
 
 void
 pulse_source_remove_output (PulseSource *source, guint32 index)
 {
-    PulseSourceOutput *output;
-    gchar             *name;
+    gchar name[64];
 
     g_return_if_fail (PULSE_IS_SOURCE (source));
 
-    output = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER (index));
-    if (G_UNLIKELY (output == NULL))
+    if (g_hash_table_remove (source->priv->outputs, GUINT_TO_POINTER (index)) == FALSE)
         return;
 
-    name = g_strdup (mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (output)));
-
-    g_hash_table_remove (source->priv->outputs, GUINT_TO_POINTER (index));
+    g_snprintf (name, sizeof (name),
+                PULSE_SOURCE_OUTPUT_NAME_PREFIX "%lu",
+                (gulong) index);
 
     free_list_controls (source);
     g_signal_emit_by_name (G_OBJECT (source),
                            "control-removed",
                            name);
-    g_free (name);
 }
 
 void
@@ -250,6 +261,42 @@ pulse_source_update (PulseSource          *source,
     pulse_source_control_update (source->priv->control, info);
 }
 
+static MateMixerStreamControl *
+pulse_source_get_control (MateMixerStream *mms, const gchar *name)
+{
+    PulseSource            *source;
+    PulseControlRecord     *record;
+    MateMixerStreamControl *control;
+    const gchar            *str;
+    gchar                  *end;
+    guint64                 index;
+
+    g_return_val_if_fail (PULSE_IS_SOURCE (mms), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    source = PULSE_SOURCE (mms);
+
+    control = MATE_MIXER_STREAM_CONTROL (source->priv->control);
+    if (strcmp (name, mate_mixer_stream_control_get_name (control)) == 0)
+        return control;
+
+    /* Find the source output by the index included in the name instead of
+     * creating all the controls to compare their names */
+    if (g_str_has_prefix (name, PULSE_SOURCE_OUTPUT_NAME_PREFIX) == FALSE)
+        return NULL;
+
+    str   = name + strlen (PULSE_SOURCE_OUTPUT_NAME_PREFIX);
+    index = g_ascii_strtoull (str, &end, 10);
+    if (end == str || *end != '\0' || index > G_MAXUINT32)
+        return NULL;
+
+    record = g_hash_table_lookup (source->priv->outputs, GUINT_TO_POINTER ((guint32) index));
+    if (record == NULL)
+        return NULL;
+
+    return MATE_MIXER_STREAM_CONTROL (materialize_output (source, record));
+}
+
 static const GList *
 pulse_source_list_controls (MateMixerStream *mms)
 {
@@ -260,9 +307,17 @@ pulse_source_list_controls (MateMixerStream *mms)
     source = PULSE_SOURCE (mms);
 
     if (source->priv->outputs_list == NULL) {
-        source->priv->outputs_list = g_hash_table_get_values (source->priv->outputs);
-        if (source->priv->outputs_list != NULL)
-            g_list_foreach (source->priv->outputs_list, (GFunc) g_object_ref, NULL);
+        GHashTableIter      iter;
+        PulseControlRecord *record;
+
+        g_hash_table_iter_init (&iter, source->priv->outputs);
+
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &record) == TRUE) {
+            PulseSourceOutput *output = materialize_output (source, record);
+
+            source->priv->outputs_list = g_list_prepend (source->priv->outputs_list,
+                                                         g_object_ref (output));
+        }
 
         source->priv->outputs_list = g_list_prepend (source->priv->outputs_list,
                                                      g_object_ref (source->priv->control));
@@ -288,3 +343,19 @@ free_list_controls (PulseSource *source)
 
     source->priv->outputs_list = NULL;
 }
+
+static PulseSourceOutput *
+materialize_output (PulseSource *source, PulseControlRecord *record)
+{
+    if (record->control == NULL) {
+        pa_source_output_info info;
+
+        pulse_control_record_fill_source_output_info (record, &info);
+
+        record->control =
+            PULSE_STREAM_CONTROL (pulse_source_output_new (pulse_stream_get_connection (PULSE_STREAM (source)),
+                                                           &info,
+                                                           source));
+    }
+    return PULSE_SOURCE_OUTPUT (record->control);
+}
@@ -15,6 +15,7 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 #include <libmatemixer/matemixer.h>
@@ -28,16 +29,21 @@
 #include "pulse-stream.h"
 #include "pulse-stream-control.h"
 
+/* The volume and channel map are stored in arrays sized to the actual number
+ * of channels rather than in pa_cvolume and pa_channel_map, which are sized
+ * for PA_CHANNELS_MAX channels and take 132 bytes each */
 struct _PulseStreamControlPrivate
 {
-    guint32           index;
-    guint             volume;
-    pa_cvolume        cvolume;
-    pa_volume_t       base_volume;
-    pa_channel_map    channel_map;
-    PulseConnection  *connection;
-    PulseMonitor     *monitor;
-    MateMixerAppInfo *app_info;
+    guint32                index;
+    guint                  volume;
+    pa_volume_t            base_volume;
+    guint8                 volume_channels;
+    guint8                 map_channels;
+    pa_volume_t           *volumes;
+    pa_channel_position_t *positions;
+    PulseConnection       *connection;
+    PulseMonitor          *monitor;
+    MateMixerAppInfo      *app_info;
 };
 
 enum {
@@ -61,7 +67,13 @@ static void pulse_stream_control_set_property (GObject                 *object,
 static void pulse_stream_control_dispose      (GObject                 *object);
 static void pulse_stream_control_finalize     (GObject                 *object);
 
-G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (PulseStreamControl, pulse_stream_control, MATE_MIXER_TYPE_STREAM_CONTROL)
+static void decibel_scale_interface_init      (MateMixerDecibelScaleInterface *iface);
+
+G_DEFINE_ABSTRACT_TYPE_WITH_CODE (PulseStreamControl, pulse_stream_control,
+                                  MATE_MIXER_TYPE_STREAM_CONTROL,
+                                  G_ADD_PRIVATE (PulseStreamControl)
+                                  G_IMPLEMENT_INTERFACE (MATE_MIXER_TYPE_DECIBEL_SCALE,
+                                                         decibel_scale_interface_init))
 
 static MateMixerAppInfo *       pulse_stream_control_get_app_info         (MateMixerStreamControl   *mmsc);
 
@@ -78,6 +90,13 @@ static gdouble                  pulse_stream_control_get_decibel          (MateM
 static gboolean                 pulse_stream_control_set_decibel          (MateMixerStreamControl   *mmsc,
                                                                            gdouble                   decibel);
 
+static gboolean                 pulse_stream_control_get_decibel_from_volume (MateMixerDecibelScale *scale,
+                                                                              guint                  volume,
+                                                                              gdouble               *decibel);
+static gboolean                 pulse_stream_control_get_volume_from_decibel (MateMixerDecibelScale *scale,
+                                                                              gdouble                decibel,
+                                                                              guint                 *volume);
+
 static guint                    pulse_stream_control_get_channel_volume   (MateMixerStreamControl   *mmsc,
                                                                            guint                     channel);
 static gboolean                 pulse_stream_control_set_channel_volume   (MateMixerStreamControl   *mmsc,
@@ -110,14 +129,26 @@ static guint                    pulse_stream_control_get_max_volume       (MateM
 static guint                    pulse_stream_control_get_normal_volume    (MateMixerStreamControl   *mmsc);
 static guint                    pulse_stream_control_get_base_volume      (MateMixerStreamControl   *mmsc);
 
-static void                     on_monitor_value (PulseMonitor       *monitor,
-                                                  gdouble             value,
-                                                  PulseStreamControl *control);
+static void                     on_monitor_value  (PulseMonitor         *monitor,
+                                                   gdouble               value,
+                                                   PulseStreamControl   *control);
+
+static void                     set_balance_fade  (PulseStreamControl   *control);
 
-static void                     set_balance_fade (PulseStreamControl *control);
+static gboolean                 set_cvolume       (PulseStreamControl   *control,
+                                                   pa_cvolume           *cvolume);
 
-static gboolean                 set_cvolume      (PulseStreamControl *control,
-                                                  pa_cvolume         *cvolume);
+static void                     store_cvolume     (PulseStreamControl   *control,
+                                                   const pa_cvolume     *cvolume);
+static void                     store_channel_map (PulseStreamControl   *control,
+                                                   const pa_channel_map *map);
+
+static void
+decibel_scale_interface_init (MateMixerDecibelScaleInterface *iface)
+{
+    iface->get_decibel_from_volume = pulse_stream_control_get_decibel_from_volume;
+    iface->get_volume_from_decibel = pulse_stream_control_get_volume_from_decibel;
+}
 
 static void
 pulse_stream_control_class_init (PulseStreamControlClass *klass)
@@ -227,12 +258,6 @@ static void
 pulse_stream_control_init (PulseStreamControl *control)
 {
     control->priv = pulse_stream_control_get_instance_private (control);
-
-    /* Initialize empty volume and channel map structures, they will be used
-     * if the stream does not support volume */
-    pa_cvolume_init (&control->priv->cvolume);
-
-    pa_channel_map_init (&control->priv->channel_map);
 }
 
 static void
@@ -256,7 +281,10 @@ pulse_stream_control_finalize (GObject *object)
     control = PULSE_STREAM_CONTROL (object);
 
     if (control->priv->app_info != NULL)
-        _mate_mixer_app_info_free (control->priv->app_info);
+        _mate_mixer_app_info_unref (control->priv->app_info);
+
+    g_free (control->priv->volumes);
+    g_free (control->priv->positions);
 
     G_OBJECT_CLASS (pulse_stream_control_parent_class)->finalize (object);
 }
@@ -299,20 +327,58 @@ pulse_stream_control_get_monitor (PulseStreamControl *control)
     return control->priv->monitor;
 }
 
-const pa_cvolume *
-pulse_stream_control_get_cvolume (PulseStreamControl *control)
+void
+pulse_stream_control_reset_monitor (PulseStreamControl *control)
 {
-    g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (control), NULL);
+    gboolean enabled;
+
+    g_return_if_fail (PULSE_IS_STREAM_CONTROL (control));
+
+    if (control->priv->monitor == NULL)
+        return;
+
+    /* The monitor records from the indices the stream had when the monitor
+     * was created, create it again with the current ones if it is in use */
+    enabled = pulse_monitor_get_enabled (control->priv->monitor);
 
-    return &control->priv->cvolume;
+    g_signal_handlers_disconnect_by_func (G_OBJECT (control->priv->monitor),
+                                          on_monitor_value,
+                                          control);
+    g_clear_object (&control->priv->monitor);
+
+    if (enabled == TRUE)
+        pulse_stream_control_set_monitor_enabled (MATE_MIXER_STREAM_CONTROL (control), TRUE);
 }
 
-const pa_channel_map *
-pulse_stream_control_get_channel_map (PulseStreamControl *control)
+void
+pulse_stream_control_get_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
 {
-    g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (control), NULL);
+    g_return_if_fail (PULSE_IS_STREAM_CONTROL (control));
+    g_return_if_fail (cvolume != NULL);
 
-    return &control->priv->channel_map;
+    /* A control without volume has an empty cvolume, which won't validate */
+    pa_cvolume_init (cvolume);
+
+    cvolume->channels = control->priv->volume_channels;
+    if (cvolume->channels > 0)
+        memcpy (cvolume->values,
+                control->priv->volumes,
+                cvolume->channels * sizeof (pa_volume_t));
+}
+
+void
+pulse_stream_control_get_channel_map (PulseStreamControl *control, pa_channel_map *map)
+{
+    g_return_if_fail (PULSE_IS_STREAM_CONTROL (control));
+    g_return_if_fail (map != NULL);
+
+    pa_channel_map_init (map);
+
+    map->channels = control->priv->map_channels;
+    if (map->channels > 0)
+        memcpy (map->map,
+                control->priv->positions,
+                map->channels * sizeof (pa_channel_position_t));
 }
 
 void
@@ -323,12 +389,12 @@ pulse_stream_control_set_app_info (PulseStreamControl *control,
     g_return_if_fail (PULSE_IS_STREAM_CONTROL (control));
 
     if (G_UNLIKELY (control->priv->app_info != NULL))
-        _mate_mixer_app_info_free (control->priv->app_info);
+        _mate_mixer_app_info_unref (control->priv->app_info);
 
     if (take == TRUE)
         control->priv->app_info = info;
     else
-        control->priv->app_info = _mate_mixer_app_info_copy (info);
+        control->priv->app_info = _mate_mixer_app_info_ref (info);
 }
 
 void
@@ -351,13 +417,13 @@ pulse_stream_control_set_channel_map (PulseStreamControl *control, const pa_chan
         else
             flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_FADE;
 
-        control->priv->channel_map = *map;
+        store_channel_map (control, map);
     } else {
         flags &= ~(MATE_MIXER_STREAM_CONTROL_CAN_BALANCE | MATE_MIXER_STREAM_CONTROL_CAN_FADE);
 
-        /* If the channel map is not valid, create an empty channel map, which
+        /* If the channel map is not valid, store an empty channel map, which
          * also won't validate, but at least we know what it is */
-        pa_channel_map_init (&control->priv->channel_map);
+        store_channel_map (control, NULL);
     }
 
     _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (control), flags);
@@ -380,13 +446,20 @@ pulse_stream_control_set_cvolume (PulseStreamControl *control,
     g_object_freeze_notify (G_OBJECT (control));
 
     if (cvolume != NULL && pa_cvolume_valid (cvolume)) {
+        pa_cvolume current;
+
         /* Decibel volume and volume settability flags must be provided by
          * the implementation */
         flags |= MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE;
 
-        if (pa_cvolume_equal (&control->priv->cvolume, cvolume) == 0) {
-            control->priv->cvolume = *cvolume;
-            control->priv->volume  = (guint) pa_cvolume_max (&control->priv->cvolume);
+        pulse_stream_control_get_cvolume (control, &current);
+
+        if (pa_cvolume_equal (&current, cvolume) == 0) {
+            store_cvolume (control, cvolume);
+
+            control->priv->volume = (guint) pa_cvolume_max (cvolume);
+
+            _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
 
             g_object_notify (G_OBJECT (control), "volume");
         }
@@ -395,13 +468,15 @@ pulse_stream_control_set_cvolume (PulseStreamControl *control,
                    MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE |
                    MATE_MIXER_STREAM_CONTROL_HAS_DECIBEL);
 
-        /* If the cvolume is not valid, create an empty cvolume, which also
+        /* If the cvolume is not valid, store an empty cvolume, which also
          * won't validate, but at least we know what it is */
-        pa_cvolume_init (&control->priv->cvolume);
+        store_cvolume (control, NULL);
 
         if (control->priv->volume != (guint) PA_VOLUME_MUTED) {
             control->priv->volume = (guint) PA_VOLUME_MUTED;
 
+            _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
+
             g_object_notify (G_OBJECT (control), "volume");
         }
     }
@@ -435,7 +510,7 @@ pulse_stream_control_get_num_channels (MateMixerStreamControl *mmsc)
 {
     g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (mmsc), 0);
 
-    return PULSE_STREAM_CONTROL (mmsc)->priv->channel_map.channels;
+    return PULSE_STREAM_CONTROL (mmsc)->priv->map_channels;
 }
 
 static guint
@@ -455,7 +530,8 @@ pulse_stream_control_set_volume (MateMixerStreamControl *mmsc, guint volume)
     g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = PULSE_STREAM_CONTROL (mmsc);
-    cvolume = control->priv->cvolume;
+
+    pulse_stream_control_get_cvolume (control, &cvolume);
 
     if (pa_cvolume_scale (&cvolume, (pa_volume_t) volume) == NULL)
         return FALSE;
@@ -485,6 +561,32 @@ pulse_stream_control_set_decibel (MateMixerStreamControl *mmsc, gdouble decibel)
                                             pa_sw_volume_from_dB (decibel));
 }
 
+static gboolean
+pulse_stream_control_get_decibel_from_volume (MateMixerDecibelScale *scale,
+                                              guint                  volume,
+                                              gdouble               *decibel)
+{
+    gdouble value;
+
+    g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (scale), FALSE);
+
+    value = pa_sw_volume_to_dB ((pa_volume_t) volume);
+
+    *decibel = (value == PA_DECIBEL_MININFTY) ? -MATE_MIXER_INFINITY : value;
+    return TRUE;
+}
+
+static gboolean
+pulse_stream_control_get_volume_from_decibel (MateMixerDecibelScale *scale,
+                                              gdouble                decibel,
+                                              guint                 *volume)
+{
+    g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (scale), FALSE);
+
+    *volume = pa_sw_volume_from_dB (decibel);
+    return TRUE;
+}
+
 static guint
 pulse_stream_control_get_channel_volume (MateMixerStreamControl *mmsc, guint channel)
 {
@@ -494,10 +596,10 @@ pulse_stream_control_get_channel_volume (MateMixerStreamControl *mmsc, guint cha
 
     control = PULSE_STREAM_CONTROL (mmsc);
 
-    if (channel >= control->priv->cvolume.channels)
+    if (channel >= control->priv->volume_channels)
         return (guint) PA_VOLUME_MUTED;
 
-    return (guint) control->priv->cvolume.values[channel];
+    return (guint) control->priv->volumes[channel];
 }
 
 static gboolean
@@ -510,11 +612,12 @@ pulse_stream_control_set_channel_volume (MateMixerStreamControl *mmsc, guint cha
 
     control = PULSE_STREAM_CONTROL (mmsc);
 
-    if (channel >= control->priv->cvolume.channels)
+    if (channel >= control->priv->volume_channels)
         return FALSE;
 
     /* This is safe, because the cvolume is validated by set_cvolume() */
-    cvolume = control->priv->cvolume;
+    pulse_stream_control_get_cvolume (control, &cvolume);
+
     cvolume.values[channel] = (pa_volume_t) volume;
 
     return set_cvolume (control, &cvolume);
@@ -530,10 +633,10 @@ pulse_stream_control_get_channel_decibel (MateMixerStreamControl *mmsc, guint ch
 
     control = PULSE_STREAM_CONTROL (mmsc);
 
-    if (channel >= control->priv->cvolume.channels)
+    if (channel >= control->priv->volume_channels)
         return -MATE_MIXER_INFINITY;
 
-    value = pa_sw_volume_to_dB (control->priv->cvolume.values[channel]);
+    value = pa_sw_volume_to_dB (control->priv->volumes[channel]);
 
     return (value == PA_DECIBEL_MININFTY) ? -MATE_MIXER_INFINITY : value;
 }
@@ -559,13 +662,13 @@ pulse_stream_control_get_channel_position (MateMixerStreamControl *mmsc, guint c
 
     control = PULSE_STREAM_CONTROL (mmsc);
 
-    if (channel >= control->priv->channel_map.channels)
+    if (channel >= control->priv->map_channels)
         return MATE_MIXER_CHANNEL_UNKNOWN;
 
-    if (control->priv->channel_map.map[channel] == PA_CHANNEL_POSITION_INVALID)
+    if (control->priv->positions[channel] == PA_CHANNEL_POSITION_INVALID)
         return MATE_MIXER_CHANNEL_UNKNOWN;
 
-    return pulse_channel_map_from[control->priv->channel_map.map[channel]];
+    return pulse_channel_map_from[control->priv->positions[channel]];
 }
 
 static gboolean
@@ -573,6 +676,7 @@ pulse_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
                                            MateMixerChannelPosition position)
 {
     PulseStreamControl *control;
+    guint               i;
 
     g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (mmsc), FALSE);
 
@@ -583,11 +687,11 @@ pulse_stream_control_has_channel_position (MateMixerStreamControl  *mmsc,
     if (pulse_channel_map_to[position] == PA_CHANNEL_POSITION_INVALID)
         return FALSE;
 
-    if (pa_channel_map_has_position (&control->priv->channel_map,
-                                     pulse_channel_map_to[position]) != 0)
-        return TRUE;
-    else
-        return FALSE;
+    for (i = 0; i < control->priv->map_channels; i++)
+        if (control->priv->positions[i] == pulse_channel_map_to[position])
+            return TRUE;
+
+    return FALSE;
 }
 
 static gboolean
@@ -595,13 +699,16 @@ pulse_stream_control_set_balance (MateMixerStreamControl *mmsc, gfloat balance)
 {
     PulseStreamControl *control;
     pa_cvolume          cvolume;
+    pa_channel_map      map;
 
     g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = PULSE_STREAM_CONTROL (mmsc);
-    cvolume = control->priv->cvolume;
 
-    if (pa_cvolume_set_balance (&cvolume, &control->priv->channel_map, balance) == NULL)
+    pulse_stream_control_get_cvolume (control, &cvolume);
+    pulse_stream_control_get_channel_map (control, &map);
+
+    if (pa_cvolume_set_balance (&cvolume, &map, balance) == NULL)
         return FALSE;
 
     return set_cvolume (control, &cvolume);
@@ -612,13 +719,16 @@ pulse_stream_control_set_fade (MateMixerStreamControl *mmsc, gfloat fade)
 {
     PulseStreamControl *control;
     pa_cvolume          cvolume;
+    pa_channel_map      map;
 
     g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (mmsc), FALSE);
 
     control = PULSE_STREAM_CONTROL (mmsc);
-    cvolume = control->priv->cvolume;
 
-    if (pa_cvolume_set_fade (&cvolume, &control->priv->channel_map, fade) == NULL)
+    pulse_stream_control_get_cvolume (control, &cvolume);
+    pulse_stream_control_get_channel_map (control, &map);
+
+    if (pa_cvolume_set_fade (&cvolume, &map, fade) == NULL)
         return FALSE;
 
     return set_cvolume (control, &cvolume);
@@ -723,25 +833,33 @@ pulse_stream_control_get_base_volume (MateMixerStreamControl *mmsc)
 static void
 on_monitor_value (PulseMonitor *monitor, gdouble value, PulseStreamControl *control)
 {
-    g_signal_emit_by_name (G_OBJECT (control),
-                           "monitor-value",
-                           value);
+    MateMixerStatistics *statistics;
+
+    statistics = pulse_connection_get_statistics (control->priv->connection);
+    if (statistics != NULL)
+        _mate_mixer_statistics_add_monitor_value (statistics);
+
+    _mate_mixer_stream_control_push_monitor_value (MATE_MIXER_STREAM_CONTROL (control),
+                                                   value);
 }
 
 static void
 set_balance_fade (PulseStreamControl *control)
 {
-    gfloat value;
+    pa_cvolume     cvolume;
+    pa_channel_map map;
+    gfloat         value;
+
+    pulse_stream_control_get_cvolume (control, &cvolume);
+    pulse_stream_control_get_channel_map (control, &map);
 
     /* PulseAudio returns the default 0.0f value on error, so skip checking validity
      * of the channel map and cvolume */
-    value = pa_cvolume_get_balance (&control->priv->cvolume,
-                                    &control->priv->channel_map);
+    value = pa_cvolume_get_balance (&cvolume, &map);
 
     _mate_mixer_stream_control_set_balance (MATE_MIXER_STREAM_CONTROL (control), value);
 
-    value = pa_cvolume_get_fade (&control->priv->cvolume,
-                                 &control->priv->channel_map);
+    value = pa_cvolume_get_fade (&cvolume, &map);
 
     _mate_mixer_stream_control_set_fade (MATE_MIXER_STREAM_CONTROL (control), value);
 }
@@ -750,10 +868,14 @@ static gboolean
 set_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
 {
     PulseStreamControlClass *klass;
+    pa_cvolume               current;
 
     if (pa_cvolume_valid (cvolume) == 0)
         return FALSE;
-    if (pa_cvolume_equal (cvolume, &control->priv->cvolume) != 0)
+
+    pulse_stream_control_get_cvolume (control, &current);
+
+    if (pa_cvolume_equal (cvolume, &current) != 0)
         return TRUE;
 
     klass = PULSE_STREAM_CONTROL_GET_CLASS (control);
@@ -761,8 +883,11 @@ set_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
     if (klass->set_volume (control, cvolume) == FALSE)
         return FALSE;
 
-    control->priv->cvolume = *cvolume;
-    control->priv->volume  = (guint) pa_cvolume_max (cvolume);
+    store_cvolume (control, cvolume);
+
+    control->priv->volume = (guint) pa_cvolume_max (cvolume);
+
+    _mate_mixer_stream_control_publish_state (MATE_MIXER_STREAM_CONTROL (control));
 
     g_object_notify (G_OBJECT (control), "volume");
 
@@ -770,3 +895,42 @@ set_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
     set_balance_fade (control);
     return TRUE;
 }
+
+static void
+store_cvolume (PulseStreamControl *control, const pa_cvolume *cvolume)
+{
+    guint8 channels = (cvolume != NULL) ? cvolume->channels : 0;
+
+    /* The number of channels rarely changes, so reallocate only when it does */
+    if (control->priv->volume_channels != channels) {
+        control->priv->volumes = g_renew (pa_volume_t,
+                                          control->priv->volumes,
+                                          channels);
+
+        control->priv->volume_channels = channels;
+    }
+
+    if (channels > 0)
+        memcpy (control->priv->volumes,
+                cvolume->values,
+                channels * sizeof (pa_volume_t));
+}
+
+static void
+store_channel_map (PulseStreamControl *control, const pa_channel_map *map)
+{
+    guint8 channels = (map != NULL) ? map->channels : 0;
+
+    if (control->priv->map_channels != channels) {
+        control->priv->positions = g_renew (pa_channel_position_t,
+                                            control->priv->positions,
+                                            channels);
+
+        control->priv->map_channels = channels;
+    }
+
+    if (channels > 0)
+        memcpy (control->priv->positions,
+                map->map,
+                channels * sizeof (pa_channel_position_t));
+}
@@ -72,9 +72,12 @@ guint32               pulse_stream_control_get_stream_index (PulseStreamControl
 
 PulseConnection *     pulse_stream_control_get_connection   (PulseStreamControl   *control);
 PulseMonitor *        pulse_stream_control_get_monitor      (PulseStreamControl   *control);
+void                  pulse_stream_control_reset_monitor    (PulseStreamControl   *control);
 
-const pa_cvolume *    pulse_stream_control_get_cvolume      (PulseStreamControl   *control);
-const pa_channel_map *pulse_stream_control_get_channel_map  (PulseStreamControl   *control);
+void                  pulse_stream_control_get_cvolume      (PulseStreamControl   *control,
+                                                             pa_cvolume           *cvolume);
+void                  pulse_stream_control_get_channel_map  (PulseStreamControl   *control,
+                                                             pa_channel_map       *map);
 
 void                  pulse_stream_control_set_app_info     (PulseStreamControl   *stream,
                                                              MateMixerAppInfo     *info,
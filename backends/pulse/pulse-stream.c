@@ -162,6 +162,21 @@ pulse_stream_get_index (PulseStream *stream)
     return stream->priv->index;
 }
 
+void
+pulse_stream_set_index (PulseStream *stream, guint32 index)
+{
+    g_return_if_fail (PULSE_IS_STREAM (stream));
+
+    /* The index changes when PulseAudio creates the stream again, for
+     * example after a change of the card profile */
+    if (stream->priv->index == index)
+        return;
+
+    stream->priv->index = index;
+
+    g_object_notify_by_pspec (G_OBJECT (stream), properties[PROP_INDEX]);
+}
+
 PulseConnection *
 pulse_stream_get_connection (PulseStream *stream)
 {
@@ -22,6 +22,7 @@ G_BEGIN_DECLS
 
 typedef struct _PulseBackend            PulseBackend;
 typedef struct _PulseConnection         PulseConnection;
+typedef struct _PulseControlRecord      PulseControlRecord;
 typedef struct _PulseDevice             PulseDevice;
 typedef struct _PulseDeviceProfile      PulseDeviceProfile;
 typedef struct _PulseDeviceSwitch       PulseDeviceSwitch;
@@ -29,10 +30,13 @@ typedef struct _PulseExtStream          PulseExtStream;
 typedef struct _PulseMonitor            PulseMonitor;
 typedef struct _PulsePort               PulsePort;
 typedef struct _PulsePortSwitch         PulsePortSwitch;
+typedef struct _PulseRecorder           PulseRecorder;
+typedef struct _PulseReplay             PulseReplay;
 typedef struct _PulseSink               PulseSink;
 typedef struct _PulseSinkControl        PulseSinkControl;
 typedef struct _PulseSinkInput          PulseSinkInput;
 typedef struct _PulseSinkSwitch         PulseSinkSwitch;
+typedef struct _PulseSocketWatch        PulseSocketWatch;
 typedef struct _PulseSource             PulseSource;
 typedef struct _PulseSourceControl      PulseSourceControl;
 typedef struct _PulseSourceOutput       PulseSourceOutput;
@@ -350,6 +350,72 @@ on_context_stream_removed (MateMixerContext *context, const gchar *name)
     g_print ("Stream removed: %s\n", name);
 }
 
+static void
+print_statistics (void)
+{
+    MateMixerStatistics *statistics;
+    GEnumClass          *klass;
+    guint                i;
+
+    statistics = mate_mixer_context_get_statistics (context);
+    if (statistics == NULL) {
+        g_print ("Statistics are not available\n");
+        return;
+    }
+
+    g_print ("Statistics after %.1f seconds\n"
+             "  Queries        : %" G_GUINT64_FORMAT "\n"
+             "  Operations     : %u (peak %u)\n"
+             "  Signals        : %" G_GUINT64_FORMAT "\n"
+             "  Notifications  : %" G_GUINT64_FORMAT "\n"
+             "  Devices        : %u (peak %u)\n"
+             "  Streams        : %u (peak %u)\n"
+             "  Stored controls: %u (peak %u)\n"
+             "  Monitor values : %" G_GUINT64_FORMAT " (%.1f/s)\n",
+             mate_mixer_statistics_get_elapsed_time (statistics) / (gdouble) G_USEC_PER_SEC,
+             mate_mixer_statistics_get_queries (statistics),
+             mate_mixer_statistics_get_operations (statistics),
+             mate_mixer_statistics_get_operations_peak (statistics),
+             mate_mixer_statistics_get_signals (statistics),
+             mate_mixer_statistics_get_notifications (statistics),
+             mate_mixer_statistics_get_devices (statistics),
+             mate_mixer_statistics_get_devices_peak (statistics),
+             mate_mixer_statistics_get_streams (statistics),
+             mate_mixer_statistics_get_streams_peak (statistics),
+             mate_mixer_statistics_get_stored_controls (statistics),
+             mate_mixer_statistics_get_stored_controls_peak (statistics),
+             mate_mixer_statistics_get_monitor_values (statistics),
+             mate_mixer_statistics_get_monitor_rate (statistics));
+
+    g_print ("  Events\n");
+
+    klass = g_type_class_ref (MATE_MIXER_TYPE_STATISTICS_EVENT);
+
+    for (i = 0; i < MATE_MIXER_STATISTICS_EVENT_MAX; i++)
+        g_print ("    %-15s: %" G_GUINT64_FORMAT "\n",
+                 g_enum_get_value (klass, i)->value_nick,
+                 mate_mixer_statistics_get_events (statistics, i));
+
+    g_type_class_unref (klass);
+
+    g_print ("  Handlers       : %" G_GUINT64_FORMAT " calls, %" G_GUINT64_FORMAT " us\n",
+             mate_mixer_statistics_get_handler_calls (statistics),
+             mate_mixer_statistics_get_handler_time (statistics));
+
+    for (i = 0; i < MATE_MIXER_STATISTICS_HISTOGRAM_SIZE; i++) {
+        gint64 bound = mate_mixer_statistics_get_histogram_bound (i);
+
+        if (bound == G_MAXINT64)
+            g_print ("    %15s: %" G_GUINT64_FORMAT "\n", "more",
+                     mate_mixer_statistics_get_handler_histogram (statistics, i));
+        else
+            g_print ("    < %10" G_GINT64_FORMAT " us: %" G_GUINT64_FORMAT "\n", bound,
+                     mate_mixer_statistics_get_handler_histogram (statistics, i));
+    }
+
+    mate_mixer_statistics_free (statistics);
+}
+
 #ifdef G_OS_UNIX
 static gboolean
 on_signal (gpointer mainloop)
@@ -358,6 +424,14 @@ on_signal (gpointer mainloop)
 
     return G_SOURCE_REMOVE;
 }
+
+static gboolean
+on_signal_statistics (gpointer data)
+{
+    print_statistics ();
+
+    return G_SOURCE_CONTINUE;
+}
 #endif
 
 int main (int argc, char *argv[])
@@ -369,7 +443,7 @@ int main (int argc, char *argv[])
     gchar          *server  = NULL;
     GError         *error   = NULL;
     GOptionEntry    entries[] = {
-        { "backend", 'b', 0, G_OPTION_ARG_STRING, &backend, "Sound system to use (pulseaudio, alsa, oss, null)", NULL },
+        { "backend", 'b', 0, G_OPTION_ARG_STRING, &backend, "Sound system to use (pipewire, pulseaudio, alsa, oss, null, broker)", NULL },
         { "debug",   'd', 0, G_OPTION_ARG_NONE,   &debug,   "Enable debug", NULL },
         { "server",  's', 0, G_OPTION_ARG_STRING, &server,  "Sound server address", NULL },
         { NULL }
@@ -401,14 +475,16 @@ int main (int argc, char *argv[])
     /* Create a libmatemixer context to access the library */
     context = mate_mixer_context_new ();
 
-    /* Fill in some details about our application, only used with the PulseAudio backend */
+    /* Fill in some details about our application, only used with the PipeWire and PulseAudio backends */
     mate_mixer_context_set_app_name (context, "MateMixer Monitor");
     mate_mixer_context_set_app_id (context, "org.mate-desktop.libmatemixer-monitor");
     mate_mixer_context_set_app_version (context, "1.0");
     mate_mixer_context_set_app_icon (context, "multimedia-volume-control");
 
     if (backend != NULL) {
-        if (strcmp (backend, "pulseaudio") == 0)
+        if (strcmp (backend, "pipewire") == 0)
+            mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_PIPEWIRE);
+        else if (strcmp (backend, "pulseaudio") == 0)
             mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_PULSEAUDIO);
         else if (strcmp (backend, "alsa") == 0)
             mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_ALSA);
@@ -416,6 +492,8 @@ int main (int argc, char *argv[])
             mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_OSS);
         else if (strcmp (backend, "null") == 0)
             mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_NULL);
+        else if (strcmp (backend, "broker") == 0)
+            mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_BROKER);
         else
             g_printerr ("Sound system backend '%s' is unknown, the backend will be auto-detected.\n",
                         backend);
@@ -482,6 +560,9 @@ int main (int argc, char *argv[])
 #ifdef G_OS_UNIX
     g_unix_signal_add (SIGTERM, on_signal, mainloop);
     g_unix_signal_add (SIGINT,  on_signal, mainloop);
+
+    /* Print the context statistics on demand */
+    g_unix_signal_add (SIGUSR1, on_signal_statistics, NULL);
 #endif
 
     g_main_loop_run (mainloop);
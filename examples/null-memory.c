@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Memory benchmark of the object model.
+ *
+ * The Null backend is loaded with a synthetic model using the
+ * LIBMATEMIXER_NULL_LOAD variable, once with devices only, once with streams
+ * added to them and once with controls added to the streams. The growth of
+ * the heap between the runs gives the cost of a single device, stream and
+ * control.
+ */
+
+#include <stdlib.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <libmatemixer/matemixer.h>
+
+static gint64
+heap_size (void)
+{
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 info = mallinfo2 ();
+#else
+    struct mallinfo info = mallinfo ();
+#endif
+    return (gint64) info.uordblks + (gint64) info.hblkhd;
+#else
+    return -1;
+#endif
+}
+
+static void
+walk_context (MateMixerContext *context)
+{
+    const GList *streams;
+
+    /* Let the lists be built the same way as in an application which reads
+     * the whole model */
+    mate_mixer_context_list_devices (context);
+
+    streams = mate_mixer_context_list_streams (context);
+    while (streams != NULL) {
+        mate_mixer_stream_list_controls (MATE_MIXER_STREAM (streams->data));
+        mate_mixer_stream_list_switches (MATE_MIXER_STREAM (streams->data));
+        streams = streams->next;
+    }
+}
+
+static gboolean
+measure (guint devices, guint streams, guint controls, guint seed, gint64 *size)
+{
+    MateMixerContext *context;
+    gchar            *load;
+    gint64            before;
+
+    load = g_strdup_printf ("devices=%u,streams=%u,controls=%u,rate=0,seed=%u",
+                            devices,
+                            streams,
+                            controls,
+                            seed);
+
+    g_setenv ("LIBMATEMIXER_NULL_LOAD", load, TRUE);
+    g_free (load);
+
+    before = heap_size ();
+
+    context = mate_mixer_context_new ();
+
+    mate_mixer_context_set_backend_type (context, MATE_MIXER_BACKEND_NULL);
+
+    /* The Null backend is ready as soon as it is opened */
+    if (mate_mixer_context_open (context) == FALSE ||
+        mate_mixer_context_get_state (context) != MATE_MIXER_STATE_READY) {
+        g_object_unref (context);
+        return FALSE;
+    }
+
+    walk_context (context);
+
+    *size = heap_size () - before;
+
+    mate_mixer_context_close (context);
+    g_object_unref (context);
+    return TRUE;
+}
+
+int main (int argc, char *argv[])
+{
+    GOptionContext *ctx;
+    GError         *error    = NULL;
+    gint            devices  = 50;
+    gint            streams  = 4;
+    gint            controls = 2;
+    gint            seed     = 1;
+    gint            target   = 0;
+    gint64          size_empty;
+    gint64          size_devices;
+    gint64          size_streams;
+    gint64          size_controls;
+    gdouble         per_device;
+    gdouble         per_stream;
+    gdouble         per_control;
+    GOptionEntry    entries[] = {
+        { "devices",  'd', 0, G_OPTION_ARG_INT, &devices,  "Number of devices", NULL },
+        { "streams",  's', 0, G_OPTION_ARG_INT, &streams,  "Number of streams of each device", NULL },
+        { "controls", 'c', 0, G_OPTION_ARG_INT, &controls, "Number of controls of each stream", NULL },
+        { "seed",     'r', 0, G_OPTION_ARG_INT, &seed,     "Seed of the random generator", NULL },
+        { "target",   't', 0, G_OPTION_ARG_INT, &target,   "Fail when a control takes more bytes", NULL },
+        { NULL }
+    };
+
+    ctx = g_option_context_new ("- Object model memory benchmark");
+
+    g_option_context_add_main_entries (ctx, entries, NULL);
+
+    if (g_option_context_parse (ctx, &argc, &argv, &error) == FALSE) {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        g_option_context_free (ctx);
+        return 1;
+    }
+
+    g_option_context_free (ctx);
+
+    if (devices < 1 || streams < 1 || controls < 1) {
+        g_printerr ("The numbers of objects must be positive\n");
+        return 1;
+    }
+
+    if (heap_size () < 0) {
+        g_printerr ("Measuring the heap is not supported on this system\n");
+        return 1;
+    }
+
+    if (mate_mixer_init () == FALSE)
+        return 1;
+
+    /* Register the types and fill the caches of GLib before measuring */
+    if (measure (devices, streams, controls, seed, &size_controls) == FALSE)
+        goto failed;
+
+    if (measure (0, 0, 0, seed, &size_empty) == FALSE ||
+        measure (devices, 0, 0, seed, &size_devices) == FALSE ||
+        measure (devices, streams, 0, seed, &size_streams) == FALSE ||
+        measure (devices, streams, controls, seed, &size_controls) == FALSE)
+        goto failed;
+
+    per_device  = (gdouble) (size_devices - size_empty) / devices;
+    per_stream  = (gdouble) (size_streams - size_devices) / (devices * streams);
+    per_control = (gdouble) (size_controls - size_streams) / (devices * streams * controls);
+
+    g_print ("%-10s %10s %14s %12s\n",
+             "object",
+             "count",
+             "heap [bytes]",
+             "per object");
+
+    g_print ("%-10s %10d %14" G_GINT64_FORMAT " %12.1f\n",
+             "device",
+             devices,
+             size_devices - size_empty,
+             per_device);
+    g_print ("%-10s %10d %14" G_GINT64_FORMAT " %12.1f\n",
+             "stream",
+             devices * streams,
+             size_streams - size_devices,
+             per_stream);
+    g_print ("%-10s %10d %14" G_GINT64_FORMAT " %12.1f\n",
+             "control",
+             devices * streams * controls,
+             size_controls - size_streams,
+             per_control);
+
+    g_print ("\nTotal heap of the model: %" G_GINT64_FORMAT " bytes\n",
+             size_controls - size_empty);
+
+    if (target > 0 && per_control > target) {
+        g_printerr ("A control takes %.1f bytes, more than the target of %d bytes\n",
+                    per_control,
+                    target);
+        return 1;
+    }
+    return 0;
+
+failed:
+    g_printerr ("Failed to open the Null backend\n");
+    return 1;
+}
@@ -0,0 +1,103 @@
+#!/bin/sh
+#
+# Runs matemixer-monitor with the PipeWire backend against a private PipeWire
+# server which only has a null sink and a null source, so the PipeWire module
+# can be tried without sound hardware and without touching the session server.
+#
+# Usage: pipewire-null-sink.sh [MONITOR OPTIONS]
+#
+# The MONITOR variable selects the program to run, the default is the
+# matemixer-monitor program next to this script.
+
+set -e
+
+MONITOR=${MONITOR:-$(dirname "$0")/matemixer-monitor}
+
+if ! command -v pipewire >/dev/null 2>&1; then
+    echo "pipewire is not installed" >&2
+    exit 1
+fi
+
+runtime=$(mktemp -d)
+pid=
+
+cleanup() {
+    if [ -n "$pid" ]; then
+        kill "$pid" 2>/dev/null || true
+        wait "$pid" 2>/dev/null || true
+    fi
+    rm -rf "$runtime"
+}
+trap cleanup EXIT INT TERM
+
+cat > "$runtime/pipewire.conf" <<EOF
+context.properties = {
+    core.daemon = true
+    core.name   = pipewire-0
+}
+
+context.spa-libs = {
+    audio.convert.* = audioconvert/libspa-audioconvert
+    support.*       = support/libspa-support
+}
+
+context.modules = [
+    { name = libpipewire-module-protocol-native }
+    { name = libpipewire-module-client-node }
+    { name = libpipewire-module-adapter }
+    { name = libpipewire-module-metadata }
+]
+
+context.objects = [
+    { factory = spa-node-factory
+      args = {
+          factory.name    = support.node.driver
+          node.name       = null-driver
+          priority.driver = 20000
+      }
+    }
+    { factory = adapter
+      args = {
+          factory.name     = support.null-audio-sink
+          node.name        = null-sink
+          node.description = "Null Output"
+          media.class      = Audio/Sink
+          audio.position   = [ FL FR ]
+          monitor.channel-volumes = true
+          object.linger    = true
+      }
+    }
+    { factory = adapter
+      args = {
+          factory.name     = support.null-audio-sink
+          node.name        = null-source
+          node.description = "Null Input"
+          media.class      = Audio/Source/Virtual
+          audio.position   = [ FL FR ]
+          object.linger    = true
+      }
+    }
+]
+EOF
+
+# Both the server and the monitor use the private runtime directory, so the
+# monitor cannot reach the server of the session
+export XDG_RUNTIME_DIR="$runtime"
+export PIPEWIRE_RUNTIME_DIR="$runtime"
+unset PIPEWIRE_REMOTE
+
+pipewire -c "$runtime/pipewire.conf" &
+pid=$!
+
+# Wait for the server socket
+i=0
+while [ ! -S "$runtime/pipewire-0" ]; do
+    i=$((i + 1))
+    if [ $i -gt 50 ] || ! kill -0 "$pid" 2>/dev/null; then
+        echo "PipeWire server failed to start" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+
+"$MONITOR" --backend pipewire "$@"
@@ -0,0 +1,1202 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-aggregate-control.h"
+#include "matemixer-app-info.h"
+#include "matemixer-app-info-private.h"
+#include "matemixer-context.h"
+#include "matemixer-enums.h"
+#include "matemixer-enum-types.h"
+#include "matemixer-stream.h"
+#include "matemixer-stream-control.h"
+#include "matemixer-stream-control-private.h"
+#include "matemixer-transaction.h"
+
+/**
+ * SECTION:matemixer-aggregate-control
+ * @short_description: Combined control of a group of stream controls
+ * @include: libmatemixer/matemixer.h
+ * @see_also: #MateMixerStreamControl, #MateMixerTransaction
+ *
+ * A #MateMixerAggregateControl groups all the stream controls of a single
+ * application or all the stream controls with the same media role and
+ * presents them as a single #MateMixerStreamControl.
+ *
+ * The volume of the aggregate control is the highest volume of its members
+ * and it is muted when all of its members are muted. Changing the volume
+ * scales the volumes of all the members so that their relative levels are
+ * preserved, the changes are committed as a single #MateMixerTransaction.
+ * When the members support decibels, the same number of decibels is added
+ * to each of them.
+ *
+ * The members are tracked as streams and controls are added to and removed
+ * from the #MateMixerContext, the #MateMixerAggregateControl::control-added
+ * and #MateMixerAggregateControl::control-removed signals are emitted when
+ * the group changes. Application controls are only available when the
+ * context is interested in them, see mate_mixer_context_set_interests().
+ */
+
+typedef struct {
+    MateMixerStreamControl *control;
+    MateMixerStream        *stream;
+} AggregateMember;
+
+struct _MateMixerAggregateControlPrivate
+{
+    MateMixerContext                *context;
+    MateMixerAppInfo                *app_info;
+    MateMixerStreamControlMediaRole  media_role;
+    MateMixerDirection               direction;
+    GHashTable                      *streams;
+    GList                           *members;
+    GList                           *controls;
+    guint                            volume;
+    guint                            min_volume;
+    guint                            max_volume;
+    guint                            normal_volume;
+    guint                            base_volume;
+};
+
+enum {
+    PROP_0,
+    PROP_CONTEXT,
+    PROP_APP_INFO,
+    PROP_DIRECTION,
+    N_PROPERTIES
+};
+
+static GParamSpec *properties[N_PROPERTIES] = { NULL, };
+
+enum {
+    CONTROL_ADDED,
+    CONTROL_REMOVED,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS] = { 0, };
+
+static void mate_mixer_aggregate_control_get_property (GObject                     *object,
+                                                       guint                        param_id,
+                                                       GValue                      *value,
+                                                       GParamSpec                  *pspec);
+static void mate_mixer_aggregate_control_set_property (GObject                     *object,
+                                                       guint                        param_id,
+                                                       const GValue                *value,
+                                                       GParamSpec                  *pspec);
+
+static void mate_mixer_aggregate_control_constructed  (GObject                     *object);
+static void mate_mixer_aggregate_control_dispose      (GObject                     *object);
+static void mate_mixer_aggregate_control_finalize     (GObject                     *object);
+
+G_DEFINE_TYPE_WITH_PRIVATE (MateMixerAggregateControl, mate_mixer_aggregate_control, MATE_MIXER_TYPE_STREAM_CONTROL)
+
+static MateMixerAppInfo *       mate_mixer_aggregate_control_get_app_info         (MateMixerStreamControl   *mmsc);
+
+static gboolean                 mate_mixer_aggregate_control_set_mute             (MateMixerStreamControl   *mmsc,
+                                                                                   gboolean                  mute);
+
+static guint                    mate_mixer_aggregate_control_get_num_channels     (MateMixerStreamControl   *mmsc);
+
+static guint                    mate_mixer_aggregate_control_get_volume           (MateMixerStreamControl   *mmsc);
+static gboolean                 mate_mixer_aggregate_control_set_volume           (MateMixerStreamControl   *mmsc,
+                                                                                   guint                     volume);
+
+static gboolean                 mate_mixer_aggregate_control_has_channel_position (MateMixerStreamControl   *mmsc,
+                                                                                   MateMixerChannelPosition  position);
+static MateMixerChannelPosition mate_mixer_aggregate_control_get_channel_position (MateMixerStreamControl   *mmsc,
+                                                                                   guint                     channel);
+
+static guint                    mate_mixer_aggregate_control_get_channel_volume   (MateMixerStreamControl   *mmsc,
+                                                                                   guint                     channel);
+static gboolean                 mate_mixer_aggregate_control_set_channel_volume   (MateMixerStreamControl   *mmsc,
+                                                                                   guint                     channel,
+                                                                                   guint                     volume);
+
+static guint                    mate_mixer_aggregate_control_get_min_volume       (MateMixerStreamControl   *mmsc);
+static guint                    mate_mixer_aggregate_control_get_max_volume       (MateMixerStreamControl   *mmsc);
+static guint                    mate_mixer_aggregate_control_get_normal_volume    (MateMixerStreamControl   *mmsc);
+static guint                    mate_mixer_aggregate_control_get_base_volume      (MateMixerStreamControl   *mmsc);
+
+static void                     on_context_state_notify   (MateMixerContext          *context,
+                                                           GParamSpec                *pspec,
+                                                           MateMixerAggregateControl *aggregate);
+
+static void                     on_context_stream_added   (MateMixerContext          *context,
+                                                           const gchar               *name,
+                                                           MateMixerAggregateControl *aggregate);
+static void                     on_context_stream_removed (MateMixerContext          *context,
+                                                           const gchar               *name,
+                                                           MateMixerAggregateControl *aggregate);
+
+static void                     on_stream_control_added   (MateMixerStream           *stream,
+                                                           const gchar               *name,
+                                                           MateMixerAggregateControl *aggregate);
+static void                     on_stream_control_removed (MateMixerStream           *stream,
+                                                           const gchar               *name,
+                                                           MateMixerAggregateControl *aggregate);
+
+static void                     on_member_notify          (MateMixerStreamControl    *control,
+                                                           GParamSpec                *pspec,
+                                                           MateMixerAggregateControl *aggregate);
+
+static void                     add_all_streams           (MateMixerAggregateControl *aggregate);
+static void                     remove_all_streams        (MateMixerAggregateControl *aggregate);
+
+static void                     add_stream                (MateMixerAggregateControl *aggregate,
+                                                           MateMixerStream           *stream);
+static void                     remove_stream             (MateMixerAggregateControl *aggregate,
+                                                           MateMixerStream           *stream);
+
+static void                     add_member                (MateMixerAggregateControl *aggregate,
+                                                           MateMixerStream           *stream,
+                                                           MateMixerStreamControl    *control);
+static void                     remove_member             (MateMixerAggregateControl *aggregate,
+                                                           AggregateMember           *member);
+
+static AggregateMember *        find_member               (MateMixerAggregateControl *aggregate,
+                                                           MateMixerStreamControl    *control);
+
+static gboolean                 match_control             (MateMixerAggregateControl *aggregate,
+                                                           MateMixerStreamControl    *control);
+
+static void                     update_state              (MateMixerAggregateControl *aggregate);
+
+static gboolean                 writable_volume           (AggregateMember           *member);
+
+static gboolean                 get_decibel_delta         (MateMixerAggregateControl *aggregate,
+                                                           guint                      current,
+                                                           guint                      volume,
+                                                           gdouble                   *delta);
+static gdouble                  get_volume_ratio          (MateMixerAggregateControl *aggregate,
+                                                           guint                      current,
+                                                           guint                      volume);
+
+static gboolean                 write_volume              (MateMixerAggregateControl *aggregate,
+                                                           guint                      volume);
+
+static void
+mate_mixer_aggregate_control_class_init (MateMixerAggregateControlClass *klass)
+{
+    GObjectClass                *object_class;
+    MateMixerStreamControlClass *control_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+    object_class->constructed  = mate_mixer_aggregate_control_constructed;
+    object_class->dispose      = mate_mixer_aggregate_control_dispose;
+    object_class->finalize     = mate_mixer_aggregate_control_finalize;
+    object_class->get_property = mate_mixer_aggregate_control_get_property;
+    object_class->set_property = mate_mixer_aggregate_control_set_property;
+
+    control_class = MATE_MIXER_STREAM_CONTROL_CLASS (klass);
+    control_class->get_app_info         = mate_mixer_aggregate_control_get_app_info;
+    control_class->set_mute             = mate_mixer_aggregate_control_set_mute;
+    control_class->get_num_channels     = mate_mixer_aggregate_control_get_num_channels;
+    control_class->get_volume           = mate_mixer_aggregate_control_get_volume;
+    control_class->set_volume           = mate_mixer_aggregate_control_set_volume;
+    control_class->has_channel_position = mate_mixer_aggregate_control_has_channel_position;
+    control_class->get_channel_position = mate_mixer_aggregate_control_get_channel_position;
+    control_class->get_channel_volume   = mate_mixer_aggregate_control_get_channel_volume;
+    control_class->set_channel_volume   = mate_mixer_aggregate_control_set_channel_volume;
+    control_class->get_min_volume       = mate_mixer_aggregate_control_get_min_volume;
+    control_class->get_max_volume       = mate_mixer_aggregate_control_get_max_volume;
+    control_class->get_normal_volume    = mate_mixer_aggregate_control_get_normal_volume;
+    control_class->get_base_volume      = mate_mixer_aggregate_control_get_base_volume;
+
+    properties[PROP_CONTEXT] =
+        g_param_spec_object ("context",
+                             "Context",
+                             "Context which provides the grouped controls",
+                             MATE_MIXER_TYPE_CONTEXT,
+                             G_PARAM_READWRITE |
+                             G_PARAM_CONSTRUCT_ONLY |
+                             G_PARAM_STATIC_STRINGS);
+
+    properties[PROP_APP_INFO] =
+        g_param_spec_boxed ("app-info",
+                            "App info",
+                            "Application whose controls are grouped",
+                            MATE_MIXER_TYPE_APP_INFO,
+                            G_PARAM_READWRITE |
+                            G_PARAM_CONSTRUCT_ONLY |
+                            G_PARAM_STATIC_STRINGS);
+
+    properties[PROP_DIRECTION] =
+        g_param_spec_enum ("direction",
+                           "Direction",
+                           "Direction of the streams of the grouped controls",
+                           MATE_MIXER_TYPE_DIRECTION,
+                           MATE_MIXER_DIRECTION_UNKNOWN,
+                           G_PARAM_READWRITE |
+                           G_PARAM_CONSTRUCT_ONLY |
+                           G_PARAM_STATIC_STRINGS);
+
+    g_object_class_install_properties (object_class, N_PROPERTIES, properties);
+
+    /**
+     * MateMixerAggregateControl::control-added:
+     * @aggregate: a #MateMixerAggregateControl
+     * @control: the #MateMixerStreamControl which joined the group
+     *
+     * The signal is emitted each time a stream control joins the group.
+     */
+    signals[CONTROL_ADDED] =
+        g_signal_new ("control-added",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerAggregateControlClass, control_added),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__OBJECT,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_STREAM_CONTROL);
+
+    /**
+     * MateMixerAggregateControl::control-removed:
+     * @aggregate: a #MateMixerAggregateControl
+     * @control: the #MateMixerStreamControl which left the group
+     *
+     * The signal is emitted each time a stream control leaves the group.
+     */
+    signals[CONTROL_REMOVED] =
+        g_signal_new ("control-removed",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerAggregateControlClass, control_removed),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__OBJECT,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_STREAM_CONTROL);
+}
+
+static void
+mate_mixer_aggregate_control_get_property (GObject    *object,
+                                           guint       param_id,
+                                           GValue     *value,
+                                           GParamSpec *pspec)
+{
+    MateMixerAggregateControl *aggregate;
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (object);
+
+    switch (param_id) {
+    case PROP_CONTEXT:
+        g_value_set_object (value, aggregate->priv->context);
+        break;
+    case PROP_APP_INFO:
+        g_value_set_boxed (value, aggregate->priv->app_info);
+        break;
+    case PROP_DIRECTION:
+        g_value_set_enum (value, aggregate->priv->direction);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, param_id, pspec);
+        break;
+    }
+}
+
+static void
+mate_mixer_aggregate_control_set_property (GObject      *object,
+                                           guint         param_id,
+                                           const GValue *value,
+                                           GParamSpec   *pspec)
+{
+    MateMixerAggregateControl *aggregate;
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (object);
+
+    switch (param_id) {
+    case PROP_CONTEXT:
+        /* Construct-only object */
+        aggregate->priv->context = g_value_dup_object (value);
+        break;
+    case PROP_APP_INFO:
+        /* Construct-only boxed */
+        if (g_value_get_boxed (value) != NULL)
+            aggregate->priv->app_info = _mate_mixer_app_info_ref (g_value_get_boxed (value));
+        break;
+    case PROP_DIRECTION:
+        aggregate->priv->direction = g_value_get_enum (value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, param_id, pspec);
+        break;
+    }
+}
+
+static void
+mate_mixer_aggregate_control_init (MateMixerAggregateControl *aggregate)
+{
+    aggregate->priv = mate_mixer_aggregate_control_get_instance_private (aggregate);
+
+    aggregate->priv->streams = g_hash_table_new_full (g_str_hash,
+                                                      g_str_equal,
+                                                      g_free,
+                                                      g_object_unref);
+}
+
+static void
+mate_mixer_aggregate_control_constructed (GObject *object)
+{
+    MateMixerAggregateControl *aggregate;
+
+    G_OBJECT_CLASS (mate_mixer_aggregate_control_parent_class)->constructed (object);
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (object);
+
+    aggregate->priv->media_role =
+        mate_mixer_stream_control_get_media_role (MATE_MIXER_STREAM_CONTROL (aggregate));
+
+    if (G_UNLIKELY (aggregate->priv->context == NULL))
+        return;
+
+    g_signal_connect (G_OBJECT (aggregate->priv->context),
+                      "notify::state",
+                      G_CALLBACK (on_context_state_notify),
+                      aggregate);
+    g_signal_connect (G_OBJECT (aggregate->priv->context),
+                      "stream-added",
+                      G_CALLBACK (on_context_stream_added),
+                      aggregate);
+    g_signal_connect (G_OBJECT (aggregate->priv->context),
+                      "stream-removed",
+                      G_CALLBACK (on_context_stream_removed),
+                      aggregate);
+
+    if (mate_mixer_context_get_state (aggregate->priv->context) == MATE_MIXER_STATE_READY)
+        add_all_streams (aggregate);
+}
+
+static void
+mate_mixer_aggregate_control_dispose (GObject *object)
+{
+    MateMixerAggregateControl *aggregate;
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (object);
+
+    if (aggregate->priv->context != NULL) {
+        g_signal_handlers_disconnect_by_data (G_OBJECT (aggregate->priv->context),
+                                              aggregate);
+
+        remove_all_streams (aggregate);
+        g_clear_object (&aggregate->priv->context);
+    }
+
+    G_OBJECT_CLASS (mate_mixer_aggregate_control_parent_class)->dispose (object);
+}
+
+static void
+mate_mixer_aggregate_control_finalize (GObject *object)
+{
+    MateMixerAggregateControl *aggregate;
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (object);
+
+    if (aggregate->priv->app_info != NULL)
+        _mate_mixer_app_info_unref (aggregate->priv->app_info);
+
+    g_hash_table_unref (aggregate->priv->streams);
+
+    G_OBJECT_CLASS (mate_mixer_aggregate_control_parent_class)->finalize (object);
+}
+
+/**
+ * mate_mixer_aggregate_control_new_for_app:
+ * @context: a #MateMixerContext
+ * @info: a #MateMixerAppInfo
+ * @direction: a #MateMixerDirection
+ *
+ * Creates a control grouping the application stream controls of the
+ * application described by @info. Controls are matched by the application
+ * ID, or by the application name if @info does not include an ID.
+ *
+ * Use %MATE_MIXER_DIRECTION_OUTPUT or %MATE_MIXER_DIRECTION_INPUT to only
+ * group the playback or recording controls of the application, or
+ * %MATE_MIXER_DIRECTION_UNKNOWN to group all of them.
+ *
+ * Returns: a new #MateMixerAggregateControl. Use g_object_unref() when you
+ * are done with it.
+ */
+MateMixerAggregateControl *
+mate_mixer_aggregate_control_new_for_app (MateMixerContext   *context,
+                                          MateMixerAppInfo   *info,
+                                          MateMixerDirection  direction)
+{
+    MateMixerAggregateControl *aggregate;
+    const gchar               *key;
+    gchar                     *name;
+
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+    g_return_val_if_fail (info != NULL, NULL);
+
+    key = mate_mixer_app_info_get_id (info);
+    if (key == NULL)
+        key = mate_mixer_app_info_get_name (info);
+
+    g_return_val_if_fail (key != NULL, NULL);
+
+    name = g_strdup_printf ("aggregate-app-%s", key);
+
+    aggregate = g_object_new (MATE_MIXER_TYPE_AGGREGATE_CONTROL,
+                              "name", name,
+                              "label", mate_mixer_app_info_get_name (info),
+                              "role", MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION,
+                              "context", context,
+                              "app-info", info,
+                              "direction", direction,
+                              NULL);
+    g_free (name);
+    return aggregate;
+}
+
+/**
+ * mate_mixer_aggregate_control_new_for_media_role:
+ * @context: a #MateMixerContext
+ * @media_role: a #MateMixerStreamControlMediaRole
+ * @direction: a #MateMixerDirection
+ *
+ * Creates a control grouping the stream controls with the given media role.
+ * See mate_mixer_aggregate_control_new_for_app() for the description of
+ * @direction.
+ *
+ * Returns: a new #MateMixerAggregateControl. Use g_object_unref() when you
+ * are done with it.
+ */
+MateMixerAggregateControl *
+mate_mixer_aggregate_control_new_for_media_role (MateMixerContext                *context,
+                                                 MateMixerStreamControlMediaRole  media_role,
+                                                 MateMixerDirection               direction)
+{
+    MateMixerAggregateControl *aggregate;
+    GEnumClass                *klass;
+    GEnumValue                *value;
+    gchar                     *name;
+
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+    g_return_val_if_fail (media_role != MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN, NULL);
+
+    klass = g_type_class_ref (MATE_MIXER_TYPE_STREAM_CONTROL_MEDIA_ROLE);
+    value = g_enum_get_value (klass, media_role);
+    if (G_UNLIKELY (value == NULL)) {
+        g_type_class_unref (klass);
+        g_return_val_if_reached (NULL);
+    }
+
+    name = g_strdup_printf ("aggregate-role-%s", value->value_nick);
+
+    aggregate = g_object_new (MATE_MIXER_TYPE_AGGREGATE_CONTROL,
+                              "name", name,
+                              "label", value->value_nick,
+                              "media-role", media_role,
+                              "context", context,
+                              "direction", direction,
+                              NULL);
+    g_free (name);
+    g_type_class_unref (klass);
+    return aggregate;
+}
+
+/**
+ * mate_mixer_aggregate_control_get_direction:
+ * @aggregate: a #MateMixerAggregateControl
+ *
+ * Gets the direction of the streams whose controls are grouped.
+ *
+ * Returns: a #MateMixerDirection, %MATE_MIXER_DIRECTION_UNKNOWN if the
+ * controls of all the streams are grouped.
+ */
+MateMixerDirection
+mate_mixer_aggregate_control_get_direction (MateMixerAggregateControl *aggregate)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_AGGREGATE_CONTROL (aggregate), MATE_MIXER_DIRECTION_UNKNOWN);
+
+    return aggregate->priv->direction;
+}
+
+/**
+ * mate_mixer_aggregate_control_get_num_controls:
+ * @aggregate: a #MateMixerAggregateControl
+ *
+ * Gets the number of stream controls in the group.
+ *
+ * Returns: the number of grouped controls.
+ */
+guint
+mate_mixer_aggregate_control_get_num_controls (MateMixerAggregateControl *aggregate)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_AGGREGATE_CONTROL (aggregate), 0);
+
+    return g_list_length (aggregate->priv->members);
+}
+
+/**
+ * mate_mixer_aggregate_control_list_controls:
+ * @aggregate: a #MateMixerAggregateControl
+ *
+ * Gets the stream controls in the group.
+ *
+ * The returned #GList is owned by the #MateMixerAggregateControl and may be
+ * invalidated at any time.
+ *
+ * Returns: (transfer none) (element-type MateMixerStreamControl): a #GList of
+ * the grouped controls.
+ */
+const GList *
+mate_mixer_aggregate_control_list_controls (MateMixerAggregateControl *aggregate)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_AGGREGATE_CONTROL (aggregate), NULL);
+
+    if (aggregate->priv->controls == NULL) {
+        GList *list;
+
+        for (list = aggregate->priv->members; list != NULL; list = list->next) {
+            AggregateMember *member = list->data;
+
+            aggregate->priv->controls = g_list_prepend (aggregate->priv->controls,
+                                                        member->control);
+        }
+        aggregate->priv->controls = g_list_reverse (aggregate->priv->controls);
+    }
+    return aggregate->priv->controls;
+}
+
+static MateMixerAppInfo *
+mate_mixer_aggregate_control_get_app_info (MateMixerStreamControl *mmsc)
+{
+    return MATE_MIXER_AGGREGATE_CONTROL (mmsc)->priv->app_info;
+}
+
+static gboolean
+mate_mixer_aggregate_control_set_mute (MateMixerStreamControl *mmsc, gboolean mute)
+{
+    MateMixerAggregateControl *aggregate;
+    MateMixerTransaction      *transaction;
+    GList                     *list;
+    gboolean                   ret;
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (mmsc);
+
+    transaction = mate_mixer_context_begin_transaction (aggregate->priv->context);
+    if (transaction == NULL)
+        return FALSE;
+
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+
+        if (mate_mixer_stream_control_get_flags (member->control) & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE)
+            mate_mixer_transaction_set_mute (transaction, member->control, mute);
+    }
+
+    ret = mate_mixer_context_commit_transaction (aggregate->priv->context, transaction);
+
+    mate_mixer_transaction_unref (transaction);
+    return ret;
+}
+
+static guint
+mate_mixer_aggregate_control_get_num_channels (MateMixerStreamControl *mmsc)
+{
+    /* The group is presented as a single mono channel */
+    return 1;
+}
+
+static guint
+mate_mixer_aggregate_control_get_volume (MateMixerStreamControl *mmsc)
+{
+    return MATE_MIXER_AGGREGATE_CONTROL (mmsc)->priv->volume;
+}
+
+static gboolean
+mate_mixer_aggregate_control_set_volume (MateMixerStreamControl *mmsc, guint volume)
+{
+    return write_volume (MATE_MIXER_AGGREGATE_CONTROL (mmsc), volume);
+}
+
+static gboolean
+mate_mixer_aggregate_control_has_channel_position (MateMixerStreamControl  *mmsc,
+                                                   MateMixerChannelPosition position)
+{
+    return position == MATE_MIXER_CHANNEL_MONO;
+}
+
+static MateMixerChannelPosition
+mate_mixer_aggregate_control_get_channel_position (MateMixerStreamControl *mmsc, guint channel)
+{
+    if (channel > 0)
+        return MATE_MIXER_CHANNEL_UNKNOWN;
+
+    return MATE_MIXER_CHANNEL_MONO;
+}
+
+static guint
+mate_mixer_aggregate_control_get_channel_volume (MateMixerStreamControl *mmsc, guint channel)
+{
+    MateMixerAggregateControl *aggregate;
+
+    aggregate = MATE_MIXER_AGGREGATE_CONTROL (mmsc);
+
+    if (channel > 0)
+        return aggregate->priv->min_volume;
+
+    return aggregate->priv->volume;
+}
+
+static gboolean
+mate_mixer_aggregate_control_set_channel_volume (MateMixerStreamControl *mmsc,
+                                                 guint                   channel,
+                                                 guint                   volume)
+{
+    if (channel > 0)
+        return FALSE;
+
+    return write_volume (MATE_MIXER_AGGREGATE_CONTROL (mmsc), volume);
+}
+
+static guint
+mate_mixer_aggregate_control_get_min_volume (MateMixerStreamControl *mmsc)
+{
+    return MATE_MIXER_AGGREGATE_CONTROL (mmsc)->priv->min_volume;
+}
+
+static guint
+mate_mixer_aggregate_control_get_max_volume (MateMixerStreamControl *mmsc)
+{
+    return MATE_MIXER_AGGREGATE_CONTROL (mmsc)->priv->max_volume;
+}
+
+static guint
+mate_mixer_aggregate_control_get_normal_volume (MateMixerStreamControl *mmsc)
+{
+    return MATE_MIXER_AGGREGATE_CONTROL (mmsc)->priv->normal_volume;
+}
+
+static guint
+mate_mixer_aggregate_control_get_base_volume (MateMixerStreamControl *mmsc)
+{
+    return MATE_MIXER_AGGREGATE_CONTROL (mmsc)->priv->base_volume;
+}
+
+static void
+on_context_state_notify (MateMixerContext          *context,
+                         GParamSpec                *pspec,
+                         MateMixerAggregateControl *aggregate)
+{
+    /* The lists of the context are only available in the READY state, all
+     * the streams are dropped together when the state changes */
+    if (mate_mixer_context_get_state (context) == MATE_MIXER_STATE_READY)
+        add_all_streams (aggregate);
+    else
+        remove_all_streams (aggregate);
+}
+
+static void
+on_context_stream_added (MateMixerContext          *context,
+                         const gchar               *name,
+                         MateMixerAggregateControl *aggregate)
+{
+    MateMixerStream *stream;
+
+    stream = mate_mixer_context_get_stream (context, name);
+    if (G_UNLIKELY (stream == NULL))
+        return;
+
+    add_stream (aggregate, stream);
+}
+
+static void
+on_context_stream_removed (MateMixerContext          *context,
+                           const gchar               *name,
+                           MateMixerAggregateControl *aggregate)
+{
+    MateMixerStream *stream;
+
+    /* The stream is already gone from the context, use the stored one */
+    stream = g_hash_table_lookup (aggregate->priv->streams, name);
+    if (stream == NULL)
+        return;
+
+    remove_stream (aggregate, stream);
+}
+
+static void
+on_stream_control_added (MateMixerStream           *stream,
+                         const gchar               *name,
+                         MateMixerAggregateControl *aggregate)
+{
+    MateMixerStreamControl *control;
+
+    control = mate_mixer_stream_get_control (stream, name);
+    if (G_UNLIKELY (control == NULL))
+        return;
+
+    add_member (aggregate, stream, control);
+}
+
+static void
+on_stream_control_removed (MateMixerStream           *stream,
+                           const gchar               *name,
+                           MateMixerAggregateControl *aggregate)
+{
+    GList *list;
+
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+
+        /* A control moved to a different stream may be reported as added to
+         * the new stream before it is reported as removed from the old one */
+        if (member->stream == stream &&
+            strcmp (mate_mixer_stream_control_get_name (member->control), name) == 0) {
+            remove_member (aggregate, member);
+            break;
+        }
+    }
+}
+
+static void
+on_member_notify (MateMixerStreamControl    *control,
+                  GParamSpec                *pspec,
+                  MateMixerAggregateControl *aggregate)
+{
+    update_state (aggregate);
+}
+
+static void
+add_all_streams (MateMixerAggregateControl *aggregate)
+{
+    const GList *list;
+
+    list = mate_mixer_context_list_streams (aggregate->priv->context);
+    while (list != NULL) {
+        add_stream (aggregate, MATE_MIXER_STREAM (list->data));
+        list = list->next;
+    }
+}
+
+static void
+remove_all_streams (MateMixerAggregateControl *aggregate)
+{
+    GHashTableIter   iter;
+    MateMixerStream *stream;
+
+    g_hash_table_iter_init (&iter, aggregate->priv->streams);
+
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &stream) == TRUE) {
+        GList *list = aggregate->priv->members;
+
+        g_signal_handlers_disconnect_by_data (G_OBJECT (stream), aggregate);
+
+        while (list != NULL) {
+            AggregateMember *member = list->data;
+
+            list = list->next;
+            if (member->stream == stream)
+                remove_member (aggregate, member);
+        }
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+static void
+add_stream (MateMixerAggregateControl *aggregate, MateMixerStream *stream)
+{
+    const GList *list;
+    const gchar *name;
+
+    if (aggregate->priv->direction != MATE_MIXER_DIRECTION_UNKNOWN &&
+        aggregate->priv->direction != mate_mixer_stream_get_direction (stream))
+        return;
+
+    name = mate_mixer_stream_get_name (stream);
+    if (g_hash_table_contains (aggregate->priv->streams, name) == TRUE)
+        return;
+
+    g_hash_table_insert (aggregate->priv->streams,
+                         g_strdup (name),
+                         g_object_ref (stream));
+
+    g_signal_connect (G_OBJECT (stream),
+                      "control-added",
+                      G_CALLBACK (on_stream_control_added),
+                      aggregate);
+    g_signal_connect (G_OBJECT (stream),
+                      "control-removed",
+                      G_CALLBACK (on_stream_control_removed),
+                      aggregate);
+
+    list = mate_mixer_stream_list_controls (stream);
+    while (list != NULL) {
+        add_member (aggregate, stream, MATE_MIXER_STREAM_CONTROL (list->data));
+        list = list->next;
+    }
+}
+
+static void
+remove_stream (MateMixerAggregateControl *aggregate, MateMixerStream *stream)
+{
+    GList *list = aggregate->priv->members;
+
+    g_signal_handlers_disconnect_by_data (G_OBJECT (stream), aggregate);
+
+    while (list != NULL) {
+        AggregateMember *member = list->data;
+
+        list = list->next;
+        if (member->stream == stream)
+            remove_member (aggregate, member);
+    }
+
+    /* This releases the reference to the stream */
+    g_hash_table_remove (aggregate->priv->streams, mate_mixer_stream_get_name (stream));
+}
+
+static void
+add_member (MateMixerAggregateControl *aggregate,
+            MateMixerStream           *stream,
+            MateMixerStreamControl    *control)
+{
+    AggregateMember *member;
+
+    if (match_control (aggregate, control) == FALSE)
+        return;
+
+    member = find_member (aggregate, control);
+    if (member != NULL) {
+        /* The control has been moved to another stream */
+        member->stream = stream;
+        return;
+    }
+
+    member = g_slice_new (AggregateMember);
+    member->control = g_object_ref (control);
+    member->stream  = stream;
+
+    aggregate->priv->members = g_list_append (aggregate->priv->members, member);
+
+    g_clear_pointer (&aggregate->priv->controls, g_list_free);
+
+    g_signal_connect (G_OBJECT (control),
+                      "notify::flags",
+                      G_CALLBACK (on_member_notify),
+                      aggregate);
+    g_signal_connect (G_OBJECT (control),
+                      "notify::mute",
+                      G_CALLBACK (on_member_notify),
+                      aggregate);
+    g_signal_connect (G_OBJECT (control),
+                      "notify::volume",
+                      G_CALLBACK (on_member_notify),
+                      aggregate);
+
+    update_state (aggregate);
+
+    g_signal_emit (G_OBJECT (aggregate),
+                   signals[CONTROL_ADDED],
+                   0,
+                   control);
+}
+
+static void
+remove_member (MateMixerAggregateControl *aggregate, AggregateMember *member)
+{
+    MateMixerStreamControl *control = member->control;
+
+    g_signal_handlers_disconnect_by_data (G_OBJECT (control), aggregate);
+
+    aggregate->priv->members = g_list_remove (aggregate->priv->members, member);
+
+    g_clear_pointer (&aggregate->priv->controls, g_list_free);
+    g_slice_free (AggregateMember, member);
+
+    update_state (aggregate);
+
+    g_signal_emit (G_OBJECT (aggregate),
+                   signals[CONTROL_REMOVED],
+                   0,
+                   control);
+
+    g_object_unref (control);
+}
+
+static AggregateMember *
+find_member (MateMixerAggregateControl *aggregate, MateMixerStreamControl *control)
+{
+    GList *list;
+
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+
+        if (member->control == control)
+            return member;
+    }
+    return NULL;
+}
+
+static gboolean
+match_control (MateMixerAggregateControl *aggregate, MateMixerStreamControl *control)
+{
+    MateMixerAppInfo *info;
+    const gchar      *a;
+    const gchar      *b;
+
+    if (aggregate->priv->app_info == NULL)
+        return mate_mixer_stream_control_get_media_role (control) == aggregate->priv->media_role;
+
+    info = mate_mixer_stream_control_get_app_info (control);
+    if (info == NULL)
+        return FALSE;
+
+    /* Interned app info is shared by the controls of the same application */
+    if (info == aggregate->priv->app_info)
+        return TRUE;
+
+    a = mate_mixer_app_info_get_id (aggregate->priv->app_info);
+    if (a != NULL) {
+        b = mate_mixer_app_info_get_id (info);
+    } else {
+        a = mate_mixer_app_info_get_name (aggregate->priv->app_info);
+        b = mate_mixer_app_info_get_name (info);
+    }
+    return b != NULL && strcmp (a, b) == 0;
+}
+
+static void
+update_state (MateMixerAggregateControl *aggregate)
+{
+    MateMixerStreamControl      *mmsc;
+    MateMixerStreamControlFlags  flags = MATE_MIXER_STREAM_CONTROL_NO_FLAGS;
+    GList                       *list;
+    gboolean                     mute = FALSE;
+    guint                        volume = 0;
+    guint                        n_muted = 0;
+    guint                        n_mute = 0;
+
+    mmsc = MATE_MIXER_STREAM_CONTROL (aggregate);
+
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember             *member = list->data;
+        MateMixerStreamControlFlags  member_flags;
+
+        member_flags = mate_mixer_stream_control_get_flags (member->control);
+
+        /* Each capability is available when any of the members has it */
+        flags |= member_flags & (MATE_MIXER_STREAM_CONTROL_MUTE_READABLE |
+                                 MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE |
+                                 MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
+                                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE);
+
+        if (member_flags & MATE_MIXER_STREAM_CONTROL_MUTE_READABLE) {
+            n_mute++;
+            if (mate_mixer_stream_control_get_mute (member->control) == TRUE)
+                n_muted++;
+        }
+        if (member_flags & MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE) {
+            /* All the members share the volume scale of the backend */
+            if (aggregate->priv->max_volume == 0) {
+                aggregate->priv->min_volume    = mate_mixer_stream_control_get_min_volume (member->control);
+                aggregate->priv->max_volume    = mate_mixer_stream_control_get_max_volume (member->control);
+                aggregate->priv->normal_volume = mate_mixer_stream_control_get_normal_volume (member->control);
+                aggregate->priv->base_volume   = mate_mixer_stream_control_get_base_volume (member->control);
+            }
+            volume = MAX (volume, mate_mixer_stream_control_get_volume (member->control));
+        }
+    }
+
+    if (n_mute > 0 && n_muted == n_mute)
+        mute = TRUE;
+
+    volume = MAX (volume, aggregate->priv->min_volume);
+
+    /* The notifications are only emitted for actual changes, so a batch of
+     * writes scaling all the members produces a single volume notification */
+    _mate_mixer_stream_control_set_flags (mmsc, flags);
+    _mate_mixer_stream_control_set_mute (mmsc, mute);
+
+    if (aggregate->priv->volume != volume) {
+        aggregate->priv->volume = volume;
+
+        _mate_mixer_stream_control_publish_state (mmsc);
+
+        g_object_notify (G_OBJECT (aggregate), "volume");
+    }
+}
+
+static gboolean
+writable_volume (AggregateMember *member)
+{
+    return (mate_mixer_stream_control_get_flags (member->control) &
+            MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE) != 0;
+}
+
+/* Computes the number of decibels to add to each member, this is only possible
+ * when all the members can convert their volumes to decibels */
+static gboolean
+get_decibel_delta (MateMixerAggregateControl *aggregate,
+                   guint                      current,
+                   guint                      volume,
+                   gdouble                   *delta)
+{
+    MateMixerStreamControl *loudest = NULL;
+    GList                  *list;
+    gdouble                 from;
+    gdouble                 to;
+
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+        gdouble          value;
+        guint            member_volume;
+
+        if (writable_volume (member) == FALSE)
+            continue;
+
+        member_volume = mate_mixer_stream_control_get_volume (member->control);
+
+        /* Fall back to scaling the volumes if any member lacks decibels */
+        if (_mate_mixer_stream_control_get_decibel_from_volume (member->control,
+                                                                member_volume,
+                                                                &value) == FALSE)
+            return FALSE;
+
+        if (loudest == NULL && member_volume == current)
+            loudest = member->control;
+    }
+
+    /* The volume of the aggregate control is on the scale of its loudest member */
+    if (loudest == NULL)
+        return FALSE;
+
+    if (_mate_mixer_stream_control_get_decibel_from_volume (loudest, current, &from) == FALSE ||
+        _mate_mixer_stream_control_get_decibel_from_volume (loudest, volume, &to) == FALSE)
+        return FALSE;
+
+    *delta = to - from;
+
+    /* Raise the members only as far as the quietest headroom allows, clamping
+     * each member separately would change the differences between them */
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+        gdouble          value;
+        gdouble          max;
+
+        if (writable_volume (member) == FALSE)
+            continue;
+
+        value = mate_mixer_stream_control_get_decibel (member->control);
+        if (value <= -MATE_MIXER_INFINITY)
+            continue;
+
+        if (_mate_mixer_stream_control_get_decibel_from_volume (member->control,
+                                                                mate_mixer_stream_control_get_max_volume (member->control),
+                                                                &max) == TRUE)
+            *delta = MIN (*delta, max - value);
+    }
+    return TRUE;
+}
+
+/* Computes the factor to multiply the volume of each member by, the volume
+ * scales of the sound systems without decibel support are expected to follow
+ * a power law, on which the same factor keeps the ratios of the amplitudes */
+static gdouble
+get_volume_ratio (MateMixerAggregateControl *aggregate,
+                  guint                      current,
+                  guint                      volume)
+{
+    GList   *list;
+    gdouble  ratio;
+
+    ratio = (gdouble) volume / (gdouble) current;
+
+    /* Raise the members only as far as the quietest headroom allows, clamping
+     * each member separately would change the ratios between them */
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+        guint            value;
+
+        if (writable_volume (member) == FALSE)
+            continue;
+
+        value = mate_mixer_stream_control_get_volume (member->control);
+        if (value > 0)
+            ratio = MIN (ratio, (gdouble) mate_mixer_stream_control_get_max_volume (member->control) / value);
+    }
+    return ratio;
+}
+
+static gboolean
+write_volume (MateMixerAggregateControl *aggregate, guint volume)
+{
+    MateMixerTransaction *transaction;
+    GList                *list;
+    guint                 current;
+    gboolean              decibel = FALSE;
+    gdouble               delta   = 0.0;
+    gdouble               ratio   = 1.0;
+    gboolean              ret;
+
+    current = aggregate->priv->volume;
+    volume  = CLAMP (volume, aggregate->priv->min_volume, aggregate->priv->max_volume);
+
+    /* Silent groups are set uniformly */
+    if (current > aggregate->priv->min_volume) {
+        decibel = get_decibel_delta (aggregate, current, volume, &delta);
+        if (decibel == FALSE)
+            ratio = get_volume_ratio (aggregate, current, volume);
+    }
+
+    transaction = mate_mixer_context_begin_transaction (aggregate->priv->context);
+    if (transaction == NULL)
+        return FALSE;
+
+    for (list = aggregate->priv->members; list != NULL; list = list->next) {
+        AggregateMember *member = list->data;
+        guint            member_volume;
+
+        if (writable_volume (member) == FALSE)
+            continue;
+
+        if (current <= aggregate->priv->min_volume) {
+            member_volume = volume;
+        } else if (decibel == TRUE) {
+            gdouble value = mate_mixer_stream_control_get_decibel (member->control);
+
+            /* Silent members stay silent, the same as when scaling the volume */
+            if (value <= -MATE_MIXER_INFINITY)
+                continue;
+
+            if (delta <= -MATE_MIXER_INFINITY)
+                member_volume = mate_mixer_stream_control_get_min_volume (member->control);
+            else if (_mate_mixer_stream_control_get_volume_from_decibel (member->control,
+                                                                         value + delta,
+                                                                         &member_volume) == FALSE)
+                continue;
+        } else {
+            member_volume = (guint) (mate_mixer_stream_control_get_volume (member->control) * ratio + 0.5);
+        }
+
+        mate_mixer_transaction_set_volume (transaction, member->control, member_volume);
+    }
+
+    ret = mate_mixer_context_commit_transaction (aggregate->priv->context, transaction);
+
+    mate_mixer_transaction_unref (transaction);
+    return ret;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_AGGREGATE_CONTROL_H
+#define MATEMIXER_AGGREGATE_CONTROL_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libmatemixer/matemixer-enums.h>
+#include <libmatemixer/matemixer-stream-control.h>
+#include <libmatemixer/matemixer-types.h>
+
+G_BEGIN_DECLS
+
+#define MATE_MIXER_TYPE_AGGREGATE_CONTROL       \
+        (mate_mixer_aggregate_control_get_type ())
+#define MATE_MIXER_AGGREGATE_CONTROL(o)         \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), MATE_MIXER_TYPE_AGGREGATE_CONTROL, MateMixerAggregateControl))
+#define MATE_MIXER_IS_AGGREGATE_CONTROL(o)      \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), MATE_MIXER_TYPE_AGGREGATE_CONTROL))
+#define MATE_MIXER_AGGREGATE_CONTROL_CLASS(k)   \
+        (G_TYPE_CHECK_CLASS_CAST ((k), MATE_MIXER_TYPE_AGGREGATE_CONTROL, MateMixerAggregateControlClass))
+#define MATE_MIXER_IS_AGGREGATE_CONTROL_CLASS(k) \
+        (G_TYPE_CHECK_CLASS_TYPE ((k), MATE_MIXER_TYPE_AGGREGATE_CONTROL))
+#define MATE_MIXER_AGGREGATE_CONTROL_GET_CLASS(o) \
+        (G_TYPE_INSTANCE_GET_CLASS ((o), MATE_MIXER_TYPE_AGGREGATE_CONTROL, MateMixerAggregateControlClass))
+
+typedef struct _MateMixerAggregateControlClass    MateMixerAggregateControlClass;
+typedef struct _MateMixerAggregateControlPrivate  MateMixerAggregateControlPrivate;
+
+/**
+ * MateMixerAggregateControl:
+ *
+ * The #MateMixerAggregateControl structure contains only private data and should only
+ * be accessed using the provided API.
+ */
+struct _MateMixerAggregateControl
+{
+    MateMixerStreamControl object;
+
+    /*< private >*/
+    MateMixerAggregateControlPrivate *priv;
+};
+
+/**
+ * MateMixerAggregateControlClass:
+ * @parent_class: The parent class.
+ *
+ * The class structure for #MateMixerAggregateControl.
+ */
+struct _MateMixerAggregateControlClass
+{
+    MateMixerStreamControlClass parent_class;
+
+    /*< private >*/
+    /* Signals */
+    void (*control_added)   (MateMixerAggregateControl *aggregate,
+                             MateMixerStreamControl    *control);
+    void (*control_removed) (MateMixerAggregateControl *aggregate,
+                             MateMixerStreamControl    *control);
+};
+
+GType                      mate_mixer_aggregate_control_get_type            (void) G_GNUC_CONST;
+
+MateMixerAggregateControl *mate_mixer_aggregate_control_new_for_app         (MateMixerContext                *context,
+                                                                             MateMixerAppInfo                *info,
+                                                                             MateMixerDirection               direction);
+MateMixerAggregateControl *mate_mixer_aggregate_control_new_for_media_role  (MateMixerContext                *context,
+                                                                             MateMixerStreamControlMediaRole  media_role,
+                                                                             MateMixerDirection               direction);
+
+MateMixerDirection         mate_mixer_aggregate_control_get_direction       (MateMixerAggregateControl       *aggregate);
+
+guint                      mate_mixer_aggregate_control_get_num_controls    (MateMixerAggregateControl       *aggregate);
+const GList *              mate_mixer_aggregate_control_list_controls       (MateMixerAggregateControl       *aggregate);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_AGGREGATE_CONTROL_H */
@@ -26,13 +26,19 @@ G_BEGIN_DECLS
 
 struct _MateMixerAppInfo
 {
-    gchar *name;
-    gchar *id;
-    gchar *version;
-    gchar *icon;
+    gchar   *name;
+    gchar   *id;
+    gchar   *version;
+    gchar   *icon;
+    gint     ref_count;
+    gboolean interned;
 };
 
 MateMixerAppInfo *_mate_mixer_app_info_new         (void);
+MateMixerAppInfo *_mate_mixer_app_info_intern      (const gchar      *name,
+                                                    const gchar      *id,
+                                                    const gchar      *version,
+                                                    const gchar      *icon);
 
 void              _mate_mixer_app_info_set_name    (MateMixerAppInfo *info,
                                                     const gchar      *name);
@@ -44,7 +50,9 @@ void              _mate_mixer_app_info_set_icon    (MateMixerAppInfo *info,
                                                     const gchar      *icon);
 
 MateMixerAppInfo *_mate_mixer_app_info_copy        (MateMixerAppInfo *info);
-void              _mate_mixer_app_info_free        (MateMixerAppInfo *info);
+
+MateMixerAppInfo *_mate_mixer_app_info_ref         (MateMixerAppInfo *info);
+void              _mate_mixer_app_info_unref       (MateMixerAppInfo *info);
 
 G_END_DECLS
 
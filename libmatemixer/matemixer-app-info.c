@@ -26,6 +26,13 @@
  *
  * The #MateMixerAppInfo structure describes application properties.
  *
+ * Stream controls which belong to the same application share a single
+ * #MateMixerAppInfo instance, so two controls belong to the same application
+ * if their #MateMixerAppInfo pointers are equal.
+ *
+ * The structure is reference counted and immutable, copying the boxed type
+ * only adds a reference, so a copy compares equal to the original.
+ *
  * See #MateMixerStreamControl and the mate_mixer_stream_control_get_app_info()
  * function for more information.
  */
@@ -37,8 +44,18 @@
  * be accessed using the provided API.
  */
 G_DEFINE_BOXED_TYPE (MateMixerAppInfo, mate_mixer_app_info,
-                     _mate_mixer_app_info_copy,
-                     _mate_mixer_app_info_free)
+                     _mate_mixer_app_info_ref,
+                     _mate_mixer_app_info_unref)
+
+/* Table of shared application info structures, the structure itself is
+ * both the key and the value */
+static GHashTable *interned = NULL;
+
+G_LOCK_DEFINE_STATIC (interned);
+
+static guint    app_info_hash  (gconstpointer a);
+static gboolean app_info_equal (gconstpointer a,
+                                gconstpointer b);
 
 /**
  * mate_mixer_app_info_get_name:
@@ -115,7 +132,68 @@ mate_mixer_app_info_get_icon (MateMixerAppInfo *info)
 MateMixerAppInfo *
 _mate_mixer_app_info_new (void)
 {
-    return g_slice_new0 (MateMixerAppInfo);
+    MateMixerAppInfo *info;
+
+    info = g_slice_new0 (MateMixerAppInfo);
+    info->ref_count = 1;
+
+    return info;
+}
+
+/**
+ * _mate_mixer_app_info_intern:
+ * @name: the application name or %NULL
+ * @id: the application identifier or %NULL
+ * @version: the application version or %NULL
+ * @icon: the application icon name or %NULL
+ *
+ * Gets a shared #MateMixerAppInfo structure with the given properties. The
+ * structure is created if it does not exist yet, otherwise a new reference
+ * to the existing structure is returned.
+ *
+ * The returned structure must not be modified.
+ *
+ * Returns: a #MateMixerAppInfo, release it with _mate_mixer_app_info_unref().
+ */
+MateMixerAppInfo *
+_mate_mixer_app_info_intern (const gchar *name,
+                             const gchar *id,
+                             const gchar *version,
+                             const gchar *icon)
+{
+    MateMixerAppInfo *info;
+    MateMixerAppInfo  key;
+
+    key.name    = (gchar *) name;
+    key.id      = (gchar *) id;
+    key.version = (gchar *) version;
+    key.icon    = (gchar *) icon;
+
+    G_LOCK (interned);
+
+    if (G_UNLIKELY (interned == NULL))
+        interned = g_hash_table_new (app_info_hash, app_info_equal);
+
+    info = g_hash_table_lookup (interned, &key);
+    if (info != NULL) {
+        g_atomic_int_inc (&info->ref_count);
+    } else {
+        info = _mate_mixer_app_info_new ();
+
+        /* The strings are owned by the structure and freed together with
+         * it when the last reference is released */
+        info->name     = g_strdup (name);
+        info->id       = g_strdup (id);
+        info->version  = g_strdup (version);
+        info->icon     = g_strdup (icon);
+        info->interned = TRUE;
+
+        g_hash_table_add (interned, info);
+    }
+
+    G_UNLOCK (interned);
+
+    return info;
 }
 
 /**
@@ -124,11 +202,14 @@ _mate_mixer_app_info_new (void)
  * @name: the application name to set
  *
  * Sets the name of the application described by @info.
+ * The @info must not be a shared structure returned by
+ * _mate_mixer_app_info_intern().
  */
 void
 _mate_mixer_app_info_set_name (MateMixerAppInfo *info, const gchar *name)
 {
     g_return_if_fail (info != NULL);
+    g_return_if_fail (info->interned == FALSE);
 
     g_free (info->name);
 
@@ -141,11 +222,14 @@ _mate_mixer_app_info_set_name (MateMixerAppInfo *info, const gchar *name)
  * @id: the application identifier to set
  *
  * Sets the identifier of the application described by @info.
+ * The @info must not be a shared structure returned by
+ * _mate_mixer_app_info_intern().
  */
 void
 _mate_mixer_app_info_set_id (MateMixerAppInfo *info, const gchar *id)
 {
     g_return_if_fail (info != NULL);
+    g_return_if_fail (info->interned == FALSE);
 
     g_free (info->id);
 
@@ -158,11 +242,14 @@ _mate_mixer_app_info_set_id (MateMixerAppInfo *info, const gchar *id)
  * @version: the application version to set
  *
  * Sets the version of the application described by @info.
+ * The @info must not be a shared structure returned by
+ * _mate_mixer_app_info_intern().
  */
 void
 _mate_mixer_app_info_set_version (MateMixerAppInfo *info, const gchar *version)
 {
     g_return_if_fail (info != NULL);
+    g_return_if_fail (info->interned == FALSE);
 
     g_free (info->version);
 
@@ -175,11 +262,14 @@ _mate_mixer_app_info_set_version (MateMixerAppInfo *info, const gchar *version)
  * @icon: the application icon name to set
  *
  * Sets the XDG icon name of the application described by @info.
+ * The @info must not be a shared structure returned by
+ * _mate_mixer_app_info_intern().
  */
 void
 _mate_mixer_app_info_set_icon (MateMixerAppInfo *info, const gchar *icon)
 {
     g_return_if_fail (info != NULL);
+    g_return_if_fail (info->interned == FALSE);
 
     g_free (info->icon);
 
@@ -190,7 +280,9 @@ _mate_mixer_app_info_set_icon (MateMixerAppInfo *info, const gchar *icon)
  * _mate_mixer_app_info_copy:
  * @info: a #MateMixerAppInfo
  *
- * Creates a copy of the #MateMixerAppInfo.
+ * Creates a separate copy of the #MateMixerAppInfo. Unlike the copy of the
+ * boxed type, which only adds a reference, the returned structure is not
+ * shared and may be modified with the setters even if @info is interned.
  *
  * Returns: a copy of the given @info.
  */
@@ -211,16 +303,52 @@ _mate_mixer_app_info_copy (MateMixerAppInfo *info)
 }
 
 /**
- * _mate_mixer_app_info_free:
+ * _mate_mixer_app_info_ref:
  * @info: a #MateMixerAppInfo
  *
- * Frees the #MateMixerAppInfo.
+ * Increments the reference count of the #MateMixerAppInfo.
+ *
+ * Returns: the given @info.
+ */
+MateMixerAppInfo *
+_mate_mixer_app_info_ref (MateMixerAppInfo *info)
+{
+    g_return_val_if_fail (info != NULL, NULL);
+
+    g_atomic_int_inc (&info->ref_count);
+    return info;
+}
+
+/**
+ * _mate_mixer_app_info_unref:
+ * @info: a #MateMixerAppInfo
+ *
+ * Decrements the reference count of the #MateMixerAppInfo and frees it when
+ * the reference count reaches zero.
  */
 void
-_mate_mixer_app_info_free (MateMixerAppInfo *info)
+_mate_mixer_app_info_unref (MateMixerAppInfo *info)
 {
+    gboolean last;
+
     g_return_if_fail (info != NULL);
 
+    if (info->interned == TRUE) {
+        /* Remove the structure from the table while holding the lock, so it
+         * cannot be returned by _mate_mixer_app_info_intern() in between */
+        G_LOCK (interned);
+
+        last = g_atomic_int_dec_and_test (&info->ref_count);
+        if (last == TRUE)
+            g_hash_table_remove (interned, info);
+
+        G_UNLOCK (interned);
+    } else
+        last = g_atomic_int_dec_and_test (&info->ref_count);
+
+    if (last == FALSE)
+        return;
+
     g_free (info->name);
     g_free (info->id);
     g_free (info->version);
@@ -228,3 +356,33 @@ _mate_mixer_app_info_free (MateMixerAppInfo *info)
 
     g_slice_free (MateMixerAppInfo, info);
 }
+
+static guint
+app_info_hash (gconstpointer a)
+{
+    const MateMixerAppInfo *info = a;
+    guint                   hash = 0;
+
+    if (info->name != NULL)
+        hash = g_str_hash (info->name);
+    if (info->id != NULL)
+        hash = hash * 31 + g_str_hash (info->id);
+    if (info->version != NULL)
+        hash = hash * 31 + g_str_hash (info->version);
+    if (info->icon != NULL)
+        hash = hash * 31 + g_str_hash (info->icon);
+
+    return hash;
+}
+
+static gboolean
+app_info_equal (gconstpointer a, gconstpointer b)
+{
+    const MateMixerAppInfo *info1 = a;
+    const MateMixerAppInfo *info2 = b;
+
+    return g_strcmp0 (info1->name, info2->name) == 0 &&
+           g_strcmp0 (info1->id, info2->id) == 0 &&
+           g_strcmp0 (info1->version, info2->version) == 0 &&
+           g_strcmp0 (info1->icon, info2->icon) == 0;
+}
@@ -23,17 +23,23 @@
 #include "matemixer-device.h"
 #include "matemixer-enums.h"
 #include "matemixer-enum-types.h"
+#include "matemixer-statistics.h"
+#include "matemixer-statistics-private.h"
 #include "matemixer-stream.h"
 #include "matemixer-stream-control.h"
 #include "matemixer-stored-control.h"
+#include "matemixer-transaction.h"
+#include "matemixer-transaction-private.h"
 
 struct _MateMixerBackendPrivate
 {
-    GHashTable           *devices;
-    MateMixerStream      *default_input;
-    MateMixerStream      *default_output;
-    MateMixerState        state;
-    MateMixerBackendFlags flags;
+    GHashTable            *devices;
+    MateMixerStream       *default_input;
+    MateMixerStream       *default_output;
+    MateMixerState         state;
+    MateMixerBackendFlags  flags;
+    MateMixerInterestFlags interests;
+    MateMixerStatistics   *statistics;
 };
 
 enum {
@@ -53,6 +59,7 @@ enum {
     STREAM_REMOVED,
     STORED_CONTROL_ADDED,
     STORED_CONTROL_REMOVED,
+    TRANSACTION_COMPLETED,
     N_SIGNALS
 };
 
@@ -82,6 +89,18 @@ static void device_stream_added   (MateMixerBackend *backend,
 static void device_stream_removed (MateMixerBackend *backend,
                                    const gchar      *name);
 
+static void stream_added          (MateMixerBackend *backend,
+                                   const gchar      *name);
+static void stream_removed        (MateMixerBackend *backend,
+                                   const gchar      *name);
+
+static void stored_control_added   (MateMixerBackend *backend,
+                                    const gchar      *name);
+static void stored_control_removed (MateMixerBackend *backend,
+                                    const gchar      *name);
+
+static gboolean is_counting       (MateMixerBackend *backend);
+
 static void
 mate_mixer_backend_class_init (MateMixerBackendClass *klass)
 {
@@ -191,6 +210,19 @@ mate_mixer_backend_class_init (MateMixerBackendClass *klass)
                       G_TYPE_NONE,
                       1,
                       G_TYPE_STRING);
+
+    signals[TRANSACTION_COMPLETED] =
+        g_signal_new ("transaction-completed",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerBackendClass, transaction_completed),
+                      NULL,
+                      NULL,
+                      NULL,
+                      G_TYPE_NONE,
+                      2,
+                      MATE_MIXER_TYPE_TRANSACTION,
+                      G_TYPE_BOOLEAN);
 }
 
 static void
@@ -254,6 +286,9 @@ mate_mixer_backend_init (MateMixerBackend *backend)
                                                     g_free,
                                                     g_object_unref);
 
+    backend->priv->statistics = _mate_mixer_statistics_new ();
+    backend->priv->interests  = MATE_MIXER_INTEREST_ALL;
+
     g_signal_connect (G_OBJECT (backend),
                       "device-added",
                       G_CALLBACK (device_added),
@@ -263,6 +298,25 @@ mate_mixer_backend_init (MateMixerBackend *backend)
                       "device-removed",
                       G_CALLBACK (device_removed),
                       NULL);
+
+    /* The backend may be shared by several contexts, count the changes of
+     * the object model here so that each of them is counted once */
+    g_signal_connect (G_OBJECT (backend),
+                      "stream-added",
+                      G_CALLBACK (stream_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (backend),
+                      "stream-removed",
+                      G_CALLBACK (stream_removed),
+                      NULL);
+    g_signal_connect (G_OBJECT (backend),
+                      "stored-control-added",
+                      G_CALLBACK (stored_control_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (backend),
+                      "stored-control-removed",
+                      G_CALLBACK (stored_control_removed),
+                      NULL);
 }
 
 static void
@@ -289,6 +343,8 @@ mate_mixer_backend_finalize (GObject *object)
 
     g_hash_table_unref (backend->priv->devices);
 
+    mate_mixer_statistics_free (backend->priv->statistics);
+
     G_OBJECT_CLASS (mate_mixer_backend_parent_class)->finalize (object);
 }
 
@@ -318,6 +374,22 @@ mate_mixer_backend_set_server_address (MateMixerBackend *backend, const gchar *a
         klass->set_server_address (backend, address);
 }
 
+MateMixerInterestFlags
+mate_mixer_backend_get_interests (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), MATE_MIXER_INTEREST_NO_FLAGS);
+
+    return backend->priv->interests;
+}
+
+void
+mate_mixer_backend_set_interests (MateMixerBackend *backend, MateMixerInterestFlags interests)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    backend->priv->interests = interests;
+}
+
 gboolean
 mate_mixer_backend_open (MateMixerBackend *backend)
 {
@@ -523,11 +595,44 @@ mate_mixer_backend_set_default_output_stream (MateMixerBackend *backend,
     return TRUE;
 }
 
+gboolean
+mate_mixer_backend_commit_transaction (MateMixerBackend     *backend,
+                                       MateMixerTransaction *transaction)
+{
+    MateMixerBackendClass *klass;
+    gboolean               success;
+
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (transaction != NULL, FALSE);
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+    if (klass->commit_transaction != NULL)
+        return klass->commit_transaction (backend, transaction);
+
+    /* Backends which do not implement batching apply the changes one by one,
+     * the changes are finished when the functions return */
+    _mate_mixer_transaction_freeze_notify (transaction);
+
+    success = _mate_mixer_transaction_apply (transaction, backend);
+
+    _mate_mixer_transaction_thaw_notify (transaction);
+
+    _mate_mixer_backend_complete_transaction (backend, transaction, success);
+    return TRUE;
+}
+
 static void
 device_added (MateMixerBackend *backend, const gchar *name)
 {
     MateMixerDevice *device;
 
+    if (is_counting (backend) == TRUE) {
+        MateMixerStatistics *statistics = backend->priv->statistics;
+
+        _mate_mixer_statistics_set_devices (statistics, statistics->devices + 1);
+        _mate_mixer_statistics_add_signal (statistics);
+    }
+
     device = mate_mixer_backend_get_device (backend, name);
     if (G_UNLIKELY (device == NULL)) {
         g_warn_if_reached ();
@@ -557,6 +662,13 @@ device_removed (MateMixerBackend *backend, const gchar *name)
 {
     MateMixerDevice *device;
 
+    if (is_counting (backend) == TRUE) {
+        MateMixerStatistics *statistics = backend->priv->statistics;
+
+        _mate_mixer_statistics_set_devices (statistics, statistics->devices > 0 ? statistics->devices - 1 : 0);
+        _mate_mixer_statistics_add_signal (statistics);
+    }
+
     device = g_hash_table_lookup (backend->priv->devices, name);
     if (G_UNLIKELY (device == NULL)) {
         g_warn_if_reached ();
@@ -591,6 +703,71 @@ device_stream_removed (MateMixerBackend *backend, const gchar *name)
                    name);
 }
 
+static void
+stream_added (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStatistics *statistics;
+
+    if (is_counting (backend) == FALSE)
+        return;
+
+    statistics = backend->priv->statistics;
+
+    _mate_mixer_statistics_set_streams (statistics, statistics->streams + 1);
+    _mate_mixer_statistics_add_signal (statistics);
+}
+
+static void
+stream_removed (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStatistics *statistics;
+
+    if (is_counting (backend) == FALSE)
+        return;
+
+    statistics = backend->priv->statistics;
+
+    _mate_mixer_statistics_set_streams (statistics, statistics->streams > 0 ? statistics->streams - 1 : 0);
+    _mate_mixer_statistics_add_signal (statistics);
+}
+
+static void
+stored_control_added (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStatistics *statistics;
+
+    if (is_counting (backend) == FALSE)
+        return;
+
+    statistics = backend->priv->statistics;
+
+    _mate_mixer_statistics_set_stored_controls (statistics, statistics->stored_controls + 1);
+    _mate_mixer_statistics_add_signal (statistics);
+}
+
+static void
+stored_control_removed (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStatistics *statistics;
+
+    if (is_counting (backend) == FALSE)
+        return;
+
+    statistics = backend->priv->statistics;
+
+    _mate_mixer_statistics_set_stored_controls (statistics, statistics->stored_controls > 0 ? statistics->stored_controls - 1 : 0);
+    _mate_mixer_statistics_add_signal (statistics);
+}
+
+static gboolean
+is_counting (MateMixerBackend *backend)
+{
+    /* Contexts only listen to the backend in the READY state, the changes made
+     * while the backend is loading are covered by the counts taken when it
+     * becomes ready */
+    return backend->priv->state == MATE_MIXER_STATE_READY;
+}
+
 /* Protected functions */
 void
 _mate_mixer_backend_set_state (MateMixerBackend *backend, MateMixerState state)
@@ -602,9 +779,46 @@ _mate_mixer_backend_set_state (MateMixerBackend *backend, MateMixerState state)
 
     backend->priv->state = state;
 
+    if (state == MATE_MIXER_STATE_READY) {
+        MateMixerStatistics *statistics = backend->priv->statistics;
+
+        /* Start counting the objects from the lists available in the READY state */
+        _mate_mixer_statistics_set_devices (statistics,
+                                            g_list_length ((GList *) mate_mixer_backend_list_devices (backend)));
+        _mate_mixer_statistics_set_streams (statistics,
+                                            g_list_length ((GList *) mate_mixer_backend_list_streams (backend)));
+        _mate_mixer_statistics_set_stored_controls (statistics,
+                                                    g_list_length ((GList *) mate_mixer_backend_list_stored_controls (backend)));
+    }
+
     g_object_notify_by_pspec (G_OBJECT (backend), properties[PROP_STATE]);
 }
 
+MateMixerStatistics *
+_mate_mixer_backend_get_statistics (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    return backend->priv->statistics;
+}
+
+void
+_mate_mixer_backend_complete_transaction (MateMixerBackend     *backend,
+                                          MateMixerTransaction *transaction,
+                                          gboolean              success)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+    g_return_if_fail (transaction != NULL);
+
+    _mate_mixer_statistics_add_signal (backend->priv->statistics);
+
+    g_signal_emit (G_OBJECT (backend),
+                   signals[TRANSACTION_COMPLETED],
+                   0,
+                   transaction,
+                   success);
+}
+
 void
 _mate_mixer_backend_set_default_input_stream (MateMixerBackend *backend,
                                               MateMixerStream  *stream)
@@ -626,6 +840,8 @@ _mate_mixer_backend_set_default_input_stream (MateMixerBackend *backend,
     g_debug ("Default input stream changed to %s",
              (stream != NULL) ? mate_mixer_stream_get_name (stream) : "none");
 
+    _mate_mixer_statistics_add_notification (backend->priv->statistics);
+
     g_object_notify_by_pspec (G_OBJECT (backend),
                               properties[PROP_DEFAULT_INPUT_STREAM]);
 }
@@ -651,6 +867,8 @@ _mate_mixer_backend_set_default_output_stream (MateMixerBackend *backend,
     g_debug ("Default output stream changed to %s",
              (stream != NULL) ? mate_mixer_stream_get_name (stream) : "none");
 
+    _mate_mixer_statistics_add_notification (backend->priv->statistics);
+
     g_object_notify_by_pspec (G_OBJECT (backend),
                               properties[PROP_DEFAULT_OUTPUT_STREAM]);
 }
@@ -73,6 +73,9 @@ struct _MateMixerBackendClass
     gboolean     (*set_default_output_stream) (MateMixerBackend *backend,
                                                MateMixerStream  *stream);
 
+    gboolean     (*commit_transaction)        (MateMixerBackend     *backend,
+                                               MateMixerTransaction *transaction);
+
     /* Signals */
     void         (*device_added)              (MateMixerBackend *backend,
                                                const gchar      *name);
@@ -86,6 +89,9 @@ struct _MateMixerBackendClass
                                                const gchar      *name);
     void         (*stored_control_removed)    (MateMixerBackend *backend,
                                                const gchar      *name);
+    void         (*transaction_completed)     (MateMixerBackend     *backend,
+                                               MateMixerTransaction *transaction,
+                                               gboolean              success);
 };
 
 GType                   mate_mixer_backend_get_type                  (void) G_GNUC_CONST;
@@ -95,6 +101,10 @@ void                    mate_mixer_backend_set_app_info              (MateMixerB
 void                    mate_mixer_backend_set_server_address        (MateMixerBackend *backend,
                                                                       const gchar      *address);
 
+MateMixerInterestFlags  mate_mixer_backend_get_interests             (MateMixerBackend *backend);
+void                    mate_mixer_backend_set_interests             (MateMixerBackend *backend,
+                                                                      MateMixerInterestFlags interests);
+
 gboolean                mate_mixer_backend_open                      (MateMixerBackend *backend);
 void                    mate_mixer_backend_close                     (MateMixerBackend *backend);
 
@@ -119,6 +129,9 @@ MateMixerStream *       mate_mixer_backend_get_default_output_stream (MateMixerB
 gboolean                mate_mixer_backend_set_default_output_stream (MateMixerBackend *backend,
                                                                       MateMixerStream  *stream);
 
+gboolean                mate_mixer_backend_commit_transaction        (MateMixerBackend     *backend,
+                                                                      MateMixerTransaction *transaction);
+
 /* Protected functions */
 void                   _mate_mixer_backend_set_state                 (MateMixerBackend *backend,
                                                                       MateMixerState    state);
@@ -129,6 +142,12 @@ void                   _mate_mixer_backend_set_default_input_stream  (MateMixerB
 void                   _mate_mixer_backend_set_default_output_stream (MateMixerBackend *backend,
                                                                       MateMixerStream  *stream);
 
+MateMixerStatistics *  _mate_mixer_backend_get_statistics            (MateMixerBackend *backend);
+
+void                   _mate_mixer_backend_complete_transaction      (MateMixerBackend     *backend,
+                                                                      MateMixerTransaction *transaction,
+                                                                      gboolean              success);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_BACKEND_H */
@@ -70,6 +70,26 @@
  * handle these events.
  */
 
+/* Time in milliseconds without stream changes after which the streams are
+ * considered settled when applying a snapshot */
+#define SNAPSHOT_SETTLE_TIMEOUT 250
+
+typedef struct
+{
+    MateMixerBackend       *backend;
+    MateMixerBackendModule *module;
+} ContextProbe;
+
+typedef struct
+{
+    MateMixerBackend       *backend;
+    MateMixerBackendModule *module;
+    GMainContext           *main_context;
+    gchar                  *server_address;
+    MateMixerInterestFlags  interests;
+    guint                   users;
+} ContextShared;
+
 struct _MateMixerContextPrivate
 {
     gboolean                backend_chosen;
@@ -79,6 +99,15 @@ struct _MateMixerContextPrivate
     MateMixerAppInfo       *app_info;
     MateMixerBackendType    backend_type;
     MateMixerBackendModule *module;
+    guint                   probe_timeout;
+    gboolean                share_backend;
+    GSource                *probe_timeout_source;
+    gboolean                probe_expired;
+    MateMixerInterestFlags  interests;
+    GList                  *probes;
+    GVariant               *snapshot;
+    MateMixerTransaction   *snapshot_transaction;
+    GSource                *snapshot_settle_source;
 };
 
 enum {
@@ -88,6 +117,9 @@ enum {
     PROP_APP_VERSION,
     PROP_APP_ICON,
     PROP_SERVER_ADDRESS,
+    PROP_PROBE_TIMEOUT,
+    PROP_INTERESTS,
+    PROP_SHARE_BACKEND,
     PROP_STATE,
     PROP_DEFAULT_INPUT_STREAM,
     PROP_DEFAULT_OUTPUT_STREAM,
@@ -103,11 +135,20 @@ enum {
     STREAM_REMOVED,
     STORED_CONTROL_ADDED,
     STORED_CONTROL_REMOVED,
+    TRANSACTION_COMPLETED,
     N_SIGNALS
 };
 
 static guint signals[N_SIGNALS] = { 0, };
 
+/* Backends opened by the contexts of this process, a context which asks for
+ * a backend already in this list reuses its connection and object model.
+ * A backend dispatches its events in the thread-default main context it was
+ * opened in, so it is only shared with contexts using the same main context */
+static GList *shared_backends = NULL;
+
+G_LOCK_DEFINE_STATIC (shared_backends);
+
 static void mate_mixer_context_get_property (GObject               *object,
                                              guint                  param_id,
                                              GValue                *value,
@@ -147,6 +188,11 @@ static void     on_backend_stored_control_removed       (MateMixerBackend *backe
                                                          const gchar      *name,
                                                          MateMixerContext *context);
 
+static void     on_backend_transaction_completed        (MateMixerBackend     *backend,
+                                                         MateMixerTransaction *transaction,
+                                                         gboolean              success,
+                                                         MateMixerContext     *context);
+
 static void     on_backend_default_input_stream_notify  (MateMixerBackend *backend,
                                                          GParamSpec       *pspec,
                                                          MateMixerContext *context);
@@ -154,13 +200,48 @@ static void     on_backend_default_output_stream_notify (MateMixerBackend *backe
                                                          GParamSpec       *pspec,
                                                          MateMixerContext *context);
 
+static void     on_probe_state_notify                   (MateMixerBackend *backend,
+                                                         GParamSpec       *pspec,
+                                                         MateMixerContext *context);
+
 static gboolean try_next_backend                        (MateMixerContext *context);
 
+static gboolean probe_backends                          (MateMixerContext *context,
+                                                         const GList      *modules);
+static gboolean probe_timeout                           (MateMixerContext *context);
+static void     probe_select                            (MateMixerContext *context);
+static void     probe_free                              (ContextProbe     *probe);
+static void     close_probes                            (MateMixerContext *context);
+
+static void     use_backend                             (MateMixerContext       *context,
+                                                         MateMixerBackendModule *module,
+                                                         MateMixerBackend       *backend);
+
+static gboolean share_backend                           (MateMixerContext *context);
+static void     register_backend                        (MateMixerContext *context);
+static void     release_backend                         (MateMixerContext *context);
+
 static void     change_state                            (MateMixerContext *context,
                                                          MateMixerState    state);
 
 static void     close_context                           (MateMixerContext *context);
 
+static gboolean apply_snapshot_streams                  (MateMixerContext *context,
+                                                         GVariant         *snapshot);
+static void     settle_snapshot                         (MateMixerContext *context);
+static gboolean settle_snapshot_timeout                 (MateMixerContext *context);
+static void     cancel_snapshot                         (MateMixerContext *context);
+
+static gboolean transaction_is_local                    (MateMixerContext     *context,
+                                                         MateMixerTransaction *transaction);
+
+static gboolean stream_is_local                         (MateMixerContext       *context,
+                                                         MateMixerStream        *stream);
+static gboolean control_is_local                        (MateMixerContext       *context,
+                                                         MateMixerStreamControl *control);
+static gboolean switch_is_local                         (MateMixerContext       *context,
+                                                         MateMixerSwitch        *swtch);
+
 static void
 mate_mixer_context_class_init (MateMixerContextClass *klass)
 {
@@ -236,6 +317,54 @@ mate_mixer_context_class_init (MateMixerContextClass *klass)
                              NULL,
                              G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+    /**
+     * MateMixerContext:probe-timeout:
+     *
+     * Maximum time in milliseconds to wait for higher priority sound system
+     * backends when probing backends concurrently, or 0 to try the backends
+     * one after another.
+     *
+     * See mate_mixer_context_set_probe_timeout() for more information.
+     */
+    properties[PROP_PROBE_TIMEOUT] =
+        g_param_spec_uint ("probe-timeout",
+                           "Probe timeout",
+                           "Concurrent backend probing deadline in milliseconds",
+                           0,
+                           G_MAXUINT,
+                           0,
+                           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+    /**
+     * MateMixerContext:interests:
+     *
+     * The kinds of objects the application is interested in.
+     *
+     * See mate_mixer_context_set_interests() for more information.
+     */
+    properties[PROP_INTERESTS] =
+        g_param_spec_flags ("interests",
+                            "Interests",
+                            "Kinds of objects used by the application",
+                            MATE_MIXER_TYPE_INTEREST_FLAGS,
+                            MATE_MIXER_INTEREST_ALL,
+                            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+    /**
+     * MateMixerContext:share-backend:
+     *
+     * Whether the connection to a sound system may be shared with other
+     * contexts in the process.
+     *
+     * See mate_mixer_context_set_share_backend() for more information.
+     */
+    properties[PROP_SHARE_BACKEND] =
+        g_param_spec_boolean ("share-backend",
+                              "Share backend",
+                              "Share the sound system connection with other contexts",
+                              FALSE,
+                              G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
     /**
      * MateMixerContext:state:
      *
@@ -427,6 +556,34 @@ mate_mixer_context_class_init (MateMixerContextClass *klass)
                       G_TYPE_NONE,
                       1,
                       G_TYPE_STRING);
+
+    /**
+     * MateMixerContext::transaction-completed:
+     * @context: a #MateMixerContext
+     * @transaction: the committed #MateMixerTransaction
+     * @success: %TRUE if all the operations of the transaction succeeded
+     *
+     * The signal is emitted once for each transaction committed with
+     * mate_mixer_context_commit_transaction() after the sound system has
+     * processed all of its operations.
+     *
+     * Change notifications of the controls modified by the transaction are
+     * held until the sound system has processed all of its operations and
+     * they are emitted right before this signal, so applications may prefer
+     * to update their user interface once in the handler of this signal.
+     */
+    signals[TRANSACTION_COMPLETED] =
+        g_signal_new ("transaction-completed",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerContextClass, transaction_completed),
+                      NULL,
+                      NULL,
+                      NULL,
+                      G_TYPE_NONE,
+                      2,
+                      MATE_MIXER_TYPE_TRANSACTION,
+                      G_TYPE_BOOLEAN);
 }
 
 static void
@@ -455,6 +612,15 @@ mate_mixer_context_get_property (GObject    *object,
     case PROP_SERVER_ADDRESS:
         g_value_set_string (value, context->priv->server_address);
         break;
+    case PROP_PROBE_TIMEOUT:
+        g_value_set_uint (value, context->priv->probe_timeout);
+        break;
+    case PROP_INTERESTS:
+        g_value_set_flags (value, context->priv->interests);
+        break;
+    case PROP_SHARE_BACKEND:
+        g_value_set_boolean (value, context->priv->share_backend);
+        break;
     case PROP_STATE:
         g_value_set_enum (value, context->priv->state);
         break;
@@ -497,6 +663,15 @@ mate_mixer_context_set_property (GObject      *object,
     case PROP_SERVER_ADDRESS:
         mate_mixer_context_set_server_address (context, g_value_get_string (value));
         break;
+    case PROP_PROBE_TIMEOUT:
+        mate_mixer_context_set_probe_timeout (context, g_value_get_uint (value));
+        break;
+    case PROP_INTERESTS:
+        mate_mixer_context_set_interests (context, g_value_get_flags (value));
+        break;
+    case PROP_SHARE_BACKEND:
+        mate_mixer_context_set_share_backend (context, g_value_get_boolean (value));
+        break;
     case PROP_DEFAULT_INPUT_STREAM:
         mate_mixer_context_set_default_input_stream (context, g_value_get_object (value));
         break;
@@ -515,7 +690,8 @@ mate_mixer_context_init (MateMixerContext *context)
 {
     context->priv = mate_mixer_context_get_instance_private (context);
 
-    context->priv->app_info = _mate_mixer_app_info_new ();
+    context->priv->app_info  = _mate_mixer_app_info_new ();
+    context->priv->interests = MATE_MIXER_INTEREST_ALL;
 }
 
 static void
@@ -537,7 +713,7 @@ mate_mixer_context_finalize (GObject *object)
 
     context = MATE_MIXER_CONTEXT (object);
 
-    _mate_mixer_app_info_free (context->priv->app_info);
+    _mate_mixer_app_info_unref (context->priv->app_info);
 
     g_free (context->priv->server_address);
 
@@ -762,6 +938,171 @@ mate_mixer_context_set_server_address (MateMixerContext *context, const gchar *a
     return TRUE;
 }
 
+/**
+ * mate_mixer_context_set_probe_timeout:
+ * @context: a #MateMixerContext
+ * @timeout: the probing deadline in milliseconds, or 0 to disable probing
+ *
+ * Enables concurrent probing of sound system backends.
+ *
+ * By default, when the backend type is determined automatically, the backends
+ * are tried one after another in the order of their priority and a backend is
+ * only tried after the previous one has failed. A sound server which is slow
+ * to respond therefore delays the availability of the other backends until
+ * its connection attempt fails.
+ *
+ * With a non-zero @timeout, all the available backends are opened at the same
+ * time. The backend with the highest priority which reaches the
+ * %MATE_MIXER_STATE_READY state is used and the other backends are closed.
+ * Lower priority backends are only used when all the higher priority backends
+ * fail or when they are still connecting after @timeout milliseconds.
+ *
+ * Probing is not used when a specific backend type is selected with
+ * mate_mixer_context_set_backend_type().
+ *
+ * This function must be used before opening a connection to a sound system with
+ * mate_mixer_context_open(), otherwise it will fail.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_probe_timeout (MateMixerContext *context, guint timeout)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    if (context->priv->state == MATE_MIXER_STATE_CONNECTING ||
+        context->priv->state == MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    if (context->priv->probe_timeout == timeout)
+        return TRUE;
+
+    context->priv->probe_timeout = timeout;
+
+    g_object_notify_by_pspec (G_OBJECT (context), properties[PROP_PROBE_TIMEOUT]);
+    return TRUE;
+}
+
+/**
+ * mate_mixer_context_get_interests:
+ * @context: a #MateMixerContext
+ *
+ * Gets the kinds of objects the application is interested in.
+ *
+ * Returns: the interest flags.
+ */
+MateMixerInterestFlags
+mate_mixer_context_get_interests (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_INTEREST_NO_FLAGS);
+
+    return context->priv->interests;
+}
+
+/**
+ * mate_mixer_context_set_interests:
+ * @context: a #MateMixerContext
+ * @interests: the kinds of objects the application is interested in
+ *
+ * Tells the sound system backend which kinds of objects the application uses.
+ *
+ * By default, the backends download and track all the devices, streams and
+ * controls available in the sound system. An application which only uses
+ * a part of them, for example a panel applet which only shows the volume of
+ * the default output stream, may set @interests to the kinds of objects it
+ * needs, allowing the backend to skip the other objects and the notifications
+ * about them.
+ *
+ * The objects which are not included in @interests may still be available
+ * when the sound system backend cannot track them separately, but the
+ * application should not rely on it.
+ *
+ * This function must be used before opening a connection to a sound system with
+ * mate_mixer_context_open(), otherwise it will fail.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_interests (MateMixerContext *context, MateMixerInterestFlags interests)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    if (context->priv->state == MATE_MIXER_STATE_CONNECTING ||
+        context->priv->state == MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    if (context->priv->interests == interests)
+        return TRUE;
+
+    context->priv->interests = interests;
+
+    g_object_notify_by_pspec (G_OBJECT (context), properties[PROP_INTERESTS]);
+    return TRUE;
+}
+
+/**
+ * mate_mixer_context_get_share_backend:
+ * @context: a #MateMixerContext
+ *
+ * Gets whether the connection to a sound system may be shared with other
+ * contexts in the process.
+ *
+ * Returns: %TRUE if sharing is enabled or %FALSE otherwise.
+ */
+gboolean
+mate_mixer_context_get_share_backend (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    return context->priv->share_backend;
+}
+
+/**
+ * mate_mixer_context_set_share_backend:
+ * @context: a #MateMixerContext
+ * @share: whether to share the connection with other contexts
+ *
+ * Allows the context to share its connection to a sound system with other
+ * contexts in the same process.
+ *
+ * By default, each context opens its own connection. When @share is %TRUE,
+ * mate_mixer_context_open() reuses the connection of another context which
+ * has also enabled sharing, uses the same thread-default main context,
+ * selects the same backend type and server address and whose interests
+ * include the interests of @context.
+ *
+ * Contexts sharing a connection also share the devices, streams and stored
+ * controls, which are the same objects in all of them. The sound system only
+ * knows the application information of the context which opened the
+ * connection, and the #MateMixerStatistics of the contexts count the events
+ * of the shared connection. The connection is closed when the last context
+ * using it is closed.
+ *
+ * This function must be used before opening a connection to a sound system with
+ * mate_mixer_context_open(), otherwise it will fail.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_share_backend (MateMixerContext *context, gboolean share)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    if (context->priv->state == MATE_MIXER_STATE_CONNECTING ||
+        context->priv->state == MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    share = (share != FALSE);
+
+    if (context->priv->share_backend == share)
+        return TRUE;
+
+    context->priv->share_backend = share;
+
+    g_object_notify_by_pspec (G_OBJECT (context), properties[PROP_SHARE_BACKEND]);
+    return TRUE;
+}
+
 /**
  * mate_mixer_context_open:
  * @context: a #MateMixerContext
@@ -788,6 +1129,10 @@ mate_mixer_context_set_server_address (MateMixerContext *context, const gchar *a
  * loop running to allow an asynchronous connection to proceed. The library will use
  * the thread's default main context for this purpose.
  *
+ * If sharing has been enabled with mate_mixer_context_set_share_backend(), the
+ * connection of another context in the process may be reused instead of opening
+ * a new one.
+ *
  * If this function returns %FALSE, it was not possible to connect to a sound system
  * and the #MateMixerContext:state will be set to %MATE_MIXER_STATE_FAILED.
  *
@@ -808,6 +1153,11 @@ mate_mixer_context_open (MateMixerContext *context)
         context->priv->state == MATE_MIXER_STATE_READY)
         return FALSE;
 
+    /* Another context in this process may already be connected to the sound
+     * system we are looking for */
+    if (context->priv->share_backend == TRUE && share_backend (context) == TRUE)
+        return TRUE;
+
     /* We are going to choose the first backend to try. It will be either the one
      * selected by the application or the one with the highest priority */
     modules = _mate_mixer_list_modules ();
@@ -831,6 +1181,11 @@ mate_mixer_context_open (MateMixerContext *context)
             return FALSE;
         }
     } else {
+        /* Start all the backends at once when probing is enabled, the
+         * connection state will be changed when one of them is selected */
+        if (context->priv->probe_timeout > 0)
+            return probe_backends (context, modules);
+
         /* The highest priority module is on the top of the list */
         module = MATE_MIXER_BACKEND_MODULE (modules->data);
     }
@@ -843,6 +1198,7 @@ mate_mixer_context_open (MateMixerContext *context)
 
     mate_mixer_backend_set_app_info (context->priv->backend, context->priv->app_info);
     mate_mixer_backend_set_server_address (context->priv->backend, context->priv->server_address);
+    mate_mixer_backend_set_interests (context->priv->backend, context->priv->interests);
 
     g_debug ("Trying to open backend %s", info->name);
 
@@ -879,6 +1235,8 @@ mate_mixer_context_open (MateMixerContext *context)
         return FALSE;
     }
 
+    register_backend (context);
+
     g_signal_connect (G_OBJECT (context->priv->backend),
                       "notify::state",
                       G_CALLBACK (on_backend_state_notify),
@@ -1055,6 +1413,50 @@ mate_mixer_context_list_stored_controls (MateMixerContext *context)
     return mate_mixer_backend_list_stored_controls (MATE_MIXER_BACKEND (context->priv->backend));
 }
 
+/**
+ * mate_mixer_context_read_controls:
+ * @context: a #MateMixerContext
+ * @states: (array length=n_states): an array of #MateMixerStreamControlState
+ * @n_states: the number of items in @states
+ *
+ * Reads the state of the controls of all the streams into the caller-provided
+ * array. The streams are read in the order of mate_mixer_context_list_streams()
+ * and the controls of each stream as by mate_mixer_stream_read_controls().
+ *
+ * This function is meant for applications which periodically poll all the
+ * controls, for example to find out which of them have changed since the
+ * previous call.
+ *
+ * When the array is too small, only the first @n_states controls are read.
+ * The function may be called with @n_states 0 to find out the number of
+ * controls.
+ *
+ * Returns: the number of controls of all the streams, which may be larger
+ * than @n_states, or 0 if you are not connected to a sound system.
+ */
+guint
+mate_mixer_context_read_controls (MateMixerContext            *context,
+                                  MateMixerStreamControlState *states,
+                                  guint                        n_states)
+{
+    const GList *list;
+    guint        count = 0;
+
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), 0);
+    g_return_val_if_fail (states != NULL || n_states == 0, 0);
+
+    list = mate_mixer_context_list_streams (context);
+    while (list != NULL) {
+        guint offset = MIN (count, n_states);
+
+        count += mate_mixer_stream_read_controls (MATE_MIXER_STREAM (list->data),
+                                                  (states != NULL) ? states + offset : NULL,
+                                                  n_states - offset);
+        list = list->next;
+    }
+    return count;
+}
+
 /**
  * mate_mixer_context_get_default_input_stream:
  * @context: a #MateMixerContext
@@ -1147,100 +1549,326 @@ mate_mixer_context_set_default_output_stream (MateMixerContext *context,
 }
 
 /**
- * mate_mixer_context_get_backend_name:
+ * mate_mixer_context_begin_transaction:
  * @context: a #MateMixerContext
  *
- * Gets the name of the currently used sound system backend.
+ * Creates a new transaction. Changes queued in the transaction are not
+ * performed until the transaction is committed using
+ * mate_mixer_context_commit_transaction().
  *
  * This function will not work until the @context is connected to a sound system.
  *
- * Returns: the name or %NULL on error.
+ * Returns: a new #MateMixerTransaction or %NULL if you are not connected
+ * to a sound system. Use mate_mixer_transaction_unref() to release it.
  */
-const gchar *
-mate_mixer_context_get_backend_name (MateMixerContext *context)
+MateMixerTransaction *
+mate_mixer_context_begin_transaction (MateMixerContext *context)
 {
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
-    if (context->priv->backend_chosen == FALSE)
+    if (context->priv->state != MATE_MIXER_STATE_READY)
         return NULL;
 
-    return mate_mixer_backend_module_get_info (context->priv->module)->name;
+    return _mate_mixer_transaction_new ();
 }
 
 /**
- * mate_mixer_context_get_backend_type:
+ * mate_mixer_context_commit_transaction:
  * @context: a #MateMixerContext
+ * @transaction: a #MateMixerTransaction
  *
- * Gets the type of the currently used sound system backend.
+ * Performs all the operations queued in the @transaction as a single batch.
  *
- * This function will not work until the @context is connected to a sound system.
+ * The sound system may process the operations asynchronously, the
+ * #MateMixerContext::transaction-completed signal is emitted once all of
+ * them have been processed. A transaction can only be committed once.
  *
- * Returns: the backend type or %MATE_MIXER_BACKEND_UNKNOWN on error.
+ * All the stream controls, streams and switches in the @transaction must
+ * belong to the @context, otherwise the transaction is rejected.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
  */
-MateMixerBackendType
-mate_mixer_context_get_backend_type (MateMixerContext *context)
+gboolean
+mate_mixer_context_commit_transaction (MateMixerContext     *context,
+                                       MateMixerTransaction *transaction)
 {
-    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_UNKNOWN);
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+    g_return_val_if_fail (transaction != NULL, FALSE);
 
-    if (context->priv->backend_chosen == FALSE)
-        return MATE_MIXER_BACKEND_UNKNOWN;
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return FALSE;
 
-    return mate_mixer_backend_module_get_info (context->priv->module)->backend_type;
+    if (_mate_mixer_transaction_get_committed (transaction) == TRUE)
+        return FALSE;
+
+    if (G_UNLIKELY (transaction_is_local (context, transaction) == FALSE)) {
+        g_warning ("Transaction contains objects which do not belong to the context");
+        return FALSE;
+    }
+
+    _mate_mixer_transaction_set_committed (transaction, context);
+
+    return mate_mixer_backend_commit_transaction (context->priv->backend, transaction);
 }
 
 /**
- * mate_mixer_context_get_backend_flags:
+ * mate_mixer_context_capture_snapshot:
  * @context: a #MateMixerContext
  *
- * Gets the capability flags of the currently used sound system backend.
+ * Captures the current state of the mixer into a snapshot. The snapshot
+ * includes the default streams, the volume of each channel and the mute
+ * state of the stream controls and stored controls and the active options of the stream and
+ * device switches, which includes the card profiles.
+ *
+ * The snapshot is a plain #GVariant, use g_variant_get_data() and
+ * g_variant_new_from_data() or g_variant_print() and g_variant_parse() to
+ * save it and load it again.
  *
  * This function will not work until the @context is connected to a sound system.
  *
- * Returns: the capability flags.
+ * Returns: (transfer full): a new snapshot or %NULL if you are not connected
+ * to a sound system. Use g_variant_unref() to release it.
  */
-MateMixerBackendFlags
-mate_mixer_context_get_backend_flags (MateMixerContext *context)
+GVariant *
+mate_mixer_context_capture_snapshot (MateMixerContext *context)
 {
-    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_NO_FLAGS);
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
-    if (context->priv->backend_chosen == FALSE)
-        return MATE_MIXER_BACKEND_NO_FLAGS;
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return NULL;
 
-    return mate_mixer_backend_module_get_info (context->priv->module)->backend_flags;
+    return _mate_mixer_snapshot_capture (context->priv->backend);
 }
 
-static void
-on_backend_state_notify (MateMixerBackend *backend,
-                         GParamSpec       *pspec,
-                         MateMixerContext *context)
+/**
+ * mate_mixer_context_apply_snapshot:
+ * @context: a #MateMixerContext
+ * @snapshot: a snapshot created by mate_mixer_context_capture_snapshot()
+ *
+ * Restores the state of the mixer saved in the @snapshot.
+ *
+ * The snapshot is compared with the current state and only the items which
+ * differ are changed. Changing a device switch such as a card profile may
+ * replace the streams of the device, so the device switches are committed
+ * in a transaction of their own first, see
+ * mate_mixer_context_commit_transaction(). When it has completed and the
+ * streams have stopped changing, the snapshot is compared again and the
+ * default streams, stream switches and stream controls are committed in
+ * a second transaction.
+ *
+ * The #MateMixerContext::transaction-completed signal is emitted for each
+ * of the transactions. If nothing differs, no transaction is committed and
+ * the signal is not emitted. Applying another snapshot cancels the second
+ * step of an earlier one which has not been committed yet.
+ *
+ * Items referring to devices, streams, controls or switches which do not
+ * exist are skipped.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_apply_snapshot (MateMixerContext *context, GVariant *snapshot)
 {
-    MateMixerState state = mate_mixer_backend_get_state (backend);
+    MateMixerTransaction *transaction;
+    guint32               version;
+    gboolean              ret = TRUE;
 
-    switch (state) {
-    case MATE_MIXER_STATE_CONNECTING:
-        g_debug ("Backend %s changed state to CONNECTING",
-                 mate_mixer_backend_module_get_info (context->priv->module)->name);
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+    g_return_val_if_fail (snapshot != NULL, FALSE);
 
-        change_state (context, state);
-        break;
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return FALSE;
 
-    case MATE_MIXER_STATE_READY:
-        g_debug ("Backend %s changed state to READY",
-                 mate_mixer_backend_module_get_info (context->priv->module)->name);
+    if (g_variant_is_of_type (snapshot, G_VARIANT_TYPE (MATE_MIXER_SNAPSHOT_TYPE)) == FALSE) {
+        g_warning ("Invalid mixer snapshot of type %s",
+                   g_variant_get_type_string (snapshot));
+        return FALSE;
+    }
 
-        change_state (context, state);
-        break;
+    g_variant_get_child (snapshot, 0, "u", &version);
+    if (version != MATE_MIXER_SNAPSHOT_VERSION) {
+        g_warning ("Unsupported mixer snapshot version %u", version);
+        return FALSE;
+    }
 
-    case MATE_MIXER_STATE_FAILED:
-        g_debug ("Backend %s changed state to FAILED",
-                 mate_mixer_backend_module_get_info (context->priv->module)->name);
+    cancel_snapshot (context);
 
-        if (context->priv->backend_type == MATE_MIXER_BACKEND_UNKNOWN) {
-            /* User didn't request a specific backend, so try another one */
-            try_next_backend (context);
-        } else {
-            /* User requested a specific backend and it failed */
-            close_context (context);
+    transaction = _mate_mixer_transaction_new ();
+
+    if (_mate_mixer_snapshot_diff (context->priv->backend,
+                                   mate_mixer_context_get_backend_flags (context),
+                                   snapshot,
+                                   MATE_MIXER_SNAPSHOT_PHASE_DEVICES,
+                                   transaction) == 0) {
+        /* No device is changing, the rest can be applied right away */
+        mate_mixer_transaction_unref (transaction);
+
+        return apply_snapshot_streams (context, snapshot);
+    }
+
+    /* The rest of the snapshot is applied when the transaction completes,
+     * see on_backend_transaction_completed() */
+    context->priv->snapshot             = g_variant_ref (snapshot);
+    context->priv->snapshot_transaction = transaction;
+
+    _mate_mixer_transaction_set_committed (transaction, context);
+
+    ret = mate_mixer_backend_commit_transaction (context->priv->backend, transaction);
+    if (ret == FALSE)
+        cancel_snapshot (context);
+
+    return ret;
+}
+
+/**
+ * mate_mixer_context_get_backend_name:
+ * @context: a #MateMixerContext
+ *
+ * Gets the name of the currently used sound system backend.
+ *
+ * This function will not work until the @context is connected to a sound system.
+ *
+ * Returns: the name or %NULL on error.
+ */
+const gchar *
+mate_mixer_context_get_backend_name (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+    if (context->priv->backend_chosen == FALSE)
+        return NULL;
+
+    return mate_mixer_backend_module_get_info (context->priv->module)->name;
+}
+
+/**
+ * mate_mixer_context_get_backend_type:
+ * @context: a #MateMixerContext
+ *
+ * Gets the type of the currently used sound system backend.
+ *
+ * This function will not work until the @context is connected to a sound system.
+ *
+ * Returns: the backend type or %MATE_MIXER_BACKEND_UNKNOWN on error.
+ */
+MateMixerBackendType
+mate_mixer_context_get_backend_type (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_UNKNOWN);
+
+    if (context->priv->backend_chosen == FALSE)
+        return MATE_MIXER_BACKEND_UNKNOWN;
+
+    return mate_mixer_backend_module_get_info (context->priv->module)->backend_type;
+}
+
+/**
+ * mate_mixer_context_get_backend_flags:
+ * @context: a #MateMixerContext
+ *
+ * Gets the capability flags of the currently used sound system backend.
+ *
+ * This function will not work until the @context is connected to a sound system.
+ *
+ * Returns: the capability flags.
+ */
+MateMixerBackendFlags
+mate_mixer_context_get_backend_flags (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_NO_FLAGS);
+
+    if (context->priv->backend_chosen == FALSE)
+        return MATE_MIXER_BACKEND_NO_FLAGS;
+
+    return mate_mixer_backend_module_get_info (context->priv->module)->backend_flags;
+}
+
+/**
+ * mate_mixer_context_get_statistics:
+ * @context: a #MateMixerContext
+ *
+ * Gets a snapshot of the performance counters of the @context's connection
+ * to a sound system.
+ *
+ * The counters start when the connection is established and can be reset using
+ * mate_mixer_context_reset_statistics().
+ *
+ * The @context must be in the %MATE_MIXER_STATE_READY state, otherwise %NULL is
+ * returned.
+ *
+ * Returns: a new #MateMixerStatistics, free it with mate_mixer_statistics_free(),
+ * or %NULL on failure.
+ */
+MateMixerStatistics *
+mate_mixer_context_get_statistics (MateMixerContext *context)
+{
+    MateMixerStatistics *statistics;
+
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return NULL;
+
+    statistics = mate_mixer_statistics_copy (_mate_mixer_backend_get_statistics (context->priv->backend));
+
+    statistics->elapsed_time = g_get_monotonic_time () - statistics->start_time;
+    if (statistics->elapsed_time > 0)
+        statistics->monitor_rate = statistics->monitor_values * (gdouble) G_USEC_PER_SEC /
+                                   statistics->elapsed_time;
+
+    return statistics;
+}
+
+/**
+ * mate_mixer_context_reset_statistics:
+ * @context: a #MateMixerContext
+ *
+ * Resets the performance counters of the @context's connection to a sound
+ * system. The current number of objects and operations in flight is kept.
+ */
+void
+mate_mixer_context_reset_statistics (MateMixerContext *context)
+{
+    g_return_if_fail (MATE_MIXER_IS_CONTEXT (context));
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return;
+
+    _mate_mixer_statistics_reset (_mate_mixer_backend_get_statistics (context->priv->backend));
+}
+
+static void
+on_backend_state_notify (MateMixerBackend *backend,
+                         GParamSpec       *pspec,
+                         MateMixerContext *context)
+{
+    MateMixerState state = mate_mixer_backend_get_state (backend);
+
+    switch (state) {
+    case MATE_MIXER_STATE_CONNECTING:
+        g_debug ("Backend %s changed state to CONNECTING",
+                 mate_mixer_backend_module_get_info (context->priv->module)->name);
+
+        change_state (context, state);
+        break;
+
+    case MATE_MIXER_STATE_READY:
+        g_debug ("Backend %s changed state to READY",
+                 mate_mixer_backend_module_get_info (context->priv->module)->name);
+
+        change_state (context, state);
+        break;
+
+    case MATE_MIXER_STATE_FAILED:
+        g_debug ("Backend %s changed state to FAILED",
+                 mate_mixer_backend_module_get_info (context->priv->module)->name);
+
+        if (context->priv->backend_type == MATE_MIXER_BACKEND_UNKNOWN) {
+            /* User didn't request a specific backend, so try another one */
+            try_next_backend (context);
+        } else {
+            /* User requested a specific backend and it failed */
+            close_context (context);
             change_state (context, state);
         }
         break;
@@ -1255,6 +1883,9 @@ on_backend_device_added (MateMixerBackend *backend,
                          const gchar      *name,
                          MateMixerContext *context)
 {
+    if (context->priv->snapshot_settle_source != NULL)
+        settle_snapshot (context);
+
     g_signal_emit (G_OBJECT (context),
                    signals[DEVICE_ADDED],
                    0,
@@ -1266,6 +1897,9 @@ on_backend_device_removed (MateMixerBackend *backend,
                            const gchar      *name,
                            MateMixerContext *context)
 {
+    if (context->priv->snapshot_settle_source != NULL)
+        settle_snapshot (context);
+
     g_signal_emit (G_OBJECT (context),
                    signals[DEVICE_REMOVED],
                    0,
@@ -1277,6 +1911,9 @@ on_backend_stream_added (MateMixerBackend *backend,
                          const gchar      *name,
                          MateMixerContext *context)
 {
+    if (context->priv->snapshot_settle_source != NULL)
+        settle_snapshot (context);
+
     g_signal_emit (G_OBJECT (context),
                    signals[STREAM_ADDED],
                    0,
@@ -1288,6 +1925,9 @@ on_backend_stream_removed (MateMixerBackend *backend,
                            const gchar      *name,
                            MateMixerContext *context)
 {
+    if (context->priv->snapshot_settle_source != NULL)
+        settle_snapshot (context);
+
     g_signal_emit (G_OBJECT (context),
                    signals[STREAM_REMOVED],
                    0,
@@ -1316,6 +1956,29 @@ on_backend_stored_control_removed (MateMixerBackend *backend,
                    name);
 }
 
+static void
+on_backend_transaction_completed (MateMixerBackend     *backend,
+                                  MateMixerTransaction *transaction,
+                                  gboolean              success,
+                                  MateMixerContext     *context)
+{
+    /* The backend may be shared with other contexts, only the context which
+     * committed the transaction is interested in the result */
+    if (_mate_mixer_transaction_get_owner (transaction) != context)
+        return;
+
+    g_signal_emit (G_OBJECT (context),
+                   signals[TRANSACTION_COMPLETED],
+                   0,
+                   transaction,
+                   success);
+
+    /* The device switches of a snapshot have been changed, wait for the
+     * streams to settle before applying the rest of it */
+    if (transaction == context->priv->snapshot_transaction)
+        settle_snapshot (context);
+}
+
 static void
 on_backend_default_input_stream_notify (MateMixerBackend *backend,
                                         GParamSpec       *pspec,
@@ -1354,6 +2017,10 @@ try_next_backend (MateMixerContext *context)
     }
     close_context (context);
 
+    /* Probe all the remaining backends at once when probing is enabled */
+    if (module != NULL && context->priv->probe_timeout > 0)
+        return probe_backends (context, modules->next);
+
     if (module == NULL) {
         /* We have tried all the modules and all of them failed */
         change_state (context, MATE_MIXER_STATE_FAILED);
@@ -1367,6 +2034,7 @@ try_next_backend (MateMixerContext *context)
 
     mate_mixer_backend_set_app_info (context->priv->backend, context->priv->app_info);
     mate_mixer_backend_set_server_address (context->priv->backend, context->priv->server_address);
+    mate_mixer_backend_set_interests (context->priv->backend, context->priv->interests);
 
     g_debug ("Trying to open backend %s", info->name);
 
@@ -1385,6 +2053,8 @@ try_next_backend (MateMixerContext *context)
         return try_next_backend (context);
     }
 
+    register_backend (context);
+
     g_signal_connect (G_OBJECT (context->priv->backend),
                       "notify::state",
                       G_CALLBACK (on_backend_state_notify),
@@ -1394,6 +2064,342 @@ try_next_backend (MateMixerContext *context)
     return TRUE;
 }
 
+static void
+on_probe_state_notify (MateMixerBackend *backend,
+                       GParamSpec       *pspec,
+                       MateMixerContext *context)
+{
+    probe_select (context);
+}
+
+static gboolean
+probe_backends (MateMixerContext *context, const GList *modules)
+{
+    while (modules != NULL) {
+        MateMixerBackendModule     *module;
+        MateMixerBackend           *backend;
+        MateMixerState              state;
+        const MateMixerBackendInfo *info;
+        ContextProbe               *probe;
+
+        module = MATE_MIXER_BACKEND_MODULE (modules->data);
+        info   = mate_mixer_backend_module_get_info (module);
+
+        modules = modules->next;
+
+        backend = g_object_new (info->g_type, NULL);
+
+        mate_mixer_backend_set_app_info (backend, context->priv->app_info);
+        mate_mixer_backend_set_server_address (backend, context->priv->server_address);
+        mate_mixer_backend_set_interests (backend, context->priv->interests);
+
+        g_debug ("Probing backend %s", info->name);
+
+        if (mate_mixer_backend_open (backend) == FALSE) {
+            g_object_unref (backend);
+            continue;
+        }
+
+        state = mate_mixer_backend_get_state (backend);
+
+        if (G_UNLIKELY (state != MATE_MIXER_STATE_READY &&
+                        state != MATE_MIXER_STATE_CONNECTING)) {
+            /* This would be a backend bug */
+            g_warn_if_reached ();
+
+            mate_mixer_backend_close (backend);
+            g_object_unref (backend);
+            continue;
+        }
+
+        probe = g_slice_new (ContextProbe);
+        probe->module  = g_object_ref (module);
+        probe->backend = backend;
+
+        /* The modules are sorted by priority, so are the probes */
+        context->priv->probes = g_list_append (context->priv->probes, probe);
+
+        g_signal_connect (G_OBJECT (backend),
+                          "notify::state",
+                          G_CALLBACK (on_probe_state_notify),
+                          context);
+
+        /* There is no need to start the remaining backends if this one is ready
+         * and no other backend with a higher priority is still connecting */
+        if (state == MATE_MIXER_STATE_READY && context->priv->probes->data == probe)
+            break;
+    }
+
+    if (context->priv->probes == NULL) {
+        /* All the backends have failed to open */
+        change_state (context, MATE_MIXER_STATE_FAILED);
+        return FALSE;
+    }
+
+    context->priv->probe_expired = FALSE;
+    /* The deadline runs in the main context of the thread which opens the
+     * context, where the backends deliver their state changes */
+    context->priv->probe_timeout_source = g_timeout_source_new (context->priv->probe_timeout);
+    g_source_set_callback (context->priv->probe_timeout_source,
+                           (GSourceFunc) probe_timeout,
+                           context,
+                           NULL);
+    g_source_attach (context->priv->probe_timeout_source,
+                     g_main_context_get_thread_default ());
+
+    change_state (context, MATE_MIXER_STATE_CONNECTING);
+
+    /* Some of the backends might have already reached the ready state */
+    probe_select (context);
+
+    return context->priv->state != MATE_MIXER_STATE_FAILED;
+}
+
+static gboolean
+probe_timeout (MateMixerContext *context)
+{
+    g_clear_pointer (&context->priv->probe_timeout_source, g_source_unref);
+    context->priv->probe_expired = TRUE;
+
+    g_debug ("Backend probing deadline has expired");
+
+    /* From now on, use whichever backend becomes ready first */
+    probe_select (context);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+probe_select (MateMixerContext *context)
+{
+    GList *list;
+
+    list = context->priv->probes;
+    while (list != NULL) {
+        ContextProbe  *probe = list->data;
+        GList         *next = list->next;
+        MateMixerState state;
+
+        state = mate_mixer_backend_get_state (probe->backend);
+
+        if (state == MATE_MIXER_STATE_READY) {
+            /* Take over the selected backend and close the remaining ones */
+            context->priv->probes = g_list_delete_link (context->priv->probes, list);
+
+            g_signal_handlers_disconnect_by_func (G_OBJECT (probe->backend),
+                                                  on_probe_state_notify,
+                                                  context);
+
+            close_probes (context);
+
+            use_backend (context, probe->module, probe->backend);
+
+            g_slice_free (ContextProbe, probe);
+            return;
+        }
+
+        if (state != MATE_MIXER_STATE_CONNECTING) {
+            g_debug ("Backend %s has failed while probing",
+                     mate_mixer_backend_module_get_info (probe->module)->name);
+
+            context->priv->probes = g_list_delete_link (context->priv->probes, list);
+            probe_free (probe);
+        } else {
+            /* Keep waiting for a higher priority backend to finish connecting
+             * unless the deadline has passed */
+            if (context->priv->probe_expired == FALSE)
+                return;
+        }
+        list = next;
+    }
+
+    if (context->priv->probes == NULL) {
+        /* We have probed all the backends and all of them failed */
+        close_probes (context);
+        change_state (context, MATE_MIXER_STATE_FAILED);
+    }
+}
+
+static void
+probe_free (ContextProbe *probe)
+{
+    g_signal_handlers_disconnect_matched (G_OBJECT (probe->backend),
+                                          G_SIGNAL_MATCH_FUNC,
+                                          0, 0, NULL,
+                                          on_probe_state_notify,
+                                          NULL);
+
+    mate_mixer_backend_close (probe->backend);
+
+    g_object_unref (probe->backend);
+    g_object_unref (probe->module);
+
+    g_slice_free (ContextProbe, probe);
+}
+
+static void
+close_probes (MateMixerContext *context)
+{
+    if (context->priv->probe_timeout_source != NULL) {
+        g_source_destroy (context->priv->probe_timeout_source);
+        g_clear_pointer (&context->priv->probe_timeout_source, g_source_unref);
+    }
+
+    g_list_free_full (context->priv->probes, (GDestroyNotify) probe_free);
+
+    context->priv->probes = NULL;
+}
+
+static void
+use_backend (MateMixerContext       *context,
+             MateMixerBackendModule *module,
+             MateMixerBackend       *backend)
+{
+    g_debug ("Selected backend %s",
+             mate_mixer_backend_module_get_info (module)->name);
+
+    /* Takes ownership of the module and backend references */
+    context->priv->module  = module;
+    context->priv->backend = backend;
+
+    register_backend (context);
+
+    g_signal_connect (G_OBJECT (context->priv->backend),
+                      "notify::state",
+                      G_CALLBACK (on_backend_state_notify),
+                      context);
+
+    change_state (context, mate_mixer_backend_get_state (backend));
+}
+
+static gboolean
+share_backend (MateMixerContext *context)
+{
+    ContextShared  *found = NULL;
+    GMainContext   *main_context;
+    GList          *list;
+    MateMixerState  state = MATE_MIXER_STATE_UNKNOWN;
+
+    main_context = g_main_context_ref_thread_default ();
+
+    G_LOCK (shared_backends);
+
+    list = shared_backends;
+    while (list != NULL) {
+        ContextShared              *shared = list->data;
+        const MateMixerBackendInfo *info;
+
+        list = list->next;
+
+        if (shared->main_context != main_context)
+            continue;
+
+        info = mate_mixer_backend_module_get_info (shared->module);
+
+        if (context->priv->backend_type != MATE_MIXER_BACKEND_UNKNOWN &&
+            context->priv->backend_type != info->backend_type)
+            continue;
+
+        if (g_strcmp0 (context->priv->server_address, shared->server_address) != 0)
+            continue;
+
+        /* The backend may have skipped some kinds of objects the context wants */
+        if ((shared->interests & context->priv->interests) != context->priv->interests)
+            continue;
+
+        /* Do not join a backend which is on its way out */
+        state = mate_mixer_backend_get_state (shared->backend);
+        if (state != MATE_MIXER_STATE_READY &&
+            state != MATE_MIXER_STATE_CONNECTING)
+            continue;
+
+        g_debug ("Sharing backend %s with %u other context(s)",
+                 info->name,
+                 shared->users);
+
+        shared->users++;
+
+        context->priv->module  = g_object_ref (shared->module);
+        context->priv->backend = g_object_ref (shared->backend);
+
+        found = shared;
+        break;
+    }
+
+    G_UNLOCK (shared_backends);
+
+    g_main_context_unref (main_context);
+
+    if (found == NULL)
+        return FALSE;
+
+    change_state (context, MATE_MIXER_STATE_CONNECTING);
+
+    g_signal_connect (G_OBJECT (context->priv->backend),
+                      "notify::state",
+                      G_CALLBACK (on_backend_state_notify),
+                      context);
+
+    change_state (context, state);
+    return TRUE;
+}
+
+static void
+register_backend (MateMixerContext *context)
+{
+    ContextShared *shared;
+
+    /* Only connections of contexts which allow sharing are offered to the
+     * other contexts */
+    if (context->priv->share_backend == FALSE)
+        return;
+
+    shared = g_slice_new (ContextShared);
+    shared->module         = context->priv->module;
+    shared->backend        = context->priv->backend;
+    shared->main_context   = g_main_context_ref_thread_default ();
+    shared->server_address = g_strdup (context->priv->server_address);
+    shared->interests      = context->priv->interests;
+    shared->users          = 1;
+
+    G_LOCK (shared_backends);
+    shared_backends = g_list_prepend (shared_backends, shared);
+    G_UNLOCK (shared_backends);
+}
+
+static void
+release_backend (MateMixerContext *context)
+{
+    GList *list;
+
+    G_LOCK (shared_backends);
+
+    list = shared_backends;
+    while (list != NULL) {
+        ContextShared *shared = list->data;
+
+        if (shared->backend == context->priv->backend) {
+            /* The backend stays open until the last context sharing it closes */
+            if (--shared->users > 0) {
+                G_UNLOCK (shared_backends);
+                return;
+            }
+
+            shared_backends = g_list_delete_link (shared_backends, list);
+
+            g_main_context_unref (shared->main_context);
+            g_free (shared->server_address);
+            g_slice_free (ContextShared, shared);
+            break;
+        }
+        list = list->next;
+    }
+
+    G_UNLOCK (shared_backends);
+
+    mate_mixer_backend_close (context->priv->backend);
+}
+
 static void
 change_state (MateMixerContext *context, MateMixerState state)
 {
@@ -1431,6 +2437,10 @@ change_state (MateMixerContext *context, MateMixerState state)
                           "stored-control-removed",
                           G_CALLBACK (on_backend_stored_control_removed),
                           context);
+        g_signal_connect (G_OBJECT (context->priv->backend),
+                          "transaction-completed",
+                          G_CALLBACK (on_backend_transaction_completed),
+                          context);
 
         g_signal_connect (G_OBJECT (context->priv->backend),
                           "notify::default-input-stream",
@@ -1450,11 +2460,14 @@ change_state (MateMixerContext *context, MateMixerState state)
 static void
 close_context (MateMixerContext *context)
 {
+    close_probes (context);
+    cancel_snapshot (context);
+
     if (context->priv->backend != NULL) {
         g_signal_handlers_disconnect_by_data (G_OBJECT (context->priv->backend),
                                               context);
 
-        mate_mixer_backend_close (context->priv->backend);
+        release_backend (context);
         g_clear_object (&context->priv->backend);
     }
 
@@ -1462,3 +2475,187 @@ close_context (MateMixerContext *context)
 
     context->priv->backend_chosen = FALSE;
 }
+
+static gboolean
+apply_snapshot_streams (MateMixerContext *context, GVariant *snapshot)
+{
+    MateMixerTransaction *transaction;
+    gboolean              ret = TRUE;
+
+    transaction = _mate_mixer_transaction_new ();
+
+    if (_mate_mixer_snapshot_diff (context->priv->backend,
+                                   mate_mixer_context_get_backend_flags (context),
+                                   snapshot,
+                                   MATE_MIXER_SNAPSHOT_PHASE_STREAMS,
+                                   transaction) > 0) {
+        _mate_mixer_transaction_set_committed (transaction, context);
+
+        ret = mate_mixer_backend_commit_transaction (context->priv->backend, transaction);
+    }
+
+    mate_mixer_transaction_unref (transaction);
+    return ret;
+}
+
+static void
+settle_snapshot (MateMixerContext *context)
+{
+    /* Streams of the changed devices are added and removed as the backend
+     * learns about them, the timeout restarts on each such change */
+    if (context->priv->snapshot_settle_source != NULL) {
+        g_source_destroy (context->priv->snapshot_settle_source);
+        g_source_unref (context->priv->snapshot_settle_source);
+    }
+
+    context->priv->snapshot_settle_source = g_timeout_source_new (SNAPSHOT_SETTLE_TIMEOUT);
+    g_source_set_callback (context->priv->snapshot_settle_source,
+                           (GSourceFunc) settle_snapshot_timeout,
+                           context,
+                           NULL);
+    g_source_attach (context->priv->snapshot_settle_source,
+                     g_main_context_get_thread_default ());
+}
+
+static gboolean
+settle_snapshot_timeout (MateMixerContext *context)
+{
+    GVariant *snapshot;
+
+    g_clear_pointer (&context->priv->snapshot_settle_source, g_source_unref);
+
+    snapshot = g_variant_ref (context->priv->snapshot);
+    cancel_snapshot (context);
+
+    if (context->priv->state == MATE_MIXER_STATE_READY)
+        apply_snapshot_streams (context, snapshot);
+
+    g_variant_unref (snapshot);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+cancel_snapshot (MateMixerContext *context)
+{
+    if (context->priv->snapshot_settle_source != NULL) {
+        g_source_destroy (context->priv->snapshot_settle_source);
+        g_clear_pointer (&context->priv->snapshot_settle_source, g_source_unref);
+    }
+
+    if (context->priv->snapshot_transaction != NULL) {
+        mate_mixer_transaction_unref (context->priv->snapshot_transaction);
+        context->priv->snapshot_transaction = NULL;
+    }
+
+    g_clear_pointer (&context->priv->snapshot, g_variant_unref);
+}
+
+static gboolean
+transaction_is_local (MateMixerContext *context, MateMixerTransaction *transaction)
+{
+    const GList *list;
+
+    /* The transaction is only valid if every object it refers to belongs to
+     * the backend of the context, the objects are checked one by one to avoid
+     * walking the whole model and creating the lazily built lists */
+    list = _mate_mixer_transaction_list_operations (transaction);
+    while (list != NULL) {
+        MateMixerTransactionOperation *op = list->data;
+
+        if (op->control != NULL && control_is_local (context, op->control) == FALSE)
+            return FALSE;
+        if (op->stream != NULL && stream_is_local (context, op->stream) == FALSE)
+            return FALSE;
+
+        if (op->swtch != NULL) {
+            if (switch_is_local (context, op->swtch) == FALSE)
+                return FALSE;
+
+            if (op->option != NULL &&
+                mate_mixer_switch_get_option (op->swtch,
+                                              mate_mixer_switch_option_get_name (op->option)) != op->option)
+                return FALSE;
+        }
+        list = list->next;
+    }
+    return TRUE;
+}
+
+static gboolean
+stream_is_local (MateMixerContext *context, MateMixerStream *stream)
+{
+    const gchar *name;
+
+    name = mate_mixer_stream_get_name (stream);
+    if (G_UNLIKELY (name == NULL))
+        return FALSE;
+
+    return mate_mixer_backend_get_stream (context->priv->backend, name) == stream;
+}
+
+static gboolean
+control_is_local (MateMixerContext *context, MateMixerStreamControl *control)
+{
+    MateMixerStream *stream;
+    const gchar     *name;
+
+    /* Aggregate controls belong to the context when all their members do,
+     * changing them changes the members */
+    if (MATE_MIXER_IS_AGGREGATE_CONTROL (control)) {
+        const GList *list;
+
+        list = mate_mixer_aggregate_control_list_controls (MATE_MIXER_AGGREGATE_CONTROL (control));
+        while (list != NULL) {
+            if (control_is_local (context, MATE_MIXER_STREAM_CONTROL (list->data)) == FALSE)
+                return FALSE;
+
+            list = list->next;
+        }
+        return TRUE;
+    }
+
+    stream = mate_mixer_stream_control_get_stream (control);
+    if (stream != NULL)
+        return stream_is_local (context, stream);
+
+    /* Controls without a stream are only valid as stored controls */
+    if (MATE_MIXER_IS_STORED_CONTROL (control) == FALSE)
+        return FALSE;
+
+    name = mate_mixer_stream_control_get_name (control);
+    if (G_UNLIKELY (name == NULL))
+        return FALSE;
+
+    return MATE_MIXER_STREAM_CONTROL (mate_mixer_backend_get_stored_control (context->priv->backend,
+                                                                             name)) == control;
+}
+
+static gboolean
+switch_is_local (MateMixerContext *context, MateMixerSwitch *swtch)
+{
+    if (MATE_MIXER_IS_STREAM_SWITCH (swtch)) {
+        MateMixerStream *stream;
+
+        stream = mate_mixer_stream_switch_get_stream (MATE_MIXER_STREAM_SWITCH (swtch));
+        if (stream == NULL)
+            return FALSE;
+
+        return stream_is_local (context, stream);
+    }
+
+    if (MATE_MIXER_IS_DEVICE_SWITCH (swtch)) {
+        MateMixerDevice *device;
+        const gchar     *name;
+
+        device = mate_mixer_device_switch_get_device (MATE_MIXER_DEVICE_SWITCH (swtch));
+        if (device == NULL)
+            return FALSE;
+
+        name = mate_mixer_device_get_name (device);
+        if (G_UNLIKELY (name == NULL))
+            return FALSE;
+
+        return mate_mixer_backend_get_device (context->priv->backend, name) == device;
+    }
+    return FALSE;
+}
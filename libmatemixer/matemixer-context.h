@@ -79,6 +79,9 @@ struct _MateMixerContextClass
                                     const gchar      *name);
     void (*stored_control_removed) (MateMixerContext *context,
                                     const gchar      *name);
+    void (*transaction_completed)  (MateMixerContext     *context,
+                                    MateMixerTransaction *transaction,
+                                    gboolean              success);
 };
 
 GType                   mate_mixer_context_get_type                  (void) G_GNUC_CONST;
@@ -97,6 +100,16 @@ gboolean                mate_mixer_context_set_app_icon              (MateMixerC
                                                                       const gchar          *app_icon);
 gboolean                mate_mixer_context_set_server_address        (MateMixerContext     *context,
                                                                       const gchar          *address);
+gboolean                mate_mixer_context_set_probe_timeout         (MateMixerContext     *context,
+                                                                      guint                 timeout);
+
+MateMixerInterestFlags  mate_mixer_context_get_interests             (MateMixerContext     *context);
+gboolean                mate_mixer_context_set_interests             (MateMixerContext     *context,
+                                                                      MateMixerInterestFlags interests);
+
+gboolean                mate_mixer_context_get_share_backend         (MateMixerContext     *context);
+gboolean                mate_mixer_context_set_share_backend         (MateMixerContext     *context,
+                                                                      gboolean              share);
 
 gboolean                mate_mixer_context_open                      (MateMixerContext     *context);
 void                    mate_mixer_context_close                     (MateMixerContext     *context);
@@ -114,6 +127,10 @@ const GList *           mate_mixer_context_list_devices              (MateMixerC
 const GList *           mate_mixer_context_list_streams              (MateMixerContext     *context);
 const GList *           mate_mixer_context_list_stored_controls      (MateMixerContext     *context);
 
+guint                   mate_mixer_context_read_controls             (MateMixerContext            *context,
+                                                                      MateMixerStreamControlState *states,
+                                                                      guint                        n_states);
+
 MateMixerStream *       mate_mixer_context_get_default_input_stream  (MateMixerContext     *context);
 gboolean                mate_mixer_context_set_default_input_stream  (MateMixerContext     *context,
                                                                       MateMixerStream      *stream);
@@ -122,10 +139,21 @@ MateMixerStream *       mate_mixer_context_get_default_output_stream (MateMixerC
 gboolean                mate_mixer_context_set_default_output_stream (MateMixerContext     *context,
                                                                       MateMixerStream      *stream);
 
+MateMixerTransaction *  mate_mixer_context_begin_transaction         (MateMixerContext     *context);
+gboolean                mate_mixer_context_commit_transaction        (MateMixerContext     *context,
+                                                                      MateMixerTransaction *transaction);
+
+GVariant *              mate_mixer_context_capture_snapshot          (MateMixerContext     *context);
+gboolean                mate_mixer_context_apply_snapshot            (MateMixerContext     *context,
+                                                                      GVariant             *snapshot);
+
 const gchar *           mate_mixer_context_get_backend_name          (MateMixerContext     *context);
 MateMixerBackendType    mate_mixer_context_get_backend_type          (MateMixerContext     *context);
 MateMixerBackendFlags   mate_mixer_context_get_backend_flags         (MateMixerContext     *context);
 
+MateMixerStatistics *   mate_mixer_context_get_statistics            (MateMixerContext     *context);
+void                    mate_mixer_context_reset_statistics          (MateMixerContext     *context);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_CONTEXT_H */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_DECIBEL_SCALE_PRIVATE_H
+#define MATEMIXER_DECIBEL_SCALE_PRIVATE_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Implemented by the stream controls which can convert any volume on their
+ * scale to decibels and back, without changing the control. It is kept out
+ * of the class structure of MateMixerStreamControl, which is public.
+ */
+#define MATE_MIXER_TYPE_DECIBEL_SCALE                   \
+        (_mate_mixer_decibel_scale_get_type ())
+#define MATE_MIXER_DECIBEL_SCALE(o)                     \
+        (G_TYPE_CHECK_INSTANCE_CAST ((o), MATE_MIXER_TYPE_DECIBEL_SCALE, MateMixerDecibelScale))
+#define MATE_MIXER_IS_DECIBEL_SCALE(o)                  \
+        (G_TYPE_CHECK_INSTANCE_TYPE ((o), MATE_MIXER_TYPE_DECIBEL_SCALE))
+#define MATE_MIXER_DECIBEL_SCALE_GET_INTERFACE(o)       \
+        (G_TYPE_INSTANCE_GET_INTERFACE ((o), MATE_MIXER_TYPE_DECIBEL_SCALE, MateMixerDecibelScaleInterface))
+
+typedef struct _MateMixerDecibelScale           MateMixerDecibelScale;
+typedef struct _MateMixerDecibelScaleInterface  MateMixerDecibelScaleInterface;
+
+struct _MateMixerDecibelScaleInterface
+{
+    GTypeInterface parent_iface;
+
+    gboolean (*get_decibel_from_volume) (MateMixerDecibelScale *scale,
+                                         guint                  volume,
+                                         gdouble               *decibel);
+    gboolean (*get_volume_from_decibel) (MateMixerDecibelScale *scale,
+                                         gdouble                decibel,
+                                         guint                 *volume);
+};
+
+GType _mate_mixer_decibel_scale_get_type (void) G_GNUC_CONST;
+
+G_END_DECLS
+
+#endif /* MATEMIXER_DECIBEL_SCALE_PRIVATE_H */
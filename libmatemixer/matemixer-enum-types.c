@@ -56,6 +56,8 @@ mate_mixer_backend_type_get_type (void)
             { MATE_MIXER_BACKEND_ALSA, "MATE_MIXER_BACKEND_ALSA", "alsa" },
             { MATE_MIXER_BACKEND_OSS, "MATE_MIXER_BACKEND_OSS", "oss" },
             { MATE_MIXER_BACKEND_NULL, "MATE_MIXER_BACKEND_NULL", "null" },
+            { MATE_MIXER_BACKEND_BROKER, "MATE_MIXER_BACKEND_BROKER", "broker" },
+            { MATE_MIXER_BACKEND_PIPEWIRE, "MATE_MIXER_BACKEND_PIPEWIRE", "pipewire" },
             { 0, NULL, NULL }
         };
         etype = g_enum_register_static (
@@ -86,6 +88,28 @@ mate_mixer_backend_flags_get_type (void)
     return etype;
 }
 
+GType
+mate_mixer_interest_flags_get_type (void)
+{
+    static GType etype = 0;
+
+    if (etype == 0) {
+        static const GFlagsValue values[] = {
+            { MATE_MIXER_INTEREST_NO_FLAGS, "MATE_MIXER_INTEREST_NO_FLAGS", "no-flags" },
+            { MATE_MIXER_INTEREST_DEVICES, "MATE_MIXER_INTEREST_DEVICES", "devices" },
+            { MATE_MIXER_INTEREST_STREAMS, "MATE_MIXER_INTEREST_STREAMS", "streams" },
+            { MATE_MIXER_INTEREST_APPLICATION_CONTROLS, "MATE_MIXER_INTEREST_APPLICATION_CONTROLS", "application-controls" },
+            { MATE_MIXER_INTEREST_STORED_CONTROLS, "MATE_MIXER_INTEREST_STORED_CONTROLS", "stored-controls" },
+            { MATE_MIXER_INTEREST_ALL, "MATE_MIXER_INTEREST_ALL", "all" },
+            { 0, NULL, NULL }
+        };
+        etype = g_flags_register_static (
+            g_intern_static_string ("MateMixerInterestFlags"),
+            values);
+    }
+    return etype;
+}
+
 GType
 mate_mixer_direction_get_type (void)
 {
@@ -280,3 +304,25 @@ mate_mixer_channel_position_get_type (void)
     }
     return etype;
 }
+
+GType
+mate_mixer_statistics_event_get_type (void)
+{
+    static GType etype = 0;
+
+    if (etype == 0) {
+        static const GEnumValue values[] = {
+            { MATE_MIXER_STATISTICS_EVENT_SERVER, "MATE_MIXER_STATISTICS_EVENT_SERVER", "server" },
+            { MATE_MIXER_STATISTICS_EVENT_DEVICE, "MATE_MIXER_STATISTICS_EVENT_DEVICE", "device" },
+            { MATE_MIXER_STATISTICS_EVENT_STREAM, "MATE_MIXER_STATISTICS_EVENT_STREAM", "stream" },
+            { MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL, "MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL", "stream-control" },
+            { MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL, "MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL", "stored-control" },
+            { MATE_MIXER_STATISTICS_EVENT_OTHER, "MATE_MIXER_STATISTICS_EVENT_OTHER", "other" },
+            { 0, NULL, NULL }
+        };
+        etype = g_enum_register_static (
+            g_intern_static_string ("MateMixerStatisticsEvent"),
+            values);
+    }
+    return etype;
+}
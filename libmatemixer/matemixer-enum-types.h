@@ -37,6 +37,9 @@ GType mate_mixer_backend_type_get_type (void) G_GNUC_CONST;
 #define MATE_MIXER_TYPE_BACKEND_FLAGS (mate_mixer_backend_flags_get_type ())
 GType mate_mixer_backend_flags_get_type (void) G_GNUC_CONST;
 
+#define MATE_MIXER_TYPE_INTEREST_FLAGS (mate_mixer_interest_flags_get_type ())
+GType mate_mixer_interest_flags_get_type (void) G_GNUC_CONST;
+
 #define MATE_MIXER_TYPE_DIRECTION (mate_mixer_direction_get_type ())
 GType mate_mixer_direction_get_type (void) G_GNUC_CONST;
 
@@ -61,6 +64,9 @@ GType mate_mixer_stream_switch_role_get_type (void) G_GNUC_CONST;
 #define MATE_MIXER_TYPE_CHANNEL_POSITION (mate_mixer_channel_position_get_type ())
 GType mate_mixer_channel_position_get_type (void) G_GNUC_CONST;
 
+#define MATE_MIXER_TYPE_STATISTICS_EVENT (mate_mixer_statistics_event_get_type ())
+GType mate_mixer_statistics_event_get_type (void) G_GNUC_CONST;
+
 G_END_DECLS
 
 #endif /* MATEMIXER_ENUM_TYPES_H */
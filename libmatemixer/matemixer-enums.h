@@ -51,9 +51,10 @@ typedef enum {
  * @MATE_MIXER_BACKEND_UNKNOWN:
  *     Unknown or undefined sound system backend type.
  * @MATE_MIXER_BACKEND_PULSEAUDIO:
- *     PulseAudio sound system backend. It has the highest priority and
- *     will be the first one to try when you call mate_mixer_context_open(),
- *     unless you select a specific sound system to connect to.
+ *     PulseAudio sound system backend. It has the highest priority of the
+ *     sound systems after PipeWire and will be tried when you call
+ *     mate_mixer_context_open(), unless you select a specific sound system
+ *     to connect to.
  * @MATE_MIXER_BACKEND_ALSA:
  *     The Advanced Linux Sound Architecture sound system.
  * @MATE_MIXER_BACKEND_OSS:
@@ -63,6 +64,16 @@ typedef enum {
  *     functionality. This backend has the lowest priority and will be used
  *     if you do not select a specific backend and it isn't possible to use
  *     any of the other backends.
+ * @MATE_MIXER_BACKEND_BROKER:
+ *     Client of the mixer broker, a session daemon which shares a single
+ *     connection to one of the other sound systems between all the
+ *     applications of the session. The broker is only tried after all the
+ *     sound systems have failed, select it explicitly with
+ *     mate_mixer_context_set_backend_type() to use it.
+ * @MATE_MIXER_BACKEND_PIPEWIRE:
+ *     PipeWire sound system backend. It is tried before PulseAudio, the
+ *     library falls back to the other sound systems if the PipeWire server
+ *     is not running.
  *
  * Constants identifying a sound system backend.
  */
@@ -71,7 +82,9 @@ typedef enum {
     MATE_MIXER_BACKEND_PULSEAUDIO,
     MATE_MIXER_BACKEND_ALSA,
     MATE_MIXER_BACKEND_OSS,
-    MATE_MIXER_BACKEND_NULL
+    MATE_MIXER_BACKEND_NULL,
+    MATE_MIXER_BACKEND_BROKER,
+    MATE_MIXER_BACKEND_PIPEWIRE
 } MateMixerBackendType;
 
 /**
@@ -103,6 +116,35 @@ typedef enum { /*< flags >*/
     MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM = 1 << 3
 } MateMixerBackendFlags;
 
+/**
+ * MateMixerInterestFlags:
+ * @MATE_MIXER_INTEREST_NO_FLAGS:
+ *     No flags.
+ * @MATE_MIXER_INTEREST_DEVICES:
+ *     The application uses devices and their switches.
+ * @MATE_MIXER_INTEREST_STREAMS:
+ *     The application uses streams, including the default input and output
+ *     streams.
+ * @MATE_MIXER_INTEREST_APPLICATION_CONTROLS:
+ *     The application uses the stream controls of other applications.
+ * @MATE_MIXER_INTEREST_STORED_CONTROLS:
+ *     The application uses stored controls.
+ * @MATE_MIXER_INTEREST_ALL:
+ *     The application uses all kinds of objects, this is the default.
+ *
+ * Flags describing the kinds of objects an application is interested in.
+ * Sound system backends may skip downloading and tracking the kinds of
+ * objects which were not requested. See mate_mixer_context_set_interests().
+ */
+typedef enum { /*< flags >*/
+    MATE_MIXER_INTEREST_NO_FLAGS             = 0,
+    MATE_MIXER_INTEREST_DEVICES              = 1 << 0,
+    MATE_MIXER_INTEREST_STREAMS              = 1 << 1,
+    MATE_MIXER_INTEREST_APPLICATION_CONTROLS = 1 << 2,
+    MATE_MIXER_INTEREST_STORED_CONTROLS      = 1 << 3,
+    MATE_MIXER_INTEREST_ALL                  = 0x0f
+} MateMixerInterestFlags;
+
 /**
  * MateMixerDirection:
  * @MATE_MIXER_DIRECTION_UNKNOWN:
@@ -365,4 +407,32 @@ typedef enum {
     MATE_MIXER_CHANNEL_MAX
 } MateMixerChannelPosition;
 
+/**
+ * MateMixerStatisticsEvent:
+ * @MATE_MIXER_STATISTICS_EVENT_SERVER:
+ *     Change of the sound server properties.
+ * @MATE_MIXER_STATISTICS_EVENT_DEVICE:
+ *     Addition, removal or change of a device.
+ * @MATE_MIXER_STATISTICS_EVENT_STREAM:
+ *     Addition, removal or change of a stream.
+ * @MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL:
+ *     Addition, removal or change of a stream control.
+ * @MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL:
+ *     Change of the list of stored controls.
+ * @MATE_MIXER_STATISTICS_EVENT_OTHER:
+ *     Any other event.
+ *
+ * Types of events received from the sound system, see #MateMixerStatistics.
+ */
+typedef enum {
+    MATE_MIXER_STATISTICS_EVENT_SERVER,
+    MATE_MIXER_STATISTICS_EVENT_DEVICE,
+    MATE_MIXER_STATISTICS_EVENT_STREAM,
+    MATE_MIXER_STATISTICS_EVENT_STREAM_CONTROL,
+    MATE_MIXER_STATISTICS_EVENT_STORED_CONTROL,
+    MATE_MIXER_STATISTICS_EVENT_OTHER,
+    /*< private >*/
+    MATE_MIXER_STATISTICS_EVENT_MAX
+} MateMixerStatisticsEvent;
+
 #endif /* MATEMIXER_ENUMS_H */
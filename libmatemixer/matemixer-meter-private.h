@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_METER_PRIVATE_H
+#define MATEMIXER_METER_PRIVATE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Number of the most recent values kept by a meter, must be a power of two */
+#define MATE_MIXER_METER_SIZE 64
+
+typedef struct _MateMixerMeter  MateMixerMeter;
+
+MateMixerMeter *_mate_mixer_meter_new         (void);
+void            _mate_mixer_meter_free        (MateMixerMeter *meter);
+
+void            _mate_mixer_meter_push        (MateMixerMeter *meter,
+                                               gdouble         value);
+
+gboolean        _mate_mixer_meter_read_latest (MateMixerMeter *meter,
+                                               gdouble        *value);
+gboolean        _mate_mixer_meter_read_peak   (MateMixerMeter *meter,
+                                               gdouble        *peak);
+guint           _mate_mixer_meter_copy        (MateMixerMeter *meter,
+                                               gdouble        *values,
+                                               guint           count);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_METER_PRIVATE_H */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "matemixer-meter-private.h"
+
+/*
+ * A meter keeps the most recent monitor values of a stream control in a ring
+ * buffer, which is written by a single producer (the backend in the main
+ * thread) and may be read by a single consumer in any thread without locking.
+ *
+ * The producer stores a value in its slot and then advances the counter of
+ * written values, both using atomic operations. A reader loads the counter,
+ * reads the slots below it and loads the counter again to find out which of
+ * the slots may have been overwritten in the meantime.
+ *
+ * The values are stored as the bits of a float to allow atomic access.
+ */
+#define METER_MASK (MATE_MIXER_METER_SIZE - 1)
+
+struct _MateMixerMeter
+{
+    gint  written;
+    guint peak_read;
+    gint  values[MATE_MIXER_METER_SIZE];
+};
+
+typedef union {
+    gfloat f;
+    gint   i;
+} MeterValue;
+
+static inline gdouble load_value   (MateMixerMeter *meter, guint index);
+static inline guint   load_written (MateMixerMeter *meter);
+
+MateMixerMeter *
+_mate_mixer_meter_new (void)
+{
+    return g_slice_new0 (MateMixerMeter);
+}
+
+void
+_mate_mixer_meter_free (MateMixerMeter *meter)
+{
+    g_return_if_fail (meter != NULL);
+
+    g_slice_free (MateMixerMeter, meter);
+}
+
+void
+_mate_mixer_meter_push (MateMixerMeter *meter, gdouble value)
+{
+    MeterValue v;
+    guint      written;
+
+    g_return_if_fail (meter != NULL);
+
+    v.f = (gfloat) value;
+
+    /* Only the producer changes the counter, the slot must be filled before
+     * the counter makes it visible to the consumer */
+    written = load_written (meter);
+
+    g_atomic_int_set (&meter->values[written & METER_MASK], v.i);
+    g_atomic_int_set (&meter->written, (gint) (written + 1));
+}
+
+gboolean
+_mate_mixer_meter_read_latest (MateMixerMeter *meter, gdouble *value)
+{
+    guint written;
+
+    g_return_val_if_fail (meter != NULL, FALSE);
+    g_return_val_if_fail (value != NULL, FALSE);
+
+    written = load_written (meter);
+    if (written == 0)
+        return FALSE;
+
+    /* If the slot is overwritten before it is read, the value is newer than
+     * the one we were after, which is still the right answer */
+    *value = load_value (meter, written - 1);
+    return TRUE;
+}
+
+gboolean
+_mate_mixer_meter_read_peak (MateMixerMeter *meter, gdouble *peak)
+{
+    guint   written;
+    guint   index;
+    gdouble value;
+
+    g_return_val_if_fail (meter != NULL, FALSE);
+    g_return_val_if_fail (peak != NULL, FALSE);
+
+    written = load_written (meter);
+    if (written == meter->peak_read)
+        return FALSE;
+
+    /* Values older than the ring are gone, overwritten slots hold values
+     * newer than the last read, so they belong to the peak as well */
+    index = meter->peak_read;
+    if (written - index > MATE_MIXER_METER_SIZE)
+        index = written - MATE_MIXER_METER_SIZE;
+
+    *peak = load_value (meter, index++);
+
+    while (index != written) {
+        value = load_value (meter, index++);
+        if (value > *peak)
+            *peak = value;
+    }
+
+    meter->peak_read = written;
+    return TRUE;
+}
+
+guint
+_mate_mixer_meter_copy (MateMixerMeter *meter, gdouble *values, guint count)
+{
+    guint written;
+    guint start;
+    guint skip;
+    guint i;
+
+    g_return_val_if_fail (meter != NULL, 0);
+    g_return_val_if_fail (values != NULL || count == 0, 0);
+
+    written = load_written (meter);
+
+    /* The oldest slot is the one the producer writes next */
+    count = MIN (count, MIN (written, MATE_MIXER_METER_SIZE - 1));
+    if (count == 0)
+        return 0;
+
+    start = written - count;
+    for (i = 0; i < count; i++)
+        values[i] = load_value (meter, start + i);
+
+    /* A slot is safe as long as the producer has not started writing the
+     * value which replaces it, drop the values which may have been
+     * overwritten while copying */
+    written = load_written (meter);
+    if (written - start < MATE_MIXER_METER_SIZE)
+        return count;
+
+    skip = written - start - MATE_MIXER_METER_SIZE + 1;
+    if (skip >= count)
+        return 0;
+
+    count -= skip;
+    memmove (values, values + skip, count * sizeof (gdouble));
+    return count;
+}
+
+static inline gdouble
+load_value (MateMixerMeter *meter, guint index)
+{
+    MeterValue v;
+
+    v.i = g_atomic_int_get (&meter->values[index & METER_MASK]);
+    return v.f;
+}
+
+static inline guint
+load_written (MateMixerMeter *meter)
+{
+    return (guint) g_atomic_int_get (&meter->written);
+}
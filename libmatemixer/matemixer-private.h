@@ -25,10 +25,14 @@
 #include "matemixer-app-info-private.h"
 #include "matemixer-backend.h"
 #include "matemixer-backend-module.h"
+#include "matemixer-decibel-scale-private.h"
+#include "matemixer-snapshot-private.h"
+#include "matemixer-statistics-private.h"
 #include "matemixer-stream-private.h"
 #include "matemixer-stream-control-private.h"
 #include "matemixer-switch-private.h"
 #include "matemixer-switch-option-private.h"
+#include "matemixer-transaction-private.h"
 
 G_BEGIN_DECLS
 
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_SNAPSHOT_PRIVATE_H
+#define MATEMIXER_SNAPSHOT_PRIVATE_H
+
+#include <glib.h>
+
+#include "matemixer-backend.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+/* Version of the snapshot format, snapshots of a different version are
+ * refused */
+#define MATE_MIXER_SNAPSHOT_VERSION     2
+
+/* (version, default input, default output,
+ *  [(stream, control, mute, volume, [channel volume])],
+ *  [(owner kind, owner, switch, active option)]) */
+#define MATE_MIXER_SNAPSHOT_TYPE        "(ussa(ssbuau)a(ysss))"
+
+#define MATE_MIXER_SNAPSHOT_DEVICE      'd'
+#define MATE_MIXER_SNAPSHOT_STREAM      's'
+
+/* A snapshot is applied in two steps, changing the device switches such as
+ * card profiles may replace the streams the rest of the snapshot refers to */
+typedef enum {
+    MATE_MIXER_SNAPSHOT_PHASE_DEVICES,
+    MATE_MIXER_SNAPSHOT_PHASE_STREAMS
+} MateMixerSnapshotPhase;
+
+GVariant *_mate_mixer_snapshot_capture (MateMixerBackend       *backend);
+
+guint     _mate_mixer_snapshot_diff    (MateMixerBackend       *backend,
+                                        MateMixerBackendFlags   flags,
+                                        GVariant               *snapshot,
+                                        MateMixerSnapshotPhase  phase,
+                                        MateMixerTransaction   *transaction);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_SNAPSHOT_PRIVATE_H */
@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-backend.h"
+#include "matemixer-device.h"
+#include "matemixer-device-switch.h"
+#include "matemixer-enums.h"
+#include "matemixer-snapshot-private.h"
+#include "matemixer-stored-control.h"
+#include "matemixer-stream.h"
+#include "matemixer-stream-control.h"
+#include "matemixer-stream-switch.h"
+#include "matemixer-switch.h"
+#include "matemixer-switch-option.h"
+#include "matemixer-transaction.h"
+
+static void                    add_control  (GVariantBuilder        *builder,
+                                             const gchar            *owner,
+                                             MateMixerStreamControl *control);
+static guint                   diff_control (MateMixerStreamControl *control,
+                                             gboolean                mute,
+                                             guint                   volume,
+                                             GVariant               *volumes,
+                                             MateMixerTransaction   *transaction);
+
+static void                    add_switch   (GVariantBuilder        *builder,
+                                             guchar                  kind,
+                                             const gchar            *owner,
+                                             MateMixerSwitch        *swtch);
+
+static MateMixerStreamControl *find_control (MateMixerBackend       *backend,
+                                             const gchar            *owner,
+                                             const gchar            *name);
+static MateMixerSwitch *       find_switch  (MateMixerBackend       *backend,
+                                             guchar                  kind,
+                                             const gchar            *owner,
+                                             const gchar            *name);
+
+GVariant *
+_mate_mixer_snapshot_capture (MateMixerBackend *backend)
+{
+    GVariantBuilder  controls;
+    GVariantBuilder  switches;
+    MateMixerStream *input;
+    MateMixerStream *output;
+    const GList     *list;
+
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    g_variant_builder_init (&controls, G_VARIANT_TYPE ("a(ssbuau)"));
+    g_variant_builder_init (&switches, G_VARIANT_TYPE ("a(ysss)"));
+
+    /* Device switches come first, changing a profile may change the
+     * streams the rest of the snapshot refers to */
+    list = mate_mixer_backend_list_devices (backend);
+    while (list != NULL) {
+        MateMixerDevice *device = MATE_MIXER_DEVICE (list->data);
+        const GList     *item;
+
+        item = mate_mixer_device_list_switches (device);
+        while (item != NULL) {
+            add_switch (&switches,
+                        MATE_MIXER_SNAPSHOT_DEVICE,
+                        mate_mixer_device_get_name (device),
+                        MATE_MIXER_SWITCH (item->data));
+            item = item->next;
+        }
+        list = list->next;
+    }
+
+    list = mate_mixer_backend_list_streams (backend);
+    while (list != NULL) {
+        MateMixerStream *stream = MATE_MIXER_STREAM (list->data);
+        const GList     *item;
+
+        item = mate_mixer_stream_list_switches (stream);
+        while (item != NULL) {
+            add_switch (&switches,
+                        MATE_MIXER_SNAPSHOT_STREAM,
+                        mate_mixer_stream_get_name (stream),
+                        MATE_MIXER_SWITCH (item->data));
+            item = item->next;
+        }
+
+        item = mate_mixer_stream_list_controls (stream);
+        while (item != NULL) {
+            add_control (&controls,
+                         mate_mixer_stream_get_name (stream),
+                         MATE_MIXER_STREAM_CONTROL (item->data));
+            item = item->next;
+        }
+        list = list->next;
+    }
+
+    /* Stored controls do not belong to a stream, they use an empty owner */
+    list = mate_mixer_backend_list_stored_controls (backend);
+    while (list != NULL) {
+        add_control (&controls, "", MATE_MIXER_STREAM_CONTROL (list->data));
+        list = list->next;
+    }
+
+    input  = mate_mixer_backend_get_default_input_stream (backend);
+    output = mate_mixer_backend_get_default_output_stream (backend);
+
+    return g_variant_ref_sink (g_variant_new (MATE_MIXER_SNAPSHOT_TYPE,
+                                              MATE_MIXER_SNAPSHOT_VERSION,
+                                              (input != NULL) ? mate_mixer_stream_get_name (input) : "",
+                                              (output != NULL) ? mate_mixer_stream_get_name (output) : "",
+                                              &controls,
+                                              &switches));
+}
+
+guint
+_mate_mixer_snapshot_diff (MateMixerBackend       *backend,
+                           MateMixerBackendFlags   flags,
+                           GVariant               *snapshot,
+                           MateMixerSnapshotPhase  phase,
+                           MateMixerTransaction   *transaction)
+{
+    GVariantIter    *controls;
+    GVariantIter    *switches;
+    GVariant        *volumes;
+    MateMixerStream *stream;
+    guint32          version;
+    const gchar     *input;
+    const gchar     *output;
+    const gchar     *owner;
+    const gchar     *name;
+    const gchar     *option_name;
+    guchar           kind;
+    gboolean         mute;
+    guint32          volume;
+    guint            changes = 0;
+
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), 0);
+    g_return_val_if_fail (snapshot != NULL, 0);
+    g_return_val_if_fail (transaction != NULL, 0);
+
+    g_variant_get (snapshot,
+                   "(u&s&sa(ssbuau)a(ysss))",
+                   &version,
+                   &input,
+                   &output,
+                   &controls,
+                   &switches);
+
+    /* Only the differences are added to the transaction, items which refer
+     * to objects that no longer exist are skipped */
+    while (g_variant_iter_loop (switches, "(y&s&s&s)", &kind, &owner, &name, &option_name)) {
+        MateMixerSwitch       *swtch;
+        MateMixerSwitchOption *option;
+
+        /* Device switches are changed in the first step and stream switches
+         * in the second one */
+        if ((kind == MATE_MIXER_SNAPSHOT_DEVICE) != (phase == MATE_MIXER_SNAPSHOT_PHASE_DEVICES))
+            continue;
+
+        swtch = find_switch (backend, kind, owner, name);
+        if (swtch == NULL)
+            continue;
+
+        option = mate_mixer_switch_get_option (swtch, option_name);
+        if (option == NULL || option == mate_mixer_switch_get_active_option (swtch))
+            continue;
+
+        mate_mixer_transaction_set_switch_option (transaction, swtch, option);
+        changes++;
+    }
+
+    if (phase == MATE_MIXER_SNAPSHOT_PHASE_DEVICES) {
+        g_variant_iter_free (controls);
+        g_variant_iter_free (switches);
+        return changes;
+    }
+
+    if ((flags & MATE_MIXER_BACKEND_CAN_SET_DEFAULT_INPUT_STREAM) && *input != '\0') {
+        stream = mate_mixer_backend_get_stream (backend, input);
+
+        if (stream != NULL && stream != mate_mixer_backend_get_default_input_stream (backend)) {
+            mate_mixer_transaction_set_default_input_stream (transaction, stream);
+            changes++;
+        }
+    }
+
+    if ((flags & MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM) && *output != '\0') {
+        stream = mate_mixer_backend_get_stream (backend, output);
+
+        if (stream != NULL && stream != mate_mixer_backend_get_default_output_stream (backend)) {
+            mate_mixer_transaction_set_default_output_stream (transaction, stream);
+            changes++;
+        }
+    }
+
+    while (g_variant_iter_loop (controls, "(&s&sbu@au)", &owner, &name, &mute, &volume, &volumes)) {
+        MateMixerStreamControl *control;
+
+        control = find_control (backend, owner, name);
+        if (control == NULL)
+            continue;
+
+        changes += diff_control (control, mute, volume, volumes, transaction);
+    }
+
+    g_variant_iter_free (controls);
+    g_variant_iter_free (switches);
+
+    return changes;
+}
+
+static void
+add_control (GVariantBuilder        *builder,
+             const gchar            *owner,
+             MateMixerStreamControl *control)
+{
+    GVariantBuilder volumes;
+    guint           channels;
+    guint           i;
+
+    /* The channel volumes keep the balance and fade of the control */
+    g_variant_builder_init (&volumes, G_VARIANT_TYPE ("au"));
+
+    channels = mate_mixer_stream_control_get_num_channels (control);
+    for (i = 0; i < channels; i++)
+        g_variant_builder_add (&volumes,
+                               "u",
+                               mate_mixer_stream_control_get_channel_volume (control, i));
+
+    g_variant_builder_add (builder,
+                           "(ssbuau)",
+                           owner,
+                           mate_mixer_stream_control_get_name (control),
+                           mate_mixer_stream_control_get_mute (control),
+                           mate_mixer_stream_control_get_volume (control),
+                           &volumes);
+}
+
+static guint
+diff_control (MateMixerStreamControl *control,
+              gboolean                mute,
+              guint                   volume,
+              GVariant               *volumes,
+              MateMixerTransaction   *transaction)
+{
+    MateMixerStreamControlFlags flags;
+    const guint32              *values;
+    gsize                       channels;
+    guint                       changes = 0;
+    guint                       i;
+
+    flags = mate_mixer_stream_control_get_flags (control);
+
+    if ((flags & MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE) &&
+        mate_mixer_stream_control_get_mute (control) != mute) {
+        mate_mixer_transaction_set_mute (transaction, control, mute);
+        changes++;
+    }
+
+    if ((flags & MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE) == 0)
+        return changes;
+
+    values = g_variant_get_fixed_array (volumes, &channels, sizeof (guint32));
+
+    /* Restore the individual channels when the channel layout is the same,
+     * otherwise only the overall volume can be restored */
+    if (channels > 0 && channels == mate_mixer_stream_control_get_num_channels (control)) {
+        for (i = 0; i < channels; i++) {
+            if (mate_mixer_stream_control_get_channel_volume (control, i) == values[i])
+                continue;
+
+            mate_mixer_transaction_set_channel_volume (transaction, control, i, values[i]);
+            changes++;
+        }
+    } else if (mate_mixer_stream_control_get_volume (control) != volume) {
+        mate_mixer_transaction_set_volume (transaction, control, volume);
+        changes++;
+    }
+    return changes;
+}
+
+static void
+add_switch (GVariantBuilder *builder,
+            guchar           kind,
+            const gchar     *owner,
+            MateMixerSwitch *swtch)
+{
+    MateMixerSwitchOption *option;
+
+    option = mate_mixer_switch_get_active_option (swtch);
+    if (option == NULL)
+        return;
+
+    g_variant_builder_add (builder,
+                           "(ysss)",
+                           kind,
+                           owner,
+                           mate_mixer_switch_get_name (swtch),
+                           mate_mixer_switch_option_get_name (option));
+}
+
+static MateMixerStreamControl *
+find_control (MateMixerBackend *backend, const gchar *owner, const gchar *name)
+{
+    MateMixerStream *stream;
+
+    if (*owner == '\0') {
+        MateMixerStoredControl *control;
+
+        control = mate_mixer_backend_get_stored_control (backend, name);
+        if (control == NULL)
+            return NULL;
+
+        return MATE_MIXER_STREAM_CONTROL (control);
+    }
+
+    stream = mate_mixer_backend_get_stream (backend, owner);
+    if (stream == NULL)
+        return NULL;
+
+    return mate_mixer_stream_get_control (stream, name);
+}
+
+static MateMixerSwitch *
+find_switch (MateMixerBackend *backend,
+             guchar            kind,
+             const gchar      *owner,
+             const gchar      *name)
+{
+    if (kind == MATE_MIXER_SNAPSHOT_DEVICE) {
+        MateMixerDevice       *device;
+        MateMixerDeviceSwitch *swtch;
+
+        device = mate_mixer_backend_get_device (backend, owner);
+        if (device == NULL)
+            return NULL;
+
+        swtch = mate_mixer_device_get_switch (device, name);
+        if (swtch == NULL)
+            return NULL;
+
+        return MATE_MIXER_SWITCH (swtch);
+    }
+
+    if (kind == MATE_MIXER_SNAPSHOT_STREAM) {
+        MateMixerStream       *stream;
+        MateMixerStreamSwitch *swtch;
+
+        stream = mate_mixer_backend_get_stream (backend, owner);
+        if (stream == NULL)
+            return NULL;
+
+        swtch = mate_mixer_stream_get_switch (stream, name);
+        if (swtch == NULL)
+            return NULL;
+
+        return MATE_MIXER_SWITCH (swtch);
+    }
+    return NULL;
+}
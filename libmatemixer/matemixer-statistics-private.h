@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_STATISTICS_PRIVATE_H
+#define MATEMIXER_STATISTICS_PRIVATE_H
+
+#include <glib.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-statistics.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+struct _MateMixerStatistics
+{
+    gint64  start_time;
+    gint64  elapsed_time;
+    guint64 events[MATE_MIXER_STATISTICS_EVENT_MAX];
+    guint64 queries;
+    guint   operations;
+    guint   operations_peak;
+    guint64 signals;
+    guint64 notifications;
+    guint64 handler_calls;
+    guint64 handler_time;
+    guint64 handler_histogram[MATE_MIXER_STATISTICS_HISTOGRAM_SIZE];
+    guint   devices;
+    guint   devices_peak;
+    guint   streams;
+    guint   streams_peak;
+    guint   stored_controls;
+    guint   stored_controls_peak;
+    guint64 monitor_values;
+    gdouble monitor_rate;
+    guint64 reconnect_attempts;
+    guint64 reconnects;
+    gint64  reconnect_latency;
+    gint64  reconnect_latency_peak;
+};
+
+MateMixerStatistics *_mate_mixer_statistics_new                   (void);
+void                 _mate_mixer_statistics_reset                 (MateMixerStatistics      *statistics);
+
+void                 _mate_mixer_statistics_add_event             (MateMixerStatistics      *statistics,
+                                                                   MateMixerStatisticsEvent  event);
+void                 _mate_mixer_statistics_add_query             (MateMixerStatistics      *statistics);
+void                 _mate_mixer_statistics_add_signal            (MateMixerStatistics      *statistics);
+void                 _mate_mixer_statistics_add_notification      (MateMixerStatistics      *statistics);
+void                 _mate_mixer_statistics_add_handler_time      (MateMixerStatistics      *statistics,
+                                                                   gint64                    usec);
+void                 _mate_mixer_statistics_add_monitor_value     (MateMixerStatistics      *statistics);
+void                 _mate_mixer_statistics_add_reconnect_attempt (MateMixerStatistics      *statistics);
+void                 _mate_mixer_statistics_add_reconnect         (MateMixerStatistics      *statistics,
+                                                                   gint64                    latency);
+
+void                 _mate_mixer_statistics_begin_operation       (MateMixerStatistics      *statistics);
+void                 _mate_mixer_statistics_end_operation         (MateMixerStatistics      *statistics);
+
+void                 _mate_mixer_statistics_set_devices           (MateMixerStatistics      *statistics,
+                                                                   guint                     devices);
+void                 _mate_mixer_statistics_set_streams           (MateMixerStatistics      *statistics,
+                                                                   guint                     streams);
+void                 _mate_mixer_statistics_set_stored_controls   (MateMixerStatistics      *statistics,
+                                                                   guint                     stored_controls);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_STATISTICS_PRIVATE_H */
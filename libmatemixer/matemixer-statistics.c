@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-statistics.h"
+#include "matemixer-statistics-private.h"
+
+/**
+ * SECTION:matemixer-statistics
+ * @short_description: Performance counters
+ * @include: libmatemixer/matemixer.h
+ * @see_also: #MateMixerContext
+ *
+ * The #MateMixerStatistics structure contains performance counters which
+ * describe the activity of a #MateMixerContext and its sound system backend.
+ *
+ * The counters start when the context connects to a sound system and can be
+ * read at any time using mate_mixer_context_get_statistics(), which returns
+ * a snapshot of the current values.
+ */
+
+/**
+ * MateMixerStatistics:
+ *
+ * The #MateMixerStatistics structure contains only private data and should
+ * only be accessed using the provided API.
+ *
+ * Not all the counters are supported by all the backends, the counters which
+ * are not supported are always zero.
+ */
+G_DEFINE_BOXED_TYPE (MateMixerStatistics, mate_mixer_statistics,
+                     mate_mixer_statistics_copy,
+                     mate_mixer_statistics_free)
+
+/* Upper bounds of the histogram buckets in microseconds, the last bucket is
+ * unbounded */
+static const gint64 histogram_bounds[MATE_MIXER_STATISTICS_HISTOGRAM_SIZE] = {
+    10, 100, 1000, 10000, 100000, G_MAXINT64
+};
+
+/**
+ * mate_mixer_statistics_copy:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Creates a copy of the #MateMixerStatistics.
+ *
+ * Returns: a copy of the given @statistics.
+ */
+MateMixerStatistics *
+mate_mixer_statistics_copy (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, NULL);
+
+    return g_slice_dup (MateMixerStatistics, statistics);
+}
+
+/**
+ * mate_mixer_statistics_free:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Frees the #MateMixerStatistics.
+ */
+void
+mate_mixer_statistics_free (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    g_slice_free (MateMixerStatistics, statistics);
+}
+
+/**
+ * mate_mixer_statistics_get_start_time:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the monotonic time in microseconds when the counting started.
+ *
+ * Returns: the start time in microseconds.
+ */
+gint64
+mate_mixer_statistics_get_start_time (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->start_time;
+}
+
+/**
+ * mate_mixer_statistics_get_elapsed_time:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of microseconds between the start of the counting and the time
+ * the @statistics were taken.
+ *
+ * Returns: the elapsed time in microseconds.
+ */
+gint64
+mate_mixer_statistics_get_elapsed_time (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->elapsed_time;
+}
+
+/**
+ * mate_mixer_statistics_get_events:
+ * @statistics: a #MateMixerStatistics
+ * @event: a #MateMixerStatisticsEvent
+ *
+ * Gets the number of events of the given type received from the sound system.
+ *
+ * Returns: the number of events.
+ */
+guint64
+mate_mixer_statistics_get_events (const MateMixerStatistics *statistics,
+                                  MateMixerStatisticsEvent   event)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+    g_return_val_if_fail (event < MATE_MIXER_STATISTICS_EVENT_MAX, 0);
+
+    return statistics->events[event];
+}
+
+/**
+ * mate_mixer_statistics_get_queries:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of introspection queries sent to the sound system.
+ *
+ * Returns: the number of queries.
+ */
+guint64
+mate_mixer_statistics_get_queries (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->queries;
+}
+
+/**
+ * mate_mixer_statistics_get_operations:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of sound system operations in flight when the @statistics
+ * were taken.
+ *
+ * Returns: the number of operations.
+ */
+guint
+mate_mixer_statistics_get_operations (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->operations;
+}
+
+/**
+ * mate_mixer_statistics_get_operations_peak:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the highest number of sound system operations in flight.
+ *
+ * Returns: the peak number of operations.
+ */
+guint
+mate_mixer_statistics_get_operations_peak (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->operations_peak;
+}
+
+/**
+ * mate_mixer_statistics_get_signals:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of signals emitted by the #MateMixerContext. Only the signals
+ * of the context itself are counted, the signals of devices, streams, controls
+ * and switches are not.
+ *
+ * Contexts which share a connection, see mate_mixer_context_set_share_backend(),
+ * also share the statistics, each signal is counted once no matter how many of
+ * the contexts receive it.
+ *
+ * Returns: the number of signals.
+ */
+guint64
+mate_mixer_statistics_get_signals (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->signals;
+}
+
+/**
+ * mate_mixer_statistics_get_notifications:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of property change notifications emitted by the
+ * #MateMixerContext.
+ *
+ * Returns: the number of notifications.
+ */
+guint64
+mate_mixer_statistics_get_notifications (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->notifications;
+}
+
+/**
+ * mate_mixer_statistics_get_handler_calls:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of calls of the backend event handlers.
+ *
+ * Returns: the number of handler calls.
+ */
+guint64
+mate_mixer_statistics_get_handler_calls (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->handler_calls;
+}
+
+/**
+ * mate_mixer_statistics_get_handler_time:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the total time spent in the backend event handlers.
+ *
+ * Returns: the handler time in microseconds.
+ */
+guint64
+mate_mixer_statistics_get_handler_time (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->handler_time;
+}
+
+/**
+ * mate_mixer_statistics_get_handler_histogram:
+ * @statistics: a #MateMixerStatistics
+ * @bucket: index of a histogram bucket
+ *
+ * Gets the number of backend event handler calls whose duration falls into
+ * the given bucket, see mate_mixer_statistics_get_histogram_bound().
+ *
+ * Returns: the number of handler calls.
+ */
+guint64
+mate_mixer_statistics_get_handler_histogram (const MateMixerStatistics *statistics,
+                                             guint                      bucket)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+    g_return_val_if_fail (bucket < MATE_MIXER_STATISTICS_HISTOGRAM_SIZE, 0);
+
+    return statistics->handler_histogram[bucket];
+}
+
+/**
+ * mate_mixer_statistics_get_devices:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of devices.
+ *
+ * Returns: the number of devices.
+ */
+guint
+mate_mixer_statistics_get_devices (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->devices;
+}
+
+/**
+ * mate_mixer_statistics_get_devices_peak:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the highest number of devices.
+ *
+ * Returns: the peak number of devices.
+ */
+guint
+mate_mixer_statistics_get_devices_peak (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->devices_peak;
+}
+
+/**
+ * mate_mixer_statistics_get_streams:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of streams.
+ *
+ * Returns: the number of streams.
+ */
+guint
+mate_mixer_statistics_get_streams (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->streams;
+}
+
+/**
+ * mate_mixer_statistics_get_streams_peak:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the highest number of streams.
+ *
+ * Returns: the peak number of streams.
+ */
+guint
+mate_mixer_statistics_get_streams_peak (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->streams_peak;
+}
+
+/**
+ * mate_mixer_statistics_get_stored_controls:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of stored controls.
+ *
+ * Returns: the number of stored controls.
+ */
+guint
+mate_mixer_statistics_get_stored_controls (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->stored_controls;
+}
+
+/**
+ * mate_mixer_statistics_get_stored_controls_peak:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the highest number of stored controls.
+ *
+ * Returns: the peak number of stored controls.
+ */
+guint
+mate_mixer_statistics_get_stored_controls_peak (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->stored_controls_peak;
+}
+
+/**
+ * mate_mixer_statistics_get_monitor_values:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of values delivered by stream control monitors.
+ *
+ * Returns: the number of monitor values.
+ */
+guint64
+mate_mixer_statistics_get_monitor_values (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->monitor_values;
+}
+
+/**
+ * mate_mixer_statistics_get_monitor_rate:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the average number of monitor values per second.
+ *
+ * Returns: the monitor value rate.
+ */
+gdouble
+mate_mixer_statistics_get_monitor_rate (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0.0);
+
+    return statistics->monitor_rate;
+}
+
+/**
+ * mate_mixer_statistics_get_reconnect_attempts:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of attempts to connect again to the sound system after the
+ * connection was lost.
+ *
+ * Returns: the number of reconnection attempts.
+ */
+guint64
+mate_mixer_statistics_get_reconnect_attempts (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->reconnect_attempts;
+}
+
+/**
+ * mate_mixer_statistics_get_reconnects:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the number of times the lost connection was established again.
+ *
+ * Returns: the number of reconnections.
+ */
+guint64
+mate_mixer_statistics_get_reconnects (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->reconnects;
+}
+
+/**
+ * mate_mixer_statistics_get_reconnect_latency:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the time the last reconnection took after the sound system became
+ * available, counted from the last failed attempt or from the moment the sound
+ * system was noticed to be back.
+ *
+ * Returns: the latency in microseconds.
+ */
+gint64
+mate_mixer_statistics_get_reconnect_latency (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->reconnect_latency;
+}
+
+/**
+ * mate_mixer_statistics_get_reconnect_latency_peak:
+ * @statistics: a #MateMixerStatistics
+ *
+ * Gets the highest reconnection latency.
+ *
+ * Returns: the peak latency in microseconds.
+ */
+gint64
+mate_mixer_statistics_get_reconnect_latency_peak (const MateMixerStatistics *statistics)
+{
+    g_return_val_if_fail (statistics != NULL, 0);
+
+    return statistics->reconnect_latency_peak;
+}
+
+/**
+ * mate_mixer_statistics_get_histogram_bound:
+ * @bucket: index of a histogram bucket
+ *
+ * Gets the upper bound of the given bucket of the handler time histogram,
+ * see mate_mixer_statistics_get_handler_histogram(). A handler call is counted in the
+ * first bucket whose upper bound is higher than the duration of the call.
+ *
+ * Returns: the upper bound in microseconds or %G_MAXINT64 for the last bucket.
+ */
+gint64
+mate_mixer_statistics_get_histogram_bound (guint bucket)
+{
+    g_return_val_if_fail (bucket < MATE_MIXER_STATISTICS_HISTOGRAM_SIZE, 0);
+
+    return histogram_bounds[bucket];
+}
+
+MateMixerStatistics *
+_mate_mixer_statistics_new (void)
+{
+    MateMixerStatistics *statistics;
+
+    statistics = g_slice_new0 (MateMixerStatistics);
+    statistics->start_time = g_get_monotonic_time ();
+
+    return statistics;
+}
+
+void
+_mate_mixer_statistics_reset (MateMixerStatistics *statistics)
+{
+    guint operations;
+    guint devices;
+    guint streams;
+    guint stored_controls;
+
+    g_return_if_fail (statistics != NULL);
+
+    /* Keep the current values, only the counters and peaks are reset */
+    operations      = statistics->operations;
+    devices         = statistics->devices;
+    streams         = statistics->streams;
+    stored_controls = statistics->stored_controls;
+
+    memset (statistics, 0, sizeof (MateMixerStatistics));
+
+    statistics->start_time = g_get_monotonic_time ();
+
+    statistics->operations = statistics->operations_peak = operations;
+    statistics->devices = statistics->devices_peak = devices;
+    statistics->streams = statistics->streams_peak = streams;
+    statistics->stored_controls = statistics->stored_controls_peak = stored_controls;
+}
+
+void
+_mate_mixer_statistics_add_event (MateMixerStatistics *statistics, MateMixerStatisticsEvent event)
+{
+    g_return_if_fail (statistics != NULL);
+    g_return_if_fail (event < MATE_MIXER_STATISTICS_EVENT_MAX);
+
+    statistics->events[event]++;
+}
+
+void
+_mate_mixer_statistics_add_query (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->queries++;
+}
+
+void
+_mate_mixer_statistics_add_signal (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->signals++;
+}
+
+void
+_mate_mixer_statistics_add_notification (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->notifications++;
+}
+
+void
+_mate_mixer_statistics_add_handler_time (MateMixerStatistics *statistics, gint64 usec)
+{
+    guint i;
+
+    g_return_if_fail (statistics != NULL);
+
+    statistics->handler_calls++;
+    statistics->handler_time += usec;
+
+    for (i = 0; i < MATE_MIXER_STATISTICS_HISTOGRAM_SIZE - 1; i++)
+        if (usec < histogram_bounds[i])
+            break;
+
+    statistics->handler_histogram[i]++;
+}
+
+void
+_mate_mixer_statistics_add_monitor_value (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->monitor_values++;
+}
+
+void
+_mate_mixer_statistics_add_reconnect_attempt (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->reconnect_attempts++;
+}
+
+void
+_mate_mixer_statistics_add_reconnect (MateMixerStatistics *statistics, gint64 latency)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->reconnects++;
+    statistics->reconnect_latency      = latency;
+    statistics->reconnect_latency_peak = MAX (statistics->reconnect_latency_peak, latency);
+}
+
+void
+_mate_mixer_statistics_begin_operation (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->operations++;
+    statistics->operations_peak = MAX (statistics->operations_peak, statistics->operations);
+}
+
+void
+_mate_mixer_statistics_end_operation (MateMixerStatistics *statistics)
+{
+    g_return_if_fail (statistics != NULL);
+
+    /* The counting might have started while an operation was in flight */
+    if (statistics->operations > 0)
+        statistics->operations--;
+}
+
+void
+_mate_mixer_statistics_set_devices (MateMixerStatistics *statistics, guint devices)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->devices      = devices;
+    statistics->devices_peak = MAX (statistics->devices_peak, devices);
+}
+
+void
+_mate_mixer_statistics_set_streams (MateMixerStatistics *statistics, guint streams)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->streams      = streams;
+    statistics->streams_peak = MAX (statistics->streams_peak, streams);
+}
+
+void
+_mate_mixer_statistics_set_stored_controls (MateMixerStatistics *statistics, guint stored_controls)
+{
+    g_return_if_fail (statistics != NULL);
+
+    statistics->stored_controls      = stored_controls;
+    statistics->stored_controls_peak = MAX (statistics->stored_controls_peak, stored_controls);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_STATISTICS_H
+#define MATEMIXER_STATISTICS_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+#define MATE_MIXER_TYPE_STATISTICS (mate_mixer_statistics_get_type ())
+
+/**
+ * MATE_MIXER_STATISTICS_HISTOGRAM_SIZE:
+ *
+ * Number of buckets of the backend handler time histogram.
+ */
+#define MATE_MIXER_STATISTICS_HISTOGRAM_SIZE 6
+
+GType                mate_mixer_statistics_get_type                   (void) G_GNUC_CONST;
+
+MateMixerStatistics *mate_mixer_statistics_copy                       (const MateMixerStatistics *statistics);
+void                 mate_mixer_statistics_free                       (MateMixerStatistics       *statistics);
+
+gint64               mate_mixer_statistics_get_start_time             (const MateMixerStatistics *statistics);
+gint64               mate_mixer_statistics_get_elapsed_time           (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_events                 (const MateMixerStatistics *statistics,
+                                                                       MateMixerStatisticsEvent   event);
+guint64              mate_mixer_statistics_get_queries                (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_operations             (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_operations_peak        (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_signals                (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_notifications          (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_handler_calls          (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_handler_time           (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_handler_histogram      (const MateMixerStatistics *statistics,
+                                                                       guint                      bucket);
+guint                mate_mixer_statistics_get_devices                (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_devices_peak           (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_streams                (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_streams_peak           (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_stored_controls        (const MateMixerStatistics *statistics);
+guint                mate_mixer_statistics_get_stored_controls_peak   (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_monitor_values         (const MateMixerStatistics *statistics);
+gdouble              mate_mixer_statistics_get_monitor_rate           (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_reconnect_attempts     (const MateMixerStatistics *statistics);
+guint64              mate_mixer_statistics_get_reconnects             (const MateMixerStatistics *statistics);
+gint64               mate_mixer_statistics_get_reconnect_latency      (const MateMixerStatistics *statistics);
+gint64               mate_mixer_statistics_get_reconnect_latency_peak (const MateMixerStatistics *statistics);
+
+gint64               mate_mixer_statistics_get_histogram_bound        (guint                      bucket);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_STATISTICS_H */
@@ -25,20 +25,32 @@
 
 G_BEGIN_DECLS
 
-void _mate_mixer_stream_control_set_flags   (MateMixerStreamControl     *control,
-                                             MateMixerStreamControlFlags flags);
+void _mate_mixer_stream_control_set_flags          (MateMixerStreamControl     *control,
+                                                    MateMixerStreamControlFlags flags);
 
-void _mate_mixer_stream_control_set_stream  (MateMixerStreamControl     *control,
-                                             MateMixerStream            *stream);
+void _mate_mixer_stream_control_set_stream         (MateMixerStreamControl     *control,
+                                                    MateMixerStream            *stream);
 
-void _mate_mixer_stream_control_set_mute    (MateMixerStreamControl     *control,
-                                             gboolean                    mute);
+void _mate_mixer_stream_control_set_mute           (MateMixerStreamControl     *control,
+                                                    gboolean                    mute);
 
-void _mate_mixer_stream_control_set_balance (MateMixerStreamControl     *control,
-                                             gfloat                      balance);
+void _mate_mixer_stream_control_set_balance        (MateMixerStreamControl     *control,
+                                                    gfloat                      balance);
 
-void _mate_mixer_stream_control_set_fade    (MateMixerStreamControl     *control,
-                                             gfloat                      fade);
+void _mate_mixer_stream_control_set_fade           (MateMixerStreamControl     *control,
+                                                    gfloat                      fade);
+
+void _mate_mixer_stream_control_push_monitor_value (MateMixerStreamControl     *control,
+                                                    gdouble                     value);
+
+void _mate_mixer_stream_control_publish_state      (MateMixerStreamControl     *control);
+
+gboolean _mate_mixer_stream_control_get_decibel_from_volume (MateMixerStreamControl *control,
+                                                             guint                   volume,
+                                                             gdouble                *decibel);
+gboolean _mate_mixer_stream_control_get_volume_from_decibel (MateMixerStreamControl *control,
+                                                             gdouble                 decibel,
+                                                             guint                  *volume);
 
 G_END_DECLS
 
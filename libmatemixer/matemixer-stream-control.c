@@ -23,6 +23,8 @@
 #include "matemixer-stream.h"
 #include "matemixer-stream-control.h"
 #include "matemixer-stream-control-private.h"
+#include "matemixer-decibel-scale-private.h"
+#include "matemixer-meter-private.h"
 
 /**
  * SECTION:matemixer-stream-control
@@ -40,6 +42,10 @@ struct _MateMixerStreamControlPrivate
     MateMixerStreamControlFlags     flags;
     MateMixerStreamControlRole      role;
     MateMixerStreamControlMediaRole media_role;
+    MateMixerMeter                 *meter;
+    gboolean                        monitor_signal;
+    gint                            shared_sequence;
+    MateMixerStreamControlState     shared;
 };
 
 enum {
@@ -251,6 +257,7 @@ mate_mixer_stream_control_set_property (GObject      *object,
     case PROP_NAME:
         /* Construct-only string */
         control->priv->name = g_value_dup_string (value);
+        control->priv->shared.name = control->priv->name;
         break;
     case PROP_LABEL:
         /* Construct-only string */
@@ -284,6 +291,8 @@ static void
 mate_mixer_stream_control_init (MateMixerStreamControl *control)
 {
     control->priv = mate_mixer_stream_control_get_instance_private (control);
+
+    control->priv->monitor_signal = TRUE;
 }
 
 static void
@@ -309,6 +318,9 @@ mate_mixer_stream_control_finalize (GObject *object)
     g_free (control->priv->name);
     g_free (control->priv->label);
 
+    if (control->priv->meter != NULL)
+        _mate_mixer_meter_free (control->priv->meter);
+
     G_OBJECT_CLASS (mate_mixer_stream_control_parent_class)->finalize (object);
 }
 
@@ -819,6 +831,136 @@ mate_mixer_stream_control_set_monitor_enabled (MateMixerStreamControl *control,
     return MATE_MIXER_STREAM_CONTROL_GET_CLASS (control)->set_monitor_enabled (control, enabled);
 }
 
+/**
+ * mate_mixer_stream_control_get_monitor_signal:
+ * @control: a #MateMixerStreamControl
+ *
+ * Gets whether the #MateMixerStreamControl::monitor-value signal is emitted
+ * for each value delivered by the monitor.
+ *
+ * Returns: %TRUE if the signal is emitted or %FALSE otherwise.
+ */
+gboolean
+mate_mixer_stream_control_get_monitor_signal (MateMixerStreamControl *control)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+
+    return control->priv->monitor_signal;
+}
+
+/**
+ * mate_mixer_stream_control_set_monitor_signal:
+ * @control: a #MateMixerStreamControl
+ * @enabled: a boolean value
+ *
+ * Sets whether the #MateMixerStreamControl::monitor-value signal is emitted
+ * for each value delivered by the monitor. The signal is enabled by default.
+ *
+ * Applications which draw the monitor values at their own pace may disable
+ * the signal and read the values using mate_mixer_stream_control_read_monitor_value(),
+ * mate_mixer_stream_control_read_monitor_peak() and
+ * mate_mixer_stream_control_copy_monitor_values() instead.
+ */
+void
+mate_mixer_stream_control_set_monitor_signal (MateMixerStreamControl *control,
+                                              gboolean                enabled)
+{
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    control->priv->monitor_signal = enabled;
+}
+
+/**
+ * mate_mixer_stream_control_read_monitor_value:
+ * @control: a #MateMixerStreamControl
+ * @value: (out): return location for the value
+ *
+ * Reads the most recent value delivered by the monitor of the control.
+ *
+ * The monitor values of a control may be read from a single thread other
+ * than the main thread without locking, the caller must hold a reference to
+ * the control while reading.
+ *
+ * Returns: %TRUE on success or %FALSE if the monitor has not delivered any
+ * value yet.
+ */
+gboolean
+mate_mixer_stream_control_read_monitor_value (MateMixerStreamControl *control,
+                                              gdouble                *value)
+{
+    MateMixerMeter *meter;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+    g_return_val_if_fail (value != NULL, FALSE);
+
+    meter = g_atomic_pointer_get (&control->priv->meter);
+    if (meter == NULL)
+        return FALSE;
+
+    return _mate_mixer_meter_read_latest (meter, value);
+}
+
+/**
+ * mate_mixer_stream_control_read_monitor_peak:
+ * @control: a #MateMixerStreamControl
+ * @peak: (out): return location for the peak value
+ *
+ * Reads the highest value delivered by the monitor of the control since the
+ * last call of this function. Only a limited number of the most recent values
+ * is kept, older values are not included in the peak.
+ *
+ * See mate_mixer_stream_control_read_monitor_value() for the threading rules.
+ *
+ * Returns: %TRUE on success or %FALSE if the monitor has not delivered any
+ * value since the last call.
+ */
+gboolean
+mate_mixer_stream_control_read_monitor_peak (MateMixerStreamControl *control,
+                                             gdouble                *peak)
+{
+    MateMixerMeter *meter;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+    g_return_val_if_fail (peak != NULL, FALSE);
+
+    meter = g_atomic_pointer_get (&control->priv->meter);
+    if (meter == NULL)
+        return FALSE;
+
+    return _mate_mixer_meter_read_peak (meter, peak);
+}
+
+/**
+ * mate_mixer_stream_control_copy_monitor_values:
+ * @control: a #MateMixerStreamControl
+ * @values: (array length=count) (out caller-allocates): an array to fill
+ * @count: the size of the @values array
+ *
+ * Copies up to @count most recent values delivered by the monitor of the
+ * control to @values, the oldest value first. Only a limited number of the
+ * most recent values is kept, so fewer values than requested may be copied.
+ *
+ * See mate_mixer_stream_control_read_monitor_value() for the threading rules.
+ *
+ * Returns: the number of values copied.
+ */
+guint
+mate_mixer_stream_control_copy_monitor_values (MateMixerStreamControl *control,
+                                               gdouble                *values,
+                                               guint                   count)
+{
+    MateMixerMeter *meter;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), 0);
+    g_return_val_if_fail (values != NULL || count == 0, 0);
+
+    meter = g_atomic_pointer_get (&control->priv->meter);
+    if (meter == NULL)
+        return 0;
+
+    return _mate_mixer_meter_copy (meter, values, count);
+}
+
 /**
  * mate_mixer_stream_control_get_min_volume:
  * @control: a #MateMixerStreamControl
@@ -871,6 +1013,130 @@ mate_mixer_stream_control_get_base_volume (MateMixerStreamControl *control)
     return MATE_MIXER_STREAM_CONTROL_GET_CLASS (control)->get_base_volume (control);
 }
 
+/**
+ * MateMixerStreamControlState:
+ * @name: the name of the control, owned by the control
+ * @flags: the #MateMixerStreamControlFlags of the control
+ * @mute: %TRUE if the control is muted
+ * @volume: the volume of the control
+ * @balance: the balance of the control
+ * @fade: the fade of the control
+ * @num_channels: the number of channels of the control
+ * @channel_volume: the volumes of the channels, only the first @num_channels
+ *     values are used and the rest is set to 0
+ *
+ * A snapshot of the state of a #MateMixerStreamControl.
+ *
+ * The snapshot is filled by mate_mixer_stream_control_read_state() and in
+ * bulk by mate_mixer_stream_read_controls() and
+ * mate_mixer_context_read_controls(). The @name points into the control
+ * and it is only valid as long as the control exists.
+ *
+ * Controls with more than %MATE_MIXER_STREAM_CONTROL_STATE_MAX_CHANNELS
+ * channels only include the volumes of the first channels.
+ */
+
+/**
+ * mate_mixer_stream_control_read_state:
+ * @control: a #MateMixerStreamControl
+ * @state: a #MateMixerStreamControlState to fill
+ *
+ * Reads the name, flags, mute, volume, balance, fade and channel volumes of
+ * the control in a single call.
+ *
+ * The values are the same as the values returned by the individual getter
+ * functions, reading them together avoids the overhead of calling each of
+ * the functions.
+ */
+void
+mate_mixer_stream_control_read_state (MateMixerStreamControl      *control,
+                                      MateMixerStreamControlState *state)
+{
+    MateMixerStreamControlClass *klass;
+    guint                        channels = 0;
+    guint                        i;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+    g_return_if_fail (state != NULL);
+
+    klass = MATE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+
+    state->name         = control->priv->name;
+    state->flags        = control->priv->flags;
+    state->mute         = control->priv->mute;
+    state->balance      = control->priv->balance;
+    state->fade         = control->priv->fade;
+    state->num_channels = 0;
+
+    if (klass->get_num_channels != NULL) {
+        state->num_channels = klass->get_num_channels (control);
+
+        channels = MIN (state->num_channels, MATE_MIXER_STREAM_CONTROL_STATE_MAX_CHANNELS);
+    }
+
+    if (control->priv->flags & MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE) {
+        state->volume = klass->get_volume (control);
+
+        for (i = 0; i < channels; i++)
+            state->channel_volume[i] = klass->get_channel_volume (control, i);
+    } else {
+        state->volume = klass->get_min_volume (control);
+
+        for (i = 0; i < channels; i++)
+            state->channel_volume[i] = state->volume;
+    }
+
+    /* Keep the unused part defined so snapshots can be compared as a whole */
+    for (; i < MATE_MIXER_STREAM_CONTROL_STATE_MAX_CHANNELS; i++)
+        state->channel_volume[i] = 0;
+}
+
+/**
+ * mate_mixer_stream_control_read_shared_state:
+ * @control: a #MateMixerStreamControl
+ * @state: a #MateMixerStreamControlState to fill
+ *
+ * Reads the state of the control last published by the backend.
+ *
+ * Unlike the other functions of #MateMixerStreamControl, this function may be
+ * called from any thread, for example to draw an on-screen display without
+ * going through the main loop. The caller must hold a reference to the control
+ * while reading.
+ *
+ * The values are the same as the values returned by
+ * mate_mixer_stream_control_read_state() in the main thread, except that a
+ * change made in the main thread may not be visible until the backend
+ * finishes handling it.
+ */
+void
+mate_mixer_stream_control_read_shared_state (MateMixerStreamControl      *control,
+                                             MateMixerStreamControlState *state)
+{
+    gint sequence;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+    g_return_if_fail (state != NULL);
+
+    /* The sequence number is odd while the main thread is writing the state,
+     * copy the state again if it changed during the copy */
+    while (TRUE) {
+        sequence = g_atomic_int_get (&control->priv->shared_sequence);
+        if (sequence & 1) {
+            g_thread_yield ();
+            continue;
+        }
+
+        *state = control->priv->shared;
+
+        /* Keep the copy from being reordered after the second read of the
+         * sequence number */
+        __atomic_thread_fence (__ATOMIC_ACQUIRE);
+
+        if (g_atomic_int_get (&control->priv->shared_sequence) == sequence)
+            break;
+    }
+}
+
 /* Protected functions */
 void
 _mate_mixer_stream_control_set_flags (MateMixerStreamControl     *control,
@@ -883,6 +1149,8 @@ _mate_mixer_stream_control_set_flags (MateMixerStreamControl     *control,
 
     control->priv->flags = flags;
 
+    _mate_mixer_stream_control_publish_state (control);
+
     g_object_notify_by_pspec (G_OBJECT (control), properties[PROP_FLAGS]);
 }
 
@@ -920,6 +1188,8 @@ _mate_mixer_stream_control_set_mute (MateMixerStreamControl *control, gboolean m
 
     control->priv->mute = mute;
 
+    _mate_mixer_stream_control_publish_state (control);
+
     g_object_notify_by_pspec (G_OBJECT (control), properties[PROP_MUTE]);
 }
 
@@ -933,6 +1203,8 @@ _mate_mixer_stream_control_set_balance (MateMixerStreamControl *control, gfloat
 
     control->priv->balance = balance;
 
+    _mate_mixer_stream_control_publish_state (control);
+
     g_object_notify_by_pspec (G_OBJECT (control), properties[PROP_BALANCE]);
 }
 
@@ -946,5 +1218,103 @@ _mate_mixer_stream_control_set_fade (MateMixerStreamControl *control, gfloat fad
 
     control->priv->fade = fade;
 
+    _mate_mixer_stream_control_publish_state (control);
+
     g_object_notify_by_pspec (G_OBJECT (control), properties[PROP_FADE]);
 }
+
+void
+_mate_mixer_stream_control_push_monitor_value (MateMixerStreamControl *control,
+                                               gdouble                 value)
+{
+    MateMixerMeter *meter;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    /* The meter is only created by the producer, readers see it once it is
+     * fully initialized */
+    meter = control->priv->meter;
+    if (meter == NULL) {
+        meter = _mate_mixer_meter_new ();
+        g_atomic_pointer_set (&control->priv->meter, meter);
+    }
+
+    _mate_mixer_meter_push (meter, value);
+
+    if (control->priv->monitor_signal == TRUE)
+        g_signal_emit (G_OBJECT (control), signals[MONITOR_VALUE], 0, value);
+}
+
+void
+_mate_mixer_stream_control_publish_state (MateMixerStreamControl *control)
+{
+    MateMixerStreamControlState state;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    /* Read the state before entering the write section to keep it short */
+    mate_mixer_stream_control_read_state (control, &state);
+
+    /* Only the main thread writes, the fences keep the plain stores of the
+     * state between the two increments of the sequence number */
+    g_atomic_int_inc (&control->priv->shared_sequence);
+
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+
+    control->priv->shared = state;
+
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+
+    g_atomic_int_inc (&control->priv->shared_sequence);
+}
+
+/* Converts a volume on the scale of the control to decibels without changing
+ * the control, returns FALSE when the control does not support decibels or
+ * does not implement the private MateMixerDecibelScale interface */
+gboolean
+_mate_mixer_stream_control_get_decibel_from_volume (MateMixerStreamControl *control,
+                                                    guint                   volume,
+                                                    gdouble                *decibel)
+{
+    MateMixerDecibelScaleInterface *iface;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+    g_return_val_if_fail (decibel != NULL, FALSE);
+
+    if ((control->priv->flags & MATE_MIXER_STREAM_CONTROL_HAS_DECIBEL) == 0)
+        return FALSE;
+
+    if (MATE_MIXER_IS_DECIBEL_SCALE (control) == FALSE)
+        return FALSE;
+
+    iface = MATE_MIXER_DECIBEL_SCALE_GET_INTERFACE (control);
+
+    if (iface->get_decibel_from_volume == NULL)
+        return FALSE;
+
+    return iface->get_decibel_from_volume (MATE_MIXER_DECIBEL_SCALE (control), volume, decibel);
+}
+
+gboolean
+_mate_mixer_stream_control_get_volume_from_decibel (MateMixerStreamControl *control,
+                                                    gdouble                 decibel,
+                                                    guint                  *volume)
+{
+    MateMixerDecibelScaleInterface *iface;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+    g_return_val_if_fail (volume != NULL, FALSE);
+
+    if ((control->priv->flags & MATE_MIXER_STREAM_CONTROL_HAS_DECIBEL) == 0)
+        return FALSE;
+
+    if (MATE_MIXER_IS_DECIBEL_SCALE (control) == FALSE)
+        return FALSE;
+
+    iface = MATE_MIXER_DECIBEL_SCALE_GET_INTERFACE (control);
+
+    if (iface->get_volume_from_decibel == NULL)
+        return FALSE;
+
+    return iface->get_volume_from_decibel (MATE_MIXER_DECIBEL_SCALE (control), decibel, volume);
+}
@@ -49,6 +49,25 @@ G_BEGIN_DECLS
 typedef struct _MateMixerStreamControlClass    MateMixerStreamControlClass;
 typedef struct _MateMixerStreamControlPrivate  MateMixerStreamControlPrivate;
 
+/**
+ * MATE_MIXER_STREAM_CONTROL_STATE_MAX_CHANNELS:
+ *
+ * Maximum number of channel volumes stored in a #MateMixerStreamControlState.
+ */
+#define MATE_MIXER_STREAM_CONTROL_STATE_MAX_CHANNELS 32
+
+struct _MateMixerStreamControlState
+{
+    const gchar                 *name;
+    MateMixerStreamControlFlags  flags;
+    gboolean                     mute;
+    guint                        volume;
+    gfloat                       balance;
+    gfloat                       fade;
+    guint                        num_channels;
+    guint                        channel_volume[MATE_MIXER_STREAM_CONTROL_STATE_MAX_CHANNELS];
+};
+
 /**
  * MateMixerStreamControl:
  *
@@ -185,11 +204,28 @@ gboolean                        mate_mixer_stream_control_get_monitor_enabled  (
 gboolean                        mate_mixer_stream_control_set_monitor_enabled  (MateMixerStreamControl  *control,
                                                                                 gboolean                 enabled);
 
+gboolean                        mate_mixer_stream_control_get_monitor_signal   (MateMixerStreamControl  *control);
+void                            mate_mixer_stream_control_set_monitor_signal   (MateMixerStreamControl  *control,
+                                                                                gboolean                 enabled);
+
+gboolean                        mate_mixer_stream_control_read_monitor_value   (MateMixerStreamControl  *control,
+                                                                                gdouble                 *value);
+gboolean                        mate_mixer_stream_control_read_monitor_peak    (MateMixerStreamControl  *control,
+                                                                                gdouble                 *peak);
+guint                           mate_mixer_stream_control_copy_monitor_values  (MateMixerStreamControl  *control,
+                                                                                gdouble                 *values,
+                                                                                guint                    count);
+
 guint                           mate_mixer_stream_control_get_min_volume       (MateMixerStreamControl  *control);
 guint                           mate_mixer_stream_control_get_max_volume       (MateMixerStreamControl  *control);
 guint                           mate_mixer_stream_control_get_normal_volume    (MateMixerStreamControl  *control);
 guint                           mate_mixer_stream_control_get_base_volume      (MateMixerStreamControl  *control);
 
+void                            mate_mixer_stream_control_read_state           (MateMixerStreamControl  *control,
+                                                                                MateMixerStreamControlState *state);
+void                            mate_mixer_stream_control_read_shared_state    (MateMixerStreamControl  *control,
+                                                                                MateMixerStreamControlState *state);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_STREAM_CONTROL_H */
@@ -443,6 +443,45 @@ mate_mixer_stream_list_switches (MateMixerStream *stream)
     return NULL;
 }
 
+/**
+ * mate_mixer_stream_read_controls:
+ * @stream: a #MateMixerStream
+ * @states: (array length=n_states): an array of #MateMixerStreamControlState
+ * @n_states: the number of items in @states
+ *
+ * Reads the state of all the controls of the stream into the caller-provided
+ * array, in the order of mate_mixer_stream_list_controls(). See
+ * mate_mixer_stream_control_read_state() for the description of the values.
+ *
+ * When the array is too small, only the first @n_states controls are read.
+ * The function may be called with @n_states 0 to find out the number of
+ * controls.
+ *
+ * Returns: the number of controls of the stream, which may be larger than
+ * @n_states.
+ */
+guint
+mate_mixer_stream_read_controls (MateMixerStream             *stream,
+                                 MateMixerStreamControlState *states,
+                                 guint                        n_states)
+{
+    const GList *list;
+    guint        count = 0;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), 0);
+    g_return_val_if_fail (states != NULL || n_states == 0, 0);
+
+    list = mate_mixer_stream_list_controls (stream);
+    while (list != NULL) {
+        if (count < n_states)
+            mate_mixer_stream_control_read_state (MATE_MIXER_STREAM_CONTROL (list->data),
+                                                  &states[count]);
+        count++;
+        list = list->next;
+    }
+    return count;
+}
+
 static MateMixerStreamControl *
 mate_mixer_stream_real_get_control (MateMixerStream *stream, const gchar *name)
 {
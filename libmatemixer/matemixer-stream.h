@@ -105,6 +105,10 @@ MateMixerStreamControl *mate_mixer_stream_get_default_control (MateMixerStream *
 const GList *           mate_mixer_stream_list_controls       (MateMixerStream *stream);
 const GList *           mate_mixer_stream_list_switches       (MateMixerStream *stream);
 
+guint                   mate_mixer_stream_read_controls       (MateMixerStream             *stream,
+                                                               MateMixerStreamControlState *states,
+                                                               guint                        n_states);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_STREAM_H */
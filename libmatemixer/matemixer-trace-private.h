@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_TRACE_PRIVATE_H
+#define MATEMIXER_TRACE_PRIVATE_H
+
+#include "config.h"
+
+#include <glib.h>
+
+#ifdef HAVE_SDT
+#include <sys/sdt.h>
+#endif
+
+G_BEGIN_DECLS
+
+/*
+ * Static tracepoints for perf, bpftrace and SystemTap.
+ *
+ * The probes are placed in the "libmatemixer" provider and are only compiled
+ * in when the library is configured with --enable-tracing, otherwise the
+ * macros expand to nothing and the arguments are not evaluated.
+ *
+ * MATE_MIXER_TRACE_TIMESTAMP() may be used to measure the latency passed to a
+ * probe, it evaluates to 0 when tracing is disabled. MATE_MIXER_TRACE_ENABLED
+ * tells whether the probes are compiled in, so that code which only gathers
+ * data for a probe can be skipped.
+ */
+#ifdef HAVE_SDT
+#define MATE_MIXER_TRACE(name, ...)                             \
+        STAP_PROBEV (libmatemixer, name, ##__VA_ARGS__)
+#define MATE_MIXER_TRACE_TIMESTAMP()                            \
+        (g_get_monotonic_time ())
+#define MATE_MIXER_TRACE_ENABLED                                \
+        TRUE
+#else
+#define MATE_MIXER_TRACE(name, ...)                             \
+        G_STMT_START { } G_STMT_END
+#define MATE_MIXER_TRACE_TIMESTAMP()                            \
+        ((gint64) 0)
+#define MATE_MIXER_TRACE_ENABLED                                \
+        FALSE
+#endif
+
+G_END_DECLS
+
+#endif /* MATEMIXER_TRACE_PRIVATE_H */
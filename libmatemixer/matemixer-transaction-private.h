@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_TRANSACTION_PRIVATE_H
+#define MATEMIXER_TRANSACTION_PRIVATE_H
+
+#include <glib.h>
+
+#include "matemixer-backend.h"
+#include "matemixer-transaction.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+    MATE_MIXER_TRANSACTION_SET_VOLUME,
+    MATE_MIXER_TRANSACTION_SET_CHANNEL_VOLUME,
+    MATE_MIXER_TRANSACTION_SET_MUTE,
+    MATE_MIXER_TRANSACTION_SET_STREAM,
+    MATE_MIXER_TRANSACTION_SET_DEFAULT_INPUT_STREAM,
+    MATE_MIXER_TRANSACTION_SET_DEFAULT_OUTPUT_STREAM,
+    MATE_MIXER_TRANSACTION_SET_SWITCH_OPTION
+} MateMixerTransactionAction;
+
+typedef struct
+{
+    MateMixerTransactionAction  action;
+    MateMixerStreamControl     *control;
+    MateMixerSwitch            *swtch;
+    MateMixerStream            *stream;
+    MateMixerSwitchOption      *option;
+    guint                       channel;
+    guint                       volume;
+    gboolean                    mute;
+} MateMixerTransactionOperation;
+
+MateMixerTransaction *_mate_mixer_transaction_new              (void);
+
+const GList *         _mate_mixer_transaction_list_operations  (MateMixerTransaction *transaction);
+
+gboolean              _mate_mixer_transaction_get_committed    (MateMixerTransaction *transaction);
+void                  _mate_mixer_transaction_set_committed    (MateMixerTransaction *transaction,
+                                                                gpointer              owner);
+
+gpointer              _mate_mixer_transaction_get_owner        (MateMixerTransaction *transaction);
+
+void                  _mate_mixer_transaction_freeze_notify    (MateMixerTransaction *transaction);
+void                  _mate_mixer_transaction_thaw_notify      (MateMixerTransaction *transaction);
+
+gboolean              _mate_mixer_transaction_apply            (MateMixerTransaction *transaction,
+                                                                MateMixerBackend     *backend);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_TRANSACTION_PRIVATE_H */
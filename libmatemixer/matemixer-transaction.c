@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-backend.h"
+#include "matemixer-stream.h"
+#include "matemixer-stream-control.h"
+#include "matemixer-switch.h"
+#include "matemixer-switch-option.h"
+#include "matemixer-transaction.h"
+#include "matemixer-transaction-private.h"
+
+/**
+ * SECTION:matemixer-transaction
+ * @short_description: Batched control changes
+ * @include: libmatemixer/matemixer.h
+ * @see_also: #MateMixerContext, #MateMixerStreamControl
+ *
+ * A #MateMixerTransaction collects changes of several stream controls,
+ * switches and default streams, which are then applied together.
+ *
+ * A transaction is created with mate_mixer_context_begin_transaction(), the
+ * changes are added using the mate_mixer_transaction_set_*() functions and
+ * they are applied using mate_mixer_context_commit_transaction().
+ *
+ * The sound system backend sends the changes to the sound system as a single
+ * batch without waiting for each of them to complete. When all of them have
+ * been processed, the #MateMixerContext::transaction-completed signal is
+ * emitted once for the whole transaction. Change notifications of the
+ * modified controls and switches are held until then.
+ */
+
+/**
+ * MateMixerTransaction:
+ *
+ * The #MateMixerTransaction structure contains only private data and should
+ * only be accessed using the provided API.
+ */
+struct _MateMixerTransaction
+{
+    gint     ref_count;
+    gpointer owner;
+    GQueue   operations;
+};
+
+G_DEFINE_BOXED_TYPE (MateMixerTransaction, mate_mixer_transaction,
+                     mate_mixer_transaction_ref,
+                     mate_mixer_transaction_unref)
+
+static MateMixerTransactionOperation *add_operation  (MateMixerTransaction          *transaction,
+                                                      MateMixerTransactionAction     action,
+                                                      MateMixerStreamControl        *control,
+                                                      MateMixerSwitch               *swtch,
+                                                      guint                          channel);
+
+static void                           set_object     (gpointer                      *object_ptr,
+                                                      gpointer                       object);
+
+static void                           free_operation (MateMixerTransactionOperation *op);
+
+/**
+ * mate_mixer_transaction_ref:
+ * @transaction: a #MateMixerTransaction
+ *
+ * Increases the reference count of the transaction.
+ *
+ * Returns: the given @transaction.
+ */
+MateMixerTransaction *
+mate_mixer_transaction_ref (MateMixerTransaction *transaction)
+{
+    g_return_val_if_fail (transaction != NULL, NULL);
+
+    g_atomic_int_inc (&transaction->ref_count);
+    return transaction;
+}
+
+/**
+ * mate_mixer_transaction_unref:
+ * @transaction: a #MateMixerTransaction
+ *
+ * Decreases the reference count of the transaction. When the reference count
+ * drops to 0, the transaction is freed.
+ */
+void
+mate_mixer_transaction_unref (MateMixerTransaction *transaction)
+{
+    g_return_if_fail (transaction != NULL);
+
+    if (g_atomic_int_dec_and_test (&transaction->ref_count) == FALSE)
+        return;
+
+    g_queue_foreach (&transaction->operations, (GFunc) free_operation, NULL);
+    g_queue_clear (&transaction->operations);
+
+    g_slice_free (MateMixerTransaction, transaction);
+}
+
+/**
+ * mate_mixer_transaction_set_volume:
+ * @transaction: a #MateMixerTransaction
+ * @control: a #MateMixerStreamControl
+ * @volume: the volume to set
+ *
+ * Adds a change of the volume of @control to the transaction.
+ * See mate_mixer_stream_control_set_volume().
+ */
+void
+mate_mixer_transaction_set_volume (MateMixerTransaction   *transaction,
+                                   MateMixerStreamControl *control,
+                                   guint                   volume)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_VOLUME, control, NULL, 0);
+    if (op != NULL)
+        op->volume = volume;
+}
+
+/**
+ * mate_mixer_transaction_set_channel_volume:
+ * @transaction: a #MateMixerTransaction
+ * @control: a #MateMixerStreamControl
+ * @channel: a channel index
+ * @volume: the volume to set
+ *
+ * Adds a change of the volume of a single channel of @control to the
+ * transaction. See mate_mixer_stream_control_set_channel_volume().
+ */
+void
+mate_mixer_transaction_set_channel_volume (MateMixerTransaction   *transaction,
+                                           MateMixerStreamControl *control,
+                                           guint                   channel,
+                                           guint                   volume)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_CHANNEL_VOLUME, control, NULL, channel);
+    if (op != NULL)
+        op->volume = volume;
+}
+
+/**
+ * mate_mixer_transaction_set_mute:
+ * @transaction: a #MateMixerTransaction
+ * @control: a #MateMixerStreamControl
+ * @mute: the mute state to set
+ *
+ * Adds a change of the mute state of @control to the transaction.
+ * See mate_mixer_stream_control_set_mute().
+ */
+void
+mate_mixer_transaction_set_mute (MateMixerTransaction   *transaction,
+                                 MateMixerStreamControl *control,
+                                 gboolean                mute)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_MUTE, control, NULL, 0);
+    if (op != NULL)
+        op->mute = mute;
+}
+
+/**
+ * mate_mixer_transaction_set_stream:
+ * @transaction: a #MateMixerTransaction
+ * @control: a #MateMixerStreamControl
+ * @stream: the stream to move @control to
+ *
+ * Adds a move of @control to a different stream to the transaction.
+ * See mate_mixer_stream_control_set_stream().
+ */
+void
+mate_mixer_transaction_set_stream (MateMixerTransaction   *transaction,
+                                   MateMixerStreamControl *control,
+                                   MateMixerStream        *stream)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+    g_return_if_fail (MATE_MIXER_IS_STREAM (stream));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_STREAM, control, NULL, 0);
+    if (op != NULL)
+        set_object ((gpointer *) &op->stream, stream);
+}
+
+/**
+ * mate_mixer_transaction_set_default_input_stream:
+ * @transaction: a #MateMixerTransaction
+ * @stream: a #MateMixerStream
+ *
+ * Adds a change of the default input stream to the transaction.
+ * See mate_mixer_context_set_default_input_stream().
+ */
+void
+mate_mixer_transaction_set_default_input_stream (MateMixerTransaction *transaction,
+                                                 MateMixerStream      *stream)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM (stream));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_DEFAULT_INPUT_STREAM, NULL, NULL, 0);
+    if (op != NULL)
+        set_object ((gpointer *) &op->stream, stream);
+}
+
+/**
+ * mate_mixer_transaction_set_default_output_stream:
+ * @transaction: a #MateMixerTransaction
+ * @stream: a #MateMixerStream
+ *
+ * Adds a change of the default output stream to the transaction.
+ * See mate_mixer_context_set_default_output_stream().
+ */
+void
+mate_mixer_transaction_set_default_output_stream (MateMixerTransaction *transaction,
+                                                  MateMixerStream      *stream)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM (stream));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_DEFAULT_OUTPUT_STREAM, NULL, NULL, 0);
+    if (op != NULL)
+        set_object ((gpointer *) &op->stream, stream);
+}
+
+/**
+ * mate_mixer_transaction_set_switch_option:
+ * @transaction: a #MateMixerTransaction
+ * @swtch: a #MateMixerSwitch
+ * @option: the #MateMixerSwitchOption to activate
+ *
+ * Adds a change of the active option of @swtch to the transaction.
+ * See mate_mixer_switch_set_active_option().
+ */
+void
+mate_mixer_transaction_set_switch_option (MateMixerTransaction  *transaction,
+                                          MateMixerSwitch       *swtch,
+                                          MateMixerSwitchOption *option)
+{
+    MateMixerTransactionOperation *op;
+
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (MATE_MIXER_IS_SWITCH (swtch));
+    g_return_if_fail (MATE_MIXER_IS_SWITCH_OPTION (option));
+
+    op = add_operation (transaction, MATE_MIXER_TRANSACTION_SET_SWITCH_OPTION, NULL, swtch, 0);
+    if (op != NULL)
+        set_object ((gpointer *) &op->option, option);
+}
+
+/**
+ * mate_mixer_transaction_get_num_operations:
+ * @transaction: a #MateMixerTransaction
+ *
+ * Gets the number of changes in the transaction. A change which replaces an
+ * earlier change of the same kind of the same control is only counted once.
+ *
+ * Returns: the number of changes.
+ */
+guint
+mate_mixer_transaction_get_num_operations (MateMixerTransaction *transaction)
+{
+    g_return_val_if_fail (transaction != NULL, 0);
+
+    return g_queue_get_length (&transaction->operations);
+}
+
+MateMixerTransaction *
+_mate_mixer_transaction_new (void)
+{
+    MateMixerTransaction *transaction;
+
+    transaction = g_slice_new0 (MateMixerTransaction);
+    transaction->ref_count = 1;
+
+    g_queue_init (&transaction->operations);
+    return transaction;
+}
+
+const GList *
+_mate_mixer_transaction_list_operations (MateMixerTransaction *transaction)
+{
+    g_return_val_if_fail (transaction != NULL, NULL);
+
+    return transaction->operations.head;
+}
+
+gboolean
+_mate_mixer_transaction_get_committed (MateMixerTransaction *transaction)
+{
+    g_return_val_if_fail (transaction != NULL, FALSE);
+
+    return transaction->owner != NULL;
+}
+
+void
+_mate_mixer_transaction_set_committed (MateMixerTransaction *transaction, gpointer owner)
+{
+    g_return_if_fail (transaction != NULL);
+    g_return_if_fail (owner != NULL);
+
+    transaction->owner = owner;
+}
+
+gpointer
+_mate_mixer_transaction_get_owner (MateMixerTransaction *transaction)
+{
+    g_return_val_if_fail (transaction != NULL, NULL);
+
+    return transaction->owner;
+}
+
+void
+_mate_mixer_transaction_freeze_notify (MateMixerTransaction *transaction)
+{
+    GList *list;
+
+    g_return_if_fail (transaction != NULL);
+
+    /* Hold the change notifications of the controls until all the changes
+     * have been processed, so each control notifies at most once per property */
+    for (list = transaction->operations.head; list != NULL; list = list->next) {
+        MateMixerTransactionOperation *op = list->data;
+
+        if (op->control != NULL)
+            g_object_freeze_notify (G_OBJECT (op->control));
+        if (op->swtch != NULL)
+            g_object_freeze_notify (G_OBJECT (op->swtch));
+    }
+}
+
+void
+_mate_mixer_transaction_thaw_notify (MateMixerTransaction *transaction)
+{
+    GList *list;
+
+    g_return_if_fail (transaction != NULL);
+
+    for (list = transaction->operations.tail; list != NULL; list = list->prev) {
+        MateMixerTransactionOperation *op = list->data;
+
+        if (op->control != NULL)
+            g_object_thaw_notify (G_OBJECT (op->control));
+        if (op->swtch != NULL)
+            g_object_thaw_notify (G_OBJECT (op->swtch));
+    }
+}
+
+gboolean
+_mate_mixer_transaction_apply (MateMixerTransaction *transaction, MateMixerBackend *backend)
+{
+    GList    *list;
+    gboolean  success = TRUE;
+
+    g_return_val_if_fail (transaction != NULL, FALSE);
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), FALSE);
+
+    for (list = transaction->operations.head; list != NULL; list = list->next) {
+        MateMixerTransactionOperation *op = list->data;
+        gboolean                       ret = FALSE;
+
+        switch (op->action) {
+        case MATE_MIXER_TRANSACTION_SET_VOLUME:
+            ret = mate_mixer_stream_control_set_volume (op->control, op->volume);
+            break;
+        case MATE_MIXER_TRANSACTION_SET_CHANNEL_VOLUME:
+            ret = mate_mixer_stream_control_set_channel_volume (op->control,
+                                                                op->channel,
+                                                                op->volume);
+            break;
+        case MATE_MIXER_TRANSACTION_SET_MUTE:
+            ret = mate_mixer_stream_control_set_mute (op->control, op->mute);
+            break;
+        case MATE_MIXER_TRANSACTION_SET_STREAM:
+            ret = mate_mixer_stream_control_set_stream (op->control, op->stream);
+            break;
+        case MATE_MIXER_TRANSACTION_SET_DEFAULT_INPUT_STREAM:
+            ret = mate_mixer_backend_set_default_input_stream (backend, op->stream);
+            break;
+        case MATE_MIXER_TRANSACTION_SET_DEFAULT_OUTPUT_STREAM:
+            ret = mate_mixer_backend_set_default_output_stream (backend, op->stream);
+            break;
+        case MATE_MIXER_TRANSACTION_SET_SWITCH_OPTION:
+            ret = mate_mixer_switch_set_active_option (op->swtch, op->option);
+            break;
+        }
+
+        /* Keep going, the other changes are independent */
+        if (ret == FALSE)
+            success = FALSE;
+    }
+    return success;
+}
+
+static MateMixerTransactionOperation *
+add_operation (MateMixerTransaction       *transaction,
+               MateMixerTransactionAction  action,
+               MateMixerStreamControl     *control,
+               MateMixerSwitch            *swtch,
+               guint                       channel)
+{
+    MateMixerTransactionOperation *op;
+    GList                         *list;
+
+    if (G_UNLIKELY (transaction->owner != NULL)) {
+        g_warning ("Unable to change a transaction which has already been committed");
+        return NULL;
+    }
+
+    /* A later change of the same kind replaces the earlier one */
+    for (list = transaction->operations.head; list != NULL; list = list->next) {
+        op = list->data;
+
+        if (op->action == action &&
+            op->control == control &&
+            op->swtch == swtch &&
+            op->channel == channel)
+            return op;
+    }
+
+    op = g_slice_new0 (MateMixerTransactionOperation);
+    op->action  = action;
+    op->channel = channel;
+
+    if (control != NULL)
+        op->control = g_object_ref (control);
+    if (swtch != NULL)
+        op->swtch = g_object_ref (swtch);
+
+    g_queue_push_tail (&transaction->operations, op);
+    return op;
+}
+
+static void
+set_object (gpointer *object_ptr, gpointer object)
+{
+    if (*object_ptr == object)
+        return;
+
+    if (*object_ptr != NULL)
+        g_object_unref (*object_ptr);
+
+    *object_ptr = g_object_ref (object);
+}
+
+static void
+free_operation (MateMixerTransactionOperation *op)
+{
+    if (op->control != NULL)
+        g_object_unref (op->control);
+    if (op->swtch != NULL)
+        g_object_unref (op->swtch);
+    if (op->stream != NULL)
+        g_object_unref (op->stream);
+    if (op->option != NULL)
+        g_object_unref (op->option);
+
+    g_slice_free (MateMixerTransactionOperation, op);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_TRANSACTION_H
+#define MATEMIXER_TRANSACTION_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+#define MATE_MIXER_TYPE_TRANSACTION (mate_mixer_transaction_get_type ())
+
+GType                 mate_mixer_transaction_get_type                   (void) G_GNUC_CONST;
+
+MateMixerTransaction *mate_mixer_transaction_ref                        (MateMixerTransaction   *transaction);
+void                  mate_mixer_transaction_unref                      (MateMixerTransaction   *transaction);
+
+void                  mate_mixer_transaction_set_volume                 (MateMixerTransaction   *transaction,
+                                                                         MateMixerStreamControl *control,
+                                                                         guint                   volume);
+void                  mate_mixer_transaction_set_channel_volume         (MateMixerTransaction   *transaction,
+                                                                         MateMixerStreamControl *control,
+                                                                         guint                   channel,
+                                                                         guint                   volume);
+void                  mate_mixer_transaction_set_mute                   (MateMixerTransaction   *transaction,
+                                                                         MateMixerStreamControl *control,
+                                                                         gboolean                mute);
+void                  mate_mixer_transaction_set_stream                 (MateMixerTransaction   *transaction,
+                                                                         MateMixerStreamControl *control,
+                                                                         MateMixerStream        *stream);
+void                  mate_mixer_transaction_set_default_input_stream   (MateMixerTransaction   *transaction,
+                                                                         MateMixerStream        *stream);
+void                  mate_mixer_transaction_set_default_output_stream  (MateMixerTransaction   *transaction,
+                                                                         MateMixerStream        *stream);
+void                  mate_mixer_transaction_set_switch_option          (MateMixerTransaction   *transaction,
+                                                                         MateMixerSwitch        *swtch,
+                                                                         MateMixerSwitchOption  *option);
+
+guint                 mate_mixer_transaction_get_num_operations         (MateMixerTransaction   *transaction);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_TRANSACTION_H */
@@ -20,17 +20,21 @@
 
 G_BEGIN_DECLS
 
+typedef struct _MateMixerAggregateControl MateMixerAggregateControl;
 typedef struct _MateMixerAppInfo        MateMixerAppInfo;
 typedef struct _MateMixerContext        MateMixerContext;
 typedef struct _MateMixerDevice         MateMixerDevice;
 typedef struct _MateMixerDeviceSwitch   MateMixerDeviceSwitch;
+typedef struct _MateMixerStatistics     MateMixerStatistics;
 typedef struct _MateMixerStoredControl  MateMixerStoredControl;
 typedef struct _MateMixerStream         MateMixerStream;
 typedef struct _MateMixerStreamControl  MateMixerStreamControl;
+typedef struct _MateMixerStreamControlState MateMixerStreamControlState;
 typedef struct _MateMixerStreamSwitch   MateMixerStreamSwitch;
 typedef struct _MateMixerStreamToggle   MateMixerStreamToggle;
 typedef struct _MateMixerSwitch         MateMixerSwitch;
 typedef struct _MateMixerSwitchOption   MateMixerSwitchOption;
+typedef struct _MateMixerTransaction    MateMixerTransaction;
 
 G_END_DECLS
 
@@ -23,12 +23,14 @@
 
 #include <libmatemixer/matemixer-types.h>
 
+#include <libmatemixer/matemixer-aggregate-control.h>
 #include <libmatemixer/matemixer-app-info.h>
 #include <libmatemixer/matemixer-context.h>
 #include <libmatemixer/matemixer-device.h>
 #include <libmatemixer/matemixer-device-switch.h>
 #include <libmatemixer/matemixer-enums.h>
 #include <libmatemixer/matemixer-enum-types.h>
+#include <libmatemixer/matemixer-statistics.h>
 #include <libmatemixer/matemixer-stored-control.h>
 #include <libmatemixer/matemixer-stream.h>
 #include <libmatemixer/matemixer-stream-control.h>
@@ -36,6 +38,7 @@
 #include <libmatemixer/matemixer-stream-toggle.h>
 #include <libmatemixer/matemixer-switch.h>
 #include <libmatemixer/matemixer-switch-option.h>
+#include <libmatemixer/matemixer-transaction.h>
 #include <libmatemixer/matemixer-version.h>
 
 G_BEGIN_DECLS